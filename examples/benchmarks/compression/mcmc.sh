@@ -1,21 +1,23 @@
 SCENE_DIR="data/360_v2"
 # eval all 9 scenes for benchmarking
 SCENE_LIST="garden bicycle stump bonsai counter kitchen room treehill flowers"
+# compression method: png or rans
+COMPRESSION="png"
 
 # # 0.36M GSs
-# RESULT_DIR="results/benchmark_mcmc_0_36M_png_compression"
+# RESULT_DIR="results/benchmark_mcmc_0_36M_${COMPRESSION}_compression"
 # CAP_MAX=360000
 
 # # 0.49M GSs
-# RESULT_DIR="results/benchmark_mcmc_0_49M_png_compression"
+# RESULT_DIR="results/benchmark_mcmc_0_49M_${COMPRESSION}_compression"
 # CAP_MAX=490000
 
 # 1M GSs
-RESULT_DIR="results/benchmark_mcmc_1M_png_compression"
+RESULT_DIR="results/benchmark_mcmc_1M_${COMPRESSION}_compression"
 CAP_MAX=1000000
 
 # # 4M GSs
-# RESULT_DIR="results/benchmark_mcmc_4M_png_compression"
+# RESULT_DIR="results/benchmark_mcmc_4M_${COMPRESSION}_compression"
 # CAP_MAX=4000000
 
 
@@ -41,7 +43,7 @@ do
         --data_dir $SCENE_DIR/$SCENE/ \
         --result_dir $RESULT_DIR/$SCENE/ \
         --lpips_net vgg \
-        --compression png \
+        --compression $COMPRESSION \
         --ckpt $RESULT_DIR/$SCENE/ckpts/ckpt_29999_rank0.pt
 done
 
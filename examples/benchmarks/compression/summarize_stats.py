@@ -31,10 +31,25 @@ def main(results_dir: str, scenes: List[str], stage: str = "compress"):
             for k, v in stats.items():
                 summary[k].append(v)
 
+        # encoding and decoding times of the compression method
+        time_path = os.path.join(scene_dir, f"stats/{stage}_time_step29999.json")
+        if os.path.exists(time_path):
+            with open(time_path, "r") as f:
+                for k, v in json.load(f).items():
+                    summary[k].append(v)
+
     for k, v in summary.items():
         summary[k] = np.mean(v)
     summary["scenes"] = scenes
 
+    # size / quality trade-off
+    if "size" in summary:
+        line = f"{results_dir}: {summary['size'] / 1024**2:.2f}MB"
+        for k in ["psnr", "ssim", "lpips", "compress_time", "decompress_time"]:
+            if k in summary:
+                line += f", {k} {summary[k]:.3f}"
+        print(line)
+
     with open(os.path.join(results_dir, f"{stage}_summary.json"), "w") as f:
         json.dump(summary, f, indent=2)
 
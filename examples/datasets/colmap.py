@@ -1,6 +1,7 @@
 import json
 import os
-from typing import Any, Dict, List, Optional
+from concurrent.futures import ThreadPoolExecutor
+from typing import Any, Dict, List, Optional, Tuple
 
 import cv2
 import imageio.v2 as imageio
@@ -9,7 +10,7 @@ import torch
 from PIL import Image
 from pycolmap import SceneManager
 from tqdm import tqdm
-from typing_extensions import assert_never
+from typing_extensions import Literal, assert_never
 
 from .normalize import (
     align_principal_axes,
@@ -349,7 +350,14 @@ class Parser:
 
 
 class Dataset:
-    """A simple dataset class."""
+    """A simple dataset class.
+
+    With `cache`, the decoded and undistorted images are kept as uint8 arrays,
+    either in memory ("ram") or in memory-mapped .npy files under `cache_dir`
+    ("disk"), which are reused across runs. Both are shared with forked
+    DataLoader workers without copies. The depths of the SfM points are
+    projected once for all the images when `load_depths` is set.
+    """
 
     def __init__(
         self,
@@ -357,6 +365,9 @@ class Dataset:
         split: str = "train",
         patch_size: Optional[int] = None,
         load_depths: bool = False,
+        cache: Optional[Literal["ram", "disk"]] = None,
+        cache_dir: Optional[str] = None,
+        num_threads: int = 8,
     ):
         self.parser = parser
         self.split = split
@@ -368,18 +379,32 @@ class Dataset:
         else:
             self.indices = indices[indices % self.parser.test_every == 0]
 
+        self.cache = cache
+        self.images: Dict[int, np.ndarray] = {}
+        if cache is not None:
+            if cache_dir is None:
+                cache_dir = os.path.join(
+                    parser.data_dir, f"cache_{parser.factor}", "images"
+                )
+            self.cache_dir = cache_dir
+            with ThreadPoolExecutor(num_threads) as pool:
+                images = pool.map(self._cache_image, self.indices)
+                for index, image in zip(self.indices, images):
+                    self.images[index] = image
+
+        self.depth_points: Dict[int, Tuple[np.ndarray, np.ndarray]] = {}
+        if load_depths:
+            for index in self.indices:
+                self.depth_points[index] = self._project_points(index)
+
     def __len__(self):
         return len(self.indices)
 
-    def __getitem__(self, item: int) -> Dict[str, Any]:
-        index = self.indices[item]
+    def _load_image(self, index: int) -> np.ndarray:
+        """Decode an image and undistort it."""
         image = imageio.imread(self.parser.image_paths[index])[..., :3]
         camera_id = self.parser.camera_ids[index]
-        K = self.parser.Ks_dict[camera_id].copy()  # undistorted K
         params = self.parser.params_dict[camera_id]
-        camtoworlds = self.parser.camtoworlds[index]
-        mask = self.parser.mask_dict[camera_id]
-
         if len(params) > 0:
             # Images are distorted. Undistort them.
             mapx, mapy = (
@@ -389,7 +414,51 @@ class Dataset:
             image = cv2.remap(image, mapx, mapy, cv2.INTER_LINEAR)
             x, y, w, h = self.parser.roi_undist_dict[camera_id]
             image = image[y : y + h, x : x + w]
+        return np.ascontiguousarray(image)
+
+    def _cache_image(self, index: int) -> np.ndarray:
+        if self.cache == "ram":
+            return self._load_image(index)
+        image_name = self.parser.image_names[index]
+        path = os.path.join(self.cache_dir, os.path.splitext(image_name)[0] + ".npy")
+        if not os.path.exists(path):
+            os.makedirs(os.path.dirname(path), exist_ok=True)
+            # write to a temporary file first, so that an interrupted run does
+            # not leave a truncated cache
+            tmp_path = path[: -len(".npy")] + f".{os.getpid()}.tmp.npy"
+            np.save(tmp_path, self._load_image(index))
+            os.replace(tmp_path, path)
+        # copy-on-write, so that the arrays are writable
+        return np.load(path, mmap_mode="c")
+
+    def _project_points(self, index: int) -> Tuple[np.ndarray, np.ndarray]:
+        """Project the SfM points seen by an image to get their depths. The points
+        outside the image are filtered out when loading it."""
+        camera_id = self.parser.camera_ids[index]
+        K = self.parser.Ks_dict[camera_id]
+        worldtocams = np.linalg.inv(self.parser.camtoworlds[index])
+        image_name = self.parser.image_names[index]
+        point_indices = self.parser.point_indices[image_name]
+        points_world = self.parser.points[point_indices]
+        points_cam = (worldtocams[:3, :3] @ points_world.T + worldtocams[:3, 3:4]).T
+        points_proj = (K @ points_cam.T).T
+        points = points_proj[:, :2] / points_proj[:, 2:3]  # (M, 2)
+        depths = points_cam[:, 2]  # (M,)
+        selector = depths > 0
+        return points[selector], depths[selector]
+
+    def __getitem__(self, item: int) -> Dict[str, Any]:
+        index = self.indices[item]
+        if index in self.images:
+            image = self.images[index]
+        else:
+            image = self._load_image(index)
+        camera_id = self.parser.camera_ids[index]
+        K = self.parser.Ks_dict[camera_id].copy()  # undistorted K
+        camtoworlds = self.parser.camtoworlds[index]
+        mask = self.parser.mask_dict[camera_id]
 
+        x, y = 0, 0
         if self.patch_size is not None:
             # Random crop.
             h, w = image.shape[:2]
@@ -409,27 +478,18 @@ class Dataset:
             data["mask"] = torch.from_numpy(mask).bool()
 
         if self.load_depths:
-            # projected points to image plane to get depths
-            worldtocams = np.linalg.inv(camtoworlds)
-            image_name = self.parser.image_names[index]
-            point_indices = self.parser.point_indices[image_name]
-            points_world = self.parser.points[point_indices]
-            points_cam = (worldtocams[:3, :3] @ points_world.T + worldtocams[:3, 3:4]).T
-            points_proj = (K @ points_cam.T).T
-            points = points_proj[:, :2] / points_proj[:, 2:3]  # (M, 2)
-            depths = points_cam[:, 2]  # (M,)
+            # projected points to image plane, shifted to the crop
+            points, depths = self.depth_points[index]
+            points = points - np.array([x, y])
             # filter out points outside the image
             selector = (
                 (points[:, 0] >= 0)
                 & (points[:, 0] < image.shape[1])
                 & (points[:, 1] >= 0)
                 & (points[:, 1] < image.shape[0])
-                & (depths > 0)
             )
-            points = points[selector]
-            depths = depths[selector]
-            data["points"] = torch.from_numpy(points).float()
-            data["depths"] = torch.from_numpy(depths).float()
+            data["points"] = torch.from_numpy(points[selector]).float()
+            data["depths"] = torch.from_numpy(depths[selector]).float()
 
         return data
 
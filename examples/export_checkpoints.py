@@ -0,0 +1,49 @@
+"""Export trained checkpoints to splat files.
+
+Every checkpoint is loaded once and written in all the requested formats, and
+the checkpoints are exported in parallel within a memory budget.
+
+Usage:
+```bash
+python examples/export_checkpoints.py results/*/ckpts/ckpt_29999_rank0.pt \
+    --formats ply ply_compressed splat --output_dir exports --num_workers 8
+```
+"""
+
+import argparse
+import sys
+
+from gsplat.exporter import export_checkpoints
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("ckpts", type=str, nargs="+", help="checkpoint paths")
+    parser.add_argument(
+        "--formats",
+        type=str,
+        nargs="+",
+        default=["ply"],
+        help="ply, splat, ply_compressed, chunked",
+    )
+    parser.add_argument(
+        "--output_dir",
+        type=str,
+        default=None,
+        help="output directory, next to the checkpoints by default",
+    )
+    parser.add_argument(
+        "--num_workers", type=int, default=4, help="checkpoints exported at once"
+    )
+    parser.add_argument(
+        "--memory_budget", type=float, default=8.0, help="memory budget in GiB"
+    )
+    args = parser.parse_args()
+
+    reports = export_checkpoints(
+        args.ckpts,
+        args.formats,
+        output_dir=args.output_dir,
+        num_workers=args.num_workers,
+        memory_budget=int(args.memory_budget * 1024**3),
+    )
+    sys.exit(any(report.error is not None for report in reports))
@@ -16,6 +16,7 @@ import tyro
 import viser
 import yaml
 from datasets.colmap import Dataset, Parser
+from datasets.prefetch import PrefetchLoader
 from datasets.traj import (
     generate_ellipse_path_z,
     generate_interpolated_path,
@@ -31,7 +32,13 @@ from typing_extensions import Literal, assert_never
 from utils import AppearanceOptModule, CameraOptModule, knn, rgb_to_sh, set_random_seed
 
 from gsplat import export_splats
-from gsplat.compression import PngCompression
+from gsplat.checkpoint import (
+    PROVENANCE_KEY,
+    DeltaCheckpointWriter,
+    load_checkpoint,
+    track_provenance,
+)
+from gsplat.compression import PngCompression, RansCompression
 from gsplat.distributed import cli
 from gsplat.optimizers import SelectiveAdam
 from gsplat.rendering import rasterization
@@ -47,7 +54,7 @@ class Config:
     # Path to the .pt files. If provide, it will skip training and run evaluation only.
     ckpt: Optional[List[str]] = None
     # Name of compression strategy to use
-    compression: Optional[Literal["png"]] = None
+    compression: Optional[Literal["png", "rans"]] = None
     # Render trajectory path
     render_traj_path: str = "interp"
 
@@ -61,6 +68,11 @@ class Config:
     test_every: int = 8
     # Random crop size for training  (experimental)
     patch_size: Optional[int] = None
+    # Cache the decoded and undistorted training images, in "ram" or memory-mapped
+    # on "disk" (under the data directory)
+    data_cache: Optional[Literal["ram", "disk"]] = None
+    # Load the training batches with background threads instead of worker processes
+    prefetch_loader: bool = False
     # A global scaler that applies to the scene size related parameters
     global_scale: float = 1.0
     # Normalize the world space
@@ -82,6 +94,10 @@ class Config:
     eval_steps: List[int] = field(default_factory=lambda: [7_000, 30_000])
     # Steps to save the model
     save_steps: List[int] = field(default_factory=lambda: [7_000, 30_000])
+    # Save the checkpoints as quantized deltas from the previous checkpoint
+    delta_ckpt: bool = False
+    # Number of checkpoints between two full checkpoints when saving deltas
+    delta_ckpt_keyframe_every: int = 10
     # Whether to save ply file (storage size can be large)
     save_ply: bool = False
     # Steps to save the model as ply
@@ -342,6 +358,7 @@ class Runner:
             split="train",
             patch_size=cfg.patch_size,
             load_depths=cfg.depth_loss,
+            cache=cfg.data_cache,
         )
         self.valset = Dataset(self.parser, split="val")
         self.scene_scale = self.parser.scene_scale * 1.1 * cfg.global_scale
@@ -374,6 +391,15 @@ class Runner:
         )
         print("Model initialized. Number of GS:", len(self.splats["means"]))
 
+        self.ckpt_writer = None
+        if cfg.delta_ckpt:
+            track_provenance(self.splats)
+            self.ckpt_writer = DeltaCheckpointWriter(
+                self.ckpt_dir,
+                rank=world_rank,
+                keyframe_every=cfg.delta_ckpt_keyframe_every,
+            )
+
         # Densification Strategy
         self.cfg.strategy.check_sanity(self.splats, self.optimizers)
 
@@ -391,6 +417,8 @@ class Runner:
         if cfg.compression is not None:
             if cfg.compression == "png":
                 self.compression_method = PngCompression()
+            elif cfg.compression == "rans":
+                self.compression_method = RansCompression()
             else:
                 raise ValueError(f"Unknown compression strategy: {cfg.compression}")
 
@@ -586,14 +614,19 @@ class Runner:
                 )
             )
 
-        trainloader = torch.utils.data.DataLoader(
-            self.trainset,
-            batch_size=cfg.batch_size,
-            shuffle=True,
-            num_workers=4,
-            persistent_workers=True,
-            pin_memory=True,
-        )
+        if cfg.prefetch_loader:
+            trainloader = PrefetchLoader(
+                self.trainset, batch_size=cfg.batch_size, shuffle=True, num_workers=4
+            )
+        else:
+            trainloader = torch.utils.data.DataLoader(
+                self.trainset,
+                batch_size=cfg.batch_size,
+                shuffle=True,
+                num_workers=4,
+                persistent_workers=True,
+                pin_memory=True,
+            )
         trainloader_iter = iter(trainloader)
 
         # Training loop.
@@ -765,7 +798,7 @@ class Runner:
                     "w",
                 ) as f:
                     json.dump(stats, f)
-                data = {"step": step, "splats": self.splats.state_dict()}
+                data = {}
                 if cfg.pose_opt:
                     if world_size > 1:
                         data["pose_adjust"] = self.pose_adjust.module.state_dict()
@@ -776,9 +809,14 @@ class Runner:
                         data["app_module"] = self.app_module.module.state_dict()
                     else:
                         data["app_module"] = self.app_module.state_dict()
-                torch.save(
-                    data, f"{self.ckpt_dir}/ckpt_{step}_rank{self.world_rank}.pt"
-                )
+                if self.ckpt_writer is not None:
+                    self.ckpt_writer.save(step, self.splats, **data)
+                else:
+                    data["step"] = step
+                    data["splats"] = self.splats.state_dict()
+                    torch.save(
+                        data, f"{self.ckpt_dir}/ckpt_{step}_rank{self.world_rank}.pt"
+                    )
             if (
                 step in [i - 1 for i in cfg.ply_steps] or step == max_steps - 1
             ) and cfg.save_ply:
@@ -812,6 +850,7 @@ class Runner:
                     shN=shN,
                     format="ply",
                     save_to=f"{self.ply_dir}/point_cloud_{step}.ply",
+                    streaming=True,
                 )
 
             # Turn Gradients into Sparse Tensor before running optimizer
@@ -1076,10 +1115,23 @@ class Runner:
         compress_dir = f"{cfg.result_dir}/compression/rank{world_rank}"
         os.makedirs(compress_dir, exist_ok=True)
 
-        self.compression_method.compress(compress_dir, self.splats)
+        tic = time.time()
+        splats = {k: v for k, v in self.splats.items() if k != PROVENANCE_KEY}
+        self.compression_method.compress(compress_dir, splats)
+        compress_time = time.time() - tic
 
         # evaluate compression
+        tic = time.time()
         splats_c = self.compression_method.decompress(compress_dir)
+        decompress_time = time.time() - tic
+        if world_rank == 0:
+            stats = {
+                "compress_time": compress_time,
+                "decompress_time": decompress_time,
+            }
+            print("Compression:", stats)
+            with open(f"{self.stats_dir}/compress_time_step{step:04d}.json", "w") as f:
+                json.dump(stats, f)
         for k in splats_c.keys():
             self.splats[k].data = splats_c[k].to(self.device)
         self.eval(step=step, stage="compress")
@@ -1168,11 +1220,8 @@ def main(local_rank: int, world_rank, world_size: int, cfg: Config):
 
     if cfg.ckpt is not None:
         # run eval only
-        ckpts = [
-            torch.load(file, map_location=runner.device, weights_only=True)
-            for file in cfg.ckpt
-        ]
-        for k in runner.splats.keys():
+        ckpts = [load_checkpoint(file, map_location=runner.device) for file in cfg.ckpt]
+        for k in ckpts[0]["splats"].keys():
             runner.splats[k].data = torch.cat([ckpt["splats"][k] for ckpt in ckpts])
         step = ckpts[0]["step"]
         runner.eval(step=step)
@@ -1243,18 +1292,6 @@ if __name__ == "__main__":
                 total_variation_loss,
             )
 
-    # try import extra dependencies
-    if cfg.compression == "png":
-        try:
-            import plas
-            import torchpq
-        except:
-            raise ImportError(
-                "To use PNG compression, you need to install "
-                "torchpq (instruction at https://github.com/DeMoriarty/TorchPQ?tab=readme-ov-file#install) "
-                "and plas (via 'pip install git+https://github.com/fraunhoferhhi/PLAS.git') "
-            )
-
     if cfg.with_ut:
         assert cfg.with_eval3d, "Training with UT requires setting `with_eval3d` flag."
 
@@ -2,12 +2,13 @@ import random
 
 import numpy as np
 import torch
-from sklearn.neighbors import NearestNeighbors
 from torch import Tensor
 import torch.nn.functional as F
 import matplotlib.pyplot as plt
 from matplotlib import colormaps
 
+import gsplat
+
 
 class CameraOptModule(torch.nn.Module):
     """Camera pose optimization module."""
@@ -139,10 +140,7 @@ def rotation_6d_to_matrix(d6: Tensor) -> Tensor:
 
 
 def knn(x: Tensor, K: int = 4) -> Tensor:
-    x_np = x.cpu().numpy()
-    model = NearestNeighbors(n_neighbors=K, metric="euclidean").fit(x_np)
-    distances, _ = model.kneighbors(x_np)
-    return torch.from_numpy(distances).to(x)
+    return gsplat.knn(x, K)
 
 
 def rgb_to_sh(rgb: Tensor) -> Tensor:
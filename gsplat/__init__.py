@@ -1,12 +1,19 @@
 import warnings
 
-from .compression import PngCompression
+from .checkpoint import (
+    DeltaCheckpointWriter,
+    compact_checkpoint,
+    load_checkpoint,
+    track_provenance,
+)
+from .compression import PngCompression, RansCompression
 from .cuda._torch_impl import accumulate
 from .cuda._torch_impl_2dgs import accumulate_2dgs
 from .cuda._wrapper import (
     RollingShutterType,
     fully_fused_projection,
     fully_fused_projection_2dgs,
+    fully_fused_projection_storage,
     fully_fused_projection_with_ut,
     isect_offset_encode,
     isect_tiles,
@@ -18,9 +25,14 @@ from .cuda._wrapper import (
     rasterize_to_pixels_2dgs,
     rasterize_to_pixels_eval3d,
     spherical_harmonics,
+    spherical_harmonics_storage,
     world_to_cam,
 )
-from .exporter import export_splats
+from .culling import FrustumIndex, build_frustum_index
+from .exporter import export_checkpoints, export_splats, export_splats_multi
+from .importer import ChunkedSplats, import_splats
+from .lod import LODTree, build_lod_tree
+from .neighbors import KdTree, build_kdtree, knn
 from .optimizers import SelectiveAdam
 from .rendering import (
     rasterization,
@@ -28,14 +40,17 @@ from .rendering import (
     rasterization_2dgs_inria_wrapper,
     rasterization_inria_wrapper,
 )
-from .strategy import DefaultStrategy, MCMCStrategy, Strategy
+from .storage import Dequantization, quantize_gaussians
+from .strategy import DefaultStrategy, GaussianPool, MCMCStrategy, Strategy
 from .version import __version__
 
 all = [
     "PngCompression",
+    "RansCompression",
     "DefaultStrategy",
     "MCMCStrategy",
     "Strategy",
+    "GaussianPool",
     "rasterization",
     "rasterization_2dgs",
     "rasterization_inria_wrapper",
@@ -58,5 +73,24 @@ all = [
     "fully_fused_projection_with_ut",
     "rasterize_to_pixels_eval3d",
     "export_splats",
+    "export_splats_multi",
+    "export_checkpoints",
+    "import_splats",
+    "ChunkedSplats",
+    "LODTree",
+    "build_lod_tree",
+    "FrustumIndex",
+    "build_frustum_index",
+    "KdTree",
+    "build_kdtree",
+    "knn",
+    "quantize_gaussians",
+    "Dequantization",
+    "fully_fused_projection_storage",
+    "spherical_harmonics_storage",
+    "DeltaCheckpointWriter",
+    "track_provenance",
+    "load_checkpoint",
+    "compact_checkpoint",
     "__version__",
 ]
@@ -0,0 +1,257 @@
+import os
+from typing import Any, Dict, List, Optional, Union
+
+import torch
+from torch import Tensor
+
+# The name of the non-trainable parameter that tracks, for every Gaussian, the row
+# it derives from in the last checkpoint.
+PROVENANCE_KEY = "ckpt_ids"
+
+# The number of consecutive rows sharing the scales of a quantized difference, so
+# that an outlier row only coarsens the quantization of its own block.
+DIFF_BLOCK_SIZE = 256
+
+
+@torch.no_grad()
+def track_provenance(
+    params: Union[Dict[str, torch.nn.Parameter], torch.nn.ParameterDict],
+) -> None:
+    """Add the parameter that lets :class:`DeltaCheckpointWriter` match the Gaussians
+    of consecutive checkpoints.
+
+    `params[PROVENANCE_KEY]` is a non-trainable int64 parameter holding the row index
+    of every Gaussian. As it is a parameter without optimizer, the strategy ops in
+    :mod:`gsplat.strategy.ops` carry it along: duplicated, split, sampled and
+    relocated Gaussians inherit the index of the Gaussian they were copied from, and
+    removed Gaussians drop theirs. The writer resets it after every checkpoint.
+    """
+    N = len(params["means"])
+    params[PROVENANCE_KEY] = torch.nn.Parameter(
+        torch.arange(N, device=params["means"].device), requires_grad=False
+    )
+
+
+def _checkpoint_name(step: int, rank: int) -> str:
+    return f"ckpt_{step}_rank{rank}"
+
+
+def _blocks(flat: Tensor, block_size: int) -> Tensor:
+    """View [N, D] rows as [n_blocks, block_size, D], padding the last block with
+    zeros."""
+    N, D = flat.shape
+    n_blocks = (N + block_size - 1) // block_size
+    padding = flat.new_zeros(n_blocks * block_size - N, D)
+    return torch.cat([flat, padding]).view(n_blocks, block_size, D)
+
+
+def _quantize_diff(x: Tensor, bits: int) -> Dict[str, Any]:
+    """Quantize [N, ...] differences symmetrically with a scale per channel for
+    each block of `DIFF_BLOCK_SIZE` rows."""
+    qmax = 2 ** (bits - 1) - 1
+    blocks = _blocks(x.reshape(len(x), -1), DIFF_BLOCK_SIZE)
+    scale = (blocks.abs().amax(dim=1) / qmax).clamp_min(1e-12)  # [n_blocks, D]
+    q = (blocks / scale[:, None]).round().clamp(-qmax, qmax)
+    q = q.to(torch.int8 if bits == 8 else torch.int16).view(-1, scale.shape[1])
+    return {
+        # a copy, not to save the padding along with the view
+        "q": q[: len(x)].clone().view(x.shape),
+        "scale": scale,
+        "block_size": DIFF_BLOCK_SIZE,
+    }
+
+
+def _apply_delta(base: Dict[str, Tensor], delta: Dict[str, Any]) -> Dict[str, Tensor]:
+    """Rebuild the splats of a delta from the splats of its base."""
+    src = delta["src"].long()
+    splats = {}
+    for k, diff in delta["diffs"].items():
+        if "raw" in diff:
+            splats[k] = diff["raw"]
+            continue
+        ref = base[k][src]
+        q = _blocks(diff["q"].reshape(len(src), -1).float(), diff["block_size"])
+        d = (q * diff["scale"][:, None]).view(-1, q.shape[-1])[: len(src)]
+        value = ref.float() + d.view(ref.shape)
+        splats[k] = value.to(ref.dtype)
+    return splats
+
+
+class DeltaCheckpointWriter:
+    """Writes checkpoints of the splats as deltas from the previous checkpoint.
+
+    A full checkpoint (a keyframe) is written every `keyframe_every` checkpoints, with
+    the same layout as the checkpoints of `simple_trainer.py`. In between, a delta
+    file `ckpt_{step}_rank{rank}.delta.pt` records:
+
+    - **src**. For every Gaussian, the row of the previous checkpoint it derives
+      from, as tracked by :func:`track_provenance`. It encodes the Gaussians that were
+      appended (duplicated, split or sampled), relocated onto dead rows, and removed
+      (rows missing from `src`).
+    - **diffs**. For every parameter, the difference with the source rows, quantized
+      to `bits` with a scale per channel for each block of `DIFF_BLOCK_SIZE` rows.
+
+    The differences are taken against the dequantized previous checkpoint, so the
+    quantization errors do not accumulate along the chain. When the parameters do not
+    carry `PROVENANCE_KEY`, every checkpoint is a keyframe.
+
+    Args:
+        ckpt_dir: Directory to write the checkpoints to.
+        rank: Rank of the process, part of the file names. Default: 0.
+        keyframe_every: Number of checkpoints between two keyframes. Default: 10.
+        bits: Quantization bits of the differences, 8 or 16. Default: 16.
+
+    Example:
+        >>> track_provenance(splats)
+        >>> writer = DeltaCheckpointWriter("ckpts")
+        >>> writer.save(step, splats)  # at every save step
+        >>> splats = load_checkpoint("ckpts/ckpt_29999_rank0.delta.pt")["splats"]
+    """
+
+    def __init__(
+        self,
+        ckpt_dir: str,
+        rank: int = 0,
+        keyframe_every: int = 10,
+        bits: int = 16,
+    ):
+        assert bits in (8, 16), f"Unsupported number of bits {bits}"
+        assert keyframe_every > 0, keyframe_every
+        self.ckpt_dir = ckpt_dir
+        self.rank = rank
+        self.keyframe_every = keyframe_every
+        self.bits = bits
+        self._count = 0
+        self._last_step: Optional[int] = None
+        self._last_splats: Optional[Dict[str, Tensor]] = None
+
+    @torch.no_grad()
+    def save(
+        self,
+        step: int,
+        splats: Union[Dict[str, Tensor], torch.nn.ParameterDict],
+        **extra: Any,
+    ) -> str:
+        """Write the checkpoint of `step` and reset the provenance of `splats`.
+
+        Args:
+            step: The training step.
+            splats: The parameters, with `PROVENANCE_KEY` to write deltas.
+            extra: Other entries saved as is, e.g. the state dicts of modules.
+
+        Returns:
+            The path of the written file.
+        """
+        ids = splats.get(PROVENANCE_KEY, None)
+        current = {
+            k: v.detach().cpu() for k, v in splats.items() if k != PROVENANCE_KEY
+        }
+        keyframe = (
+            ids is None
+            or self._last_splats is None
+            or self._count % self.keyframe_every == 0
+            or current.keys() != self._last_splats.keys()
+        )
+
+        name = _checkpoint_name(step, self.rank)
+        if keyframe:
+            path = os.path.join(self.ckpt_dir, f"{name}.pt")
+            torch.save({"step": step, "splats": current, **extra}, path)
+            self._last_splats = current
+        else:
+            src = ids.detach().cpu()
+            diffs = {}
+            for k, v in current.items():
+                if not v.is_floating_point() or v.numel() == 0:
+                    diffs[k] = {"raw": v}
+                    continue
+                ref = self._last_splats[k][src]
+                diffs[k] = _quantize_diff(v.float() - ref.float(), self.bits)
+            delta = {
+                "step": step,
+                "base": _checkpoint_name(self._last_step, self.rank),
+                "src": src.int(),
+                "diffs": diffs,
+            }
+            path = os.path.join(self.ckpt_dir, f"{name}.delta.pt")
+            torch.save({**delta, **extra}, path)
+            self._last_splats = _apply_delta(self._last_splats, delta)
+
+        if ids is not None:
+            ids.copy_(torch.arange(len(ids), device=ids.device))
+        self._last_step = step
+        self._count += 1
+        return path
+
+
+def _resolve(ckpt_dir: str, name: str) -> str:
+    """Find the checkpoint `name`, compacted or not."""
+    for ext in [".pt", ".delta.pt"]:
+        path = os.path.join(ckpt_dir, name + ext)
+        if os.path.exists(path):
+            return path
+    raise FileNotFoundError(f"Checkpoint {name} not found in {ckpt_dir}")
+
+
+def load_checkpoint(path: str, map_location: Any = None) -> Dict[str, Any]:
+    """Load a checkpoint written by :class:`DeltaCheckpointWriter` or
+    `simple_trainer.py`.
+
+    The deltas are applied in order from the closest keyframe, looked up in the
+    directory of `path`.
+
+    Args:
+        path: Path to a full or a delta checkpoint.
+        map_location: Passed to `torch.load`.
+
+    Returns:
+        The checkpoint, with the rebuilt parameters in `"splats"`.
+    """
+    ckpt_dir = os.path.dirname(path)
+    chain: List[Dict[str, Any]] = []
+    ckpt = torch.load(path, map_location=map_location, weights_only=True)
+    while "splats" not in ckpt:
+        chain.append(ckpt)
+        base_path = _resolve(ckpt_dir, ckpt["base"])
+        ckpt = torch.load(base_path, map_location=map_location, weights_only=True)
+
+    splats = ckpt["splats"]
+    for delta in reversed(chain):
+        splats = _apply_delta(splats, delta)
+    if not chain:
+        return ckpt
+    ckpt = {k: v for k, v in chain[0].items() if k not in ["base", "src", "diffs"]}
+    ckpt["splats"] = splats
+    return ckpt
+
+
+def compact_checkpoint(path: str, prune: bool = False) -> str:
+    """Fold a delta checkpoint and its chain of bases into a full checkpoint.
+
+    The full checkpoint replaces the delta file, and the deltas written after it keep
+    loading since their bases are looked up by name.
+
+    Args:
+        path: Path to a delta checkpoint `*.delta.pt`.
+        prune: Whether to also remove the older deltas of the chain, which are not
+            needed by the newer checkpoints anymore. Default: False.
+
+    Returns:
+        The path of the full checkpoint.
+    """
+    assert path.endswith(".delta.pt"), f"{path} is not a delta checkpoint"
+    ckpt_dir = os.path.dirname(path)
+    ckpt = load_checkpoint(path)
+    out_path = path[: -len(".delta.pt")] + ".pt"
+    torch.save(ckpt, out_path)
+
+    if prune:
+        delta = torch.load(path, weights_only=True)
+        while True:
+            base_path = _resolve(ckpt_dir, delta["base"])
+            if not base_path.endswith(".delta.pt"):
+                break
+            delta = torch.load(base_path, weights_only=True)
+            os.remove(base_path)
+    os.remove(path)
+    return out_path
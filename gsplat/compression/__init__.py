@@ -1 +1,2 @@
 from .png_compression import PngCompression
+from .rans_compression import RansCompression
@@ -1,5 +1,7 @@
 import json
+import math
 import os
+import time
 from dataclasses import dataclass
 from typing import Any, Callable, Dict
 
@@ -9,6 +11,7 @@ import torch.nn.functional as F
 from torch import Tensor
 
 from gsplat.compression.sort import sort_splats
+from gsplat.cuda._wrapper import _make_lazy_cuda_func
 from gsplat.utils import inverse_log_transform, log_transform
 
 
@@ -18,13 +21,13 @@ class PngCompression:
     K-means clustering to compress the spherical harmonic coefficents.
 
     .. warning::
-        This class requires the `imageio <https://pypi.org/project/imageio/>`_,
-        `plas <https://github.com/fraunhoferhhi/PLAS.git>`_
-        and `torchpq <https://github.com/DeMoriarty/TorchPQ?tab=readme-ov-file#install>`_ packages to be installed.
+        This class requires the `imageio <https://pypi.org/project/imageio/>`_ package
+        to be installed.
 
-    .. warning::
-        This class might throw away a few lowest opacities splats if the number of
-        splats is not a square number.
+    .. note::
+        The splats are laid out row-major on images of `ceil(sqrt(N))` columns. If the
+        number of splats is not a square number, the last row is completed with
+        copies of the row above, which are dropped at decompression.
 
     .. note::
         The splats parameters are expected to be pre-activation values. It expects
@@ -85,22 +88,16 @@ class PngCompression:
         splats["quats"] = F.normalize(splats["quats"], dim=-1)
 
         n_gs = len(splats["means"])
-        n_sidelen = int(n_gs**0.5)
-        n_crop = n_gs - n_sidelen**2
-        if n_crop != 0:
-            splats = _crop_n_splats(splats, n_crop)
-            print(
-                f"Warning: Number of Gaussians was not square. Removed {n_crop} Gaussians."
-            )
+        width = math.ceil(math.sqrt(n_gs))
 
         if self.use_sort:
-            splats = sort_splats(splats)
+            splats = sort_splats(splats, verbose=self.verbose, width=width)
 
         meta = {}
         for param_name in splats.keys():
             compress_fn = self._get_compress_fn(param_name)
             kwargs = {
-                "n_sidelen": n_sidelen,
+                "width": width,
                 "verbose": self.verbose,
             }
             meta[param_name] = compress_fn(
@@ -132,16 +129,23 @@ class PngCompression:
         return splats
 
 
-def _crop_n_splats(splats: Dict[str, Tensor], n_crop: int) -> Dict[str, Tensor]:
-    opacities = splats["opacities"]
-    keep_indices = torch.argsort(opacities, descending=True)[:-n_crop]
-    for k, v in splats.items():
-        splats[k] = v[keep_indices]
-    return splats
+def _to_grid(params: Tensor, width: int) -> Tensor:
+    """Lay out the parameters row-major on a grid of `width` columns. The missing
+    cells of the last row are copies of the cells above them."""
+    n = params.shape[0]
+    height = math.ceil(n / width)
+    params = params.reshape(n, -1)
+    n_pad = height * width - n
+    if n_pad > 0:
+        pad_ids = (torch.arange(n, n + n_pad, device=params.device) - width).clamp(
+            min=0
+        )
+        params = torch.cat([params, params[pad_ids]], dim=0)
+    return params.reshape(height, width, -1)
 
 
 def _compress_png(
-    compress_dir: str, param_name: str, params: Tensor, n_sidelen: int, **kwargs
+    compress_dir: str, param_name: str, params: Tensor, width: int, **kwargs
 ) -> Dict[str, Any]:
     """Compress parameters with 8-bit quantization and lossless PNG compression.
 
@@ -149,7 +153,7 @@ def _compress_png(
         compress_dir (str): compression directory
         param_name (str): parameter field name
         params (Tensor): parameters
-        n_sidelen (int): image side length
+        width (int): image width
 
     Returns:
         Dict[str, Any]: metadata
@@ -163,7 +167,7 @@ def _compress_png(
         }
         return meta
 
-    grid = params.reshape((n_sidelen, n_sidelen, -1))
+    grid = _to_grid(params, width)
     mins = torch.amin(grid, dim=(0, 1))
     maxs = torch.amax(grid, dim=(0, 1))
     grid_norm = (grid - mins) / (maxs - mins)
@@ -207,13 +211,14 @@ def _decompress_png(compress_dir: str, param_name: str, meta: Dict[str, Any]) ->
     maxs = torch.tensor(meta["maxs"])
     grid = grid_norm * (maxs - mins) + mins
 
-    params = grid.reshape(meta["shape"])
+    shape = meta["shape"]
+    params = grid.reshape(-1, *shape[1:])[: shape[0]]
     params = params.to(dtype=getattr(torch, meta["dtype"]))
     return params
 
 
 def _compress_png_16bit(
-    compress_dir: str, param_name: str, params: Tensor, n_sidelen: int, **kwargs
+    compress_dir: str, param_name: str, params: Tensor, width: int, **kwargs
 ) -> Dict[str, Any]:
     """Compress parameters with 16-bit quantization and PNG compression.
 
@@ -221,7 +226,7 @@ def _compress_png_16bit(
         compress_dir (str): compression directory
         param_name (str): parameter field name
         params (Tensor): parameters
-        n_sidelen (int): image side length
+        width (int): image width
 
     Returns:
         Dict[str, Any]: metadata
@@ -235,7 +240,7 @@ def _compress_png_16bit(
         }
         return meta
 
-    grid = params.reshape((n_sidelen, n_sidelen, -1))
+    grid = _to_grid(params, width)
     mins = torch.amin(grid, dim=(0, 1))
     maxs = torch.amax(grid, dim=(0, 1))
     grid_norm = (grid - mins) / (maxs - mins)
@@ -290,7 +295,8 @@ def _decompress_png_16bit(
     maxs = torch.tensor(meta["maxs"])
     grid = grid_norm * (maxs - mins) + mins
 
-    params = grid.reshape(meta["shape"])
+    shape = meta["shape"]
+    params = grid.reshape(-1, *shape[1:])[: shape[0]]
     params = params.to(dtype=getattr(torch, meta["dtype"]))
     return params
 
@@ -326,12 +332,15 @@ def _compress_kmeans(
     n_clusters: int = 65536,
     quantization: int = 6,
     verbose: bool = True,
+    n_iters: int = 50,
+    batch_size: int = 131072,
+    n_probe: int = 8,
     **kwargs,
 ) -> Dict[str, Any]:
     """Run K-means clustering on parameters and save centroids and labels to a npz file.
 
-    .. warning::
-        TorchPQ must installed to use K-means clustering.
+    The clustering uses the Manhattan distance and runs on the CPU with the native
+    `kmeans_l1` operator (mini-batch iterations, then a full assignment).
 
     Args:
         compress_dir (str): compression directory
@@ -340,29 +349,38 @@ def _compress_kmeans(
         n_clusters (int): number of K-means clusters
         quantization (int): number of bits in quantization
         verbose (bool, optional): Whether to print verbose information. Default to True.
+        n_iters (int, optional): number of mini-batch iterations. Default to 50.
+        batch_size (int, optional): number of points per mini-batch. Default to 131072.
+        n_probe (int, optional): number of centroid groups searched for the nearest
+            centroid of every point. Default to 8.
 
     Returns:
         Dict[str, Any]: metadata
     """
-    try:
-        from torchpq.clustering import KMeans
-    except:
-        raise ImportError(
-            "Please install extra dependencies with 'pip install torchpq cupy' to use K-means clustering"
-        )
-
-    if torch.numel == 0:
+    if params.numel() == 0:
         meta = {
             "shape": list(params.shape),
             "dtype": str(params.dtype).split(".")[1],
         }
         return meta
 
-    kmeans = KMeans(n_clusters=n_clusters, distance="manhattan", verbose=verbose)
-    x = params.reshape(params.shape[0], -1).permute(1, 0).contiguous()
-    labels = kmeans.fit(x)
-    labels = labels.detach().cpu().numpy()
-    centroids = kmeans.centroids.permute(1, 0)
+    x = params.reshape(params.shape[0], -1).detach().float().cpu().contiguous()
+    start = time.time()
+    centroids, labels = _make_lazy_cuda_func("kmeans_l1")(
+        x,
+        n_clusters,
+        n_iters,
+        batch_size,
+        n_probe,
+        0,
+    )
+    if verbose:
+        error = (x - centroids[labels]).abs().mean().item()
+        print(
+            f"K-means on {param_name}: {x.shape[0]} points, {centroids.shape[0]} "
+            f"clusters, mean L1 error {error:.4f}, {time.time() - start:.1f}s"
+        )
+    labels = labels.numpy()
 
     mins = torch.min(centroids)
     maxs = torch.max(centroids)
@@ -0,0 +1,253 @@
+import json
+import math
+import os
+import time
+from dataclasses import dataclass
+from typing import Any, Callable, Dict
+
+import numpy as np
+import torch
+import torch.nn.functional as F
+from torch import Tensor
+
+from gsplat.compression.png_compression import (
+    _compress_kmeans,
+    _compress_npz,
+    _decompress_kmeans,
+    _decompress_npz,
+)
+from gsplat.compression.sort import sort_splats
+from gsplat.cuda._wrapper import _make_lazy_cuda_func
+from gsplat.utils import inverse_log_transform, log_transform
+
+
+@dataclass
+class RansCompression:
+    """Uses quantization, sorting and entropy coding to compress splats and uses
+    K-means clustering to compress the spherical harmonic coefficents.
+
+    Like :class:`PngCompression`, the sorted splats are laid out row-major on a grid
+    of `ceil(sqrt(N))` columns. Instead of PNG images, every quantized value is
+    predicted from its left and upper neighbors on the grid and the residuals are
+    entropy coded with rANS. The grid is cut into tiles of `tile_rows` rows that are
+    coded independently, so that encoding and decoding run in parallel on the CPU.
+
+    .. note::
+        The splats parameters are expected to be pre-activation values. It expects
+        the following fields in the splats dictionary: "means", "scales", "quats",
+        "opacities", "sh0", "shN". More fields can be added to the dictionary, but
+        they will only be compressed using NPZ compression.
+
+    References:
+        - `Compact 3D Scene Representation via Self-Organizing Gaussian Grids <https://arxiv.org/abs/2312.13299>`_
+        - `Asymmetric numeral systems <https://arxiv.org/abs/1311.2540>`_
+
+    Args:
+        use_sort (bool, optional): Whether to sort splats before compression. Defaults to True.
+        verbose (bool, optional): Whether to print verbose information. Default to True.
+        means_bits (int, optional): Quantization bits of the means. Default to 16.
+        bits (int, optional): Quantization bits of the other grid parameters. Default to 8.
+        tile_rows (int, optional): Number of grid rows per independently coded tile.
+            Default to 16.
+    """
+
+    use_sort: bool = True
+    verbose: bool = True
+    means_bits: int = 16
+    bits: int = 8
+    tile_rows: int = 16
+
+    def _get_compress_fn(self, param_name: str) -> Callable:
+        compress_fn_map = {
+            "means": _compress_rans,
+            "scales": _compress_rans,
+            "quats": _compress_rans,
+            "opacities": _compress_rans,
+            "sh0": _compress_rans,
+            "shN": _compress_kmeans,
+        }
+        if param_name in compress_fn_map:
+            return compress_fn_map[param_name]
+        else:
+            return _compress_npz
+
+    def _get_decompress_fn(self, param_name: str) -> Callable:
+        decompress_fn_map = {
+            "means": _decompress_rans,
+            "scales": _decompress_rans,
+            "quats": _decompress_rans,
+            "opacities": _decompress_rans,
+            "sh0": _decompress_rans,
+            "shN": _decompress_kmeans,
+        }
+        if param_name in decompress_fn_map:
+            return decompress_fn_map[param_name]
+        else:
+            return _decompress_npz
+
+    def compress(self, compress_dir: str, splats: Dict[str, Tensor]) -> None:
+        """Run compression
+
+        Args:
+            compress_dir (str): directory to save compressed files
+            splats (Dict[str, Tensor]): Gaussian splats to compress
+        """
+
+        # Param-specific preprocessing
+        splats["means"] = log_transform(splats["means"])
+        splats["quats"] = F.normalize(splats["quats"], dim=-1)
+
+        n_gs = len(splats["means"])
+        width = math.ceil(math.sqrt(n_gs))
+
+        if self.use_sort:
+            splats = sort_splats(splats, verbose=self.verbose, width=width)
+
+        meta = {}
+        for param_name in splats.keys():
+            compress_fn = self._get_compress_fn(param_name)
+            kwargs = {
+                "width": width,
+                "bits": self.means_bits if param_name == "means" else self.bits,
+                "tile_rows": self.tile_rows,
+                "verbose": self.verbose,
+            }
+            meta[param_name] = compress_fn(
+                compress_dir, param_name, splats[param_name], **kwargs
+            )
+
+        with open(os.path.join(compress_dir, "meta.json"), "w") as f:
+            json.dump(meta, f)
+
+    def decompress(self, compress_dir: str) -> Dict[str, Tensor]:
+        """Run decompression
+
+        Args:
+            compress_dir (str): directory that contains compressed files
+
+        Returns:
+            Dict[str, Tensor]: decompressed Gaussian splats
+        """
+        with open(os.path.join(compress_dir, "meta.json"), "r") as f:
+            meta = json.load(f)
+
+        splats = {}
+        for param_name, param_meta in meta.items():
+            decompress_fn = self._get_decompress_fn(param_name)
+            splats[param_name] = decompress_fn(compress_dir, param_name, param_meta)
+
+        # Param-specific postprocessing
+        splats["means"] = inverse_log_transform(splats["means"])
+        return splats
+
+
+def _compress_rans(
+    compress_dir: str,
+    param_name: str,
+    params: Tensor,
+    width: int,
+    bits: int = 8,
+    tile_rows: int = 16,
+    verbose: bool = True,
+    **kwargs,
+) -> Dict[str, Any]:
+    """Compress parameters with per-channel quantization, prediction from the grid
+    neighbors and rANS entropy coding.
+
+    The file `{param_name}.rans` holds the 16-bit frequency tables, the int64 byte
+    size of every tile and the concatenated tile streams.
+
+    Args:
+        compress_dir (str): compression directory
+        param_name (str): parameter field name
+        params (Tensor): parameters
+        width (int): grid width
+        bits (int, optional): number of bits in quantization. Default to 8.
+        tile_rows (int, optional): number of grid rows per tile. Default to 16.
+        verbose (bool, optional): Whether to print verbose information. Default to True.
+
+    Returns:
+        Dict[str, Any]: metadata
+    """
+    if params.numel() == 0:
+        meta = {
+            "shape": list(params.shape),
+            "dtype": str(params.dtype).split(".")[1],
+        }
+        return meta
+
+    x = params.reshape(params.shape[0], -1).detach().float().cpu()
+    mins = torch.amin(x, dim=0)
+    maxs = torch.amax(x, dim=0)
+    x_norm = (x - mins) / (maxs - mins).clamp_min(1e-12)
+    q = (x_norm * (2**bits - 1)).round().int().contiguous()
+
+    start = time.time()
+    freqs, tile_sizes, data = _make_lazy_cuda_func("rans_encode")(
+        q, torch.full((q.shape[1],), bits, dtype=torch.int32), width, tile_rows
+    )
+    with open(os.path.join(compress_dir, f"{param_name}.rans"), "wb") as f:
+        f.write(freqs.to(torch.int16).numpy().tobytes())
+        f.write(tile_sizes.numpy().tobytes())
+        f.write(data.numpy().tobytes())
+    if verbose:
+        print(
+            f"rANS on {param_name}: {q.numel() * bits / 8 / 1024**2:.2f}MB -> "
+            f"{data.numel() / 1024**2:.2f}MB, {time.time() - start:.2f}s"
+        )
+
+    meta = {
+        "shape": list(params.shape),
+        "dtype": str(params.dtype).split(".")[1],
+        "mins": mins.tolist(),
+        "maxs": maxs.tolist(),
+        "bits": bits,
+        "width": width,
+        "tile_rows": tile_rows,
+        "n_tables": freqs.shape[0],
+        "n_tiles": tile_sizes.shape[0],
+    }
+    return meta
+
+
+def _decompress_rans(
+    compress_dir: str, param_name: str, meta: Dict[str, Any]
+) -> Tensor:
+    """Decompress parameters from a rANS file.
+
+    Args:
+        compress_dir (str): compression directory
+        param_name (str): parameter field name
+        meta (Dict[str, Any]): metadata
+
+    Returns:
+        Tensor: parameters
+    """
+    if not np.all(meta["shape"]):
+        params = torch.zeros(meta["shape"], dtype=getattr(torch, meta["dtype"]))
+        return params
+
+    buf = np.fromfile(os.path.join(compress_dir, f"{param_name}.rans"), np.uint8)
+    n_freqs = meta["n_tables"] * 256 * 2
+    n_sizes = meta["n_tiles"] * 8
+    freqs = torch.from_numpy(buf[:n_freqs].view(np.int16).astype(np.int32))
+    tile_sizes = torch.from_numpy(buf[n_freqs : n_freqs + n_sizes].view(np.int64))
+    data = torch.from_numpy(buf[n_freqs + n_sizes :])
+
+    mins = torch.tensor(meta["mins"])
+    maxs = torch.tensor(meta["maxs"])
+    bits = meta["bits"]
+    q = _make_lazy_cuda_func("rans_decode")(
+        freqs.reshape(-1, 256),
+        tile_sizes,
+        data,
+        torch.full((len(mins),), bits, dtype=torch.int32),
+        meta["shape"][0],
+        meta["width"],
+        meta["tile_rows"],
+    )
+    x = q / (2**bits - 1) * (maxs - mins) + mins
+
+    params = x.reshape(meta["shape"])
+    params = params.to(dtype=getattr(torch, meta["dtype"]))
+    return params
@@ -1,46 +1,75 @@
-from typing import Dict
+import math
+import time
+from typing import Dict, Optional
 
 import torch
 from torch import Tensor
 
+from gsplat.cuda._wrapper import _make_lazy_cuda_func
 
-def sort_splats(splats: Dict[str, Tensor], verbose: bool = True) -> Dict[str, Tensor]:
+
+def sort_splats(
+    splats: Dict[str, Tensor],
+    verbose: bool = True,
+    width: Optional[int] = None,
+    native: bool = True,
+) -> Dict[str, Tensor]:
     """Sort splats with Parallel Linear Assignment Sorting from the paper `Compact 3D Scene Representation via
     Self-Organizing Gaussian Grids <https://arxiv.org/pdf/2312.13299>`_.
 
+    The splats are arranged row-major on a grid of `width` columns whose last row may
+    be partial, so any number of splats can be sorted.
+
     .. warning::
-        PLAS must installed to use sorting.
+        PLAS must installed to use sorting with `native=False`, which also requires a
+        square number of splats.
 
     Args:
         splats (Dict[str, Tensor]): splats
         verbose (bool, optional): Whether to print verbose information. Default to True.
+        width (int, optional): Number of columns of the grid. Default to
+            `ceil(sqrt(N))`.
+        native (bool, optional): Whether to use the native multithreaded CPU
+            implementation instead of the PLAS package. Default to True.
 
     Returns:
         Dict[str, Tensor]: sorted splats
     """
-    try:
-        from plas import sort_with_plas
-    except:
-        raise ImportError(
-            "Please install PLAS with 'pip install git+https://github.com/fraunhoferhhi/PLAS.git' to use sorting"
-        )
-
     n_gs = len(splats["means"])
-    n_sidelen = int(n_gs**0.5)
-    assert n_sidelen**2 == n_gs, "Must be a perfect square"
-
     sort_keys = [k for k in splats if k != "shN"]
     params_to_sort = torch.cat([splats[k].reshape(n_gs, -1) for k in sort_keys], dim=-1)
-    shuffled_indices = torch.randperm(
-        params_to_sort.shape[0], device=params_to_sort.device
-    )
-    params_to_sort = params_to_sort[shuffled_indices]
-    grid = params_to_sort.reshape((n_sidelen, n_sidelen, -1))
-    _, sorted_indices = sort_with_plas(
-        grid.permute(2, 0, 1), improvement_break=1e-4, verbose=verbose
-    )
-    sorted_indices = sorted_indices.squeeze().flatten()
-    sorted_indices = shuffled_indices[sorted_indices]
+
+    start = time.time()
+    if native:
+        if width is None:
+            width = math.ceil(math.sqrt(n_gs))
+        sorted_indices = _make_lazy_cuda_func("plas_sort")(
+            params_to_sort.detach().float().cpu().contiguous(), width, 0.9, 1e-3, 0
+        ).to(params_to_sort.device)
+    else:
+        try:
+            from plas import sort_with_plas
+        except:
+            raise ImportError(
+                "Please install PLAS with 'pip install git+https://github.com/fraunhoferhhi/PLAS.git' to use sorting"
+            )
+
+        n_sidelen = int(n_gs**0.5)
+        assert n_sidelen**2 == n_gs, "Must be a perfect square"
+
+        shuffled_indices = torch.randperm(
+            params_to_sort.shape[0], device=params_to_sort.device
+        )
+        params_to_sort = params_to_sort[shuffled_indices]
+        grid = params_to_sort.reshape((n_sidelen, n_sidelen, -1))
+        _, sorted_indices = sort_with_plas(
+            grid.permute(2, 0, 1), improvement_break=1e-4, verbose=verbose
+        )
+        sorted_indices = sorted_indices.squeeze().flatten()
+        sorted_indices = shuffled_indices[sorted_indices]
+    if verbose:
+        print(f"Sorted {n_gs} splats in {time.time() - start:.1f}s")
+
     for k, v in splats.items():
         splats[k] = v[sorted_indices]
     return splats
@@ -8,12 +8,14 @@ import glob
 import json
 import os
 import shutil
+import sys
 import time
 from subprocess import DEVNULL, call
 
 import torch
 from packaging import version
 from rich.console import Console
+from torch.__config__ import parallel_info
 from torch.utils.cpp_extension import _find_cuda_home  # <--- For robust CUDA detection
 from torch.utils.cpp_extension import (
     _TORCH_PATH,
@@ -174,7 +176,23 @@ except ImportError:
 
         extra_include_paths = [os.path.join(PATH, "include/"), glm_path]
         opt_level = "-O0" if FAST_COMPILE else "-O3"
-        extra_cflags = [opt_level, "-Wno-attributes"]
+        # -fno-math-errno as in setup.py, for the CPU kernels' simd loops
+        extra_cflags = [opt_level, "-Wno-attributes", "-fno-math-errno"]
+        extra_ldflags = []
+        # The CPU implementations are parallelized with ATen's parallel_for,
+        # which needs OpenMP to actually spread over threads (as in setup.py).
+        info = parallel_info()
+        if (
+            "backend: OpenMP" in info
+            and "OpenMP not found" not in info
+            and sys.platform != "darwin"
+        ):
+            extra_cflags += ["-DAT_PARALLEL_OPENMP"]
+            if sys.platform == "win32":
+                extra_cflags += ["/openmp"]
+            else:
+                extra_cflags += ["-fopenmp"]
+                extra_ldflags += ["-fopenmp"]
         extra_cuda_cflags = [opt_level]
         if not NO_FAST_MATH:
             extra_cuda_cflags += ["-use_fast_math"]
@@ -201,6 +219,7 @@ except ImportError:
                 sources=sources,
                 extra_cflags=extra_cflags,
                 extra_cuda_cflags=extra_cuda_cflags,
+                extra_ldflags=extra_ldflags,
                 extra_include_paths=extra_include_paths,
                 build_directory=build_dir,
                 verbose=VERBOSE,
@@ -219,6 +238,7 @@ except ImportError:
                     sources=sources,
                     extra_cflags=extra_cflags,
                     extra_cuda_cflags=extra_cuda_cflags,
+                    extra_ldflags=extra_ldflags,
                     extra_include_paths=extra_include_paths,
                     build_directory=build_dir,
                     verbose=VERBOSE,
@@ -2,7 +2,7 @@ import math
 import warnings
 from dataclasses import dataclass
 from enum import Enum
-from typing import Any, Callable, Optional, Tuple
+from typing import Any, Callable, List, Optional, Tuple
 
 import torch
 from torch import Tensor
@@ -148,6 +148,86 @@ def adam(
     )
 
 
+def densification_stats(
+    grads: Tensor,  # [..., C, N, 2] or [nnz, 2]
+    radii: Tensor,  # [..., C, N, 2] or [nnz, 2]
+    gaussian_ids: Optional[Tensor],  # [nnz]
+    width: int,
+    height: int,
+    n_cameras: int,
+    grad2d: Tensor,  # [N]
+    count: Tensor,  # [N]
+    max_radii: Optional[Tensor] = None,  # [N]
+) -> None:
+    """Accumulate the densification statistics of the Gaussians in place.
+
+    This fuses the running state update of :class:`DefaultStrategy` into a single
+    pass: for every projection of a Gaussian, `grad2d` accumulates the norm of the
+    screen-space gradient, normalized to [-1, 1] screen space, `count` accumulates
+    one view, and `max_radii` keeps the largest radius normalized by the image size.
+    In the unpacked mode, only the projections with positive radii are counted.
+
+    Args:
+        grads: The gradients of the projected means. [..., C, N, 2] or [nnz, 2]
+        radii: The radii of the projected Gaussians. [..., C, N, 2] or [nnz, 2]
+        gaussian_ids: The Gaussian ids of the packed projections, None in the
+            unpacked mode. [nnz]
+        width: Image width.
+        height: Image height.
+        n_cameras: Number of cameras the gradients were averaged over.
+        grad2d: Accumulated gradient norms, updated in place. [N]
+        count: Accumulated number of views, updated in place. [N]
+        max_radii: Largest normalized radii, updated in place. [N] Default: None.
+    """
+    if gaussian_ids is None:
+        grads = grads.reshape(-1, grad2d.shape[0], 2)
+        radii = radii.reshape(-1, grad2d.shape[0], 2)
+    _make_lazy_cuda_func("densification_stats")(
+        grads.contiguous(),
+        radii.int().contiguous(),
+        gaussian_ids.contiguous() if gaussian_ids is not None else None,
+        width / 2.0 * n_cameras,
+        height / 2.0 * n_cameras,
+        1.0 / float(max(width, height)),
+        grad2d,
+        count,
+        max_radii,
+    )
+
+
+def compact_rows(
+    tensors: List[Tensor],  # each [N, ...]
+    keep: Tensor,  # [N]
+    append: Optional[Tensor] = None,  # [M]
+    zero_append: Optional[List[bool]] = None,
+) -> List[Tensor]:
+    """Compact the rows of several tensors in a single pass.
+
+    Every output is `torch.cat([x[keep], x[append]])` for its input `x`, or has
+    zeros in place of `x[append]` if its flag in `zero_append` is set. The tensors
+    are written together from one scan of `keep`, instead of one gather per tensor.
+
+    Args:
+        tensors: Tensors with the same number of rows, on the same device. [N, ...]
+        keep: Boolean mask of the rows to keep. [N]
+        append: Indices of the rows appended after the kept ones. [M] Default: None.
+        zero_append: Whether to append zeros instead of rows, per tensor.
+            Default: None, i.e. append rows for all tensors.
+
+    Returns:
+        The compacted tensors. [K + M, ...], with K the number of kept rows.
+    """
+    if zero_append is None:
+        zero_append = [False] * len(tensors)
+    assert len(zero_append) == len(tensors), (len(zero_append), len(tensors))
+    return _make_lazy_cuda_func("compact_rows")(
+        [x.contiguous() for x in tensors],
+        keep.bool().contiguous(),
+        append.long().contiguous() if append is not None else None,
+        zero_append,
+    )
+
+
 def spherical_harmonics(
     degrees_to_use: int,
     dirs: Tensor,  # [..., 3]
@@ -181,6 +261,82 @@ def spherical_harmonics(
     )
 
 
+@torch.no_grad()
+def spherical_harmonics_storage(
+    degrees_to_use: int,
+    means: Tensor,  # [N, 3]
+    coeffs: Tensor,  # [N, K, 3]
+    campos: Tensor,  # [C, 3]
+    camera_ids: Optional[Tensor] = None,  # [nnz]
+    gaussian_ids: Optional[Tensor] = None,  # [nnz]
+    dequant_geometry: Optional[Tensor] = None,  # [n_chunks, 2, 11]
+    dequant_colors: Optional[Tensor] = None,  # [n_chunks, 2, K * 3]
+    chunk_size: int = 0,
+    masks: Optional[Tensor] = None,  # [C, N] or [nnz]
+) -> Tensor:
+    """Computes spherical harmonics from Gaussians stored in float32, float16 or
+    uint8, for inference.
+
+    The Gaussian `gaussian_ids[m]` is evaluated from the camera center
+    `campos[camera_ids[m]]`, or every Gaussian from every camera if the ids are not
+    given. The view directions are computed in the kernel from the stored means, and
+    the means and coefficients are read and dequantized there, so no per-pair
+    direction or coefficient tensor is built. See :func:`gsplat.quantize_gaussians`
+    for the uint8 storage.
+
+    Args:
+        degrees_to_use: The degree to be used.
+        means: Gaussian means, in float32, float16 or uint8. [N, 3]
+        coeffs: Coefficients, with the dtype of `means`. [N, K, 3]
+        campos: Camera centers, in float32. [C, 3]
+        camera_ids: The camera of each pair. [nnz] Default: None.
+        gaussian_ids: The Gaussian of each pair. [nnz] Default: None.
+        dequant_geometry: Per-chunk scales and offsets of the uint8 geometry.
+            [n_chunks, 2, 11]. Required if and only if `means` is uint8.
+        dequant_colors: Per-chunk scales and offsets of the uint8 coefficients.
+            [n_chunks, 2, K * 3]. Required if and only if `coeffs` is uint8.
+        chunk_size: Number of consecutive Gaussians sharing a scale and an offset.
+        masks: Optional boolen masks to skip some computation. [C, N] or [nnz]
+            Default: None.
+
+    Returns:
+        Spherical harmonics in float32. [C, N, 3] without the ids, [nnz, 3] with them.
+    """
+    assert (degrees_to_use + 1) ** 2 <= coeffs.shape[-2], coeffs.shape
+    N = means.shape[0]
+    C = campos.shape[0]
+    assert means.shape == (N, 3), means.shape
+    assert coeffs.dim() == 3 and coeffs.shape[::2] == (N, 3), coeffs.shape
+    assert campos.shape == (C, 3), campos.shape
+    assert (camera_ids is None) == (gaussian_ids is None)
+    if camera_ids is not None:
+        assert camera_ids.shape == gaussian_ids.shape, gaussian_ids.shape
+        camera_ids = camera_ids.long().contiguous()
+        gaussian_ids = gaussian_ids.long().contiguous()
+    if masks is not None:
+        if camera_ids is None:
+            assert masks.shape == (C, N), masks.shape
+        else:
+            assert masks.shape == camera_ids.shape, masks.shape
+        masks = masks.contiguous()
+    if dequant_geometry is not None:
+        dequant_geometry = dequant_geometry.contiguous()
+    if dequant_colors is not None:
+        dequant_colors = dequant_colors.contiguous()
+    return _make_lazy_cuda_func("spherical_harmonics_storage_fwd")(
+        degrees_to_use,
+        means.contiguous(),
+        coeffs.contiguous(),
+        dequant_geometry,
+        dequant_colors,
+        chunk_size,
+        campos.float().contiguous(),
+        camera_ids,
+        gaussian_ids,
+        masks,
+    )
+
+
 def quat_scale_to_covar_preci(
     quats: Tensor,  # [..., 4],
     scales: Tensor,  # [..., 3],
@@ -439,6 +595,131 @@ def fully_fused_projection(
         )
 
 
+@torch.no_grad()
+def fully_fused_projection_storage(
+    means: Tensor,  # [N, 3]
+    quats: Tensor,  # [N, 4]
+    scales: Tensor,  # [N, 3]
+    opacities: Tensor,  # [N]
+    viewmats: Tensor,  # [C, 4, 4]
+    Ks: Tensor,  # [C, 3, 3]
+    width: int,
+    height: int,
+    dequant: Optional[Tensor] = None,  # [n_chunks, 2, 11]
+    chunk_size: int = 0,
+    eps2d: float = 0.3,
+    near_plane: float = 0.01,
+    far_plane: float = 1e10,
+    radius_clip: float = 0.0,
+    packed: bool = False,
+    calc_compensations: bool = False,
+    camera_model: Literal["pinhole", "ortho", "fisheye"] = "pinhole",
+) -> Tuple[Tensor, ...]:
+    """Projects Gaussians stored in float32, float16 or uint8 to 2D, for inference.
+
+    This is the forward pass of :func:`fully_fused_projection()` for Gaussians that
+    are kept in a compact storage, which are read and dequantized in the kernel
+    instead of being upcast to float32 beforehand. The means, quats, scales and
+    opacities must share the same dtype. With uint8 storage, the scales are stored in
+    log space and `dequant` holds the scale and the offset of the 11 channels (means,
+    quats, log-scales, opacities) for each chunk of `chunk_size` consecutive Gaussians.
+    See :func:`gsplat.quantize_gaussians`.
+
+    Args:
+        means: Gaussian means. [N, 3]
+        quats: Quaternions (No need to be normalized). [N, 4]
+        scales: Scales, or log-scales if stored in uint8. [N, 3]
+        opacities: Gaussian opacities in range [0, 1]. [N]
+        viewmats: World-to-camera matrices, in float32. [C, 4, 4]
+        Ks: Camera intrinsics, in float32. [C, 3, 3]
+        width: Image width.
+        height: Image height.
+        dequant: Per-chunk scales and offsets of the uint8 Gaussians. [n_chunks, 2, 11]
+            Required if and only if the Gaussians are stored in uint8.
+        chunk_size: Number of consecutive Gaussians sharing a scale and an offset.
+        eps2d: A epsilon added to the 2D covariance for numerical stability. Default: 0.3.
+        near_plane: Near plane distance. Default: 0.01.
+        far_plane: Far plane distance. Default: 1e10.
+        radius_clip: Gaussians with projected radii smaller than this value will be ignored. Default: 0.0.
+        packed: If True, the output tensors will be packed into a flattened tensor. Default: False.
+        calc_compensations: If True, a view-dependent opacity compensation factor will be computed, which
+          is useful for anti-aliasing. Default: False.
+
+    Returns:
+        The same outputs as :func:`fully_fused_projection()`, in float32, followed by
+        the opacities read by the kernel, in float32. [C, N] if packed is False,
+        [nnz] if packed is True. With packed=True the packed projection kernels are
+        used, as in :func:`fully_fused_projection()`.
+    """
+    N = means.shape[0]
+    C = viewmats.shape[0]
+    assert means.shape == (N, 3), means.shape
+    assert quats.shape == (N, 4), quats.shape
+    assert scales.shape == (N, 3), scales.shape
+    assert opacities.shape == (N,), opacities.shape
+    assert viewmats.shape == (C, 4, 4), viewmats.shape
+    assert Ks.shape == (C, 3, 3), Ks.shape
+    assert camera_model in [
+        "pinhole",
+        "ortho",
+        "fisheye",
+    ], "only the pinhole, ortho and fisheye cameras support the compact storage"
+    if dequant is not None:
+        dequant = dequant.contiguous()
+
+    camera_model_type = _make_lazy_cuda_obj(f"CameraModelType.{camera_model.upper()}")
+    args = (
+        means.contiguous(),
+        quats.contiguous(),
+        scales.contiguous(),
+        opacities.contiguous(),
+        dequant,
+        chunk_size,
+        viewmats.float().contiguous(),
+        Ks.float().contiguous(),
+        width,
+        height,
+        eps2d,
+        near_plane,
+        far_plane,
+        radius_clip,
+        calc_compensations,
+        camera_model_type,
+    )
+    if packed:
+        (
+            _,
+            batch_ids,
+            camera_ids,
+            gaussian_ids,
+            radii,
+            means2d,
+            depths,
+            conics,
+            compensations,
+            opacities,
+        ) = _make_lazy_cuda_func("projection_ewa_3dgs_storage_packed_fwd")(*args)
+    else:
+        radii, means2d, depths, conics, compensations, opacities = (
+            _make_lazy_cuda_func("projection_ewa_3dgs_storage_fwd")(*args)
+        )
+    if not calc_compensations:
+        compensations = None
+    if packed:
+        return (
+            batch_ids,
+            camera_ids,
+            gaussian_ids,
+            radii,
+            means2d,
+            depths,
+            conics,
+            compensations,
+            opacities,
+        )
+    return radii, means2d, depths, conics, compensations, opacities
+
+
 @torch.no_grad()
 def isect_tiles(
     means2d: Tensor,  # [..., N, 2] or [nnz, 2]
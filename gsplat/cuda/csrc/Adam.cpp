@@ -24,12 +24,13 @@ void adam(
     const float eps
 ) {
     DEVICE_GUARD(param);
-    CHECK_INPUT(param);
-    CHECK_INPUT(param_grad);
-    CHECK_INPUT(exp_avg);
-    CHECK_INPUT(exp_avg_sq);
+    CHECK_CUDA_OR_CPU(param);
+    CHECK_CONTIGUOUS(param);
+    CHECK_INPUT_LIKE(param_grad, param);
+    CHECK_INPUT_LIKE(exp_avg, param);
+    CHECK_INPUT_LIKE(exp_avg_sq, param);
     if (valid.has_value()) {
-        CHECK_INPUT(valid.value());
+        CHECK_INPUT_LIKE(valid.value(), param);
         TORCH_CHECK(valid.value().dim() == 1, "valid should be 1D tensor");
         TORCH_CHECK(
             valid.value().size(0) == param.size(0),
@@ -37,7 +38,8 @@ void adam(
         );
     }
 
-    launch_adam_kernel(
+    auto launch = param.is_cpu() ? launch_adam_kernel_cpu : launch_adam_kernel;
+    launch(
         param, param_grad, exp_avg, exp_avg_sq, valid, lr, b1, b2, eps
     );
 }
@@ -20,4 +20,17 @@ void launch_adam_kernel(
     const float eps
 );
 
+// CPU counterpart of the launcher above.
+void launch_adam_kernel_cpu(
+    at::Tensor &param,                    // [N, ...]
+    const at::Tensor &param_grad,         // [N, ...]
+    at::Tensor &exp_avg,                  // [N, ...]
+    at::Tensor &exp_avg_sq,               // [N, ...]
+    const at::optional<at::Tensor> valid, // [N]
+    const float lr,
+    const float b1,
+    const float b2,
+    const float eps
+);
+
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <ATen/Dispatch.h> // AT_DISPATCH_XXX
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <cmath>
+
+#include "Adam.h"
+#include "Common.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Update the rows [begin, end). Consecutive valid rows are merged into one
+// contiguous run that is streamed in a single SIMD loop, and the invalid rows
+// in between are never read, so a mostly-invisible model costs little more
+// than reading `valid`.
+template <typename scalar_t>
+GSPLAT_CPU_TARGET_CLONES void adam_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t D,
+    scalar_t *__restrict__ param,
+    const scalar_t *__restrict__ param_grad,
+    scalar_t *__restrict__ exp_avg,
+    scalar_t *__restrict__ exp_avg_sq,
+    const bool *__restrict__ valid,
+    const float lr,
+    const float b1,
+    const float b2,
+    const float eps
+) {
+    int64_t row = begin;
+    while (row < end) {
+        if (valid != nullptr && !valid[row]) {
+            ++row;
+            continue;
+        }
+        int64_t run_end = row + 1;
+        while (run_end < end && (valid == nullptr || valid[run_end])) {
+            ++run_end;
+        }
+
+#pragma omp simd
+        for (int64_t i = row * D; i < run_end * D; ++i) {
+            const float grad = param_grad[i];
+            const float m =
+                b1 * static_cast<float>(exp_avg[i]) + (1.0f - b1) * grad;
+            const float v = b2 * static_cast<float>(exp_avg_sq[i]) +
+                            (1.0f - b2) * grad * grad;
+            param[i] += -lr * m / (std::sqrt(v) + eps);
+            exp_avg[i] = m;
+            exp_avg_sq[i] = v;
+        }
+        row = run_end;
+    }
+}
+
+} // namespace
+
+void launch_adam_kernel_cpu(
+    at::Tensor &param,                    // [N, ...]
+    const at::Tensor &param_grad,         // [N, ...]
+    at::Tensor &exp_avg,                  // [N, ...]
+    at::Tensor &exp_avg_sq,               // [N, ...]
+    const at::optional<at::Tensor> valid, // [N]
+    const float lr,
+    const float b1,
+    const float b2,
+    const float eps
+) {
+    const int64_t N = param.size(0);
+    if (param.numel() == 0) {
+        return;
+    }
+    const int64_t D = param.numel() / N;
+
+    AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "adam_cpu", [&]() {
+        scalar_t *param_ptr = param.data_ptr<scalar_t>();
+        const scalar_t *param_grad_ptr = param_grad.data_ptr<scalar_t>();
+        scalar_t *exp_avg_ptr = exp_avg.data_ptr<scalar_t>();
+        scalar_t *exp_avg_sq_ptr = exp_avg_sq.data_ptr<scalar_t>();
+        const bool *valid_ptr =
+            valid.has_value() ? valid.value().data_ptr<bool>() : nullptr;
+        // about 16K elements per task
+        const int64_t grain = std::max<int64_t>(1, (1 << 14) / D);
+        at::parallel_for(0, N, grain, [&](int64_t begin, int64_t end) {
+            adam_cpu<scalar_t>(
+                begin,
+                end,
+                D,
+                param_ptr,
+                param_grad_ptr,
+                exp_avg_ptr,
+                exp_avg_sq_ptr,
+                valid_ptr,
+                lr,
+                b1,
+                b2,
+                eps
+            );
+        });
+    });
+}
+
+} // namespace gsplat
@@ -0,0 +1,65 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <c10/cuda/CUDAGuard.h> // for DEVICE_GUARD
+#include <vector>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h"     // where all the macros are defined
+#include "Compaction.h" // where the launch function is declared
+#include "Ops.h"        // a collection of all gsplat operators
+
+namespace gsplat {
+
+std::vector<at::Tensor> compact_rows(
+    const std::vector<at::Tensor> &inputs, // each [N, ...]
+    const at::Tensor &keep,                // [N] bool
+    const at::optional<at::Tensor> append, // [M] int64 optional
+    const std::vector<bool> &zero_append   // one flag per input
+) {
+    DEVICE_GUARD(keep);
+    CHECK_CUDA_OR_CPU(keep);
+    CHECK_CONTIGUOUS(keep);
+    TORCH_CHECK(
+        keep.dim() == 1 && keep.scalar_type() == at::kBool,
+        "keep should be a bool [N] tensor"
+    );
+    TORCH_CHECK(
+        zero_append.size() == inputs.size(),
+        "zero_append should have one flag per input"
+    );
+    const int64_t N = keep.size(0);
+    for (const at::Tensor &x : inputs) {
+        CHECK_INPUT_LIKE(x, keep);
+        TORCH_CHECK(
+            x.dim() > 0 && x.size(0) == N,
+            "every input should have as many rows as keep"
+        );
+    }
+    at::Tensor append_ids =
+        append.has_value() ? append.value()
+                           : at::empty({0}, keep.options().dtype(at::kLong));
+    CHECK_INPUT_LIKE(append_ids, keep);
+    TORCH_CHECK(
+        append_ids.dim() == 1 && append_ids.scalar_type() == at::kLong,
+        "append should be an int64 [M] tensor"
+    );
+
+    const int64_t K = keep.sum().item<int64_t>();
+    const int64_t M = append_ids.size(0);
+    std::vector<at::Tensor> outputs;
+    outputs.reserve(inputs.size());
+    for (const at::Tensor &x : inputs) {
+        std::vector<int64_t> sizes = x.sizes().vec();
+        sizes[0] = K + M;
+        outputs.push_back(at::empty(sizes, x.options()));
+    }
+
+    auto launch = keep.is_cpu() ? launch_compact_rows_kernel_cpu
+                                : launch_compact_rows_kernel;
+    launch(inputs, keep, append_ids, zero_append, outputs);
+    return outputs;
+}
+
+} // namespace gsplat
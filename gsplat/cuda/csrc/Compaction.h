@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+void launch_compact_rows_kernel(
+    // inputs
+    const std::vector<at::Tensor> &inputs, // each [N, ...]
+    const at::Tensor &keep,                // [N] bool
+    const at::Tensor &append,              // [M] int64
+    const std::vector<bool> &zero_append,  // one flag per input
+    // outputs
+    std::vector<at::Tensor> &outputs // each [K + M, ...]
+);
+
+// CPU counterpart of the launcher above.
+void launch_compact_rows_kernel_cpu(
+    // inputs
+    const std::vector<at::Tensor> &inputs, // each [N, ...]
+    const at::Tensor &keep,                // [N] bool
+    const at::Tensor &append,              // [M] int64
+    const std::vector<bool> &zero_append,  // one flag per input
+    // outputs
+    std::vector<at::Tensor> &outputs // each [K + M, ...]
+);
+
+} // namespace gsplat
@@ -0,0 +1,154 @@
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "Common.h"
+#include "Compaction.h"
+
+namespace gsplat {
+
+namespace {
+
+// Rows per task when counting and copying the kept rows.
+constexpr int64_t COMPACTION_GRAIN_SIZE = 4096;
+
+// Byte view of the rows of an input and of its output.
+struct RowBuffer {
+    const uint8_t *src;
+    uint8_t *dst;
+    int64_t row_bytes;
+    bool zero_append;
+};
+
+// Copy the kept rows of [begin, end) to the outputs from row `dst_row` on. The
+// mask is scanned once into runs of consecutive kept rows, which are then
+// copied with a single memcpy per run and input.
+void compact_block_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t dst_row,
+    const bool *keep, // [N]
+    const std::vector<RowBuffer> &buffers
+) {
+    std::vector<std::pair<int64_t, int64_t>> runs;
+    for (int64_t i = begin; i < end;) {
+        if (!keep[i]) {
+            ++i;
+            continue;
+        }
+        int64_t j = i + 1;
+        while (j < end && keep[j]) {
+            ++j;
+        }
+        runs.emplace_back(i, j);
+        i = j;
+    }
+
+    for (const RowBuffer &b : buffers) {
+        uint8_t *dst = b.dst + dst_row * b.row_bytes;
+        for (const auto &run : runs) {
+            const int64_t n_bytes = (run.second - run.first) * b.row_bytes;
+            std::memcpy(dst, b.src + run.first * b.row_bytes, n_bytes);
+            dst += n_bytes;
+        }
+    }
+}
+
+// Write the appended rows [begin, end) after the K kept ones: copies of the
+// rows `append` of the inputs, or zeros.
+void append_block_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t K,
+    const int64_t *append, // [M]
+    const std::vector<RowBuffer> &buffers
+) {
+    for (const RowBuffer &b : buffers) {
+        uint8_t *dst = b.dst + (K + begin) * b.row_bytes;
+        if (b.zero_append) {
+            std::memset(dst, 0, (end - begin) * b.row_bytes);
+            continue;
+        }
+        for (int64_t j = begin; j < end; ++j) {
+            std::memcpy(dst, b.src + append[j] * b.row_bytes, b.row_bytes);
+            dst += b.row_bytes;
+        }
+    }
+}
+
+} // namespace
+
+void launch_compact_rows_kernel_cpu(
+    // inputs
+    const std::vector<at::Tensor> &inputs, // each [N, ...]
+    const at::Tensor &keep,                // [N] bool
+    const at::Tensor &append,              // [M] int64
+    const std::vector<bool> &zero_append,  // one flag per input
+    // outputs
+    std::vector<at::Tensor> &outputs // each [K + M, ...]
+) {
+    const int64_t N = keep.size(0);
+    const int64_t M = append.size(0);
+    std::vector<RowBuffer> buffers;
+    for (size_t t = 0; t < inputs.size(); ++t) {
+        const int64_t row_bytes =
+            N > 0 ? inputs[t].numel() / N * inputs[t].element_size() : 0;
+        if (row_bytes == 0) {
+            continue;
+        }
+        buffers.push_back(
+            {static_cast<const uint8_t *>(inputs[t].data_ptr()),
+             static_cast<uint8_t *>(outputs[t].data_ptr()),
+             row_bytes,
+             zero_append[t]}
+        );
+    }
+    if (buffers.empty()) {
+        return;
+    }
+    const bool *keep_ptr = keep.data_ptr<bool>();
+    const int64_t *append_ptr = append.data_ptr<int64_t>();
+
+    // count the kept rows per block
+    const int64_t n_blocks =
+        (N + COMPACTION_GRAIN_SIZE - 1) / COMPACTION_GRAIN_SIZE;
+    std::vector<int64_t> offsets(n_blocks + 1, 0);
+    at::parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+            const int64_t lo = b * COMPACTION_GRAIN_SIZE;
+            const int64_t hi = std::min(N, lo + COMPACTION_GRAIN_SIZE);
+            offsets[b + 1] = std::count(keep_ptr + lo, keep_ptr + hi, true);
+        }
+    });
+    for (int64_t b = 0; b < n_blocks; ++b) {
+        offsets[b + 1] += offsets[b];
+    }
+    const int64_t K = offsets[n_blocks];
+
+    // copy the kept blocks and the appended blocks in the same parallel pass
+    const int64_t n_append_blocks =
+        (M + COMPACTION_GRAIN_SIZE - 1) / COMPACTION_GRAIN_SIZE;
+    at::parallel_for(
+        0,
+        n_blocks + n_append_blocks,
+        1,
+        [&](int64_t begin, int64_t end) {
+            for (int64_t b = begin; b < end; ++b) {
+                if (b < n_blocks) {
+                    const int64_t lo = b * COMPACTION_GRAIN_SIZE;
+                    const int64_t hi = std::min(N, lo + COMPACTION_GRAIN_SIZE);
+                    compact_block_cpu(lo, hi, offsets[b], keep_ptr, buffers);
+                } else {
+                    const int64_t lo = (b - n_blocks) * COMPACTION_GRAIN_SIZE;
+                    const int64_t hi = std::min(M, lo + COMPACTION_GRAIN_SIZE);
+                    append_block_cpu(lo, hi, K, append_ptr, buffers);
+                }
+            }
+        }
+    );
+}
+
+} // namespace gsplat
@@ -0,0 +1,113 @@
+#include <ATen/Functions.h>
+#include <ATen/core/Tensor.h>
+#include <c10/cuda/CUDAStream.h>
+#include <algorithm>
+
+#include "Common.h"
+#include "Compaction.h"
+
+namespace gsplat {
+
+// Columns of the per-input table passed to the kernel.
+enum CompactionEntry {
+    COMPACTION_SRC = 0,   // address of the input
+    COMPACTION_DST = 1,   // address of the output
+    COMPACTION_UNITS = 2, // row size in units of 4 or 1 bytes
+    COMPACTION_FLAGS = 3, // 1: the units are words, 2: zero the appended rows
+    COMPACTION_COLUMNS = 4
+};
+
+// One thread per (output row, unit) and one grid row per input, so that all
+// the inputs are written by a single launch that reads the source rows once
+// per unit.
+__global__ void compact_rows_kernel(
+    const int64_t R,
+    const int64_t K,
+    const int64_t *__restrict__ src_rows, // [R]
+    const int64_t *__restrict__ table     // [T, COMPACTION_COLUMNS]
+) {
+    const int64_t *entry = table + blockIdx.y * COMPACTION_COLUMNS;
+    const int64_t units = entry[COMPACTION_UNITS];
+    const int64_t idx = threadIdx.x + (int64_t)blockIdx.x * blockDim.x;
+    if (idx >= R * units)
+        return;
+
+    const int64_t row = idx / units;
+    const int64_t unit = idx % units;
+    const int64_t flags = entry[COMPACTION_FLAGS];
+    const bool zero = (flags & 2) && row >= K;
+    const int64_t src_idx = src_rows[row] * units + unit;
+    if (flags & 1) {
+        const uint32_t *src =
+            reinterpret_cast<const uint32_t *>(entry[COMPACTION_SRC]);
+        uint32_t *dst = reinterpret_cast<uint32_t *>(entry[COMPACTION_DST]);
+        dst[idx] = zero ? 0u : src[src_idx];
+    } else {
+        const uint8_t *src =
+            reinterpret_cast<const uint8_t *>(entry[COMPACTION_SRC]);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(entry[COMPACTION_DST]);
+        dst[idx] = zero ? 0 : src[src_idx];
+    }
+}
+
+void launch_compact_rows_kernel(
+    // inputs
+    const std::vector<at::Tensor> &inputs, // each [N, ...]
+    const at::Tensor &keep,                // [N] bool
+    const at::Tensor &append,              // [M] int64
+    const std::vector<bool> &zero_append,  // one flag per input
+    // outputs
+    std::vector<at::Tensor> &outputs // each [K + M, ...]
+) {
+    const int64_t N = keep.size(0);
+    const int64_t T = inputs.size();
+
+    // the source row of every output row, shared by all the inputs
+    at::Tensor src_rows = at::nonzero(keep).squeeze(1); // [K]
+    const int64_t K = src_rows.size(0);
+    if (append.size(0) > 0) {
+        src_rows = at::cat({src_rows, append});
+    }
+    const int64_t R = src_rows.size(0);
+
+    at::Tensor table = at::zeros(
+        {T, COMPACTION_COLUMNS},
+        keep.options().dtype(at::kLong).device(at::kCPU)
+    );
+    int64_t *table_ptr = table.data_ptr<int64_t>();
+    int64_t max_units = 0;
+    for (int64_t t = 0; t < T; ++t) {
+        const int64_t row_bytes =
+            N > 0 ? inputs[t].numel() / N * inputs[t].element_size() : 0;
+        const int64_t src = reinterpret_cast<int64_t>(inputs[t].data_ptr());
+        const int64_t dst = reinterpret_cast<int64_t>(outputs[t].data_ptr());
+        const bool word = row_bytes % 4 == 0 && src % 4 == 0 && dst % 4 == 0;
+        int64_t *entry = table_ptr + t * COMPACTION_COLUMNS;
+        entry[COMPACTION_SRC] = src;
+        entry[COMPACTION_DST] = dst;
+        entry[COMPACTION_UNITS] = word ? row_bytes / 4 : row_bytes;
+        entry[COMPACTION_FLAGS] = (word ? 1 : 0) | (zero_append[t] ? 2 : 0);
+        max_units = std::max(max_units, entry[COMPACTION_UNITS]);
+    }
+
+    int64_t n_elements = R * max_units;
+    dim3 threads(256);
+    dim3 grid((n_elements + threads.x - 1) / threads.x, T);
+    int64_t shmem_size = 0; // No shared memory used in this kernel
+
+    if (n_elements == 0) {
+        // skip the kernel launch if there are no elements
+        return;
+    }
+
+    table = table.to(keep.device());
+    compact_rows_kernel<<<
+        grid,
+        threads,
+        shmem_size,
+        at::cuda::getCurrentCUDAStream()>>>(
+        R, K, src_rows.data_ptr<int64_t>(), table.data_ptr<int64_t>()
+    );
+}
+
+} // namespace gsplat
@@ -0,0 +1,81 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <c10/cuda/CUDAGuard.h> // for DEVICE_GUARD
+#include <tuple>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h"             // where all the macros are defined
+#include "DensificationStats.h" // where the launch function is declared
+#include "Ops.h"                // a collection of all gsplat operators
+
+namespace gsplat {
+
+void densification_stats(
+    const at::Tensor &grads,                     // [C, N, 2] or [nnz, 2]
+    const at::Tensor &radii,                     // [C, N, 2] or [nnz, 2]
+    const at::optional<at::Tensor> gaussian_ids, // [nnz] optional
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    at::Tensor &grad2d,                      // [N]
+    at::Tensor &count,                       // [N]
+    const at::optional<at::Tensor> max_radii // [N] optional
+) {
+    DEVICE_GUARD(grads);
+    CHECK_CUDA_OR_CPU(grads);
+    CHECK_CONTIGUOUS(grads);
+    CHECK_INPUT_LIKE(radii, grads);
+    CHECK_INPUT_LIKE(grad2d, grads);
+    CHECK_INPUT_LIKE(count, grads);
+    TORCH_CHECK(grads.size(-1) == 2, "grads should be [C, N, 2] or [nnz, 2]");
+    TORCH_CHECK(radii.sizes() == grads.sizes(), "radii should match grads");
+    TORCH_CHECK(
+        radii.scalar_type() == at::kInt, "radii should be an int32 tensor"
+    );
+    TORCH_CHECK(
+        grad2d.scalar_type() == at::kFloat && count.scalar_type() == at::kFloat,
+        "grad2d and count should be float32 tensors"
+    );
+    const int64_t N = grad2d.size(0);
+    TORCH_CHECK(count.size(0) == N, "count should be [N]");
+    if (gaussian_ids.has_value()) {
+        CHECK_INPUT_LIKE(gaussian_ids.value(), grads);
+        TORCH_CHECK(grads.dim() == 2, "packed grads should be [nnz, 2]");
+        TORCH_CHECK(
+            gaussian_ids.value().scalar_type() == at::kLong &&
+                gaussian_ids.value().size(0) == grads.size(0),
+            "gaussian_ids should be an int64 [nnz] tensor"
+        );
+    } else {
+        TORCH_CHECK(
+            grads.dim() == 3 && grads.size(1) == N,
+            "unpacked grads should be [C, N, 2]"
+        );
+    }
+    if (max_radii.has_value()) {
+        CHECK_INPUT_LIKE(max_radii.value(), grads);
+        TORCH_CHECK(
+            max_radii.value().scalar_type() == at::kFloat &&
+                max_radii.value().size(0) == N,
+            "max_radii should be a float32 [N] tensor"
+        );
+    }
+
+    auto launch = grads.is_cpu() ? launch_densification_stats_kernel_cpu
+                                 : launch_densification_stats_kernel;
+    launch(
+        grads,
+        radii,
+        gaussian_ids,
+        scale_x,
+        scale_y,
+        radius_scale,
+        grad2d,
+        count,
+        max_radii
+    );
+}
+
+} // namespace gsplat
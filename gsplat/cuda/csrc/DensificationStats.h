@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+void launch_densification_stats_kernel(
+    // inputs
+    const at::Tensor &grads,                     // [C, N, 2] or [nnz, 2]
+    const at::Tensor &radii,                     // [C, N, 2] or [nnz, 2]
+    const at::optional<at::Tensor> gaussian_ids, // [nnz] optional
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    // outputs
+    at::Tensor &grad2d,                      // [N]
+    at::Tensor &count,                       // [N]
+    const at::optional<at::Tensor> max_radii // [N] optional
+);
+
+// CPU counterpart of the launcher above.
+void launch_densification_stats_kernel_cpu(
+    // inputs
+    const at::Tensor &grads,                     // [C, N, 2] or [nnz, 2]
+    const at::Tensor &radii,                     // [C, N, 2] or [nnz, 2]
+    const at::optional<at::Tensor> gaussian_ids, // [nnz] optional
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    // outputs
+    at::Tensor &grad2d,                      // [N]
+    at::Tensor &count,                       // [N]
+    const at::optional<at::Tensor> max_radii // [N] optional
+);
+
+} // namespace gsplat
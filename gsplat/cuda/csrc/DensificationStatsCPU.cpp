@@ -0,0 +1,204 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <cmath>
+
+#include "Common.h"
+#include "DensificationStats.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Add the statistics of one projection of the Gaussian g: the norm of its
+// screen-space gradient, one view, and its largest radius normalized by the
+// image size.
+template <typename scalar_t>
+GSPLAT_CPU_INLINE void accumulate_stats(
+    const scalar_t *__restrict__ grad,  // [2]
+    const int32_t *__restrict__ radius, // [2]
+    const int64_t g,
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    float *__restrict__ grad2d,   // [N]
+    float *__restrict__ count,    // [N]
+    float *__restrict__ max_radii // [N] optional
+) {
+    const float gx = static_cast<float>(grad[0]) * scale_x;
+    const float gy = static_cast<float>(grad[1]) * scale_y;
+    grad2d[g] += std::sqrt(gx * gx + gy * gy);
+    count[g] += 1.f;
+    if (max_radii != nullptr) {
+        const float r = std::max(radius[0], radius[1]) * radius_scale;
+        max_radii[g] = std::max(max_radii[g], r);
+    }
+}
+
+// Unpacked projections of the Gaussians [begin, end). The cameras are the
+// outer loop so that every row is streamed, and the rows of a task do not
+// overlap with the other tasks.
+template <typename scalar_t>
+GSPLAT_CPU_TARGET_CLONES void densification_stats_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t C,
+    const int64_t N,
+    const scalar_t *__restrict__ grads, // [C, N, 2]
+    const int32_t *__restrict__ radii,  // [C, N, 2]
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    float *__restrict__ grad2d,   // [N]
+    float *__restrict__ count,    // [N]
+    float *__restrict__ max_radii // [N] optional
+) {
+    for (int64_t c = 0; c < C; ++c) {
+        const scalar_t *grads_c = grads + c * N * 2;
+        const int32_t *radii_c = radii + c * N * 2;
+        for (int64_t g = begin; g < end; ++g) {
+            if (radii_c[g * 2] <= 0 || radii_c[g * 2 + 1] <= 0) {
+                continue;
+            }
+            accumulate_stats(
+                grads_c + g * 2,
+                radii_c + g * 2,
+                g,
+                scale_x,
+                scale_y,
+                radius_scale,
+                grad2d,
+                count,
+                max_radii
+            );
+        }
+    }
+}
+
+// Packed projections [begin, end), whose Gaussians must be distinct.
+template <typename scalar_t>
+GSPLAT_CPU_TARGET_CLONES void densification_stats_packed_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const scalar_t *__restrict__ grads,       // [nnz, 2]
+    const int32_t *__restrict__ radii,        // [nnz, 2]
+    const int64_t *__restrict__ gaussian_ids, // [nnz]
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    float *__restrict__ grad2d,   // [N]
+    float *__restrict__ count,    // [N]
+    float *__restrict__ max_radii // [N] optional
+) {
+    for (int64_t i = begin; i < end; ++i) {
+        accumulate_stats(
+            grads + i * 2,
+            radii + i * 2,
+            gaussian_ids[i],
+            scale_x,
+            scale_y,
+            radius_scale,
+            grad2d,
+            count,
+            max_radii
+        );
+    }
+}
+
+} // namespace
+
+void launch_densification_stats_kernel_cpu(
+    // inputs
+    const at::Tensor &grads,                     // [C, N, 2] or [nnz, 2]
+    const at::Tensor &radii,                     // [C, N, 2] or [nnz, 2]
+    const at::optional<at::Tensor> gaussian_ids, // [nnz] optional
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    // outputs
+    at::Tensor &grad2d,                      // [N]
+    at::Tensor &count,                       // [N]
+    const at::optional<at::Tensor> max_radii // [N] optional
+) {
+    if (grads.numel() == 0) {
+        return;
+    }
+    const int32_t *radii_ptr = radii.data_ptr<int32_t>();
+    float *grad2d_ptr = grad2d.data_ptr<float>();
+    float *count_ptr = count.data_ptr<float>();
+    float *max_radii_ptr =
+        max_radii.has_value() ? max_radii.value().data_ptr<float>() : nullptr;
+
+    AT_DISPATCH_FLOATING_TYPES(
+        grads.scalar_type(),
+        "densification_stats_cpu",
+        [&]() {
+            const scalar_t *grads_ptr = grads.data_ptr<scalar_t>();
+            if (!gaussian_ids.has_value()) {
+                const int64_t C = grads.size(0);
+                const int64_t N = grads.size(1);
+                at::parallel_for(
+                    0,
+                    N,
+                    std::max<int64_t>(1, (1 << 14) / C),
+                    [&](int64_t begin, int64_t end) {
+                        densification_stats_cpu<scalar_t>(
+                            begin,
+                            end,
+                            C,
+                            N,
+                            grads_ptr,
+                            radii_ptr,
+                            scale_x,
+                            scale_y,
+                            radius_scale,
+                            grad2d_ptr,
+                            count_ptr,
+                            max_radii_ptr
+                        );
+                    }
+                );
+                return;
+            }
+
+            // A Gaussian shows up at most once per camera and the packed
+            // projections are sorted by camera then Gaussian, so every run of
+            // strictly increasing ids is updated in parallel without races.
+            // Any other order still gives the right result, in shorter runs.
+            const int64_t *ids = gaussian_ids.value().data_ptr<int64_t>();
+            const int64_t nnz = grads.size(0);
+            int64_t run_begin = 0;
+            while (run_begin < nnz) {
+                int64_t run_end = run_begin + 1;
+                while (run_end < nnz && ids[run_end] > ids[run_end - 1]) {
+                    ++run_end;
+                }
+                at::parallel_for(
+                    run_begin,
+                    run_end,
+                    1 << 14,
+                    [&](int64_t begin, int64_t end) {
+                        densification_stats_packed_cpu<scalar_t>(
+                            begin,
+                            end,
+                            grads_ptr,
+                            radii_ptr,
+                            ids,
+                            scale_x,
+                            scale_y,
+                            radius_scale,
+                            grad2d_ptr,
+                            count_ptr,
+                            max_radii_ptr
+                        );
+                    }
+                );
+                run_begin = run_end;
+            }
+        }
+    );
+}
+
+} // namespace gsplat
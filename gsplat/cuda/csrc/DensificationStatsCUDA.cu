@@ -0,0 +1,151 @@
+#include <ATen/Dispatch.h>
+#include <ATen/core/Tensor.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include "Common.h"
+#include "DensificationStats.h"
+
+namespace gsplat {
+
+// One thread per Gaussian, looping over the cameras, so that no atomics are
+// needed for the unpacked projections.
+template <typename scalar_t>
+__global__ void densification_stats_kernel(
+    const uint32_t C,
+    const uint32_t N,
+    const scalar_t *__restrict__ grads, // [C, N, 2]
+    const int32_t *__restrict__ radii,  // [C, N, 2]
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    float *__restrict__ grad2d,   // [N]
+    float *__restrict__ count,    // [N]
+    float *__restrict__ max_radii // [N] optional
+) {
+    uint32_t g = threadIdx.x + blockIdx.x * blockDim.x;
+    if (g >= N)
+        return;
+
+    float grad_sum = 0.f, views = 0.f, radius = 0.f;
+    for (uint32_t c = 0; c < C; ++c) {
+        const int64_t idx = (int64_t)c * N + g;
+        const int32_t r0 = radii[idx * 2], r1 = radii[idx * 2 + 1];
+        if (r0 <= 0 || r1 <= 0)
+            continue;
+        const float gx = static_cast<float>(grads[idx * 2]) * scale_x;
+        const float gy = static_cast<float>(grads[idx * 2 + 1]) * scale_y;
+        grad_sum += sqrtf(gx * gx + gy * gy);
+        views += 1.f;
+        radius = fmaxf(radius, max(r0, r1) * radius_scale);
+    }
+    if (views == 0.f)
+        return;
+    grad2d[g] += grad_sum;
+    count[g] += views;
+    if (max_radii != nullptr)
+        max_radii[g] = fmaxf(max_radii[g], radius);
+}
+
+// One thread per packed projection. The radii are non-negative, so their
+// float bits order like integers.
+template <typename scalar_t>
+__global__ void densification_stats_packed_kernel(
+    const uint32_t nnz,
+    const scalar_t *__restrict__ grads,       // [nnz, 2]
+    const int32_t *__restrict__ radii,        // [nnz, 2]
+    const int64_t *__restrict__ gaussian_ids, // [nnz]
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    float *__restrict__ grad2d,   // [N]
+    float *__restrict__ count,    // [N]
+    float *__restrict__ max_radii // [N] optional
+) {
+    uint32_t idx = threadIdx.x + blockIdx.x * blockDim.x;
+    if (idx >= nnz)
+        return;
+
+    const int64_t g = gaussian_ids[idx];
+    const float gx = static_cast<float>(grads[idx * 2]) * scale_x;
+    const float gy = static_cast<float>(grads[idx * 2 + 1]) * scale_y;
+    atomicAdd(grad2d + g, sqrtf(gx * gx + gy * gy));
+    atomicAdd(count + g, 1.f);
+    if (max_radii != nullptr) {
+        const float r = max(radii[idx * 2], radii[idx * 2 + 1]) * radius_scale;
+        atomicMax(
+            reinterpret_cast<int32_t *>(max_radii + g), __float_as_int(r)
+        );
+    }
+}
+
+void launch_densification_stats_kernel(
+    // inputs
+    const at::Tensor &grads,                     // [C, N, 2] or [nnz, 2]
+    const at::Tensor &radii,                     // [C, N, 2] or [nnz, 2]
+    const at::optional<at::Tensor> gaussian_ids, // [nnz] optional
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    // outputs
+    at::Tensor &grad2d,                      // [N]
+    at::Tensor &count,                       // [N]
+    const at::optional<at::Tensor> max_radii // [N] optional
+) {
+    const bool packed = gaussian_ids.has_value();
+    // parallel over the Gaussians, or over the packed projections
+    int64_t n_elements = packed ? grads.size(0) : grads.size(1);
+    dim3 threads(256);
+    dim3 grid((n_elements + threads.x - 1) / threads.x);
+    int64_t shmem_size = 0; // No shared memory used in this kernel
+
+    if (n_elements == 0 || grads.numel() == 0) {
+        // skip the kernel launch if there are no elements
+        return;
+    }
+
+    float *max_radii_ptr =
+        max_radii.has_value() ? max_radii.value().data_ptr<float>() : nullptr;
+    AT_DISPATCH_FLOATING_TYPES(
+        grads.scalar_type(),
+        "densification_stats_kernel",
+        [&]() {
+            if (packed) {
+                densification_stats_packed_kernel<scalar_t>
+                    <<<grid,
+                       threads,
+                       shmem_size,
+                       at::cuda::getCurrentCUDAStream()>>>(
+                        n_elements,
+                        grads.data_ptr<scalar_t>(),
+                        radii.data_ptr<int32_t>(),
+                        gaussian_ids.value().data_ptr<int64_t>(),
+                        scale_x,
+                        scale_y,
+                        radius_scale,
+                        grad2d.data_ptr<float>(),
+                        count.data_ptr<float>(),
+                        max_radii_ptr
+                    );
+            } else {
+                densification_stats_kernel<scalar_t>
+                    <<<grid,
+                       threads,
+                       shmem_size,
+                       at::cuda::getCurrentCUDAStream()>>>(
+                        grads.size(0),
+                        n_elements,
+                        grads.data_ptr<scalar_t>(),
+                        radii.data_ptr<int32_t>(),
+                        scale_x,
+                        scale_y,
+                        radius_scale,
+                        grad2d.data_ptr<float>(),
+                        count.data_ptr<float>(),
+                        max_radii_ptr
+                    );
+            }
+        }
+    );
+}
+
+} // namespace gsplat
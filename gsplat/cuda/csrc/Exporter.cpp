@@ -0,0 +1,187 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h"   // where all the macros are defined
+#include "Exporter.h" // where the CPU functions are declared
+#include "Ops.h"      // a collection of all gsplat operators
+
+namespace gsplat {
+
+namespace {
+
+// Rows [begin, end) of an attribute as a contiguous float32 CPU tensor. This is
+// a view for contiguous float32 CPU inputs and a chunk-sized copy otherwise.
+at::Tensor load_rows(const at::Tensor &x, int64_t begin, int64_t end) {
+    return x.slice(0, begin, end).to(at::kCPU, at::kFloat).contiguous();
+}
+
+struct FileCloser {
+    void operator()(std::FILE *file) const { std::fclose(file); }
+};
+
+void write_or_throw(std::FILE *file, const void *data, size_t size) {
+    TORCH_CHECK(
+        std::fwrite(data, 1, size, file) == size, "failed to write the file"
+    );
+}
+
+} // namespace
+
+int64_t export_ply(
+    const std::string &path,
+    const at::Tensor means,     // [N, 3]
+    const at::Tensor scales,    // [N, 3]
+    const at::Tensor quats,     // [N, 4]
+    const at::Tensor opacities, // [N]
+    const at::Tensor sh0,       // [N, 1, 3]
+    const at::Tensor shN,       // [N, K, 3]
+    const int64_t chunk_size
+) {
+    const int64_t N = means.size(0);
+    const int64_t K = shN.size(1);
+    TORCH_CHECK(
+        means.numel() == N * 3 && scales.numel() == N * 3 &&
+            quats.numel() == N * 4 && opacities.numel() == N &&
+            sh0.numel() == N * 3,
+        "the attributes must have the shapes [N, 3], [N, 3], [N, 4], [N] and "
+        "[N, 1, 3]"
+    );
+    TORCH_CHECK(
+        shN.dim() == 3 && shN.size(0) == N && shN.size(2) == 3,
+        "shN must have the shape [N, K, 3]"
+    );
+    TORCH_CHECK(chunk_size > 0, "chunk_size must be positive");
+
+    // count the finite splats for the header
+    int64_t n_finite = 0;
+    for (int64_t begin = 0; begin < N; begin += chunk_size) {
+        const int64_t end = std::min(N, begin + chunk_size);
+        n_finite += count_finite_splats_cpu(
+            load_rows(means, begin, end),
+            load_rows(scales, begin, end),
+            load_rows(quats, begin, end),
+            load_rows(opacities, begin, end),
+            load_rows(sh0, begin, end),
+            load_rows(shN, begin, end)
+        );
+    }
+
+    std::unique_ptr<std::FILE, FileCloser> file(std::fopen(path.c_str(), "wb"));
+    TORCH_CHECK(file != nullptr, "failed to open ", path);
+    // the chunks are large enough, skip the stdio buffer
+    std::setvbuf(file.get(), nullptr, _IONBF, 0);
+
+    std::string header = "ply\nformat binary_little_endian 1.0\n";
+    header += "element vertex " + std::to_string(n_finite) + "\n";
+    header += "property float x\nproperty float y\nproperty float z\n";
+    for (int j = 0; j < 3; ++j) {
+        header += "property float f_dc_" + std::to_string(j) + "\n";
+    }
+    for (int64_t j = 0; j < 3 * K; ++j) {
+        header += "property float f_rest_" + std::to_string(j) + "\n";
+    }
+    header += "property float opacity\n";
+    for (int j = 0; j < 3; ++j) {
+        header += "property float scale_" + std::to_string(j) + "\n";
+    }
+    for (int j = 0; j < 4; ++j) {
+        header += "property float rot_" + std::to_string(j) + "\n";
+    }
+    header += "end_header\n";
+    write_or_throw(file.get(), header.data(), header.size());
+
+    // Double buffering: a chunk is packed while the previous one is written.
+    // The vertices are written as-is, assuming a little-endian host.
+    const int64_t n_floats = 14 + 3 * K;
+    std::vector<float> buffers[2];
+    std::future<void> pending;
+    int64_t n_written = 0;
+    for (int64_t begin = 0, b = 0; begin < N; begin += chunk_size, b ^= 1) {
+        const int64_t end = std::min(N, begin + chunk_size);
+        buffers[b].resize((end - begin) * n_floats);
+        const int64_t n = pack_ply_vertices_cpu(
+            load_rows(means, begin, end),
+            load_rows(scales, begin, end),
+            load_rows(quats, begin, end),
+            load_rows(opacities, begin, end),
+            load_rows(sh0, begin, end),
+            load_rows(shN, begin, end),
+            buffers[b].data()
+        );
+        if (pending.valid()) {
+            pending.get();
+        }
+        const float *data = buffers[b].data();
+        pending = std::async(std::launch::async, [&file, data, n, n_floats]() {
+            write_or_throw(file.get(), data, n * n_floats * sizeof(float));
+        });
+        n_written += n;
+    }
+    if (pending.valid()) {
+        pending.get();
+    }
+    TORCH_CHECK(
+        n_written == n_finite, "the splats changed while being exported"
+    );
+    return n_written;
+}
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> encode_ply_compressed(
+    const at::Tensor means,  // [N, 3]
+    const at::Tensor scales, // [N, 3]
+    const at::Tensor quats,  // [N, 4]
+    const at::Tensor colors, // [N, 3]
+    const at::Tensor alphas, // [N]
+    const at::Tensor shN,    // [N, S]
+    const int64_t chunk_size
+) {
+    TORCH_CHECK(means.is_cpu(), "means must be a CPU tensor");
+    CHECK_CONTIGUOUS(means);
+    CHECK_INPUT_LIKE(scales, means);
+    CHECK_INPUT_LIKE(quats, means);
+    CHECK_INPUT_LIKE(colors, means);
+    CHECK_INPUT_LIKE(alphas, means);
+    CHECK_INPUT_LIKE(shN, means);
+    const int64_t N = means.size(0);
+    TORCH_CHECK(
+        means.numel() == N * 3 && scales.numel() == N * 3 &&
+            quats.numel() == N * 4 && colors.numel() == N * 3 &&
+            alphas.numel() == N,
+        "the attributes must have the shapes [N, 3], [N, 3], [N, 4], [N, 3] "
+        "and [N]"
+    );
+    TORCH_CHECK(
+        shN.dim() == 2 && shN.size(0) == N, "shN must have the shape [N, S]"
+    );
+    TORCH_CHECK(chunk_size > 0, "chunk_size must be positive");
+
+    const int64_t n_chunks = (N + chunk_size - 1) / chunk_size;
+    auto opt = means.options();
+    at::Tensor chunks = at::empty({n_chunks, 18}, opt);
+    at::Tensor vertices = at::empty({N, 4}, opt.dtype(at::kInt));
+    at::Tensor sh = at::empty({N, shN.size(1)}, opt.dtype(at::kByte));
+    encode_ply_compressed_cpu(
+        means,
+        scales,
+        quats,
+        colors,
+        alphas,
+        shN,
+        chunk_size,
+        chunks,
+        vertices,
+        sh
+    );
+    return std::make_tuple(chunks, vertices, sh);
+}
+
+} // namespace gsplat
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+// The exporters only have a CPU implementation. The PLY writer works on
+// chunks of rows that the host function moves to the CPU one at a time, so
+// that the memory stays bounded by the chunk size.
+
+// Number of splats whose attributes are all finite.
+int64_t count_finite_splats_cpu(
+    const at::Tensor means,     // [n, 3]
+    const at::Tensor scales,    // [n, 3]
+    const at::Tensor quats,     // [n, 4]
+    const at::Tensor opacities, // [n]
+    const at::Tensor sh0,       // [n, 1, 3]
+    const at::Tensor shN        // [n, K, 3]
+);
+
+// Interleave the finite splats into little-endian PLY vertices of
+// 14 + 3K floats: x, y, z, f_dc_*, f_rest_* (channel-major), opacity, scale_*
+// and rot_*. Returns the number of vertices written to `vertices`.
+int64_t pack_ply_vertices_cpu(
+    const at::Tensor means,     // [n, 3]
+    const at::Tensor scales,    // [n, 3]
+    const at::Tensor quats,     // [n, 4]
+    const at::Tensor opacities, // [n]
+    const at::Tensor sh0,       // [n, 1, 3]
+    const at::Tensor shN,       // [n, K, 3]
+    float *vertices             // [n, 14 + 3K]
+);
+
+// Sort the splats by the Morton code of their means and encode them in the
+// `ply_compressed` layout of `splat2ply_bytes_compressed`, with the same
+// float operations so that the output is bit-identical: per chunk the bounds
+// of the positions, scales (clamped to [-20, 20]) and colors, and per splat
+// the packed position, rotation, scale and color words and the 8-bit SH
+// coefficients.
+void encode_ply_compressed_cpu(
+    const at::Tensor means,  // [N, 3]
+    const at::Tensor scales, // [N, 3]
+    const at::Tensor quats,  // [N, 4]
+    const at::Tensor colors, // [N, 3] sh2rgb(sh0)
+    const at::Tensor alphas, // [N] sigmoid(opacities)
+    const at::Tensor shN,    // [N, S]
+    const int64_t chunk_size,
+    // outputs
+    at::Tensor chunks,   // [n_chunks, 18] float32
+    at::Tensor vertices, // [N, 4] int32 (bits of uint32)
+    at::Tensor sh        // [N, S] uint8
+);
+
+} // namespace gsplat
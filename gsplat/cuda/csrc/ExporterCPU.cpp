@@ -0,0 +1,380 @@
+// The packing in this file repeats the float operations of the PyTorch
+// functions in `gsplat/exporter.py` to produce the same bytes. GCC contracts
+// products and sums into FMAs across statements by default
+// (-ffp-contract=fast), which round differently, so contraction is turned off
+// for the whole file, included headers too. Clang and MSVC only contract
+// within an expression, if at all.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#include <ATen/Functions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "Common.h"
+#include "Exporter.h"
+#include "Intersect.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Rows per task when flagging and packing the splats.
+constexpr int64_t EXPORT_GRAIN_SIZE = 1024;
+
+// Row-major views of the attributes of one chunk of splats, all float32 and
+// contiguous.
+struct SplatRowsCPU {
+    const float *means;
+    const float *scales;
+    const float *quats;
+    const float *opacities;
+    const float *sh0;
+    const float *shN;
+    int64_t K;
+
+    SplatRowsCPU(
+        const at::Tensor &means,
+        const at::Tensor &scales,
+        const at::Tensor &quats,
+        const at::Tensor &opacities,
+        const at::Tensor &sh0,
+        const at::Tensor &shN
+    )
+        : means(means.data_ptr<float>()), scales(scales.data_ptr<float>()),
+          quats(quats.data_ptr<float>()),
+          opacities(opacities.data_ptr<float>()), sh0(sh0.data_ptr<float>()),
+          shN(shN.data_ptr<float>()), K(shN.size(1)) {}
+
+    bool is_finite(const int64_t i) const {
+        // x - x is NaN for both NaN and Inf, so one test per value suffices
+        float acc = opacities[i] - opacities[i];
+        for (int k = 0; k < 3; ++k) {
+            acc += means[i * 3 + k] - means[i * 3 + k];
+            acc += scales[i * 3 + k] - scales[i * 3 + k];
+            acc += sh0[i * 3 + k] - sh0[i * 3 + k];
+        }
+        for (int k = 0; k < 4; ++k) {
+            acc += quats[i * 4 + k] - quats[i * 4 + k];
+        }
+        const float *sh = shN + i * K * 3;
+        for (int64_t k = 0; k < K * 3; ++k) {
+            acc += sh[k] - sh[k];
+        }
+        return acc == 0.f;
+    }
+
+    void write_vertex(const int64_t i, float *out) const {
+        std::memcpy(out, means + i * 3, 3 * sizeof(float));
+        std::memcpy(out + 3, sh0 + i * 3, 3 * sizeof(float));
+        out += 6;
+        // f_rest_{c * K + k} = shN[i, k, c]
+        const float *sh = shN + i * K * 3;
+        for (int c = 0; c < 3; ++c) {
+            for (int64_t k = 0; k < K; ++k) {
+                *out++ = sh[k * 3 + c];
+            }
+        }
+        *out++ = opacities[i];
+        std::memcpy(out, scales + i * 3, 3 * sizeof(float));
+        std::memcpy(out + 3, quats + i * 4, 4 * sizeof(float));
+    }
+};
+
+// The packing below repeats the float operations of the PyTorch functions in
+// `gsplat/exporter.py` one by one. Products and sums are kept in separate
+// statements so that Clang does not contract them into FMAs either.
+
+// Same as `pack_unorm`: round [0, 1] to `bits` bits. NaN (0 / 0 for a chunk
+// with a constant value) is packed to 0.
+inline uint32_t pack_unorm(const float value, const int bits) {
+    const float t = static_cast<float>((1u << bits) - 1);
+    float packed = value * t;
+    packed = packed + 0.5f;
+    packed = std::floor(packed);
+    return packed > 0.f ? static_cast<uint32_t>(std::min(packed, t)) : 0u;
+}
+
+inline float normalize(const float value, const float lo, const float hi) {
+    const float range = hi - lo;
+    return (value - lo) / range;
+}
+
+// Same as `pack_111011` of the values normalized in [lo, hi].
+inline uint32_t
+pack_111011(const float *value, const float *lo, const float *hi) {
+    return pack_unorm(normalize(value[0], lo[0], hi[0]), 11) << 21 |
+           pack_unorm(normalize(value[1], lo[1], hi[1]), 10) << 11 |
+           pack_unorm(normalize(value[2], lo[2], hi[2]), 11);
+}
+
+// Same as `pack_rotation`: the index of the largest component in the top 2
+// bits and the other three in 10 bits each.
+inline uint32_t pack_rotation(const float *quat) {
+    float sum = 0.f;
+    for (int k = 0; k < 4; ++k) {
+        const float sq = quat[k] * quat[k];
+        sum = sum + sq;
+    }
+    const float norm = std::sqrt(sum);
+    float q[4];
+    for (int k = 0; k < 4; ++k) {
+        q[k] = quat[k] / norm;
+    }
+    // the first one on ties, like torch.argmax
+    int largest = 0;
+    for (int k = 1; k < 4; ++k) {
+        if (std::fabs(q[k]) > std::fabs(q[largest])) {
+            largest = k;
+        }
+    }
+    const float sign = q[largest] < 0.f ? -1.f : 1.f;
+    const float scale = static_cast<float>(std::sqrt(2.0) * 0.5);
+    uint32_t packed = static_cast<uint32_t>(largest) << 30;
+    for (int k = 0, c = 0; k < 4; ++k) {
+        if (k == largest) {
+            continue;
+        }
+        float scaled = q[k] * sign;
+        scaled = scaled * scale;
+        scaled = scaled + 0.5f;
+        packed |= pack_unorm(scaled, 10) << (20 - 10 * c++);
+    }
+    return packed;
+}
+
+// Same as the quantization of the SH coefficients: 8 bits in [-4, 4).
+inline uint8_t pack_sh(const float value) {
+    float scaled = value / 8.f;
+    scaled = scaled + 0.5f;
+    scaled = scaled * 256.f;
+    scaled = std::trunc(scaled);
+    return scaled > 0.f ? static_cast<uint8_t>(std::min(scaled, 255.f)) : 0;
+}
+
+} // namespace
+
+int64_t count_finite_splats_cpu(
+    const at::Tensor means,     // [n, 3]
+    const at::Tensor scales,    // [n, 3]
+    const at::Tensor quats,     // [n, 4]
+    const at::Tensor opacities, // [n]
+    const at::Tensor sh0,       // [n, 1, 3]
+    const at::Tensor shN        // [n, K, 3]
+) {
+    const int64_t n = means.size(0);
+    const SplatRowsCPU rows(means, scales, quats, opacities, sh0, shN);
+    return at::parallel_reduce(
+        0,
+        n,
+        EXPORT_GRAIN_SIZE,
+        int64_t(0),
+        [&](int64_t begin, int64_t end, int64_t count) {
+            for (int64_t i = begin; i < end; ++i) {
+                count += rows.is_finite(i);
+            }
+            return count;
+        },
+        std::plus<int64_t>()
+    );
+}
+
+int64_t pack_ply_vertices_cpu(
+    const at::Tensor means,     // [n, 3]
+    const at::Tensor scales,    // [n, 3]
+    const at::Tensor quats,     // [n, 4]
+    const at::Tensor opacities, // [n]
+    const at::Tensor sh0,       // [n, 1, 3]
+    const at::Tensor shN,       // [n, K, 3]
+    float *vertices             // [n, 14 + 3K]
+) {
+    const int64_t n = means.size(0);
+    const SplatRowsCPU rows(means, scales, quats, opacities, sh0, shN);
+    const int64_t n_floats = 14 + 3 * rows.K;
+
+    // flag the finite rows and count them per block
+    const int64_t n_blocks = (n + EXPORT_GRAIN_SIZE - 1) / EXPORT_GRAIN_SIZE;
+    std::vector<uint8_t> is_finite(n);
+    std::vector<int64_t> offsets(n_blocks + 1, 0);
+    at::parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+            int64_t count = 0;
+            const int64_t hi = std::min(n, (b + 1) * EXPORT_GRAIN_SIZE);
+            for (int64_t i = b * EXPORT_GRAIN_SIZE; i < hi; ++i) {
+                is_finite[i] = rows.is_finite(i);
+                count += is_finite[i];
+            }
+            offsets[b + 1] = count;
+        }
+    });
+    for (int64_t b = 0; b < n_blocks; ++b) {
+        offsets[b + 1] += offsets[b];
+    }
+
+    // interleave the finite rows at their compacted positions
+    at::parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+            float *out = vertices + offsets[b] * n_floats;
+            const int64_t hi = std::min(n, (b + 1) * EXPORT_GRAIN_SIZE);
+            for (int64_t i = b * EXPORT_GRAIN_SIZE; i < hi; ++i) {
+                if (is_finite[i]) {
+                    rows.write_vertex(i, out);
+                    out += n_floats;
+                }
+            }
+        }
+    });
+    return offsets[n_blocks];
+}
+
+void encode_ply_compressed_cpu(
+    const at::Tensor means,  // [N, 3]
+    const at::Tensor scales, // [N, 3]
+    const at::Tensor quats,  // [N, 4]
+    const at::Tensor colors, // [N, 3] sh2rgb(sh0)
+    const at::Tensor alphas, // [N] sigmoid(opacities)
+    const at::Tensor shN,    // [N, S]
+    const int64_t chunk_size,
+    // outputs
+    at::Tensor chunks,   // [n_chunks, 18] float32
+    at::Tensor vertices, // [N, 4] int32 (bits of uint32)
+    at::Tensor sh        // [N, S] uint8
+) {
+    const int64_t N = means.size(0);
+    const int64_t S = shN.size(1);
+    if (N == 0) {
+        return;
+    }
+    const float *means_ptr = means.data_ptr<float>();
+    const float *scales_ptr = scales.data_ptr<float>();
+    const float *quats_ptr = quats.data_ptr<float>();
+    const float *colors_ptr = colors.data_ptr<float>();
+    const float *alphas_ptr = alphas.data_ptr<float>();
+    const float *shN_ptr = shN.data_ptr<float>();
+    float *chunks_ptr = chunks.data_ptr<float>();
+    uint32_t *vertices_ptr =
+        reinterpret_cast<uint32_t *>(vertices.data_ptr<int32_t>());
+    uint8_t *sh_ptr = sh.data_ptr<uint8_t>();
+
+    // Same as `sort_centers`: 10 bits per axis in the bounds of the means,
+    // with z in the most significant bit of every triplet.
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    using Bounds = std::array<float, 6>;
+    const Bounds bounds = at::parallel_reduce(
+        0,
+        N,
+        EXPORT_GRAIN_SIZE,
+        Bounds{inf, inf, inf, -inf, -inf, -inf},
+        [&](int64_t begin, int64_t end, Bounds b) {
+            for (int64_t i = begin; i < end; ++i) {
+                for (int k = 0; k < 3; ++k) {
+                    b[k] = std::min(b[k], means_ptr[i * 3 + k]);
+                    b[3 + k] = std::max(b[3 + k], means_ptr[i * 3 + k]);
+                }
+            }
+            return b;
+        },
+        [](Bounds a, const Bounds &b) {
+            for (int k = 0; k < 3; ++k) {
+                a[k] = std::min(a[k], b[k]);
+                a[3 + k] = std::max(a[3 + k], b[3 + k]);
+            }
+            return a;
+        }
+    );
+    float lengths[3];
+    for (int k = 0; k < 3; ++k) {
+        lengths[k] = bounds[3 + k] - bounds[k];
+        lengths[k] = lengths[k] == 0.f ? 1.f : lengths[k];
+    }
+
+    auto opt = means.options();
+    at::Tensor keys = at::empty({N}, opt.dtype(at::kLong));
+    at::Tensor values = at::empty({N}, opt.dtype(at::kInt));
+    at::Tensor keys_sorted = at::empty({N}, opt.dtype(at::kLong));
+    at::Tensor values_sorted = at::empty({N}, opt.dtype(at::kInt));
+    int64_t *keys_ptr = keys.data_ptr<int64_t>();
+    int32_t *values_ptr = values.data_ptr<int32_t>();
+    at::parallel_for(0, N, EXPORT_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            uint32_t cells[3];
+            for (int k = 0; k < 3; ++k) {
+                float u = (means_ptr[i * 3 + k] - bounds[k]) / lengths[k];
+                u = u * 1024.f;
+                // the maximum (1024) wraps to 0 like in `part1by2_vec`
+                cells[k] = static_cast<uint32_t>(std::floor(u)) & 0x3FF;
+            }
+            keys_ptr[i] = (expand_bits_10(cells[2]) << 2) |
+                          (expand_bits_10(cells[1]) << 1) |
+                          expand_bits_10(cells[0]);
+            values_ptr[i] = static_cast<int32_t>(i);
+        }
+    });
+    // the radix sort is stable, like the argsort of `sort_centers`
+    radix_sort_double_buffer_cpu(
+        N, 0, 0, keys, values, keys_sorted, values_sorted
+    );
+    const int32_t *order = values_sorted.data_ptr<int32_t>();
+
+    const int64_t n_chunks = chunks.size(0);
+    at::parallel_for(0, n_chunks, 1, [&](int64_t first, int64_t last) {
+        for (int64_t c = first; c < last; ++c) {
+            const int64_t begin = c * chunk_size;
+            const int64_t end = std::min(begin + chunk_size, N);
+
+            // min/max of the positions, scales and colors
+            float *chunk = chunks_ptr + c * 18;
+            for (int k = 0; k < 3; ++k) {
+                chunk[k] = chunk[6 + k] = chunk[12 + k] = inf;
+                chunk[3 + k] = chunk[9 + k] = chunk[15 + k] = -inf;
+            }
+            for (int64_t j = begin; j < end; ++j) {
+                const float *mean = means_ptr + order[j] * 3;
+                const float *scale = scales_ptr + order[j] * 3;
+                const float *color = colors_ptr + order[j] * 3;
+                for (int k = 0; k < 3; ++k) {
+                    chunk[k] = std::min(chunk[k], mean[k]);
+                    chunk[3 + k] = std::max(chunk[3 + k], mean[k]);
+                    chunk[6 + k] = std::min(chunk[6 + k], scale[k]);
+                    chunk[9 + k] = std::max(chunk[9 + k], scale[k]);
+                    chunk[12 + k] = std::min(chunk[12 + k], color[k]);
+                    chunk[15 + k] = std::max(chunk[15 + k], color[k]);
+                }
+            }
+            for (int k = 0; k < 3; ++k) {
+                chunk[6 + k] = std::min(std::max(chunk[6 + k], -20.f), 20.f);
+                chunk[9 + k] = std::min(std::max(chunk[9 + k], -20.f), 20.f);
+            }
+
+            for (int64_t j = begin; j < end; ++j) {
+                const int64_t i = order[j];
+                uint32_t *packed = vertices_ptr + j * 4;
+                packed[0] = pack_111011(means_ptr + i * 3, chunk, chunk + 3);
+                packed[1] = pack_rotation(quats_ptr + i * 4);
+                packed[2] =
+                    pack_111011(scales_ptr + i * 3, chunk + 6, chunk + 9);
+                uint32_t color = pack_unorm(alphas_ptr[i], 8);
+                for (int k = 0; k < 3; ++k) {
+                    const float u = normalize(
+                        colors_ptr[i * 3 + k], chunk[12 + k], chunk[15 + k]
+                    );
+                    color |= pack_unorm(u, 8) << (24 - 8 * k);
+                }
+                packed[3] = color;
+                for (int64_t k = 0; k < S; ++k) {
+                    sh_ptr[j * S + k] = pack_sh(shN_ptr[i * S + k]);
+                }
+            }
+        }
+    });
+}
+
+} // namespace gsplat
@@ -0,0 +1,83 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <tuple>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h"       // where all the macros are defined
+#include "FrustumIndex.h" // where the CPU functions are declared
+#include "Ops.h"          // a collection of all gsplat operators
+
+namespace gsplat {
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> frustum_index_build(
+    const at::Tensor means, // [N, 3]
+    const at::Tensor radii, // [N]
+    const int64_t leaf_size
+) {
+    TORCH_CHECK(means.is_cpu(), "means must be a CPU tensor");
+    CHECK_CONTIGUOUS(means);
+    CHECK_INPUT_LIKE(radii, means);
+    TORCH_CHECK(leaf_size > 0, "leaf_size must be positive");
+    return frustum_index_build_cpu(means, radii, leaf_size);
+}
+
+void frustum_index_refit(
+    const at::Tensor order, // [N]
+    const at::Tensor means, // [N, 3]
+    const at::Tensor radii, // [N]
+    const int64_t leaf_size,
+    at::Tensor spheres,    // [N, 4]
+    at::Tensor node_bounds // [2P, 6]
+) {
+    TORCH_CHECK(means.is_cpu(), "means must be a CPU tensor");
+    CHECK_CONTIGUOUS(means);
+    CHECK_INPUT_LIKE(order, means);
+    CHECK_INPUT_LIKE(radii, means);
+    CHECK_INPUT_LIKE(spheres, means);
+    CHECK_INPUT_LIKE(node_bounds, means);
+    TORCH_CHECK(
+        order.size(0) == means.size(0),
+        "the number of Gaussians changed, the index has to be rebuilt"
+    );
+    frustum_index_refit_cpu(order, means, radii, leaf_size, spheres, node_bounds);
+}
+
+std::tuple<at::Tensor, at::Tensor> frustum_index_query(
+    const at::Tensor order,       // [N]
+    const at::Tensor spheres,     // [N, 4]
+    const at::Tensor node_bounds, // [2P, 6]
+    const int64_t leaf_size,
+    const at::Tensor viewmats, // [C, 4, 4]
+    const at::Tensor Ks,       // [C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float near_plane,
+    const float far_plane,
+    const float padding,
+    const CameraModelType camera_model
+) {
+    TORCH_CHECK(order.is_cpu(), "order must be a CPU tensor");
+    CHECK_CONTIGUOUS(order);
+    CHECK_INPUT_LIKE(spheres, order);
+    CHECK_INPUT_LIKE(node_bounds, order);
+    CHECK_INPUT_LIKE(viewmats, order);
+    CHECK_INPUT_LIKE(Ks, order);
+    return frustum_index_query_cpu(
+        order,
+        spheres,
+        node_bounds,
+        leaf_size,
+        viewmats,
+        Ks,
+        image_width,
+        image_height,
+        near_plane,
+        far_plane,
+        padding,
+        camera_model
+    );
+}
+
+} // namespace gsplat
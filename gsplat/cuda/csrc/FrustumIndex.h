@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+
+#include "Common.h"
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+// The frustum culling index only has a CPU implementation. It is a complete
+// binary tree of axis-aligned boxes over buckets of `leaf_size` Gaussians in
+// Morton order, stored as a heap: node 1 is the root, the children of node i
+// are 2i and 2i + 1, and the P (a power of two) buckets are the nodes
+// [P, 2P). Node 0 is unused.
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> frustum_index_build_cpu(
+    const at::Tensor means, // [N, 3]
+    const at::Tensor radii, // [N]
+    const int64_t leaf_size
+);
+
+// Recompute the spheres and the boxes in place for new means and radii,
+// keeping the order of the Gaussians.
+void frustum_index_refit_cpu(
+    const at::Tensor order, // [N]
+    const at::Tensor means, // [N, 3]
+    const at::Tensor radii, // [N]
+    const int64_t leaf_size,
+    at::Tensor spheres,    // [N, 4]
+    at::Tensor node_bounds // [2P, 6]
+);
+
+std::tuple<at::Tensor, at::Tensor> frustum_index_query_cpu(
+    const at::Tensor order,       // [N]
+    const at::Tensor spheres,     // [N, 4]
+    const at::Tensor node_bounds, // [2P, 6]
+    const int64_t leaf_size,
+    const at::Tensor viewmats, // [C, 4, 4]
+    const at::Tensor Ks,       // [C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float near_plane,
+    const float far_plane,
+    const float padding,
+    const CameraModelType camera_model
+);
+
+} // namespace gsplat
@@ -0,0 +1,396 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Functions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "Common.h"
+#include "FrustumIndex.h"
+#include "Intersect.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Depth of the subtrees traversed by one task of the query. Fixed so that the
+// output does not depend on the number of threads.
+constexpr int FRUSTUM_TASK_LEVEL = 6;
+
+// Number of buckets rounded up to a power of two.
+inline int64_t frustum_index_n_leaves(const int64_t N, const int64_t leaf_size) {
+    int64_t P = 1;
+    while (P * leaf_size < N) {
+        P *= 2;
+    }
+    return P;
+}
+
+// A frustum is the intersection of the half-spaces dot(normal, x) + offset >= 0,
+// in world space.
+struct FrustumCPU {
+    vec3 normals[6];
+    float offsets[6];
+    int n_planes;
+};
+
+// The frustum of a camera, widened by `padding` pixels on each side of the
+// image. Only the depth planes are used for the fisheye and ftheta models.
+template <typename scalar_t>
+FrustumCPU load_frustum(
+    const scalar_t *viewmat, // [4, 4]
+    const scalar_t *K,       // [3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float near_plane,
+    const float far_plane,
+    const float padding,
+    const CameraModelType camera_model
+) {
+    // camera-space planes
+    vec3 normals[6];
+    float offsets[6];
+    int n = 0;
+    auto add_plane = [&](const vec3 &normal, const float offset) {
+        normals[n] = normal;
+        offsets[n++] = offset;
+    };
+    add_plane(vec3(0.f, 0.f, 1.f), -near_plane);
+    add_plane(vec3(0.f, 0.f, -1.f), far_plane);
+
+    const float fx = K[0], cx = K[2], fy = K[4], cy = K[5];
+    const float x_lo = (-padding - cx) / fx;
+    const float x_hi = (image_width + padding - cx) / fx;
+    const float y_lo = (-padding - cy) / fy;
+    const float y_hi = (image_height + padding - cy) / fy;
+    if (camera_model == CameraModelType::PINHOLE) {
+        // x_lo * z <= x <= x_hi * z, same for y
+        add_plane(vec3(1.f, 0.f, -x_lo), 0.f);
+        add_plane(vec3(-1.f, 0.f, x_hi), 0.f);
+        add_plane(vec3(0.f, 1.f, -y_lo), 0.f);
+        add_plane(vec3(0.f, -1.f, y_hi), 0.f);
+    } else if (camera_model == CameraModelType::ORTHO) {
+        add_plane(vec3(1.f, 0.f, 0.f), -x_lo);
+        add_plane(vec3(-1.f, 0.f, 0.f), x_hi);
+        add_plane(vec3(0.f, 1.f, 0.f), -y_lo);
+        add_plane(vec3(0.f, -1.f, 0.f), y_hi);
+    }
+
+    // to world space: dot(n, R x + t) + d = dot(R^T n, x) + dot(n, t) + d
+    mat3 R = mat3(
+        viewmat[0],
+        viewmat[4],
+        viewmat[8], // 1st column
+        viewmat[1],
+        viewmat[5],
+        viewmat[9], // 2nd column
+        viewmat[2],
+        viewmat[6],
+        viewmat[10] // 3rd column
+    );
+    vec3 t = vec3(viewmat[3], viewmat[7], viewmat[11]);
+    FrustumCPU frustum;
+    frustum.n_planes = n;
+    for (int i = 0; i < n; ++i) {
+        // unit normals so that the offsets are distances
+        const float inv_norm = 1.f / glm::length(normals[i]);
+        frustum.normals[i] = glm::transpose(R) * normals[i] * inv_norm;
+        frustum.offsets[i] =
+            (glm::dot(normals[i], t) + offsets[i]) * inv_norm;
+    }
+    return frustum;
+}
+
+enum class FrustumOverlap { OUTSIDE, PARTIAL, INSIDE };
+
+inline FrustumOverlap
+box_frustum_overlap(const FrustumCPU &frustum, const float *bound) {
+    const vec3 lo(bound[0], bound[1], bound[2]);
+    const vec3 hi(bound[3], bound[4], bound[5]);
+    if (!(lo.x <= hi.x)) {
+        return FrustumOverlap::OUTSIDE; // empty node
+    }
+    const vec3 center = 0.5f * (lo + hi), half = 0.5f * (hi - lo);
+    FrustumOverlap overlap = FrustumOverlap::INSIDE;
+    for (int i = 0; i < frustum.n_planes; ++i) {
+        const vec3 &n = frustum.normals[i];
+        const float dist = glm::dot(n, center) + frustum.offsets[i];
+        const float extent = std::fabs(n.x) * half.x +
+                             std::fabs(n.y) * half.y + std::fabs(n.z) * half.z;
+        if (dist + extent < 0.f) {
+            return FrustumOverlap::OUTSIDE;
+        }
+        if (dist - extent < 0.f) {
+            overlap = FrustumOverlap::PARTIAL;
+        }
+    }
+    return overlap;
+}
+
+inline bool sphere_in_frustum(const FrustumCPU &frustum, const float *sphere) {
+    const vec3 center(sphere[0], sphere[1], sphere[2]);
+    for (int i = 0; i < frustum.n_planes; ++i) {
+        if (glm::dot(frustum.normals[i], center) + frustum.offsets[i] <
+            -sphere[3]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void frustum_index_refit_cpu(
+    const at::Tensor order, // [N]
+    const at::Tensor means, // [N, 3]
+    const at::Tensor radii, // [N]
+    const int64_t leaf_size,
+    at::Tensor spheres,    // [N, 4]
+    at::Tensor node_bounds // [2P, 6]
+) {
+    const int64_t N = means.size(0);
+    const int64_t P = node_bounds.size(0) / 2;
+
+    AT_DISPATCH_FLOATING_TYPES(
+        means.scalar_type(),
+        "frustum_index_refit_cpu",
+        [&]() {
+            const int64_t *order_ptr = order.data_ptr<int64_t>();
+            const scalar_t *means_ptr = means.data_ptr<scalar_t>();
+            const scalar_t *radii_ptr = radii.data_ptr<scalar_t>();
+            float *spheres_ptr = spheres.data_ptr<float>();
+            float *bounds_ptr = node_bounds.data_ptr<float>();
+
+            // buckets
+            at::parallel_for(0, P, 64, [&](int64_t begin, int64_t end) {
+                for (int64_t b = begin; b < end; ++b) {
+                    vec3 lo(std::numeric_limits<float>::infinity());
+                    vec3 hi(-std::numeric_limits<float>::infinity());
+                    const int64_t lo_idx = std::min(b * leaf_size, N);
+                    const int64_t hi_idx = std::min(lo_idx + leaf_size, N);
+                    for (int64_t i = lo_idx; i < hi_idx; ++i) {
+                        const int64_t g = order_ptr[i];
+                        float *sphere = spheres_ptr + i * 4;
+                        for (int k = 0; k < 3; ++k) {
+                            sphere[k] = means_ptr[g * 3 + k];
+                        }
+                        sphere[3] = radii_ptr[g];
+                        for (int k = 0; k < 3; ++k) {
+                            lo[k] = std::min(lo[k], sphere[k] - sphere[3]);
+                            hi[k] = std::max(hi[k], sphere[k] + sphere[3]);
+                        }
+                    }
+                    float *bound = bounds_ptr + (P + b) * 6;
+                    for (int k = 0; k < 3; ++k) {
+                        bound[k] = lo[k];
+                        bound[3 + k] = hi[k];
+                    }
+                }
+            });
+
+            // inner nodes, one level at a time
+            for (int64_t level = P / 2; level >= 1; level /= 2) {
+                at::parallel_for(
+                    level, 2 * level, 256, [&](int64_t begin, int64_t end) {
+                        for (int64_t i = begin; i < end; ++i) {
+                            const float *left = bounds_ptr + 2 * i * 6;
+                            const float *right = left + 6;
+                            float *bound = bounds_ptr + i * 6;
+                            for (int k = 0; k < 3; ++k) {
+                                bound[k] = std::min(left[k], right[k]);
+                                bound[3 + k] = std::max(left[3 + k], right[3 + k]);
+                            }
+                        }
+                    }
+                );
+            }
+        }
+    );
+}
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> frustum_index_build_cpu(
+    const at::Tensor means, // [N, 3]
+    const at::Tensor radii, // [N]
+    const int64_t leaf_size
+) {
+    const int64_t N = means.size(0);
+    const int64_t P = frustum_index_n_leaves(N, leaf_size);
+    auto opt = means.options();
+
+    at::Tensor order = at::empty({N}, opt.dtype(at::kLong));
+    at::Tensor spheres = at::empty({N, 4}, opt.dtype(at::kFloat));
+    at::Tensor node_bounds = at::empty({2 * P, 6}, opt.dtype(at::kFloat));
+
+    if (N > 0) {
+        // Morton order of the means within their bounding box
+        at::Tensor keys = at::empty({N}, opt.dtype(at::kLong));
+        at::Tensor values = at::empty({N}, opt.dtype(at::kInt));
+        at::Tensor keys_sorted = at::empty({N}, opt.dtype(at::kLong));
+        at::Tensor values_sorted = at::empty({N}, opt.dtype(at::kInt));
+        AT_DISPATCH_FLOATING_TYPES(
+            means.scalar_type(),
+            "frustum_index_build_cpu",
+            [&]() {
+                const scalar_t *means_ptr = means.data_ptr<scalar_t>();
+                vec3 lo(std::numeric_limits<float>::max());
+                vec3 hi(std::numeric_limits<float>::lowest());
+                for (int64_t i = 0; i < N; ++i) {
+                    for (int k = 0; k < 3; ++k) {
+                        lo[k] = std::min<float>(lo[k], means_ptr[i * 3 + k]);
+                        hi[k] = std::max<float>(hi[k], means_ptr[i * 3 + k]);
+                    }
+                }
+                const vec3 extent = glm::max(hi - lo, vec3(1e-12f));
+
+                int64_t *keys_ptr = keys.data_ptr<int64_t>();
+                int32_t *values_ptr = values.data_ptr<int32_t>();
+                at::parallel_for(0, N, 4096, [&](int64_t begin, int64_t end) {
+                    for (int64_t i = begin; i < end; ++i) {
+                        const vec3 p = (vec3(
+                                            means_ptr[i * 3],
+                                            means_ptr[i * 3 + 1],
+                                            means_ptr[i * 3 + 2]
+                                        ) -
+                                        lo) /
+                                       extent;
+                        keys_ptr[i] = morton_code_30(p.x, p.y, p.z);
+                        values_ptr[i] = i;
+                    }
+                });
+            }
+        );
+        // the codes have 30 bits, the upper passes are skipped
+        radix_sort_double_buffer_cpu(
+            N, 0, 0, keys, values, keys_sorted, values_sorted
+        );
+        const int32_t *sorted_ptr = values_sorted.data_ptr<int32_t>();
+        std::copy_n(sorted_ptr, N, order.data_ptr<int64_t>());
+    }
+
+    // node 0 is unused
+    float *root_ptr = node_bounds.data_ptr<float>();
+    std::fill_n(root_ptr, 6, 0.f);
+    frustum_index_refit_cpu(order, means, radii, leaf_size, spheres, node_bounds);
+    return std::make_tuple(order, spheres, node_bounds);
+}
+
+std::tuple<at::Tensor, at::Tensor> frustum_index_query_cpu(
+    const at::Tensor order,       // [N]
+    const at::Tensor spheres,     // [N, 4]
+    const at::Tensor node_bounds, // [2P, 6]
+    const int64_t leaf_size,
+    const at::Tensor viewmats, // [C, 4, 4]
+    const at::Tensor Ks,       // [C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float near_plane,
+    const float far_plane,
+    const float padding,
+    const CameraModelType camera_model
+) {
+    const int64_t N = order.size(0);
+    const int64_t P = node_bounds.size(0) / 2;
+    const int64_t C = viewmats.size(0);
+    auto opt = order.options();
+
+    std::vector<FrustumCPU> frustums(C);
+    AT_DISPATCH_FLOATING_TYPES(
+        viewmats.scalar_type(),
+        "frustum_index_query_cpu",
+        [&]() {
+            const scalar_t *viewmats_ptr = viewmats.data_ptr<scalar_t>();
+            const scalar_t *Ks_ptr = Ks.data_ptr<scalar_t>();
+            for (int64_t cid = 0; cid < C; ++cid) {
+                frustums[cid] = load_frustum(
+                    viewmats_ptr + cid * 16,
+                    Ks_ptr + cid * 9,
+                    image_width,
+                    image_height,
+                    near_plane,
+                    far_plane,
+                    padding,
+                    camera_model
+                );
+            }
+        }
+    );
+
+    // Every camera is split into the subtrees at a fixed level, each
+    // traversed by one task into its own list of sorted positions.
+    int64_t n_roots = 1;
+    for (int l = 0; l < FRUSTUM_TASK_LEVEL && n_roots < P; ++l) {
+        n_roots *= 2;
+    }
+    const int64_t n_tasks = C * n_roots;
+    const float *spheres_ptr = spheres.data_ptr<float>();
+    const float *bounds_ptr = node_bounds.data_ptr<float>();
+    std::vector<std::vector<int64_t>> task_hits(n_tasks);
+    at::parallel_for(0, n_tasks, 1, [&](int64_t begin, int64_t end) {
+        std::vector<int64_t> stack;
+        for (int64_t task = begin; task < end; ++task) {
+            const FrustumCPU &frustum = frustums[task / n_roots];
+            std::vector<int64_t> &hits = task_hits[task];
+            stack.assign(1, n_roots + task % n_roots);
+            while (!stack.empty()) {
+                const int64_t node = stack.back();
+                stack.pop_back();
+                const FrustumOverlap overlap =
+                    box_frustum_overlap(frustum, bounds_ptr + node * 6);
+                if (overlap == FrustumOverlap::OUTSIDE) {
+                    continue;
+                }
+                // positions covered by the node
+                int64_t span = 1, first = node;
+                while (first < P) {
+                    first *= 2, span *= 2;
+                }
+                const int64_t lo = std::min((first - P) * leaf_size, N);
+                const int64_t hi = std::min(lo + span * leaf_size, N);
+                if (overlap == FrustumOverlap::INSIDE) {
+                    for (int64_t i = lo; i < hi; ++i) {
+                        hits.push_back(i);
+                    }
+                } else if (node >= P) {
+                    for (int64_t i = lo; i < hi; ++i) {
+                        if (sphere_in_frustum(frustum, spheres_ptr + i * 4)) {
+                            hits.push_back(i);
+                        }
+                    }
+                } else {
+                    // visit the left child first
+                    stack.push_back(2 * node + 1);
+                    stack.push_back(2 * node);
+                }
+            }
+        }
+    });
+
+    // Offsets of the tasks in the output. The candidates are grouped by camera
+    // and follow the order of the index within a camera.
+    std::vector<int64_t> task_offsets(n_tasks + 1, 0);
+    for (int64_t task = 0; task < n_tasks; ++task) {
+        task_offsets[task + 1] = task_offsets[task] + task_hits[task].size();
+    }
+    const int64_t nnz = task_offsets[n_tasks];
+    at::Tensor camera_ids = at::empty({nnz}, opt);
+    at::Tensor gaussian_ids = at::empty({nnz}, opt);
+    int64_t *camera_ids_ptr = camera_ids.data_ptr<int64_t>();
+    int64_t *gaussian_ids_ptr = gaussian_ids.data_ptr<int64_t>();
+    const int64_t *order_ptr = order.data_ptr<int64_t>();
+    at::parallel_for(0, n_tasks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t task = begin; task < end; ++task) {
+            int64_t k = task_offsets[task];
+            for (const int64_t i : task_hits[task]) {
+                camera_ids_ptr[k] = task / n_roots;
+                gaussian_ids_ptr[k++] = order_ptr[i];
+            }
+        }
+    });
+    return std::make_tuple(camera_ids, gaussian_ids);
+}
+
+} // namespace gsplat
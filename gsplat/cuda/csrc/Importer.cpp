@@ -0,0 +1,67 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <tuple>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h"   // where all the macros are defined
+#include "Importer.h" // where the CPU functions are declared
+#include "Ops.h"      // a collection of all gsplat operators
+
+namespace gsplat {
+
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+decode_ply_compressed(
+    const at::Tensor chunks,   // [n_chunks, 18] float32
+    const at::Tensor vertices, // [N, 4] int32 (bits of uint32)
+    const at::Tensor sh        // [N, 3K] uint8
+) {
+    TORCH_CHECK(chunks.is_cpu(), "chunks must be a CPU tensor");
+    CHECK_CONTIGUOUS(chunks);
+    CHECK_INPUT_LIKE(vertices, chunks);
+    CHECK_INPUT_LIKE(sh, chunks);
+    TORCH_CHECK(
+        chunks.scalar_type() == at::kFloat && chunks.dim() == 2 &&
+            chunks.size(1) == 18,
+        "chunks must be a float32 tensor of shape [n_chunks, 18]"
+    );
+    TORCH_CHECK(
+        vertices.scalar_type() == at::kInt && vertices.dim() == 2 &&
+            vertices.size(1) == 4,
+        "vertices must be an int32 tensor of shape [N, 4]"
+    );
+    const int64_t N = vertices.size(0);
+    TORCH_CHECK(
+        chunks.size(0) * 256 >= N,
+        "there are not enough chunks for ",
+        N,
+        " splats"
+    );
+    TORCH_CHECK(
+        sh.scalar_type() == at::kByte && sh.dim() == 2 && sh.size(0) == N &&
+            sh.size(1) % 3 == 0,
+        "sh must be a uint8 tensor of shape [N, 3K]"
+    );
+    const int64_t K = sh.size(1) / 3;
+
+    auto opt = chunks.options();
+    at::Tensor means = at::empty({N, 3}, opt);
+    at::Tensor scales = at::empty({N, 3}, opt);
+    at::Tensor quats = at::empty({N, 4}, opt);
+    at::Tensor opacities = at::empty({N}, opt);
+    at::Tensor sh0 = at::empty({N, 1, 3}, opt);
+    at::Tensor shN = at::empty({N, K, 3}, opt);
+    decode_ply_compressed_cpu(
+        chunks, vertices, sh, means, scales, quats, opacities, sh0, shN
+    );
+    return std::make_tuple(means, scales, quats, opacities, sh0, shN);
+}
+
+} // namespace gsplat
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+// The importers only have a CPU implementation.
+
+// Decode the `ply_compressed` format written by `splat2ply_bytes_compressed`:
+// per chunk of 256 splats, the float bounds of the positions, scales and
+// colors, and per splat four packed words (11-10-11 position, 2-10-10-10
+// smallest-three rotation, 11-10-11 scale and 8-8-8-8 color and opacity) and
+// 8-bit SH coefficients.
+void decode_ply_compressed_cpu(
+    const at::Tensor chunks,   // [n_chunks, 18] float32
+    const at::Tensor vertices, // [N, 4] int32 (bits of uint32)
+    const at::Tensor sh,       // [N, 3K] uint8
+    // outputs
+    at::Tensor means,     // [N, 3]
+    at::Tensor scales,    // [N, 3]
+    at::Tensor quats,     // [N, 4]
+    at::Tensor opacities, // [N]
+    at::Tensor sh0,       // [N, 1, 3]
+    at::Tensor shN        // [N, K, 3]
+);
+
+} // namespace gsplat
@@ -0,0 +1,123 @@
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <cmath>
+
+#include "Common.h"
+#include "Importer.h"
+
+namespace gsplat {
+
+namespace {
+
+// Number of splats per chunk of the compressed format.
+constexpr int64_t PLY_COMPRESSED_CHUNK_SIZE = 256;
+
+// The zeroth order SH basis, to convert the colors back to coefficients.
+constexpr float SH_C0 = 0.28209479177387814f;
+
+inline float unpack_unorm(const uint32_t value, const int bits) {
+    return static_cast<float>(value) / ((1u << bits) - 1);
+}
+
+// 11-10-11 bits, x in the most significant ones.
+inline void unpack_111011(
+    const uint32_t value, const float *lo, const float *hi, float *out
+) {
+    const float u[3] = {
+        unpack_unorm(value >> 21, 11),
+        unpack_unorm((value >> 11) & 0x3FF, 10),
+        unpack_unorm(value & 0x7FF, 11)
+    };
+    for (int k = 0; k < 3; ++k) {
+        out[k] = lo[k] + (hi[k] - lo[k]) * u[k];
+    }
+}
+
+// The index of the largest component in the top 2 bits and the other three
+// in 10 bits each, scaled from [-1/sqrt(2), 1/sqrt(2)].
+inline void unpack_rotation(const uint32_t value, float *quat) {
+    const int largest = value >> 30;
+    const float norm = std::sqrt(2.f) * 0.5f;
+    float sum = 0.f;
+    for (int k = 0, c = 0; k < 4; ++k) {
+        if (k == largest) {
+            continue;
+        }
+        const uint32_t bits = (value >> (20 - 10 * c++)) & 0x3FF;
+        quat[k] = (unpack_unorm(bits, 10) - 0.5f) / norm;
+        sum += quat[k] * quat[k];
+    }
+    quat[largest] = std::sqrt(std::max(1.f - sum, 0.f));
+}
+
+} // namespace
+
+void decode_ply_compressed_cpu(
+    const at::Tensor chunks,   // [n_chunks, 18] float32
+    const at::Tensor vertices, // [N, 4] int32 (bits of uint32)
+    const at::Tensor sh,       // [N, 3K] uint8
+    // outputs
+    at::Tensor means,     // [N, 3]
+    at::Tensor scales,    // [N, 3]
+    at::Tensor quats,     // [N, 4]
+    at::Tensor opacities, // [N]
+    at::Tensor sh0,       // [N, 1, 3]
+    at::Tensor shN        // [N, K, 3]
+) {
+    const int64_t N = vertices.size(0);
+    const int64_t K = shN.size(1);
+    const float *chunks_ptr = chunks.data_ptr<float>();
+    const uint32_t *vertices_ptr =
+        reinterpret_cast<const uint32_t *>(vertices.data_ptr<int32_t>());
+    const uint8_t *sh_ptr = sh.data_ptr<uint8_t>();
+    float *means_ptr = means.data_ptr<float>();
+    float *scales_ptr = scales.data_ptr<float>();
+    float *quats_ptr = quats.data_ptr<float>();
+    float *opacities_ptr = opacities.data_ptr<float>();
+    float *sh0_ptr = sh0.data_ptr<float>();
+    float *shN_ptr = shN.data_ptr<float>();
+
+    // the SH coefficients are quantized to 8 bits in [-4, 4)
+    float sh_table[256];
+    for (int q = 0; q < 256; ++q) {
+        sh_table[q] = ((q + 0.5f) / 256.f - 0.5f) * 8.f;
+    }
+
+    at::parallel_for(0, N, 4096, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            // min/max of the positions, scales and colors
+            const float *chunk =
+                chunks_ptr + (i / PLY_COMPRESSED_CHUNK_SIZE) * 18;
+            const uint32_t *packed = vertices_ptr + i * 4;
+
+            unpack_111011(packed[0], chunk, chunk + 3, means_ptr + i * 3);
+            unpack_rotation(packed[1], quats_ptr + i * 4);
+            unpack_111011(packed[2], chunk + 6, chunk + 9, scales_ptr + i * 3);
+
+            const uint32_t color = packed[3];
+            for (int k = 0; k < 3; ++k) {
+                const float u = unpack_unorm((color >> (24 - 8 * k)) & 0xFF, 8);
+                const float rgb =
+                    chunk[12 + k] + (chunk[15 + k] - chunk[12 + k]) * u;
+                sh0_ptr[i * 3 + k] = (rgb - 0.5f) / SH_C0;
+            }
+            // the opacities are stored after the sigmoid
+            const float alpha = std::min(
+                std::max(unpack_unorm(color & 0xFF, 8), 1e-6f), 1.f - 1e-6f
+            );
+            opacities_ptr[i] = std::log(alpha / (1.f - alpha));
+
+            // f_rest_{c * K + k} = shN[i, k, c]
+            const uint8_t *q = sh_ptr + i * K * 3;
+            float *out = shN_ptr + i * K * 3;
+            for (int64_t k = 0; k < K; ++k) {
+                for (int c = 0; c < 3; ++c) {
+                    out[k * 3 + c] = sh_table[q[c * K + k]];
+                }
+            }
+        }
+    });
+}
+
+} // namespace gsplat
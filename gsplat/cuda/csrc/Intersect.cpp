@@ -26,20 +26,22 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> intersect_tile(
     const bool segmented
 ) {
     DEVICE_GUARD(means2d);
-    CHECK_INPUT(means2d);
-    CHECK_INPUT(radii);
-    CHECK_INPUT(depths);
+    CHECK_CUDA_OR_CPU(means2d);
+    CHECK_CONTIGUOUS(means2d);
+    CHECK_INPUT_LIKE(radii, means2d);
+    CHECK_INPUT_LIKE(depths, means2d);
 
     auto opt = depths.options();
     uint32_t n_elements = means2d.numel() / 2;
+    bool is_cpu = means2d.is_cpu();
     bool packed = means2d.dim() == 2;
     if (packed) {
         TORCH_CHECK(
             image_ids.has_value() && gaussian_ids.has_value(),
             "When packed is set, image_ids and gaussian_ids must be provided."
         );
-        CHECK_INPUT(image_ids.value());
-        CHECK_INPUT(gaussian_ids.value());
+        CHECK_INPUT_LIKE(image_ids.value(), means2d);
+        CHECK_INPUT_LIKE(gaussian_ids.value(), means2d);
     }
 
     uint32_t n_tiles = tile_width * tile_height;
@@ -58,8 +60,10 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> intersect_tile(
     int64_t n_isects;
     at::Tensor cum_tiles_per_gauss;
     at::Tensor offsets;
+    auto launch_intersect_tile = is_cpu ? launch_intersect_tile_kernel_cpu
+                                        : launch_intersect_tile_kernel;
     if (n_elements) {
-        launch_intersect_tile_kernel(
+        launch_intersect_tile(
             // inputs
             means2d,
             radii,
@@ -76,7 +80,15 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> intersect_tile(
             c10::nullopt, // isect_ids
             c10::nullopt  // flatten_ids
         );
-        cum_tiles_per_gauss = at::cumsum(tiles_per_gauss.view({-1}), 0);
+        if (is_cpu) {
+            cum_tiles_per_gauss =
+                at::empty({tiles_per_gauss.numel()}, opt.dtype(at::kLong));
+            inclusive_scan_cpu(
+                tiles_per_gauss.view({-1}), cum_tiles_per_gauss
+            );
+        } else {
+            cum_tiles_per_gauss = at::cumsum(tiles_per_gauss.view({-1}), 0);
+        }
         n_isects = cum_tiles_per_gauss[-1].item<int64_t>();
         if (segmented) {
             // offsets in the isect_ids and flatten_ids
@@ -96,7 +108,7 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> intersect_tile(
     at::Tensor isect_ids = at::empty({n_isects}, opt.dtype(at::kLong));
     at::Tensor flatten_ids = at::empty({n_isects}, opt.dtype(at::kInt));
     if (n_isects) {
-        launch_intersect_tile_kernel(
+        launch_intersect_tile(
             // inputs
             means2d,
             radii,
@@ -120,7 +132,10 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> intersect_tile(
         at::Tensor isect_ids_sorted = at::empty_like(isect_ids);
         at::Tensor flatten_ids_sorted = at::empty_like(flatten_ids);
         if (segmented) {
-            segmented_radix_sort_double_buffer(
+            auto sort_segments = is_cpu
+                                     ? segmented_radix_sort_double_buffer_cpu
+                                     : segmented_radix_sort_double_buffer;
+            sort_segments(
                 n_isects,
                 I,
                 image_n_bits,
@@ -132,7 +147,9 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> intersect_tile(
                 flatten_ids_sorted
             );
         } else {
-            radix_sort_double_buffer(
+            auto sort_all = is_cpu ? radix_sort_double_buffer_cpu
+                                   : radix_sort_double_buffer;
+            sort_all(
                 n_isects,
                 image_n_bits,
                 tile_n_bits,
@@ -155,13 +172,16 @@ at::Tensor intersect_offset(
     const uint32_t tile_height
 ) {
     DEVICE_GUARD(isect_ids);
-    CHECK_INPUT(isect_ids);
+    CHECK_CUDA_OR_CPU(isect_ids);
+    CHECK_CONTIGUOUS(isect_ids);
 
     auto opt = isect_ids.options();
     at::Tensor offsets = at::empty(
         {I, tile_height, tile_width}, opt.dtype(at::kInt)
     );
-    launch_intersect_offset_kernel(
+    auto launch = isect_ids.is_cpu() ? launch_intersect_offset_kernel_cpu
+                                     : launch_intersect_offset_kernel;
+    launch(
         isect_ids, I, tile_width, tile_height, offsets
     );
     return offsets;
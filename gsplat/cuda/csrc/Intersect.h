@@ -58,4 +58,61 @@ void segmented_radix_sort_double_buffer(
     at::Tensor flatten_ids_sorted
 );
 
+// CPU counterparts of the launchers above.
+void launch_intersect_tile_kernel_cpu(
+    // inputs
+    const at::Tensor means2d,                    // [..., N, 2] or [nnz, 2]
+    const at::Tensor radii,                      // [..., N, 2] or [nnz, 2]
+    const at::Tensor depths,                     // [..., N] or [nnz]
+    const at::optional<at::Tensor> image_ids,    // [nnz]
+    const at::optional<at::Tensor> gaussian_ids, // [nnz]
+    const uint32_t I,
+    const uint32_t tile_size,
+    const uint32_t tile_width,
+    const uint32_t tile_height,
+    const at::optional<at::Tensor> cum_tiles_per_gauss, // [..., N] or [nnz]
+    // outputs
+    at::optional<at::Tensor> tiles_per_gauss, // [..., N] or [nnz]
+    at::optional<at::Tensor> isect_ids,       // [n_isects]
+    at::optional<at::Tensor> flatten_ids      // [n_isects]
+);
+
+void launch_intersect_offset_kernel_cpu(
+    // inputs
+    const at::Tensor isect_ids, // [n_isects]
+    const uint32_t I,
+    const uint32_t tile_width,
+    const uint32_t tile_height,
+    // outputs
+    at::Tensor offsets // [..., tile_height, tile_width]
+);
+
+void radix_sort_double_buffer_cpu(
+    const int64_t n_isects,
+    const uint32_t image_n_bits,
+    const uint32_t tile_n_bits,
+    at::Tensor isect_ids,
+    at::Tensor flatten_ids,
+    at::Tensor isect_ids_sorted,
+    at::Tensor flatten_ids_sorted
+);
+
+void segmented_radix_sort_double_buffer_cpu(
+    const int64_t n_isects,
+    const uint32_t n_segments,
+    const uint32_t image_n_bits,
+    const uint32_t tile_n_bits,
+    const at::Tensor offsets,
+    at::Tensor isect_ids,
+    at::Tensor flatten_ids,
+    at::Tensor isect_ids_sorted,
+    at::Tensor flatten_ids_sorted
+);
+
+// Inclusive prefix sum of int32 counts into int64, parallel over blocks.
+void inclusive_scan_cpu(
+    const at::Tensor counts, // [n]
+    at::Tensor cumsum        // [n]
+);
+
 } // namespace gsplat
\ No newline at end of file
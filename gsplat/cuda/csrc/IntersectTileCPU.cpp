@@ -0,0 +1,463 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Common.h"
+#include "Intersect.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+////////////////////////////////////////////////////////////////
+// Tile intersection (CPU)
+////////////////////////////////////////////////////////////////
+
+template <typename scalar_t>
+void intersect_tile_cpu(
+    // if the data is [...,  N, ...] or [nnz, ...] (packed)
+    const bool packed,
+    // parallelize over I * N, only used if packed is False
+    const uint32_t I,
+    const uint32_t N,
+    // parallelize over nnz, only used if packed is True
+    const uint32_t nnz,
+    const int64_t *__restrict__ image_ids, // [nnz] optional
+    // data
+    const scalar_t *__restrict__ means2d,            // [..., N, 2] or [nnz, 2]
+    const int32_t *__restrict__ radii,               // [..., N, 2] or [nnz, 2]
+    const scalar_t *__restrict__ depths,             // [..., N] or [nnz]
+    const int64_t *__restrict__ cum_tiles_per_gauss, // [..., N] or [nnz]
+    const uint32_t tile_size,
+    const uint32_t tile_width,
+    const uint32_t tile_height,
+    const uint32_t tile_n_bits,
+    int32_t *__restrict__ tiles_per_gauss, // [..., N] or [nnz]
+    int64_t *__restrict__ isect_ids,       // [n_isects]
+    int32_t *__restrict__ flatten_ids      // [n_isects]
+) {
+    const bool first_pass = cum_tiles_per_gauss == nullptr;
+    const int64_t n_elements = packed ? nnz : (int64_t)I * N;
+
+    at::parallel_for(0, n_elements, 2048, [&](int64_t begin, int64_t end) {
+        for (int64_t idx = begin; idx < end; ++idx) {
+            const float radius_x = radii[idx * 2];
+            const float radius_y = radii[idx * 2 + 1];
+            if (radius_x <= 0 || radius_y <= 0) {
+                if (first_pass) {
+                    tiles_per_gauss[idx] = 0;
+                }
+                continue;
+            }
+
+            const float tile_radius_x = radius_x / static_cast<float>(tile_size);
+            const float tile_radius_y = radius_y / static_cast<float>(tile_size);
+            const float tile_x = means2d[idx * 2] / static_cast<float>(tile_size);
+            const float tile_y =
+                means2d[idx * 2 + 1] / static_cast<float>(tile_size);
+
+            // tile_min is inclusive, tile_max is exclusive. Clamp in float:
+            // unlike on the GPU, casting a negative float to uint32_t does not
+            // saturate to zero on the host.
+            auto clamp_tile = [](const float x, const uint32_t hi) {
+                return static_cast<uint32_t>(
+                    std::min(std::max(x, 0.f), static_cast<float>(hi))
+                );
+            };
+            const uint32_t tile_min_x =
+                clamp_tile(std::floor(tile_x - tile_radius_x), tile_width);
+            const uint32_t tile_min_y =
+                clamp_tile(std::floor(tile_y - tile_radius_y), tile_height);
+            const uint32_t tile_max_x =
+                clamp_tile(std::ceil(tile_x + tile_radius_x), tile_width);
+            const uint32_t tile_max_y =
+                clamp_tile(std::ceil(tile_y + tile_radius_y), tile_height);
+
+            if (first_pass) {
+                // first pass only writes out tiles_per_gauss
+                tiles_per_gauss[idx] = static_cast<int32_t>(
+                    (tile_max_y - tile_min_y) * (tile_max_x - tile_min_x)
+                );
+                continue;
+            }
+
+            // image id
+            const int64_t iid = packed ? image_ids[idx] : idx / N;
+            const int64_t iid_enc = iid << (32 + tile_n_bits);
+
+            // the raw bits of the depth, zero-extended to 64-bit
+            const float depth = depths[idx];
+            uint32_t depth_u32;
+            std::memcpy(&depth_u32, &depth, sizeof(float));
+            const int64_t depth_id_enc = static_cast<int64_t>(depth_u32);
+
+            int64_t cur_idx = (idx == 0) ? 0 : cum_tiles_per_gauss[idx - 1];
+            for (uint32_t i = tile_min_y; i < tile_max_y; ++i) {
+                for (uint32_t j = tile_min_x; j < tile_max_x; ++j) {
+                    const int64_t tile_id = i * tile_width + j;
+                    // image id | tile id | depth (32 bits)
+                    isect_ids[cur_idx] = iid_enc | (tile_id << 32) | depth_id_enc;
+                    // the flatten index in [I * N] or [nnz]
+                    flatten_ids[cur_idx] = static_cast<int32_t>(idx);
+                    ++cur_idx;
+                }
+            }
+        }
+    });
+}
+
+void launch_intersect_tile_kernel_cpu(
+    // inputs
+    const at::Tensor means2d,                    // [..., N, 2] or [nnz, 2]
+    const at::Tensor radii,                      // [..., N, 2] or [nnz, 2]
+    const at::Tensor depths,                     // [..., N] or [nnz]
+    const at::optional<at::Tensor> image_ids,    // [nnz]
+    const at::optional<at::Tensor> gaussian_ids, // [nnz]
+    const uint32_t I,
+    const uint32_t tile_size,
+    const uint32_t tile_width,
+    const uint32_t tile_height,
+    const at::optional<at::Tensor> cum_tiles_per_gauss, // [..., N] or [nnz]
+    // outputs
+    at::optional<at::Tensor> tiles_per_gauss, // [..., N] or [nnz]
+    at::optional<at::Tensor> isect_ids,       // [n_isects]
+    at::optional<at::Tensor> flatten_ids      // [n_isects]
+) {
+    bool packed = means2d.dim() == 2;
+
+    uint32_t N = 0, nnz = 0;
+    int64_t n_elements;
+    if (packed) {
+        nnz = means2d.size(0); // total number of gaussians
+        n_elements = nnz;
+    } else {
+        N = means2d.size(-2); // number of gaussians per image
+        n_elements = I * N;
+    }
+
+    uint32_t n_tiles = tile_width * tile_height;
+    uint32_t tile_n_bits = (uint32_t)floor(log2(n_tiles)) + 1;
+
+    if (n_elements == 0) {
+        return;
+    }
+
+    AT_DISPATCH_FLOATING_TYPES(
+        means2d.scalar_type(),
+        "intersect_tile_cpu",
+        [&]() {
+            intersect_tile_cpu<scalar_t>(
+                packed,
+                I,
+                N,
+                nnz,
+                image_ids.has_value() ? image_ids.value().data_ptr<int64_t>()
+                                      : nullptr,
+                means2d.data_ptr<scalar_t>(),
+                radii.data_ptr<int32_t>(),
+                depths.data_ptr<scalar_t>(),
+                cum_tiles_per_gauss.has_value()
+                    ? cum_tiles_per_gauss.value().data_ptr<int64_t>()
+                    : nullptr,
+                tile_size,
+                tile_width,
+                tile_height,
+                tile_n_bits,
+                tiles_per_gauss.has_value()
+                    ? tiles_per_gauss.value().data_ptr<int32_t>()
+                    : nullptr,
+                isect_ids.has_value() ? isect_ids.value().data_ptr<int64_t>()
+                                      : nullptr,
+                flatten_ids.has_value()
+                    ? flatten_ids.value().data_ptr<int32_t>()
+                    : nullptr
+            );
+        }
+    );
+}
+
+// Blocked scan: every block sums its range, the block sums are scanned
+// serially (there are only as many as threads), then every block scans its
+// range starting from its offset.
+void inclusive_scan_cpu(
+    const at::Tensor counts, // [n] int32
+    at::Tensor cumsum        // [n] int64
+) {
+    const int64_t n = counts.numel();
+    const int32_t *counts_ptr = counts.data_ptr<int32_t>();
+    int64_t *cumsum_ptr = cumsum.data_ptr<int64_t>();
+    if (n == 0) {
+        return;
+    }
+
+    const int64_t grain = 1 << 16;
+    const int64_t n_blocks = std::max<int64_t>(
+        1, std::min<int64_t>(at::get_num_threads(), (n + grain - 1) / grain)
+    );
+    const int64_t block_size = (n + n_blocks - 1) / n_blocks;
+
+    std::vector<int64_t> block_sums(n_blocks + 1, 0);
+    at::parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+            const int64_t lo = b * block_size;
+            const int64_t hi = std::min(n, lo + block_size);
+            int64_t sum = 0;
+            for (int64_t i = lo; i < hi; ++i) {
+                sum += counts_ptr[i];
+            }
+            block_sums[b + 1] = sum;
+        }
+    });
+    for (int64_t b = 0; b < n_blocks; ++b) {
+        block_sums[b + 1] += block_sums[b];
+    }
+    at::parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+            const int64_t lo = b * block_size;
+            const int64_t hi = std::min(n, lo + block_size);
+            int64_t sum = block_sums[b];
+            for (int64_t i = lo; i < hi; ++i) {
+                sum += counts_ptr[i];
+                cumsum_ptr[i] = sum;
+            }
+        }
+    });
+}
+
+////////////////////////////////////////////////////////////////
+// Intersection offsets (CPU)
+////////////////////////////////////////////////////////////////
+
+void launch_intersect_offset_kernel_cpu(
+    // inputs
+    const at::Tensor isect_ids, // [n_isects]
+    const uint32_t I,
+    const uint32_t tile_width,
+    const uint32_t tile_height,
+    // outputs
+    at::Tensor offsets // [I, tile_height, tile_width]
+) {
+    const int64_t n_isects = isect_ids.size(0);
+    int32_t *offsets_ptr = offsets.data_ptr<int32_t>();
+    const uint32_t n_tiles = tile_width * tile_height;
+    const int64_t n_offsets = (int64_t)I * n_tiles;
+
+    if (n_isects == 0) {
+        std::fill_n(offsets_ptr, n_offsets, 0);
+        return;
+    }
+
+    const uint32_t tile_n_bits = (uint32_t)floor(log2(n_tiles)) + 1;
+    const int64_t *isect_ids_ptr = isect_ids.data_ptr<int64_t>();
+    auto image_tile_id = [&](const int64_t idx) {
+        const int64_t isect_id = isect_ids_ptr[idx] >> 32; // shift out depth
+        const int64_t iid = isect_id >> tile_n_bits;
+        const int64_t tid = isect_id & ((1 << tile_n_bits) - 1);
+        return iid * n_tiles + tid;
+    };
+
+    // Same as the CUDA kernel: every intersection where the (image, tile)
+    // pair changes writes the offsets of the tiles in between, so the writes
+    // of different intersections never overlap.
+    at::parallel_for(0, n_isects, 4096, [&](int64_t begin, int64_t end) {
+        for (int64_t idx = begin; idx < end; ++idx) {
+            const int64_t id_curr = image_tile_id(idx);
+            if (idx == 0) {
+                // write out the offsets until the first valid tile
+                // (inclusive)
+                std::fill_n(offsets_ptr, id_curr + 1, 0);
+            }
+            if (idx == n_isects - 1) {
+                // write out the rest of the offsets
+                std::fill(
+                    offsets_ptr + id_curr + 1,
+                    offsets_ptr + n_offsets,
+                    static_cast<int32_t>(n_isects)
+                );
+            }
+            if (idx > 0) {
+                const int64_t id_prev = image_tile_id(idx - 1);
+                if (id_prev != id_curr) {
+                    // write out the offsets between the previous and
+                    // current tiles
+                    std::fill(
+                        offsets_ptr + id_prev + 1,
+                        offsets_ptr + id_curr + 1,
+                        static_cast<int32_t>(idx)
+                    );
+                }
+            }
+        }
+    });
+}
+
+////////////////////////////////////////////////////////////////
+// Radix sort (CPU)
+////////////////////////////////////////////////////////////////
+
+namespace {
+
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX_SIZE = 1 << RADIX_BITS;
+
+// Stable LSD radix sort of (key, value) pairs on the bits [0, end_bit) of the
+// keys, 8 bits per pass. The range is split into one block per thread; each
+// pass histograms the blocks in parallel, turns the histograms into
+// per-(digit, block) output offsets, then scatters the blocks in parallel.
+// Passes whose digit is the same for every key are skipped. Returns true if
+// the sorted pairs ended up in the alternate buffers.
+bool radix_sort_pairs_cpu(
+    const int64_t n,
+    const uint32_t end_bit,
+    int64_t *keys,
+    int32_t *values,
+    int64_t *keys_alt,
+    int32_t *values_alt
+) {
+    const int64_t grain = 1 << 14;
+    const int64_t n_blocks = std::max<int64_t>(
+        1, std::min<int64_t>(at::get_num_threads(), (n + grain - 1) / grain)
+    );
+    const int64_t block_size = (n + n_blocks - 1) / n_blocks;
+    std::vector<int64_t> hist(n_blocks * RADIX_SIZE);
+
+    bool swapped = false;
+    for (uint32_t shift = 0; shift < end_bit; shift += RADIX_BITS) {
+        // only look at the bits below end_bit
+        const uint64_t mask =
+            end_bit - shift >= RADIX_BITS ? RADIX_SIZE - 1
+                                          : (1u << (end_bit - shift)) - 1;
+        auto digit = [&](const int64_t key) {
+            return (static_cast<uint64_t>(key) >> shift) & mask;
+        };
+
+        at::parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+            for (int64_t b = begin; b < end; ++b) {
+                int64_t *h = hist.data() + b * RADIX_SIZE;
+                std::fill_n(h, RADIX_SIZE, 0);
+                const int64_t hi = std::min(n, (b + 1) * block_size);
+                for (int64_t i = b * block_size; i < hi; ++i) {
+                    h[digit(keys[i])]++;
+                }
+            }
+        });
+
+        // exclusive scan in (digit, block) order keeps the sort stable
+        int64_t sum = 0;
+        bool trivial = false;
+        for (uint32_t d = 0; d < RADIX_SIZE; ++d) {
+            int64_t digit_count = 0;
+            for (int64_t b = 0; b < n_blocks; ++b) {
+                int64_t &h = hist[b * RADIX_SIZE + d];
+                const int64_t count = h;
+                h = sum;
+                sum += count;
+                digit_count += count;
+            }
+            trivial |= digit_count == n;
+        }
+        if (trivial) {
+            // all the keys share this digit, nothing to do
+            continue;
+        }
+
+        at::parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+            for (int64_t b = begin; b < end; ++b) {
+                int64_t *h = hist.data() + b * RADIX_SIZE;
+                const int64_t hi = std::min(n, (b + 1) * block_size);
+                for (int64_t i = b * block_size; i < hi; ++i) {
+                    const int64_t pos = h[digit(keys[i])]++;
+                    keys_alt[pos] = keys[i];
+                    values_alt[pos] = values[i];
+                }
+            }
+        });
+        std::swap(keys, keys_alt);
+        std::swap(values, values_alt);
+        swapped = !swapped;
+    }
+    return swapped;
+}
+
+} // namespace
+
+// Same contract as `radix_sort_double_buffer`: the sorted pairs are returned
+// in isect_ids_sorted / flatten_ids_sorted, which are pointed at the input
+// storage if that is where the last pass wrote them.
+void radix_sort_double_buffer_cpu(
+    const int64_t n_isects,
+    const uint32_t image_n_bits,
+    const uint32_t tile_n_bits,
+    at::Tensor isect_ids,
+    at::Tensor flatten_ids,
+    at::Tensor isect_ids_sorted,
+    at::Tensor flatten_ids_sorted
+) {
+    if (n_isects <= 0) {
+        return;
+    }
+
+    const bool swapped = radix_sort_pairs_cpu(
+        n_isects,
+        32 + tile_n_bits + image_n_bits,
+        isect_ids.data_ptr<int64_t>(),
+        flatten_ids.data_ptr<int32_t>(),
+        isect_ids_sorted.data_ptr<int64_t>(),
+        flatten_ids_sorted.data_ptr<int32_t>()
+    );
+    if (!swapped) {
+        // sorted items are stored in isect_ids / flatten_ids
+        isect_ids_sorted.set_(isect_ids);
+        flatten_ids_sorted.set_(flatten_ids);
+    }
+}
+
+void segmented_radix_sort_double_buffer_cpu(
+    const int64_t n_isects,
+    const uint32_t n_segments,
+    const uint32_t image_n_bits,
+    const uint32_t tile_n_bits,
+    const at::Tensor offsets,
+    at::Tensor isect_ids,
+    at::Tensor flatten_ids,
+    at::Tensor isect_ids_sorted,
+    at::Tensor flatten_ids_sorted
+) {
+    if (n_isects <= 0) {
+        return;
+    }
+
+    // image dimensions are contiguous in the isect_ids, so each segment only
+    // sorts the lower (tile_n_bits + 32) bits. The segments are sorted one
+    // after the other, each with all the threads.
+    const int64_t *offsets_ptr = offsets.data_ptr<int64_t>();
+    int64_t *keys = isect_ids.data_ptr<int64_t>();
+    int32_t *values = flatten_ids.data_ptr<int32_t>();
+    int64_t *keys_alt = isect_ids_sorted.data_ptr<int64_t>();
+    int32_t *values_alt = flatten_ids_sorted.data_ptr<int32_t>();
+    const int64_t n = std::min<int64_t>(n_segments, offsets.numel() - 1);
+    for (int64_t s = 0; s < n; ++s) {
+        const int64_t lo = offsets_ptr[s];
+        const int64_t len = offsets_ptr[s + 1] - lo;
+        if (len <= 0) {
+            continue;
+        }
+        const bool swapped = radix_sort_pairs_cpu(
+            len,
+            32 + tile_n_bits,
+            keys + lo,
+            values + lo,
+            keys_alt + lo,
+            values_alt + lo
+        );
+        // gather every segment in the *_sorted buffers
+        if (!swapped) {
+            std::copy_n(keys + lo, len, keys_alt + lo);
+            std::copy_n(values + lo, len, values_alt + lo);
+        }
+    }
+}
+
+} // namespace gsplat
@@ -0,0 +1,47 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h" // where all the macros are defined
+#include "KMeans.h" // where the CPU functions are declared
+#include "Ops.h"    // a collection of all gsplat operators
+
+namespace gsplat {
+
+std::tuple<at::Tensor, at::Tensor> kmeans_l1(
+    const at::Tensor x, // [N, D]
+    const int64_t n_clusters,
+    const int64_t n_iters,
+    const int64_t batch_size,
+    const int64_t n_probe,
+    const int64_t seed
+) {
+    TORCH_CHECK(x.is_cpu(), "x must be a CPU tensor");
+    CHECK_CONTIGUOUS(x);
+    TORCH_CHECK(
+        x.scalar_type() == at::kFloat && x.dim() == 2,
+        "x must be a float32 tensor of shape [N, D]"
+    );
+    TORCH_CHECK(n_clusters > 0, "n_clusters must be positive");
+    TORCH_CHECK(
+        batch_size > 0 && n_probe > 0, "batch_size and n_probe must be positive"
+    );
+    TORCH_CHECK(
+        x.size(0) < std::numeric_limits<int32_t>::max(),
+        "too many points for int32 labels"
+    );
+
+    // at most one cluster per point
+    const int64_t K = std::min(n_clusters, x.size(0));
+    at::Tensor centroids = at::empty({K, x.size(1)}, x.options());
+    at::Tensor labels = at::empty({x.size(0)}, x.options().dtype(at::kInt));
+    kmeans_l1_cpu(x, n_iters, batch_size, n_probe, seed, centroids, labels);
+    return std::make_tuple(centroids, labels);
+}
+
+} // namespace gsplat
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+// The k-means clustering only has a CPU implementation.
+
+// Mini-batch k-means with the Manhattan (L1) distance for the assignments and
+// the mean for the centroid updates. The centroids are initialized with
+// distinct random points. A coarse partition of the centroids restricts the
+// search of the nearest centroid to the `n_probe` closest groups. After the
+// mini-batch iterations, all the points are assigned and every centroid is
+// set to the mean of its points.
+void kmeans_l1_cpu(
+    const at::Tensor x, // [N, D] float32
+    const int64_t n_iters,
+    const int64_t batch_size,
+    const int64_t n_probe,
+    const int64_t seed,
+    // outputs
+    at::Tensor centroids, // [K, D] float32
+    at::Tensor labels     // [N] int32
+);
+
+} // namespace gsplat
@@ -0,0 +1,409 @@
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Common.h"
+#include "KMeans.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Points per task when assigning them to the centroids.
+constexpr int64_t KMEANS_GRAIN_SIZE = 64;
+// The vectors are zero-padded to a multiple of this many dimensions so that
+// the distances are evaluated without a scalar tail.
+constexpr int64_t KMEANS_LANES = 16;
+// Up to this many clusters, the centroids are seeded with k-means++ on a
+// sample of KMEANS_SEEDING_SAMPLES points per cluster. Above it, the seeding
+// would cost more than the clustering and distinct random points are used.
+constexpr int64_t KMEANS_SEEDING_MAX_CLUSTERS = 1024;
+constexpr int64_t KMEANS_SEEDING_SAMPLES = 64;
+// Mini-batch iterations between two rebuilds of the coarse partition.
+constexpr int64_t KMEANS_REBUILD_INTERVAL = 10;
+// Lloyd iterations of the coarse partition.
+constexpr int KMEANS_COARSE_ITERS = 4;
+
+GSPLAT_CPU_INLINE float l1_distance(
+    const float *__restrict__ a, const float *__restrict__ b, const int64_t Dp
+) {
+    float dist = 0.f;
+#pragma omp simd reduction(+ : dist)
+    for (int64_t d = 0; d < Dp; ++d) {
+        dist += std::fabs(a[d] - b[d]);
+    }
+    return dist;
+}
+
+// The centroids grouped around about sqrt(K) coarse centers, in CSR layout.
+struct CentroidGroups {
+    int64_t G = 0;
+    std::vector<float> centers;   // [G, Dp]
+    std::vector<int64_t> offsets; // [G + 1]
+    std::vector<int32_t> members; // [K]
+};
+
+GSPLAT_CPU_TARGET_CLONES void nearest_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const float *__restrict__ queries, // [n, Dp]
+    const float *__restrict__ points,  // [m, Dp]
+    const int64_t m,
+    const int64_t Dp,
+    int32_t *__restrict__ ids // [n]
+) {
+    for (int64_t i = begin; i < end; ++i) {
+        int32_t best = 0;
+        float best_dist = std::numeric_limits<float>::infinity();
+        for (int64_t j = 0; j < m; ++j) {
+            const float dist =
+                l1_distance(queries + i * Dp, points + j * Dp, Dp);
+            if (dist < best_dist) {
+                best_dist = dist;
+                best = j;
+            }
+        }
+        ids[i] = best;
+    }
+}
+
+// Partition the centroids with a few Lloyd iterations (L1 assignments, mean
+// updates) started from evenly spaced centroids.
+void build_groups(
+    const float *centroids,
+    const int64_t K,
+    const int64_t Dp,
+    CentroidGroups &out
+) {
+    const int64_t G = std::max<int64_t>(
+        1, std::min<int64_t>(K, std::llround(std::sqrt(double(K))))
+    );
+    out.G = G;
+    out.centers.resize(G * Dp);
+    for (int64_t g = 0; g < G; ++g) {
+        std::copy_n(
+            centroids + (g * K / G) * Dp, Dp, out.centers.data() + g * Dp
+        );
+    }
+
+    std::vector<int32_t> groups(K);
+    std::vector<double> sums(G * Dp);
+    std::vector<int64_t> counts(G);
+    for (int it = 0; it <= KMEANS_COARSE_ITERS; ++it) {
+        at::parallel_for(
+            0,
+            K,
+            KMEANS_GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+                nearest_cpu(
+                    begin,
+                    end,
+                    centroids,
+                    out.centers.data(),
+                    G,
+                    Dp,
+                    groups.data()
+                );
+            }
+        );
+        if (it == KMEANS_COARSE_ITERS) {
+            break;
+        }
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int64_t k = 0; k < K; ++k) {
+            counts[groups[k]]++;
+            for (int64_t d = 0; d < Dp; ++d) {
+                sums[groups[k] * Dp + d] += centroids[k * Dp + d];
+            }
+        }
+        // empty groups keep their center
+        for (int64_t g = 0; g < G; ++g) {
+            for (int64_t d = 0; counts[g] > 0 && d < Dp; ++d) {
+                out.centers[g * Dp + d] = sums[g * Dp + d] / counts[g];
+            }
+        }
+    }
+
+    out.offsets.assign(G + 1, 0);
+    for (int64_t k = 0; k < K; ++k) {
+        out.offsets[groups[k] + 1]++;
+    }
+    std::partial_sum(
+        out.offsets.begin(), out.offsets.end(), out.offsets.begin()
+    );
+    out.members.resize(K);
+    std::vector<int64_t> cursor(out.offsets.begin(), out.offsets.end() - 1);
+    for (int64_t k = 0; k < K; ++k) {
+        out.members[cursor[groups[k]]++] = k;
+    }
+}
+
+// Assign the points `ids[begin:end]` (or `begin:end` without ids) to their
+// nearest centroid among the ones of the n_probe closest groups.
+GSPLAT_CPU_TARGET_CLONES void assign_points_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const float *__restrict__ x,         // [N, D]
+    const int64_t *__restrict__ ids,     // [n] or nullptr
+    const float *__restrict__ centroids, // [K, Dp]
+    const CentroidGroups &groups,
+    const int64_t n_probe,
+    const int64_t D,
+    const int64_t Dp,
+    int32_t *__restrict__ labels // [n]
+) {
+    const int64_t G = groups.G;
+    const int64_t P = std::min(n_probe, G);
+    std::vector<float> p(Dp, 0.f);
+    std::vector<float> dists(G);
+    std::vector<int32_t> order(G);
+    for (int64_t i = begin; i < end; ++i) {
+        std::copy_n(x + (ids != nullptr ? ids[i] : i) * D, D, p.data());
+
+        for (int64_t g = 0; g < G; ++g) {
+            dists[g] =
+                l1_distance(p.data(), groups.centers.data() + g * Dp, Dp);
+        }
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(
+            order.begin(),
+            order.begin() + P,
+            order.end(),
+            [&](int32_t a, int32_t b) { return dists[a] < dists[b]; }
+        );
+
+        int32_t best = groups.members[groups.offsets[order[0]]];
+        float best_dist = std::numeric_limits<float>::infinity();
+        for (int64_t j = 0; j < P; ++j) {
+            const int64_t g = order[j];
+            const int64_t m_end = groups.offsets[g + 1];
+            for (int64_t m = groups.offsets[g]; m < m_end; ++m) {
+                const int32_t k = groups.members[m];
+                const float dist =
+                    l1_distance(p.data(), centroids + k * Dp, Dp);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best = k;
+                }
+            }
+        }
+        labels[i] = best;
+    }
+}
+
+GSPLAT_CPU_TARGET_CLONES void update_min_distances_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const float *__restrict__ samples, // [S, Dp]
+    const float *__restrict__ center,  // [Dp]
+    const int64_t Dp,
+    float *__restrict__ min_dists // [S]
+) {
+    for (int64_t s = begin; s < end; ++s) {
+        min_dists[s] = std::min(
+            min_dists[s], l1_distance(samples + s * Dp, center, Dp)
+        );
+    }
+}
+
+// k-means++ seeding on a random sample of the points: every new centroid is a
+// sample drawn with a probability proportional to its distance to the closest
+// centroid so far.
+void seed_kmeanspp(
+    const float *x,
+    const int64_t N,
+    const int64_t D,
+    const int64_t Dp,
+    const int64_t K,
+    std::mt19937_64 &rng,
+    float *centroids // [K, Dp]
+) {
+    const int64_t S = std::min(N, K * KMEANS_SEEDING_SAMPLES);
+    std::vector<float> samples(S * Dp, 0.f);
+    std::uniform_int_distribution<int64_t> sample(0, N - 1);
+    for (int64_t s = 0; s < S; ++s) {
+        const int64_t i = S == N ? s : sample(rng);
+        std::copy_n(x + i * D, D, samples.data() + s * Dp);
+    }
+
+    std::vector<float> min_dists(S, std::numeric_limits<float>::infinity());
+    int64_t pick = std::uniform_int_distribution<int64_t>(0, S - 1)(rng);
+    for (int64_t k = 0; k < K; ++k) {
+        float *center = centroids + k * Dp;
+        std::copy_n(samples.data() + pick * Dp, Dp, center);
+        at::parallel_for(
+            0,
+            S,
+            KMEANS_GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+                update_min_distances_cpu(
+                    begin, end, samples.data(), center, Dp, min_dists.data()
+                );
+            }
+        );
+        const double total =
+            std::accumulate(min_dists.begin(), min_dists.end(), 0.0);
+        if (total <= 0.0) {
+            // fewer distinct samples than clusters, the rest stay duplicates
+            pick = std::uniform_int_distribution<int64_t>(0, S - 1)(rng);
+            continue;
+        }
+        double target =
+            std::uniform_real_distribution<double>(0.0, total)(rng);
+        pick = S - 1;
+        for (int64_t s = 0; s < S; ++s) {
+            target -= min_dists[s];
+            if (target < 0.0 && min_dists[s] > 0.f) {
+                pick = s;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+void kmeans_l1_cpu(
+    const at::Tensor x, // [N, D] float32
+    const int64_t n_iters,
+    const int64_t batch_size,
+    const int64_t n_probe,
+    const int64_t seed,
+    // outputs
+    at::Tensor centroids, // [K, D] float32
+    at::Tensor labels     // [N] int32
+) {
+    const int64_t N = x.size(0);
+    const int64_t D = x.size(1);
+    const int64_t K = centroids.size(0);
+    if (N == 0 || K == 0) {
+        return;
+    }
+    const int64_t Dp = (D + KMEANS_LANES - 1) / KMEANS_LANES * KMEANS_LANES;
+    const float *x_ptr = x.data_ptr<float>();
+    int32_t *labels_ptr = labels.data_ptr<int32_t>();
+    std::mt19937_64 rng(seed);
+
+    // padded copy of the centroids, the padding stays zero
+    std::vector<float> c(K * Dp, 0.f);
+    if (K <= KMEANS_SEEDING_MAX_CLUSTERS) {
+        seed_kmeanspp(x_ptr, N, D, Dp, K, rng, c.data());
+    } else {
+        // distinct random points, with K <= N
+        std::vector<int64_t> ids(N);
+        std::iota(ids.begin(), ids.end(), 0);
+        for (int64_t k = 0; k < K; ++k) {
+            std::uniform_int_distribution<int64_t> pick(k, N - 1);
+            std::swap(ids[k], ids[pick(rng)]);
+            std::copy_n(x_ptr + ids[k] * D, D, c.data() + k * Dp);
+        }
+    }
+
+    // mini-batch iterations: every centroid moves towards its new points with
+    // a step of 1 / (number of points assigned to it so far)
+    CentroidGroups groups;
+    const int64_t B = std::min(batch_size, N);
+    std::vector<int64_t> batch(B);
+    std::vector<int32_t> batch_labels(B);
+    std::vector<int64_t> counts(K, 0);
+    std::uniform_int_distribution<int64_t> sample(0, N - 1);
+    for (int64_t it = 0; it < n_iters; ++it) {
+        if (it % KMEANS_REBUILD_INTERVAL == 0) {
+            build_groups(c.data(), K, Dp, groups);
+        }
+        for (int64_t b = 0; b < B; ++b) {
+            batch[b] = sample(rng);
+        }
+        at::parallel_for(
+            0,
+            B,
+            KMEANS_GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+                assign_points_cpu(
+                    begin,
+                    end,
+                    x_ptr,
+                    batch.data(),
+                    c.data(),
+                    groups,
+                    n_probe,
+                    D,
+                    Dp,
+                    batch_labels.data()
+                );
+            }
+        );
+        for (int64_t b = 0; b < B; ++b) {
+            const int64_t k = batch_labels[b];
+            const float eta = 1.f / ++counts[k];
+            float *center = c.data() + k * Dp;
+            const float *p = x_ptr + batch[b] * D;
+            for (int64_t d = 0; d < D; ++d) {
+                center[d] += eta * (p[d] - center[d]);
+            }
+        }
+    }
+
+    // assign all the points
+    build_groups(c.data(), K, Dp, groups);
+    at::parallel_for(0, N, KMEANS_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        assign_points_cpu(
+            begin,
+            end,
+            x_ptr,
+            nullptr,
+            c.data(),
+            groups,
+            n_probe,
+            D,
+            Dp,
+            labels_ptr
+        );
+    });
+
+    // and move the centroids to the mean of their points, the points of every
+    // cluster being gathered with a counting sort. Empty clusters keep their
+    // centroid.
+    std::vector<int64_t> offsets(K + 1, 0);
+    for (int64_t i = 0; i < N; ++i) {
+        offsets[labels_ptr[i] + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<int64_t> points(N);
+    {
+        std::vector<int64_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (int64_t i = 0; i < N; ++i) {
+            points[cursor[labels_ptr[i]]++] = i;
+        }
+    }
+    float *centroids_ptr = centroids.data_ptr<float>();
+    at::parallel_for(0, K, KMEANS_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        std::vector<double> sum(D);
+        for (int64_t k = begin; k < end; ++k) {
+            const int64_t count = offsets[k + 1] - offsets[k];
+            if (count == 0) {
+                std::copy_n(c.data() + k * Dp, D, centroids_ptr + k * D);
+                continue;
+            }
+            std::fill(sum.begin(), sum.end(), 0.0);
+            for (int64_t m = offsets[k]; m < offsets[k + 1]; ++m) {
+                const float *p = x_ptr + points[m] * D;
+                for (int64_t d = 0; d < D; ++d) {
+                    sum[d] += p[d];
+                }
+            }
+            for (int64_t d = 0; d < D; ++d) {
+                centroids_ptr[k * D + d] = sum[d] / count;
+            }
+        }
+    });
+}
+
+} // namespace gsplat
@@ -0,0 +1,56 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <limits>
+#include <tuple>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h" // where all the macros are defined
+#include "KdTree.h" // where the CPU functions are declared
+#include "Ops.h"    // a collection of all gsplat operators
+
+namespace gsplat {
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> kdtree_build(
+    const at::Tensor points, // [N, 3]
+    const int64_t leaf_size
+) {
+    TORCH_CHECK(points.is_cpu(), "points must be a CPU tensor");
+    CHECK_CONTIGUOUS(points);
+    TORCH_CHECK(
+        points.scalar_type() == at::kFloat && points.dim() == 2 &&
+            points.size(1) == 3,
+        "points must be a float32 tensor of shape [N, 3]"
+    );
+    TORCH_CHECK(leaf_size > 0, "leaf_size must be positive");
+    TORCH_CHECK(
+        points.size(0) < std::numeric_limits<int32_t>::max(),
+        "too many points for int32 ids"
+    );
+    return kdtree_build_cpu(points, leaf_size);
+}
+
+std::tuple<at::Tensor, at::Tensor> kdtree_query(
+    const at::Tensor order,       // [N]
+    const at::Tensor points,      // [N, 3]
+    const at::Tensor node_bounds, // [2P, 6]
+    const int64_t leaf_size,
+    const at::Tensor queries, // [M, 3]
+    const int64_t k
+) {
+    TORCH_CHECK(order.is_cpu(), "order must be a CPU tensor");
+    CHECK_CONTIGUOUS(order);
+    CHECK_INPUT_LIKE(points, order);
+    CHECK_INPUT_LIKE(node_bounds, order);
+    CHECK_INPUT_LIKE(queries, order);
+    TORCH_CHECK(
+        queries.scalar_type() == at::kFloat && queries.dim() == 2 &&
+            queries.size(1) == 3,
+        "queries must be a float32 tensor of shape [M, 3]"
+    );
+    TORCH_CHECK(k > 0, "k must be positive");
+    return kdtree_query_cpu(order, points, node_bounds, leaf_size, queries, k);
+}
+
+} // namespace gsplat
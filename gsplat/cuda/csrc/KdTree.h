@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+// The k-d tree only has a CPU implementation. Like the frustum culling index,
+// it is a complete binary tree over P (a power of two) buckets of `leaf_size`
+// points, stored as a heap: node 1 is the root, the children of node i are 2i
+// and 2i + 1, and the buckets are the nodes [P, 2P). Every inner node splits
+// its points at the median of the axis of largest extent, and every node keeps
+// the bounding box of its points. Node 0 is unused.
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> kdtree_build_cpu(
+    const at::Tensor points, // [N, 3]
+    const int64_t leaf_size
+);
+
+std::tuple<at::Tensor, at::Tensor> kdtree_query_cpu(
+    const at::Tensor order,       // [N]
+    const at::Tensor points,      // [N, 3], in the tree order
+    const at::Tensor node_bounds, // [2P, 6]
+    const int64_t leaf_size,
+    const at::Tensor queries, // [M, 3]
+    const int64_t k
+);
+
+} // namespace gsplat
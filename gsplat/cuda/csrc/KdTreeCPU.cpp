@@ -0,0 +1,324 @@
+#include <ATen/Functions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Common.h"
+#include "KdTree.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Queries per task. Consecutive queries are usually close to each other (e.g.
+// the points of the tree, in the tree order), so they visit the same nodes.
+constexpr int64_t KDTREE_GRAIN_SIZE = 256;
+
+// A point and its row in the input, moved around while building the tree.
+struct KdPointCPU {
+    float p[3];
+    int32_t id;
+};
+
+// Number of buckets rounded up to a power of two.
+inline int64_t kdtree_n_leaves(const int64_t N, const int64_t leaf_size) {
+    int64_t P = 1;
+    while (P * leaf_size < N) {
+        P *= 2;
+    }
+    return P;
+}
+
+// Positions [lo, hi) of the points covered by a node.
+inline std::pair<int64_t, int64_t> kdtree_node_range(
+    const int64_t node,
+    const int64_t P,
+    const int64_t leaf_size,
+    const int64_t N
+) {
+    int64_t span = 1, first = node;
+    while (first < P) {
+        first *= 2, span *= 2;
+    }
+    const int64_t lo = std::min((first - P) * leaf_size, N);
+    const int64_t hi = std::min(lo + span * leaf_size, N);
+    return {lo, hi};
+}
+
+// Squared distance from a point to a box, infinite for an empty box.
+GSPLAT_CPU_INLINE float
+box_distance2(const float *bound, const float x, const float y, const float z) {
+    const float dx = std::max(std::max(bound[0] - x, x - bound[3]), 0.f);
+    const float dy = std::max(std::max(bound[1] - y, y - bound[4]), 0.f);
+    const float dz = std::max(std::max(bound[2] - z, z - bound[5]), 0.f);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Insert a neighbor into the k best ones, sorted by increasing distance. The
+// caller checks that it is closer than the current k-th one.
+GSPLAT_CPU_INLINE void insert_neighbor(
+    const int64_t k,
+    const float d2,
+    const int64_t pos,
+    float *best_d2,   // [k]
+    int64_t *best_pos // [k]
+) {
+    int64_t j = k - 1;
+    while (j > 0 && best_d2[j - 1] > d2) {
+        best_d2[j] = best_d2[j - 1];
+        best_pos[j] = best_pos[j - 1];
+        --j;
+    }
+    best_d2[j] = d2;
+    best_pos[j] = pos;
+}
+
+// Exact k nearest neighbors of the queries [begin, end), by a depth-first
+// traversal that visits the closer child first and skips the nodes whose box
+// is farther than the current k-th neighbor.
+GSPLAT_CPU_TARGET_CLONES void kdtree_query_range(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t N,
+    const int64_t P,
+    const int64_t leaf_size,
+    const int64_t k,
+    const int64_t *__restrict__ order,     // [N]
+    const float *__restrict__ points,      // [N, 3]
+    const float *__restrict__ node_bounds, // [2P, 6]
+    const float *__restrict__ queries,     // [M, 3]
+    float *__restrict__ distances,         // [M, k]
+    int64_t *__restrict__ indices          // [M, k]
+) {
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    std::vector<float> best_d2(k);
+    std::vector<int64_t> best_pos(k);
+    std::vector<float> leaf_d2(leaf_size);
+    std::vector<std::pair<int64_t, float>> stack;
+    for (int64_t q = begin; q < end; ++q) {
+        const float x = queries[q * 3], y = queries[q * 3 + 1],
+                    z = queries[q * 3 + 2];
+        std::fill(best_d2.begin(), best_d2.end(), inf);
+        std::fill(best_pos.begin(), best_pos.end(), -1);
+
+        stack.assign(1, {1, box_distance2(node_bounds + 6, x, y, z)});
+        while (!stack.empty()) {
+            const int64_t node = stack.back().first;
+            const float node_d2 = stack.back().second;
+            stack.pop_back();
+            if (node_d2 >= best_d2[k - 1]) {
+                continue;
+            }
+            if (node >= P) {
+                const int64_t lo = std::min((node - P) * leaf_size, N);
+                const int64_t n = std::min(leaf_size, N - lo);
+                const float *p = points + lo * 3;
+#pragma omp simd
+                for (int64_t i = 0; i < n; ++i) {
+                    const float dx = p[i * 3] - x, dy = p[i * 3 + 1] - y,
+                                dz = p[i * 3 + 2] - z;
+                    leaf_d2[i] = dx * dx + dy * dy + dz * dz;
+                }
+                for (int64_t i = 0; i < n; ++i) {
+                    if (leaf_d2[i] < best_d2[k - 1]) {
+                        insert_neighbor(
+                            k,
+                            leaf_d2[i],
+                            lo + i,
+                            best_d2.data(),
+                            best_pos.data()
+                        );
+                    }
+                }
+                continue;
+            }
+            const float left_d2 =
+                box_distance2(node_bounds + 2 * node * 6, x, y, z);
+            const float right_d2 =
+                box_distance2(node_bounds + (2 * node + 1) * 6, x, y, z);
+            // push the closer child last to visit it first
+            if (left_d2 <= right_d2) {
+                stack.push_back({2 * node + 1, right_d2});
+                stack.push_back({2 * node, left_d2});
+            } else {
+                stack.push_back({2 * node, left_d2});
+                stack.push_back({2 * node + 1, right_d2});
+            }
+        }
+
+        for (int64_t j = 0; j < k; ++j) {
+            distances[q * k + j] = std::sqrt(best_d2[j]);
+            indices[q * k + j] = best_pos[j] < 0 ? -1 : order[best_pos[j]];
+        }
+    }
+}
+
+} // namespace
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> kdtree_build_cpu(
+    const at::Tensor points, // [N, 3]
+    const int64_t leaf_size
+) {
+    const int64_t N = points.size(0);
+    const int64_t P = kdtree_n_leaves(N, leaf_size);
+    auto opt = points.options();
+
+    at::Tensor order = at::empty({N}, opt.dtype(at::kLong));
+    at::Tensor sorted_points = at::empty({N, 3}, opt);
+    at::Tensor node_bounds = at::empty({2 * P, 6}, opt);
+
+    const float *points_ptr = points.data_ptr<float>();
+    std::vector<KdPointCPU> pts(N);
+    at::parallel_for(0, N, 4096, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            for (int d = 0; d < 3; ++d) {
+                pts[i].p[d] = points_ptr[i * 3 + d];
+            }
+            pts[i].id = static_cast<int32_t>(i);
+        }
+    });
+
+    // Split every inner node at the first position of its right child, along
+    // the axis of largest extent, one level at a time. The nodes of a level
+    // cover disjoint ranges and are partitioned in parallel.
+    for (int64_t level = 1; level < P; level *= 2) {
+        at::parallel_for(level, 2 * level, 1, [&](int64_t begin, int64_t end) {
+            for (int64_t node = begin; node < end; ++node) {
+                const std::pair<int64_t, int64_t> range =
+                    kdtree_node_range(node, P, leaf_size, N);
+                const int64_t lo = range.first, hi = range.second;
+                const int64_t mid =
+                    kdtree_node_range(2 * node + 1, P, leaf_size, N).first;
+                if (mid <= lo || mid >= hi) {
+                    continue;
+                }
+                float p_lo[3], p_hi[3];
+                for (int d = 0; d < 3; ++d) {
+                    p_lo[d] = std::numeric_limits<float>::infinity();
+                    p_hi[d] = -std::numeric_limits<float>::infinity();
+                }
+                for (int64_t i = lo; i < hi; ++i) {
+                    for (int d = 0; d < 3; ++d) {
+                        p_lo[d] = std::min(p_lo[d], pts[i].p[d]);
+                        p_hi[d] = std::max(p_hi[d], pts[i].p[d]);
+                    }
+                }
+                int axis = 0;
+                for (int d = 1; d < 3; ++d) {
+                    if (p_hi[d] - p_lo[d] > p_hi[axis] - p_lo[axis]) {
+                        axis = d;
+                    }
+                }
+                std::nth_element(
+                    pts.begin() + lo,
+                    pts.begin() + mid,
+                    pts.begin() + hi,
+                    [axis](const KdPointCPU &a, const KdPointCPU &b) {
+                        return a.p[axis] < b.p[axis];
+                    }
+                );
+            }
+        });
+    }
+
+    int64_t *order_ptr = order.data_ptr<int64_t>();
+    float *sorted_ptr = sorted_points.data_ptr<float>();
+    at::parallel_for(0, N, 4096, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            order_ptr[i] = pts[i].id;
+            for (int d = 0; d < 3; ++d) {
+                sorted_ptr[i * 3 + d] = pts[i].p[d];
+            }
+        }
+    });
+
+    // bounding boxes of the buckets, then of the inner nodes
+    float *bounds_ptr = node_bounds.data_ptr<float>();
+    std::fill_n(bounds_ptr, 6, 0.f); // node 0 is unused
+    at::parallel_for(0, P, 64, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; ++b) {
+            float *bound = bounds_ptr + (P + b) * 6;
+            for (int d = 0; d < 3; ++d) {
+                bound[d] = std::numeric_limits<float>::infinity();
+                bound[3 + d] = -std::numeric_limits<float>::infinity();
+            }
+            const int64_t lo = std::min(b * leaf_size, N);
+            const int64_t hi = std::min(lo + leaf_size, N);
+            for (int64_t i = lo; i < hi; ++i) {
+                for (int d = 0; d < 3; ++d) {
+                    bound[d] = std::min(bound[d], sorted_ptr[i * 3 + d]);
+                    bound[3 + d] =
+                        std::max(bound[3 + d], sorted_ptr[i * 3 + d]);
+                }
+            }
+        }
+    });
+    for (int64_t level = P / 2; level >= 1; level /= 2) {
+        at::parallel_for(
+            level, 2 * level, 256, [&](int64_t begin, int64_t end) {
+                for (int64_t i = begin; i < end; ++i) {
+                    const float *left = bounds_ptr + 2 * i * 6;
+                    const float *right = left + 6;
+                    float *bound = bounds_ptr + i * 6;
+                    for (int d = 0; d < 3; ++d) {
+                        bound[d] = std::min(left[d], right[d]);
+                        bound[3 + d] = std::max(left[3 + d], right[3 + d]);
+                    }
+                }
+            }
+        );
+    }
+    return std::make_tuple(order, sorted_points, node_bounds);
+}
+
+std::tuple<at::Tensor, at::Tensor> kdtree_query_cpu(
+    const at::Tensor order,       // [N]
+    const at::Tensor points,      // [N, 3], in the tree order
+    const at::Tensor node_bounds, // [2P, 6]
+    const int64_t leaf_size,
+    const at::Tensor queries, // [M, 3]
+    const int64_t k
+) {
+    const int64_t N = order.size(0);
+    const int64_t P = node_bounds.size(0) / 2;
+    const int64_t M = queries.size(0);
+    at::Tensor distances = at::empty({M, k}, queries.options());
+    at::Tensor indices = at::empty({M, k}, order.options());
+
+    const int64_t *order_ptr = order.data_ptr<int64_t>();
+    const float *points_ptr = points.data_ptr<float>();
+    const float *bounds_ptr = node_bounds.data_ptr<float>();
+    const float *queries_ptr = queries.data_ptr<float>();
+    float *distances_ptr = distances.data_ptr<float>();
+    int64_t *indices_ptr = indices.data_ptr<int64_t>();
+    at::parallel_for(
+        0,
+        M,
+        KDTREE_GRAIN_SIZE,
+        [&](int64_t begin, int64_t end) {
+            kdtree_query_range(
+                begin,
+                end,
+                N,
+                P,
+                leaf_size,
+                k,
+                order_ptr,
+                points_ptr,
+                bounds_ptr,
+                queries_ptr,
+                distances_ptr,
+                indices_ptr
+            );
+        }
+    );
+    return std::make_tuple(distances, indices);
+}
+
+} // namespace gsplat
@@ -0,0 +1,68 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <tuple>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h"  // where all the macros are defined
+#include "LodTree.h" // where the CPU functions are declared
+#include "Ops.h"     // a collection of all gsplat operators
+
+namespace gsplat {
+
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+lod_tree_build(
+    const at::Tensor means,     // [N, 3]
+    const at::Tensor quats,     // [N, 4]
+    const at::Tensor scales,    // [N, 3]
+    const at::Tensor opacities, // [N]
+    const at::Tensor colors     // [N, D]
+) {
+    TORCH_CHECK(means.is_cpu(), "means must be a CPU tensor");
+    CHECK_CONTIGUOUS(means);
+    CHECK_INPUT_LIKE(quats, means);
+    CHECK_INPUT_LIKE(scales, means);
+    CHECK_INPUT_LIKE(opacities, means);
+    CHECK_INPUT_LIKE(colors, means);
+    TORCH_CHECK(
+        colors.dim() == 2 && colors.size(0) == means.size(0),
+        "colors must have shape [N, D]"
+    );
+    return lod_tree_build_cpu(means, quats, scales, opacities, colors);
+}
+
+at::Tensor lod_tree_cut(
+    const at::Tensor bounds,        // [N + M, 4]
+    const at::Tensor child_offsets, // [M + 1]
+    const at::Tensor children,      // [N + M - 1]
+    const at::Tensor viewmats,      // [C, 4, 4]
+    const at::Tensor Ks,            // [C, 3, 3]
+    const float pixel_size,
+    const float near_plane
+) {
+    TORCH_CHECK(bounds.is_cpu(), "bounds must be a CPU tensor");
+    CHECK_CONTIGUOUS(bounds);
+    CHECK_INPUT_LIKE(child_offsets, bounds);
+    CHECK_INPUT_LIKE(children, bounds);
+    CHECK_INPUT_LIKE(viewmats, bounds);
+    CHECK_INPUT_LIKE(Ks, bounds);
+    TORCH_CHECK(
+        viewmats.scalar_type() == bounds.scalar_type() &&
+            Ks.scalar_type() == bounds.scalar_type(),
+        "viewmats and Ks must have the dtype of bounds"
+    );
+    return lod_tree_cut_cpu(
+        bounds, child_offsets, children, viewmats, Ks, pixel_size, near_plane
+    );
+}
+
+} // namespace gsplat
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+// The level-of-detail tree only has a CPU implementation. Both functions
+// allocate their outputs since their sizes are only known at the end.
+
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+lod_tree_build_cpu(
+    const at::Tensor means,     // [N, 3]
+    const at::Tensor quats,     // [N, 4]
+    const at::Tensor scales,    // [N, 3]
+    const at::Tensor opacities, // [N]
+    const at::Tensor colors     // [N, D]
+);
+
+at::Tensor lod_tree_cut_cpu(
+    const at::Tensor bounds,        // [N + M, 4]
+    const at::Tensor child_offsets, // [M + 1]
+    const at::Tensor children,      // [N + M - 1]
+    const at::Tensor viewmats,      // [C, 4, 4]
+    const at::Tensor Ks,            // [C, 3, 3]
+    const float pixel_size,
+    const float near_plane
+);
+
+} // namespace gsplat
@@ -0,0 +1,629 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Functions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "Common.h"
+#include "Intersect.h"
+#include "LodTree.h"
+#include "Utils.cuh"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Maximum number of children of a node. Gaussians falling into the same
+// octree cell are grouped by this many at a time, so that a dense cell still
+// yields a tree instead of a single very wide node.
+constexpr int64_t LOD_MAX_CHILDREN = 8;
+
+// Nodes the cut expands serially before the subtrees are cut in parallel.
+// Fixed so that the output order does not depend on the number of threads.
+constexpr int64_t LOD_CUT_FRONTIER = 1024;
+
+// Moments of a (merged) Gaussian. `coverage` is opacity times the area proxy
+// det(covar)^(1/3), and `weight` is the coverage used to average the
+// children into a parent.
+struct LodMoments {
+    vec3 mean;
+    mat3 covar;
+    float coverage;
+    float weight;
+};
+
+// det(covar)^(1/3), i.e. (s0 * s1 * s2)^(2/3) for a Gaussian with scales s.
+inline float area_proxy(const mat3 &covar) {
+    return std::cbrt(std::max(glm::determinant(covar), 1e-36f));
+}
+
+// Eigen decomposition of a symmetric 3x3 matrix with cyclic Jacobi rotations.
+// The eigenvectors are the columns of `evecs`, which is a proper rotation.
+void symmetric_eigen_3x3(const mat3 &A, vec3 &evals, mat3 &evecs) {
+    double a[3][3], v[3][3]; // row-major
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            a[i][j] = A[j][i];
+            v[i][j] = i == j ? 1.0 : 0.0;
+        }
+    }
+    const int pairs[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    for (int sweep = 0; sweep < 16; ++sweep) {
+        const double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] +
+                           a[1][2] * a[1][2];
+        const double diag = a[0][0] * a[0][0] + a[1][1] * a[1][1] +
+                            a[2][2] * a[2][2];
+        if (off <= 1e-24 * diag) {
+            break;
+        }
+        for (const auto &pq : pairs) {
+            const int p = pq[0], q = pq[1];
+            if (a[p][q] == 0.0) {
+                continue;
+            }
+            // rotation that zeroes a[p][q]
+            const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+            const double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                             (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+            const double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+            for (int k = 0; k < 3; ++k) { // a = a * J
+                const double akp = a[k][p], akq = a[k][q];
+                a[k][p] = c * akp - s * akq;
+                a[k][q] = s * akp + c * akq;
+            }
+            for (int k = 0; k < 3; ++k) { // a = J^T * a
+                const double apk = a[p][k], aqk = a[q][k];
+                a[p][k] = c * apk - s * aqk;
+                a[q][k] = s * apk + c * aqk;
+            }
+            for (int k = 0; k < 3; ++k) { // v = v * J
+                const double vkp = v[k][p], vkq = v[k][q];
+                v[k][p] = c * vkp - s * vkq;
+                v[k][q] = s * vkp + c * vkq;
+            }
+        }
+    }
+    // keep a right-handed basis so that it converts to a quaternion
+    const double det = v[0][0] * (v[1][1] * v[2][2] - v[1][2] * v[2][1]) -
+                       v[0][1] * (v[1][0] * v[2][2] - v[1][2] * v[2][0]) +
+                       v[0][2] * (v[1][0] * v[2][1] - v[1][1] * v[2][0]);
+    const double sign = det < 0.0 ? -1.0 : 1.0;
+    for (int j = 0; j < 3; ++j) {
+        evals[j] = a[j][j];
+        for (int i = 0; i < 3; ++i) {
+            evecs[j][i] = j == 2 ? sign * v[i][j] : v[i][j];
+        }
+    }
+}
+
+// Inverse of `quat_to_rotmat` (wxyz convention) for a rotation matrix.
+vec4 rotmat_to_quat(const mat3 &R) {
+    // r(i, j): row i, column j
+    auto r = [&](int i, int j) { return R[j][i]; };
+    const float trace = r(0, 0) + r(1, 1) + r(2, 2);
+    vec4 q;
+    if (trace > 0.f) {
+        const float s = std::sqrt(trace + 1.f) * 2.f;
+        q = vec4(
+            0.25f * s,
+            (r(2, 1) - r(1, 2)) / s,
+            (r(0, 2) - r(2, 0)) / s,
+            (r(1, 0) - r(0, 1)) / s
+        );
+    } else if (r(0, 0) > r(1, 1) && r(0, 0) > r(2, 2)) {
+        const float s = std::sqrt(1.f + r(0, 0) - r(1, 1) - r(2, 2)) * 2.f;
+        q = vec4(
+            (r(2, 1) - r(1, 2)) / s,
+            0.25f * s,
+            (r(0, 1) + r(1, 0)) / s,
+            (r(0, 2) + r(2, 0)) / s
+        );
+    } else if (r(1, 1) > r(2, 2)) {
+        const float s = std::sqrt(1.f + r(1, 1) - r(0, 0) - r(2, 2)) * 2.f;
+        q = vec4(
+            (r(0, 2) - r(2, 0)) / s,
+            (r(0, 1) + r(1, 0)) / s,
+            0.25f * s,
+            (r(1, 2) + r(2, 1)) / s
+        );
+    } else {
+        const float s = std::sqrt(1.f + r(2, 2) - r(0, 0) - r(1, 1)) * 2.f;
+        q = vec4(
+            (r(1, 0) - r(0, 1)) / s,
+            (r(0, 2) + r(2, 0)) / s,
+            (r(1, 2) + r(2, 1)) / s,
+            0.25f * s
+        );
+    }
+    return q;
+}
+
+// Builds the tree bottom-up over the Morton order of the means. Nodes are
+// numbered [0, N) for the input Gaussians followed by [N, N + M) for the
+// merged ones, in creation order, so the root is the last node.
+template <typename scalar_t> class LodTreeBuilder {
+  public:
+    LodTreeBuilder(
+        const int64_t N,
+        const int64_t D,
+        const scalar_t *means,     // [N, 3]
+        const scalar_t *quats,     // [N, 4]
+        const scalar_t *scales,    // [N, 3]
+        const scalar_t *opacities, // [N]
+        const scalar_t *colors     // [N, D]
+    )
+        : N(N), D(D), means(means), quats(quats), scales(scales),
+          opacities(opacities), colors(colors) {}
+
+    void build(const at::TensorOptions &opt) {
+        if (N == 0) {
+            return;
+        }
+        // a tree with N leaves has at most N - 1 inner nodes
+        const int64_t capacity = std::max<int64_t>(N - 1, 1);
+        node_moments.resize(capacity);
+        node_quats.resize(capacity);
+        node_scales.resize(capacity);
+        node_opacities.resize(capacity);
+        node_colors.resize(capacity * D);
+        child_offsets.assign(capacity + 1, 0);
+        children.resize(N + capacity);
+        bounds.resize(N + capacity);
+
+        std::vector<int64_t> entries(N);
+        std::vector<uint32_t> codes(N);
+        sort_leaves(entries, codes, opt);
+
+        // Group the entries by octree cell, from the finest level (same
+        // code) up to the root (shift 30). A level is repeated while some
+        // cell has more than LOD_MAX_CHILDREN entries.
+        for (int shift = 0; shift <= 30; shift += 3) {
+            while (merge_level(entries, codes, shift)) {
+            }
+        }
+        assert(entries.size() == 1);
+    }
+
+    const int64_t N, D;
+    const scalar_t *means, *quats, *scales, *opacities, *colors;
+
+    // inner nodes
+    int64_t M = 0;
+    std::vector<LodMoments> node_moments;
+    std::vector<vec4> node_quats;
+    std::vector<vec3> node_scales;
+    std::vector<float> node_opacities;
+    std::vector<float> node_colors;
+    std::vector<int64_t> child_offsets;
+    std::vector<int64_t> children;
+    // all nodes: bounding sphere (center, radius) of the 3-sigma ellipsoids
+    // of the node's leaves
+    std::vector<vec4> bounds;
+
+  private:
+    LodMoments leaf_moments(const int64_t i) const {
+        LodMoments m;
+        m.mean = vec3(means[i * 3], means[i * 3 + 1], means[i * 3 + 2]);
+        const vec4 quat(
+            quats[i * 4], quats[i * 4 + 1], quats[i * 4 + 2], quats[i * 4 + 3]
+        );
+        const vec3 scale(scales[i * 3], scales[i * 3 + 1], scales[i * 3 + 2]);
+        quat_scale_to_covar_preci(quat, scale, &m.covar, nullptr);
+        m.coverage = static_cast<float>(opacities[i]) * area_proxy(m.covar);
+        m.weight = std::max(m.coverage, 1e-30f);
+        return m;
+    }
+
+    LodMoments moments(const int64_t id) const {
+        return id < N ? leaf_moments(id) : node_moments[id - N];
+    }
+
+    float color(const int64_t id, const int64_t d) const {
+        return id < N ? static_cast<float>(colors[id * D + d])
+                      : node_colors[(id - N) * D + d];
+    }
+
+    // Morton-sort the leaves and compute their bounds.
+    void sort_leaves(
+        std::vector<int64_t> &entries,
+        std::vector<uint32_t> &codes,
+        const at::TensorOptions &opt
+    ) {
+        vec3 lo(std::numeric_limits<float>::max());
+        vec3 hi(std::numeric_limits<float>::lowest());
+        for (int64_t i = 0; i < N; ++i) {
+            for (int k = 0; k < 3; ++k) {
+                const float x = means[i * 3 + k];
+                lo[k] = std::min(lo[k], x);
+                hi[k] = std::max(hi[k], x);
+            }
+        }
+        const vec3 extent = glm::max(hi - lo, vec3(1e-12f));
+
+        at::Tensor keys = at::empty({N}, opt.dtype(at::kLong));
+        at::Tensor values = at::empty({N}, opt.dtype(at::kInt));
+        at::Tensor keys_sorted = at::empty({N}, opt.dtype(at::kLong));
+        at::Tensor values_sorted = at::empty({N}, opt.dtype(at::kInt));
+        int64_t *keys_ptr = keys.data_ptr<int64_t>();
+        int32_t *values_ptr = values.data_ptr<int32_t>();
+        at::parallel_for(0, N, 4096, [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+                const vec3 p = (vec3(
+                                    means[i * 3],
+                                    means[i * 3 + 1],
+                                    means[i * 3 + 2]
+                                ) -
+                                lo) /
+                               extent;
+                keys_ptr[i] = morton_code_30(p.x, p.y, p.z);
+                values_ptr[i] = i;
+                const vec3 scale(
+                    scales[i * 3], scales[i * 3 + 1], scales[i * 3 + 2]
+                );
+                bounds[i] = vec4(
+                    means[i * 3],
+                    means[i * 3 + 1],
+                    means[i * 3 + 2],
+                    3.f * std::max(scale.x, std::max(scale.y, scale.z))
+                );
+            }
+        });
+        // the codes have 30 bits, the upper passes are skipped
+        radix_sort_double_buffer_cpu(
+            N, 0, 0, keys, values, keys_sorted, values_sorted
+        );
+
+        const int64_t *sorted_keys = keys_sorted.data_ptr<int64_t>();
+        const int32_t *sorted_values = values_sorted.data_ptr<int32_t>();
+        for (int64_t i = 0; i < N; ++i) {
+            entries[i] = sorted_values[i];
+            codes[i] = sorted_keys[i];
+        }
+    }
+
+    // Merge the entries in [begin, end) into the inner node `k`.
+    void merge(const int64_t k, const int64_t *ids, const int64_t n) {
+        float weight = 0.f, coverage = 0.f;
+        vec3 mean(0.f);
+        for (int64_t c = 0; c < n; ++c) {
+            const LodMoments m = moments(ids[c]);
+            weight += m.weight;
+            coverage += m.coverage;
+            mean += m.weight * m.mean;
+        }
+        mean /= weight;
+
+        // moment matching: E[(x - mean)(x - mean)^T] of the mixture
+        mat3 covar(0.f);
+        float radius = 0.f;
+        for (int64_t c = 0; c < n; ++c) {
+            const LodMoments m = moments(ids[c]);
+            const vec3 d = m.mean - mean;
+            covar += m.weight * (m.covar + glm::outerProduct(d, d));
+            const vec4 &b = bounds[ids[c]];
+            radius =
+                std::max(radius, glm::length(vec3(b) - mean) + b.w);
+        }
+        covar /= weight;
+
+        float *color = node_colors.data() + k * D;
+        std::fill_n(color, D, 0.f);
+        for (int64_t c = 0; c < n; ++c) {
+            const float w = moments(ids[c]).weight / weight;
+            for (int64_t d = 0; d < D; ++d) {
+                color[d] += w * this->color(ids[c], d);
+            }
+        }
+
+        vec3 evals;
+        mat3 evecs;
+        symmetric_eigen_3x3(covar, evals, evecs);
+        const vec3 scale = glm::sqrt(glm::max(evals, vec3(1e-24f)));
+        // the opacity keeps the summed coverage of the children
+        const float area = area_proxy(covar);
+        const float opacity = std::min(coverage / area, 1.f);
+
+        LodMoments &node = node_moments[k];
+        node.mean = mean;
+        node.covar = covar;
+        node.coverage = opacity * area;
+        node.weight = weight;
+        node_quats[k] = rotmat_to_quat(evecs);
+        node_scales[k] = scale;
+        node_opacities[k] = opacity;
+        radius = std::max(
+            radius, 3.f * std::max(scale.x, std::max(scale.y, scale.z))
+        );
+        bounds[N + k] = vec4(mean, radius);
+    }
+
+    // One grouping pass at a given shift of the codes. Returns whether some
+    // group was too large and the same shift has to be processed again.
+    bool merge_level(
+        std::vector<int64_t> &entries, std::vector<uint32_t> &codes, int shift
+    ) {
+        const int64_t n_entries = entries.size();
+        // every group is split into chunks of at most LOD_MAX_CHILDREN
+        // entries, each becoming one entry of the next level
+        std::vector<int64_t> chunk_starts;
+        bool oversized = false;
+        for (int64_t begin = 0; begin < n_entries;) {
+            int64_t end = begin + 1;
+            while (end < n_entries &&
+                   (codes[end] >> shift) == (codes[begin] >> shift)) {
+                ++end;
+            }
+            oversized |= end - begin > LOD_MAX_CHILDREN;
+            for (int64_t c = begin; c < end; c += LOD_MAX_CHILDREN) {
+                chunk_starts.push_back(c);
+            }
+            begin = end;
+        }
+        const int64_t n_chunks = chunk_starts.size();
+        chunk_starts.push_back(n_entries);
+        if (n_chunks == n_entries) {
+            return false; // nothing to merge
+        }
+
+        // allocate the inner nodes of the chunks with more than one entry
+        std::vector<int64_t> chunk_nodes(n_chunks, -1);
+        for (int64_t c = 0; c < n_chunks; ++c) {
+            const int64_t n = chunk_starts[c + 1] - chunk_starts[c];
+            if (n > 1) {
+                chunk_nodes[c] = M;
+                child_offsets[M + 1] = child_offsets[M] + n;
+                std::copy_n(
+                    entries.data() + chunk_starts[c],
+                    n,
+                    children.data() + child_offsets[M]
+                );
+                ++M;
+            }
+        }
+
+        std::vector<int64_t> next_entries(n_chunks);
+        std::vector<uint32_t> next_codes(n_chunks);
+        at::parallel_for(0, n_chunks, 64, [&](int64_t begin, int64_t end) {
+            for (int64_t c = begin; c < end; ++c) {
+                const int64_t k = chunk_nodes[c];
+                const int64_t start = chunk_starts[c];
+                if (k >= 0) {
+                    merge(
+                        k,
+                        entries.data() + start,
+                        chunk_starts[c + 1] - start
+                    );
+                    next_entries[c] = N + k;
+                } else {
+                    next_entries[c] = entries[start];
+                }
+                next_codes[c] = codes[start];
+            }
+        });
+        entries.swap(next_entries);
+        codes.swap(next_codes);
+        return oversized;
+    }
+};
+
+// Whether a node with bounding sphere `bound` is larger than `pixel_size`
+// pixels in any of the cameras, or reaches within `near_plane` of one.
+bool lod_node_too_large(
+    const vec4 &bound,
+    const int64_t C,
+    const vec3 *centers, // [C] camera centers
+    const float *focals, // [C]
+    const float pixel_size,
+    const float near_plane
+) {
+    for (int64_t cid = 0; cid < C; ++cid) {
+        const float dist = glm::length(vec3(bound) - centers[cid]) - bound.w;
+        if (dist <= near_plane ||
+            2.f * bound.w * focals[cid] > pixel_size * dist) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+lod_tree_build_cpu(
+    const at::Tensor means,     // [N, 3]
+    const at::Tensor quats,     // [N, 4]
+    const at::Tensor scales,    // [N, 3]
+    const at::Tensor opacities, // [N]
+    const at::Tensor colors     // [N, D]
+) {
+    const int64_t N = means.size(0);
+    const int64_t D = colors.size(1);
+    auto opt = means.options();
+
+    at::Tensor node_means, node_quats, node_scales, node_opacities, node_colors,
+        child_offsets, children, bounds;
+    AT_DISPATCH_FLOATING_TYPES(means.scalar_type(), "lod_tree_build_cpu", [&]() {
+        LodTreeBuilder<scalar_t> tree(
+            N,
+            D,
+            means.data_ptr<scalar_t>(),
+            quats.data_ptr<scalar_t>(),
+            scales.data_ptr<scalar_t>(),
+            opacities.data_ptr<scalar_t>(),
+            colors.data_ptr<scalar_t>()
+        );
+        tree.build(opt);
+        const int64_t M = tree.M;
+
+        node_means = at::empty({M, 3}, opt);
+        node_quats = at::empty({M, 4}, opt);
+        node_scales = at::empty({M, 3}, opt);
+        node_opacities = at::empty({M}, opt);
+        node_colors = at::empty({M, D}, opt);
+        child_offsets = at::empty({M + 1}, opt.dtype(at::kLong));
+        children = at::empty({M == 0 ? 0 : N + M - 1}, opt.dtype(at::kLong));
+        bounds = at::empty({N + M, 4}, opt);
+
+        scalar_t *node_means_ptr = node_means.data_ptr<scalar_t>();
+        scalar_t *node_quats_ptr = node_quats.data_ptr<scalar_t>();
+        scalar_t *node_scales_ptr = node_scales.data_ptr<scalar_t>();
+        scalar_t *node_opacities_ptr = node_opacities.data_ptr<scalar_t>();
+        scalar_t *node_colors_ptr = node_colors.data_ptr<scalar_t>();
+        for (int64_t k = 0; k < M; ++k) {
+            for (int i = 0; i < 3; ++i) {
+                node_means_ptr[k * 3 + i] = tree.node_moments[k].mean[i];
+                node_scales_ptr[k * 3 + i] = tree.node_scales[k][i];
+            }
+            for (int i = 0; i < 4; ++i) {
+                node_quats_ptr[k * 4 + i] = tree.node_quats[k][i];
+            }
+            node_opacities_ptr[k] = tree.node_opacities[k];
+        }
+        std::copy_n(tree.node_colors.data(), M * D, node_colors_ptr);
+        std::copy_n(
+            tree.child_offsets.data(), M + 1, child_offsets.data_ptr<int64_t>()
+        );
+        std::copy_n(
+            tree.children.data(), children.numel(), children.data_ptr<int64_t>()
+        );
+        scalar_t *bounds_ptr = bounds.data_ptr<scalar_t>();
+        for (int64_t i = 0; i < N + M; ++i) {
+            for (int k = 0; k < 4; ++k) {
+                bounds_ptr[i * 4 + k] = tree.bounds[i][k];
+            }
+        }
+    });
+    return std::make_tuple(
+        node_means,
+        node_quats,
+        node_scales,
+        node_opacities,
+        node_colors,
+        child_offsets,
+        children,
+        bounds
+    );
+}
+
+at::Tensor lod_tree_cut_cpu(
+    const at::Tensor bounds,        // [N + M, 4]
+    const at::Tensor child_offsets, // [M + 1]
+    const at::Tensor children,      // [N + M - 1]
+    const at::Tensor viewmats,      // [C, 4, 4]
+    const at::Tensor Ks,            // [C, 3, 3]
+    const float pixel_size,
+    const float near_plane
+) {
+    const int64_t n_nodes = bounds.size(0);
+    const int64_t M = child_offsets.size(0) - 1;
+    const int64_t N = n_nodes - M;
+    const int64_t C = viewmats.size(0);
+    auto opt = bounds.options().dtype(at::kLong);
+    if (n_nodes == 0) {
+        return at::empty({0}, opt);
+    }
+
+    std::vector<int64_t> cut;
+    AT_DISPATCH_FLOATING_TYPES(bounds.scalar_type(), "lod_tree_cut_cpu", [&]() {
+        // camera centers -R^T t and focal lengths
+        std::vector<vec3> centers(C);
+        std::vector<float> focals(C);
+        const scalar_t *viewmats_ptr = viewmats.data_ptr<scalar_t>();
+        const scalar_t *Ks_ptr = Ks.data_ptr<scalar_t>();
+        for (int64_t cid = 0; cid < C; ++cid) {
+            const scalar_t *v = viewmats_ptr + cid * 16;
+            for (int i = 0; i < 3; ++i) {
+                centers[cid][i] =
+                    -(v[i] * v[3] + v[4 + i] * v[7] + v[8 + i] * v[11]);
+            }
+            const scalar_t *K = Ks_ptr + cid * 9;
+            focals[cid] = std::max(K[0], K[4]);
+        }
+
+        const scalar_t *bounds_ptr = bounds.data_ptr<scalar_t>();
+        const int64_t *offsets_ptr = child_offsets.data_ptr<int64_t>();
+        const int64_t *children_ptr = children.data_ptr<int64_t>();
+        auto expand = [&](const int64_t id) {
+            if (id < N) {
+                return false; // leaves are never expanded
+            }
+            const scalar_t *b = bounds_ptr + id * 4;
+            return lod_node_too_large(
+                vec4(b[0], b[1], b[2], b[3]),
+                C,
+                centers.data(),
+                focals.data(),
+                pixel_size,
+                near_plane
+            );
+        };
+
+        // breadth-first from the root until the frontier is wide enough
+        std::vector<int64_t> frontier = {n_nodes - 1}, next;
+        while (!frontier.empty() &&
+               (int64_t)frontier.size() < LOD_CUT_FRONTIER) {
+            next.clear();
+            for (const int64_t id : frontier) {
+                if (expand(id)) {
+                    for (int64_t c = offsets_ptr[id - N];
+                         c < offsets_ptr[id - N + 1];
+                         ++c) {
+                        next.push_back(children_ptr[c]);
+                    }
+                } else {
+                    cut.push_back(id);
+                }
+            }
+            frontier.swap(next);
+        }
+
+        // depth-first below the frontier, in parallel
+        std::vector<std::vector<int64_t>> subtree_cuts(frontier.size());
+        at::parallel_for(
+            0, frontier.size(), 1, [&](int64_t begin, int64_t end) {
+                std::vector<int64_t> stack;
+                for (int64_t f = begin; f < end; ++f) {
+                    std::vector<int64_t> &out = subtree_cuts[f];
+                    stack.assign(1, frontier[f]);
+                    while (!stack.empty()) {
+                        const int64_t id = stack.back();
+                        stack.pop_back();
+                        if (!expand(id)) {
+                            out.push_back(id);
+                            continue;
+                        }
+                        // push in reverse to visit the children in order
+                        for (int64_t c = offsets_ptr[id - N + 1] - 1;
+                             c >= offsets_ptr[id - N];
+                             --c) {
+                            stack.push_back(children_ptr[c]);
+                        }
+                    }
+                }
+            }
+        );
+        for (const auto &out : subtree_cuts) {
+            cut.insert(cut.end(), out.begin(), out.end());
+        }
+    });
+
+    at::Tensor node_ids = at::empty({(int64_t)cut.size()}, opt);
+    std::copy(cut.begin(), cut.end(), node_ids.data_ptr<int64_t>());
+    return node_ids;
+}
+
+} // namespace gsplat
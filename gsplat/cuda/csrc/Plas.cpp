@@ -0,0 +1,38 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h" // where all the macros are defined
+#include "Ops.h"    // a collection of all gsplat operators
+#include "Plas.h"   // where the CPU functions are declared
+
+namespace gsplat {
+
+at::Tensor plas_sort(
+    const at::Tensor params, // [N, C]
+    const int64_t width,
+    const double shrink_factor,
+    const double improvement_break,
+    const int64_t seed
+) {
+    TORCH_CHECK(params.is_cpu(), "params must be a CPU tensor");
+    CHECK_CONTIGUOUS(params);
+    TORCH_CHECK(
+        params.scalar_type() == at::kFloat && params.dim() == 2,
+        "params must be a float32 tensor of shape [N, C]"
+    );
+    TORCH_CHECK(width > 0, "width must be positive");
+    TORCH_CHECK(
+        shrink_factor > 0.0 && shrink_factor < 1.0,
+        "shrink_factor must be in (0, 1)"
+    );
+
+    at::Tensor order =
+        at::empty({params.size(0)}, params.options().dtype(at::kLong));
+    plas_sort_cpu(params, width, shrink_factor, improvement_break, seed, order);
+    return order;
+}
+
+} // namespace gsplat
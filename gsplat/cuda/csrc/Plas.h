@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+// The PLAS grid sorting only has a CPU implementation.
+
+// Parallel Linear Assignment Sorting: arrange N vectors on a grid of `width`
+// columns (row-major, the last row may be partial) so that neighbors are
+// similar. For a shrinking radius, the grid is box-blurred and every cell is
+// moved towards the position whose blurred value it is closest to, by
+// solving small assignment problems among random quadruples of cells of
+// non-overlapping blocks, the blocks being processed in parallel.
+void plas_sort_cpu(
+    const at::Tensor params, // [N, C] float32
+    const int64_t width,
+    const double shrink_factor,
+    const double improvement_break,
+    const int64_t seed,
+    // outputs
+    at::Tensor order // [N] int64, params[order] is the sorted grid
+);
+
+} // namespace gsplat
@@ -0,0 +1,454 @@
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Common.h"
+#include "Plas.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Rows or columns per task of the box blur.
+constexpr int64_t PLAS_BLUR_GRAIN_SIZE = 16;
+// Blocks per task when shuffling them, quadruples per task when solving them.
+constexpr int64_t PLAS_BLOCK_GRAIN_SIZE = 64;
+constexpr int64_t PLAS_QUAD_GRAIN_SIZE = 1024;
+// Maximum number of passes at a given radius.
+constexpr int PLAS_MAX_PASSES = 16;
+
+using Permutations = std::array<std::array<int, 4>, 24>;
+
+// The 24 permutations of 4 elements, starting with the identity.
+Permutations make_permutations() {
+    Permutations perms;
+    std::array<int, 4> p = {0, 1, 2, 3};
+    for (auto &perm : perms) {
+        perm = p;
+        std::next_permutation(p.begin(), p.end());
+    }
+    return perms;
+}
+
+GSPLAT_CPU_INLINE uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+GSPLAT_CPU_INLINE float sq_distance(
+    const float *__restrict__ a, const float *__restrict__ b, const int64_t C
+) {
+    float dist = 0.f;
+#pragma omp simd reduction(+ : dist)
+    for (int64_t c = 0; c < C; ++c) {
+        const float diff = a[c] - b[c];
+        dist += diff * diff;
+    }
+    return dist;
+}
+
+// A tiling of the H x W grid in blocks of S x S cells shifted by (ox, oy).
+struct Tiling {
+    int64_t H, W, S, ox, oy;
+    int64_t n_blocks_x, n_blocks_y;
+
+    Tiling(
+        const int64_t H,
+        const int64_t W,
+        const int64_t S,
+        const int64_t ox,
+        const int64_t oy
+    )
+        : H(H), W(W), S(S), ox(ox), oy(oy), n_blocks_x((W + ox + S - 1) / S),
+          n_blocks_y((H + oy + S - 1) / S) {}
+
+    // Cells [y0, y1) x [x0, x1) of the block b.
+    void block(
+        const int64_t b, int64_t &y0, int64_t &y1, int64_t &x0, int64_t &x1
+    ) const {
+        y0 = std::max<int64_t>(0, (b / n_blocks_x) * S - oy);
+        y1 = std::min(H, (b / n_blocks_x + 1) * S - oy);
+        x0 = std::max<int64_t>(0, (b % n_blocks_x) * S - ox);
+        x1 = std::min(W, (b % n_blocks_x + 1) * S - ox);
+    }
+};
+
+// Horizontal pass of the box blur: window sums of the valid cells (the
+// first N in row-major order) and their counts.
+GSPLAT_CPU_TARGET_CLONES void blur_rows_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const float *__restrict__ values, // [N, C]
+    const int64_t N,
+    const int64_t W,
+    const int64_t C,
+    const int64_t r,
+    float *__restrict__ sums,  // [H * W, C]
+    float *__restrict__ counts // [H * W]
+) {
+    std::vector<double> acc(C);
+    for (int64_t y = begin; y < end; ++y) {
+        const int64_t xv = std::clamp<int64_t>(N - y * W, 0, W);
+        const float *row = values + y * W * C;
+        std::fill(acc.begin(), acc.end(), 0.0);
+        int64_t count = 0;
+        for (int64_t x = 0; x < std::min(r, xv); ++x) {
+            for (int64_t c = 0; c < C; ++c) {
+                acc[c] += row[x * C + c];
+            }
+            count++;
+        }
+        for (int64_t x = 0; x < W; ++x) {
+            if (x + r < xv) {
+                for (int64_t c = 0; c < C; ++c) {
+                    acc[c] += row[(x + r) * C + c];
+                }
+                count++;
+            }
+            if (x - r - 1 >= 0 && x - r - 1 < xv) {
+                for (int64_t c = 0; c < C; ++c) {
+                    acc[c] -= row[(x - r - 1) * C + c];
+                }
+                count--;
+            }
+            float *out = sums + (y * W + x) * C;
+            for (int64_t c = 0; c < C; ++c) {
+                out[c] = acc[c];
+            }
+            counts[y * W + x] = count;
+        }
+    }
+}
+
+// Vertical pass of the box blur on the columns [begin, end), writing the
+// blurred values of the valid cells.
+GSPLAT_CPU_TARGET_CLONES void blur_columns_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const float *__restrict__ sums,   // [H * W, C]
+    const float *__restrict__ counts, // [H * W]
+    const int64_t N,
+    const int64_t H,
+    const int64_t W,
+    const int64_t C,
+    const int64_t r,
+    float *__restrict__ target // [N, C]
+) {
+    const int64_t n = end - begin;
+    std::vector<double> acc(n * C, 0.0);
+    std::vector<double> acc_counts(n, 0.0);
+    auto add_row = [&](const int64_t y, const double sign) {
+        const float *s = sums + (y * W + begin) * C;
+        const float *w = counts + y * W + begin;
+        for (int64_t i = 0; i < n * C; ++i) {
+            acc[i] += sign * s[i];
+        }
+        for (int64_t i = 0; i < n; ++i) {
+            acc_counts[i] += sign * w[i];
+        }
+    };
+    for (int64_t y = 0; y < std::min(r, H); ++y) {
+        add_row(y, 1.0);
+    }
+    for (int64_t y = 0; y < H; ++y) {
+        if (y + r < H) {
+            add_row(y + r, 1.0);
+        }
+        if (y - r - 1 >= 0) {
+            add_row(y - r - 1, -1.0);
+        }
+        const int64_t x_end = std::min(end, N - y * W);
+        for (int64_t x = begin; x < x_end; ++x) {
+            const double inv = 1.0 / acc_counts[x - begin];
+            float *out = target + (y * W + x) * C;
+            for (int64_t c = 0; c < C; ++c) {
+                out[c] = acc[(x - begin) * C + c] * inv;
+            }
+        }
+    }
+}
+
+// Gather the valid cells of the blocks [begin, end), shuffle them and keep a
+// multiple of 4 of them.
+GSPLAT_CPU_TARGET_CLONES void shuffle_blocks_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t N,
+    const Tiling &tiling,
+    const uint64_t seed,
+    const int64_t *__restrict__ offsets, // [n_blocks + 1], in quadruples
+    int64_t *__restrict__ cells          // [4 * n_quads]
+) {
+    const int64_t W = tiling.W;
+    std::vector<int64_t> buffer;
+    for (int64_t b = begin; b < end; ++b) {
+        int64_t y0, y1, x0, x1;
+        tiling.block(b, y0, y1, x0, x1);
+        buffer.clear();
+        for (int64_t y = y0; y < y1; ++y) {
+            for (int64_t x = x0; x < std::min(x1, N - y * W); ++x) {
+                buffer.push_back(y * W + x);
+            }
+        }
+        uint64_t state = splitmix64(seed ^ splitmix64(b));
+        for (int64_t i = buffer.size() - 1; i > 0; --i) {
+            state = splitmix64(state);
+            std::swap(buffer[i], buffer[state % (i + 1)]);
+        }
+        std::copy_n(
+            buffer.begin(),
+            4 * (offsets[b + 1] - offsets[b]),
+            cells + 4 * offsets[b]
+        );
+    }
+}
+
+// Move the 4 cells of every quadruple to the arrangement that is the closest
+// to the blurred grid. Returns the decrease of the squared error.
+GSPLAT_CPU_TARGET_CLONES double solve_quads_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t *__restrict__ cells, // [4 * n_quads]
+    const float *__restrict__ target,  // [N, C]
+    const int64_t C,
+    const Permutations &perms,
+    float *__restrict__ values, // [N, C]
+    int64_t *__restrict__ ids   // [N]
+) {
+    std::vector<float> buffer(4 * C);
+    double improvement = 0.0;
+    for (int64_t q = begin; q < end; ++q) {
+        const int64_t *cell = cells + 4 * q;
+        // cost[i][j]: value of the cell i at the position of the cell j
+        float cost[4][4];
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                cost[i][j] = sq_distance(
+                    values + cell[i] * C, target + cell[j] * C, C
+                );
+            }
+        }
+        const float current = cost[0][0] + cost[1][1] + cost[2][2] + cost[3][3];
+        int best = 0;
+        float best_cost = current;
+        for (int p = 1; p < 24; ++p) {
+            const auto &perm = perms[p];
+            const float c = cost[0][perm[0]] + cost[1][perm[1]] +
+                            cost[2][perm[2]] + cost[3][perm[3]];
+            if (c < best_cost) {
+                best_cost = c;
+                best = p;
+            }
+        }
+        if (best == 0) {
+            continue;
+        }
+        improvement += current - best_cost;
+
+        const auto &perm = perms[best];
+        int64_t moved_ids[4];
+        for (int i = 0; i < 4; ++i) {
+            std::copy_n(values + cell[i] * C, C, buffer.data() + i * C);
+            moved_ids[i] = ids[cell[i]];
+        }
+        for (int i = 0; i < 4; ++i) {
+            std::copy_n(buffer.data() + i * C, C, values + cell[perm[i]] * C);
+            ids[cell[perm[i]]] = moved_ids[i];
+        }
+    }
+    return improvement;
+}
+
+GSPLAT_CPU_TARGET_CLONES double sq_error_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const float *__restrict__ values, // [N, C]
+    const float *__restrict__ target, // [N, C]
+    const int64_t C
+) {
+    double error = 0.0;
+    for (int64_t i = begin; i < end; ++i) {
+        error += sq_distance(values + i * C, target + i * C, C);
+    }
+    return error;
+}
+
+} // namespace
+
+void plas_sort_cpu(
+    const at::Tensor params, // [N, C] float32
+    const int64_t width,
+    const double shrink_factor,
+    const double improvement_break,
+    const int64_t seed,
+    // outputs
+    at::Tensor order // [N] int64, params[order] is the sorted grid
+) {
+    const int64_t N = params.size(0);
+    const int64_t C = params.size(1);
+    if (N == 0) {
+        return;
+    }
+    const int64_t W = std::min(width, N);
+    const int64_t H = (N + W - 1) / W;
+    const float *params_ptr = params.data_ptr<float>();
+    int64_t *order_ptr = order.data_ptr<int64_t>();
+    const Permutations perms = make_permutations();
+    std::mt19937_64 rng(seed);
+
+    // start from a random arrangement
+    std::vector<int64_t> ids(N);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    std::vector<float> values(N * C);
+    at::parallel_for(0, N, CPU_CHUNK_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            std::copy_n(params_ptr + ids[i] * C, C, values.data() + i * C);
+        }
+    });
+
+    std::vector<float> sums(H * W * C);
+    std::vector<float> counts(H * W);
+    std::vector<float> target(N * C);
+    std::vector<int64_t> offsets;
+    std::vector<int64_t> cells;
+    for (double radius = std::max(H, W) / 4.0;; radius *= shrink_factor) {
+        const int64_t r = std::max<int64_t>(1, std::llround(radius));
+
+        at::parallel_for(
+            0,
+            H,
+            PLAS_BLUR_GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+                blur_rows_cpu(
+                    begin,
+                    end,
+                    values.data(),
+                    N,
+                    W,
+                    C,
+                    r,
+                    sums.data(),
+                    counts.data()
+                );
+            }
+        );
+        at::parallel_for(
+            0,
+            W,
+            PLAS_BLUR_GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+                blur_columns_cpu(
+                    begin,
+                    end,
+                    sums.data(),
+                    counts.data(),
+                    N,
+                    H,
+                    W,
+                    C,
+                    r,
+                    target.data()
+                );
+            }
+        );
+        const double error = at::parallel_reduce(
+            0,
+            N,
+            CPU_CHUNK_SIZE,
+            0.0,
+            [&](int64_t begin, int64_t end, double ident) {
+                return ident +
+                       sq_error_cpu(
+                           begin, end, values.data(), target.data(), C
+                       );
+            },
+            std::plus<double>()
+        );
+
+        // blocks of 2r x 2r cells: the cells are swapped within a radius
+        const int64_t S = 2 * r;
+        for (int pass = 0; pass < PLAS_MAX_PASSES; ++pass) {
+            const int64_t ox = std::uniform_int_distribution<int64_t>(
+                0, S - 1
+            )(rng);
+            const int64_t oy = std::uniform_int_distribution<int64_t>(
+                0, S - 1
+            )(rng);
+            const Tiling tiling(H, W, S, ox, oy);
+            const int64_t n_blocks = tiling.n_blocks_x * tiling.n_blocks_y;
+
+            // number of quadruples of every block, from its number of valid
+            // cells: full rows, then the partial last row
+            offsets.assign(n_blocks + 1, 0);
+            for (int64_t b = 0; b < n_blocks; ++b) {
+                int64_t y0, y1, x0, x1;
+                tiling.block(b, y0, y1, x0, x1);
+                int64_t count =
+                    (x1 - x0) * std::max<int64_t>(0, std::min(y1, N / W) - y0);
+                if (y0 <= N / W && N / W < y1) {
+                    count += std::clamp<int64_t>(N % W - x0, 0, x1 - x0);
+                }
+                offsets[b + 1] = offsets[b] + count / 4;
+            }
+            const int64_t n_quads = offsets[n_blocks];
+            cells.resize(4 * n_quads);
+
+            const uint64_t pass_seed = rng();
+            at::parallel_for(
+                0,
+                n_blocks,
+                PLAS_BLOCK_GRAIN_SIZE,
+                [&](int64_t begin, int64_t end) {
+                    shuffle_blocks_cpu(
+                        begin,
+                        end,
+                        N,
+                        tiling,
+                        pass_seed,
+                        offsets.data(),
+                        cells.data()
+                    );
+                }
+            );
+            const double improvement = at::parallel_reduce(
+                0,
+                n_quads,
+                PLAS_QUAD_GRAIN_SIZE,
+                0.0,
+                [&](int64_t begin, int64_t end, double ident) {
+                    return ident + solve_quads_cpu(
+                                       begin,
+                                       end,
+                                       cells.data(),
+                                       target.data(),
+                                       C,
+                                       perms,
+                                       values.data(),
+                                       ids.data()
+                                   );
+                },
+                std::plus<double>()
+            );
+            if (improvement <= improvement_break * error) {
+                break;
+            }
+        }
+
+        if (r == 1) {
+            break;
+        }
+    }
+
+    std::copy(ids.begin(), ids.end(), order_ptr);
+}
+
+} // namespace gsplat
@@ -10,6 +10,7 @@
 #include "Ops.h"        // a collection of all gsplat operators
 #include "Projection.h" // where the launch function is declared
 #include "Cameras.h"
+#include "Utils.cuh" // for the storage of the Gaussians
 
 namespace gsplat {
 
@@ -101,18 +102,71 @@ std::tuple<at::Tensor, at::Tensor> projection_ewa_simple_bwd(
     return std::make_tuple(v_means, v_covars);
 }
 
+namespace {
+
+// Checks the inputs of the storage projections.
+void check_storage_geometry(
+    const at::Tensor means,                 // [..., N, 3]
+    const at::Tensor quats,                 // [..., N, 4]
+    const at::Tensor scales,                // [..., N, 3]
+    const at::Tensor opacities,             // [..., N]
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const int64_t chunk_size,
+    const at::Tensor viewmats, // [..., C, 4, 4]
+    const at::Tensor Ks        // [..., C, 3, 3]
+) {
+    const at::ScalarType storage = means.scalar_type();
+    TORCH_CHECK(
+        storage == at::kFloat || storage == at::kHalf || storage == at::kByte,
+        "means must be stored in float32, float16 or uint8"
+    );
+    TORCH_CHECK(
+        quats.scalar_type() == storage && scales.scalar_type() == storage &&
+            opacities.scalar_type() == storage,
+        "means, quats, scales and opacities must have the same dtype"
+    );
+    TORCH_CHECK(
+        viewmats.scalar_type() == at::kFloat && Ks.scalar_type() == at::kFloat,
+        "viewmats and Ks must be float32"
+    );
+    TORCH_CHECK(
+        dequant.has_value() == (storage == at::kByte),
+        "dequant must be given if and only if the Gaussians are stored in uint8"
+    );
+    if (dequant.has_value()) {
+        const int64_t N = means.numel() / 3;
+        TORCH_CHECK(chunk_size > 0, "chunk_size must be positive");
+        TORCH_CHECK(
+            dequant.value().scalar_type() == at::kFloat &&
+                dequant.value().dim() == 3 &&
+                dequant.value().size(0) ==
+                    (N + chunk_size - 1) / chunk_size &&
+                dequant.value().size(1) == 2 &&
+                dequant.value().size(2) == STORAGE_GEOMETRY_CHANNELS,
+            "dequant must be a float32 tensor of shape [n_chunks, 2, 11]"
+        );
+    }
+}
+
+// The fused projection of Gaussians whose attributes may be stored in float16
+// or uint8 (see `projection_ewa_3dgs_storage_fwd`). The outputs have the
+// dtype of the cameras. With `return_opacities`, the opacities read by the
+// kernel are returned as well, as [..., C, N].
 std::tuple<
     at::Tensor,
     at::Tensor,
     at::Tensor,
     at::Tensor,
+    at::Tensor,
     at::Tensor>
-projection_ewa_3dgs_fused_fwd(
+projection_ewa_3dgs_fused_fwd_impl(
     const at::Tensor means,                // [..., N, 3]
     const at::optional<at::Tensor> covars, // [..., N, 6] optional
     const at::optional<at::Tensor> quats,  // [..., N, 4] optional
     const at::optional<at::Tensor> scales, // [..., N, 3] optional
     const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
     const at::Tensor viewmats,             // [..., C, 4, 4]
     const at::Tensor Ks,                   // [..., C, 3, 3]
     const uint32_t image_width,
@@ -122,21 +176,30 @@ projection_ewa_3dgs_fused_fwd(
     const float far_plane,
     const float radius_clip,
     const bool calc_compensations,
+    const bool return_opacities,
     const CameraModelType camera_model
 ) {
     DEVICE_GUARD(means);
-    CHECK_INPUT(means);
+    CHECK_CUDA_OR_CPU(means);
+    CHECK_CONTIGUOUS(means);
     if (covars.has_value()) {
-        CHECK_INPUT(covars.value());
+        CHECK_INPUT_LIKE(covars.value(), means);
     } else {
         assert(quats.has_value() && scales.has_value());
-        CHECK_INPUT(quats.value());
-        CHECK_INPUT(scales.value());
+        CHECK_INPUT_LIKE(quats.value(), means);
+        CHECK_INPUT_LIKE(scales.value(), means);
     }
-    CHECK_INPUT(viewmats);
-    CHECK_INPUT(Ks);
+    if (opacities.has_value()) {
+        CHECK_INPUT_LIKE(opacities.value(), means);
+    }
+    if (dequant.has_value()) {
+        CHECK_INPUT_LIKE(dequant.value(), means);
+    }
+    CHECK_INPUT_LIKE(viewmats, means);
+    CHECK_INPUT_LIKE(Ks, means);
+    assert(opacities.has_value() || !return_opacities);
 
-    auto opt = means.options();
+    auto opt = viewmats.options();
     at::DimVector batch_dims(means.sizes().slice(0, means.dim() - 2));
     uint32_t N = means.size(-2);    // number of gaussians
     uint32_t C = viewmats.size(-3); // number of cameras
@@ -160,14 +223,25 @@ projection_ewa_3dgs_fused_fwd(
         compensations_shape.append({C, N});
         compensations = at::zeros(compensations_shape, opt);
     }
+    at::Tensor out_opacities;
+    if (return_opacities) {
+        at::DimVector opacities_shape(batch_dims);
+        opacities_shape.append({C, N});
+        out_opacities = at::zeros(opacities_shape, opt);
+    }
 
-    launch_projection_ewa_3dgs_fused_fwd_kernel(
+    auto launch = means.is_cpu()
+                      ? launch_projection_ewa_3dgs_fused_fwd_kernel_cpu
+                      : launch_projection_ewa_3dgs_fused_fwd_kernel;
+    launch(
         // inputs
         means,
         covars,
         quats,
         scales,
         opacities,
+        dequant,
+        chunk_size,
         viewmats,
         Ks,
         image_width,
@@ -183,11 +257,115 @@ projection_ewa_3dgs_fused_fwd(
         depths,
         conics,
         calc_compensations ? at::optional<at::Tensor>(compensations)
-                           : c10::nullopt
+                           : c10::nullopt,
+        return_opacities ? at::optional<at::Tensor>(out_opacities)
+                         : c10::nullopt
+    );
+    return std::make_tuple(
+        radii, means2d, depths, conics, compensations, out_opacities
     );
+}
+
+} // namespace
+
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+projection_ewa_3dgs_fused_fwd(
+    const at::Tensor means,                // [..., N, 3]
+    const at::optional<at::Tensor> covars, // [..., N, 6] optional
+    const at::optional<at::Tensor> quats,  // [..., N, 4] optional
+    const at::optional<at::Tensor> scales, // [..., N, 3] optional
+    const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::Tensor viewmats,             // [..., C, 4, 4]
+    const at::Tensor Ks,                   // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const CameraModelType camera_model
+) {
+    at::Tensor radii, means2d, depths, conics, compensations;
+    std::tie(radii, means2d, depths, conics, compensations, std::ignore) =
+        projection_ewa_3dgs_fused_fwd_impl(
+            means,
+            covars,
+            quats,
+            scales,
+            opacities,
+            c10::nullopt,
+            0,
+            viewmats,
+            Ks,
+            image_width,
+            image_height,
+            eps2d,
+            near_plane,
+            far_plane,
+            radius_clip,
+            calc_compensations,
+            false,
+            camera_model
+        );
     return std::make_tuple(radii, means2d, depths, conics, compensations);
 }
 
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+projection_ewa_3dgs_storage_fwd(
+    const at::Tensor means,                 // [..., N, 3]
+    const at::Tensor quats,                 // [..., N, 4]
+    const at::Tensor scales,                // [..., N, 3]
+    const at::Tensor opacities,             // [..., N]
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const int64_t chunk_size,
+    const at::Tensor viewmats, // [..., C, 4, 4]
+    const at::Tensor Ks,       // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const CameraModelType camera_model
+) {
+    check_storage_geometry(
+        means, quats, scales, opacities, dequant, chunk_size, viewmats, Ks
+    );
+    return projection_ewa_3dgs_fused_fwd_impl(
+        means,
+        c10::nullopt,
+        quats,
+        scales,
+        opacities,
+        dequant,
+        chunk_size,
+        viewmats,
+        Ks,
+        image_width,
+        image_height,
+        eps2d,
+        near_plane,
+        far_plane,
+        radius_clip,
+        calc_compensations,
+        true,
+        camera_model
+    );
+}
+
 std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
 projection_ewa_3dgs_fused_bwd(
     // fwd inputs
@@ -213,26 +391,27 @@ projection_ewa_3dgs_fused_bwd(
     const bool viewmats_requires_grad
 ) {
     DEVICE_GUARD(means);
-    CHECK_INPUT(means);
+    CHECK_CUDA_OR_CPU(means);
+    CHECK_CONTIGUOUS(means);
     if (covars.has_value()) {
-        CHECK_INPUT(covars.value());
+        CHECK_INPUT_LIKE(covars.value(), means);
     } else {
         assert(quats.has_value() && scales.has_value());
-        CHECK_INPUT(quats.value());
-        CHECK_INPUT(scales.value());
+        CHECK_INPUT_LIKE(quats.value(), means);
+        CHECK_INPUT_LIKE(scales.value(), means);
     }
-    CHECK_INPUT(viewmats);
-    CHECK_INPUT(Ks);
-    CHECK_INPUT(radii);
-    CHECK_INPUT(conics);
-    CHECK_INPUT(v_means2d);
-    CHECK_INPUT(v_depths);
-    CHECK_INPUT(v_conics);
+    CHECK_INPUT_LIKE(viewmats, means);
+    CHECK_INPUT_LIKE(Ks, means);
+    CHECK_INPUT_LIKE(radii, means);
+    CHECK_INPUT_LIKE(conics, means);
+    CHECK_INPUT_LIKE(v_means2d, means);
+    CHECK_INPUT_LIKE(v_depths, means);
+    CHECK_INPUT_LIKE(v_conics, means);
     if (compensations.has_value()) {
-        CHECK_INPUT(compensations.value());
+        CHECK_INPUT_LIKE(compensations.value(), means);
     }
     if (v_compensations.has_value()) {
-        CHECK_INPUT(v_compensations.value());
+        CHECK_INPUT_LIKE(v_compensations.value(), means);
         assert(compensations.has_value());
     }
 
@@ -249,7 +428,10 @@ projection_ewa_3dgs_fused_bwd(
         v_viewmats = at::zeros_like(viewmats);
     }
 
-    launch_projection_ewa_3dgs_fused_bwd_kernel(
+    auto launch = means.is_cpu()
+                      ? launch_projection_ewa_3dgs_fused_bwd_kernel_cpu
+                      : launch_projection_ewa_3dgs_fused_bwd_kernel;
+    launch(
         // inputs
         means,
         covars,
@@ -280,6 +462,12 @@ projection_ewa_3dgs_fused_bwd(
     return std::make_tuple(v_means, v_covars, v_quats, v_scales, v_viewmats);
 }
 
+namespace {
+
+// The packed projection of Gaussians whose attributes may be stored in float16
+// or uint8 (see `projection_ewa_3dgs_storage_packed_fwd`). The outputs have
+// the dtype of the cameras. With `return_opacities`, the opacities read by the
+// kernel are returned as well, as [nnz].
 std::tuple<
     at::Tensor,
     at::Tensor,
@@ -289,13 +477,16 @@ std::tuple<
     at::Tensor,
     at::Tensor,
     at::Tensor,
+    at::Tensor,
     at::Tensor>
-projection_ewa_3dgs_packed_fwd(
+projection_ewa_3dgs_packed_fwd_impl(
     const at::Tensor means,                // [..., N, 3]
     const at::optional<at::Tensor> covars, // [..., N, 6] optional
     const at::optional<at::Tensor> quats,  // [..., N, 4] optional
     const at::optional<at::Tensor> scales, // [..., N, 3] optional
     const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
     const at::Tensor viewmats,             // [..., C, 4, 4]
     const at::Tensor Ks,                   // [..., C, 3, 3]
     const uint32_t image_width,
@@ -305,24 +496,58 @@ projection_ewa_3dgs_packed_fwd(
     const float far_plane,
     const float radius_clip,
     const bool calc_compensations,
+    const bool return_opacities,
     const CameraModelType camera_model
 ) {
     DEVICE_GUARD(means);
-    CHECK_INPUT(means);
+    CHECK_CUDA_OR_CPU(means);
+    CHECK_CONTIGUOUS(means);
     if (covars.has_value()) {
-        CHECK_INPUT(covars.value());
+        CHECK_INPUT_LIKE(covars.value(), means);
     } else {
         assert(quats.has_value() && scales.has_value());
-        CHECK_INPUT(quats.value());
-        CHECK_INPUT(scales.value());
+        CHECK_INPUT_LIKE(quats.value(), means);
+        CHECK_INPUT_LIKE(scales.value(), means);
+    }
+    if (opacities.has_value()) {
+        CHECK_INPUT_LIKE(opacities.value(), means);
+    }
+    if (dequant.has_value()) {
+        CHECK_INPUT_LIKE(dequant.value(), means);
+    }
+    CHECK_INPUT_LIKE(viewmats, means);
+    CHECK_INPUT_LIKE(Ks, means);
+    assert(opacities.has_value() || !return_opacities);
+
+    if (means.is_cpu()) {
+        // single pass with per-thread compaction, see
+        // ProjectionEWA3DGSPackedCPU.cpp
+        return projection_ewa_3dgs_packed_fwd_cpu(
+            means,
+            covars,
+            quats,
+            scales,
+            opacities,
+            dequant,
+            chunk_size,
+            viewmats,
+            Ks,
+            image_width,
+            image_height,
+            eps2d,
+            near_plane,
+            far_plane,
+            radius_clip,
+            calc_compensations,
+            return_opacities,
+            camera_model
+        );
     }
-    CHECK_INPUT(viewmats);
-    CHECK_INPUT(Ks);
 
     uint32_t N = means.size(-2);          // number of gaussians
     uint32_t C = viewmats.size(-3);       // number of cameras
     uint32_t B = means.numel() / (N * 3); // number of batches
-    auto opt = means.options();
+    auto opt = viewmats.options();
 
     uint32_t nrows = B * C;
     uint32_t ncols = N;
@@ -341,6 +566,8 @@ projection_ewa_3dgs_packed_fwd(
             quats,
             scales,
             opacities,
+            dequant,
+            chunk_size,
             viewmats,
             Ks,
             image_width,
@@ -363,7 +590,8 @@ projection_ewa_3dgs_packed_fwd(
             c10::nullopt, // conics
             // pass in as an indicator on whether compensation will be applied or not.
             calc_compensations ? at::optional<at::Tensor>(at::empty({1}, opt))
-                               : c10::nullopt
+                               : c10::nullopt,
+            c10::nullopt // out_opacities
         );
         block_accum = at::cumsum(block_cnts, 0, at::kInt);
         nnz = block_accum[-1].item<int32_t>();
@@ -385,6 +613,10 @@ projection_ewa_3dgs_packed_fwd(
         // we dont want NaN to appear in this tensor, so we zero intialize it
         compensations = at::zeros({nnz}, opt);
     }
+    at::Tensor out_opacities;
+    if (return_opacities) {
+        out_opacities = at::empty({nnz}, opt);
+    }
 
     if (nnz) {
         launch_projection_ewa_3dgs_packed_fwd_kernel(
@@ -394,6 +626,8 @@ projection_ewa_3dgs_packed_fwd(
             quats,
             scales,
             opacities,
+            dequant,
+            chunk_size,
             viewmats,
             Ks,
             image_width,
@@ -415,12 +649,90 @@ projection_ewa_3dgs_packed_fwd(
             depths,
             conics,
             calc_compensations ? at::optional<at::Tensor>(compensations)
-                               : c10::nullopt
+                               : c10::nullopt,
+            return_opacities ? at::optional<at::Tensor>(out_opacities)
+                             : c10::nullopt
         );
     } else {
         indptr.fill_(0);
     }
 
+    return std::make_tuple(
+        indptr,
+        batch_ids,
+        camera_ids,
+        gaussian_ids,
+        radii,
+        means2d,
+        depths,
+        conics,
+        compensations,
+        out_opacities
+    );
+}
+
+} // namespace
+
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+projection_ewa_3dgs_packed_fwd(
+    const at::Tensor means,                // [..., N, 3]
+    const at::optional<at::Tensor> covars, // [..., N, 6] optional
+    const at::optional<at::Tensor> quats,  // [..., N, 4] optional
+    const at::optional<at::Tensor> scales, // [..., N, 3] optional
+    const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::Tensor viewmats,             // [..., C, 4, 4]
+    const at::Tensor Ks,                   // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const CameraModelType camera_model
+) {
+    at::Tensor indptr, batch_ids, camera_ids, gaussian_ids, radii, means2d,
+        depths, conics, compensations;
+    std::tie(
+        indptr,
+        batch_ids,
+        camera_ids,
+        gaussian_ids,
+        radii,
+        means2d,
+        depths,
+        conics,
+        compensations,
+        std::ignore
+    ) = projection_ewa_3dgs_packed_fwd_impl(
+        means,
+        covars,
+        quats,
+        scales,
+        opacities,
+        c10::nullopt,
+        0,
+        viewmats,
+        Ks,
+        image_width,
+        image_height,
+        eps2d,
+        near_plane,
+        far_plane,
+        radius_clip,
+        calc_compensations,
+        false,
+        camera_model
+    );
     return std::make_tuple(
         indptr,
         batch_ids,
@@ -434,6 +746,60 @@ projection_ewa_3dgs_packed_fwd(
     );
 }
 
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+projection_ewa_3dgs_storage_packed_fwd(
+    const at::Tensor means,                 // [..., N, 3]
+    const at::Tensor quats,                 // [..., N, 4]
+    const at::Tensor scales,                // [..., N, 3]
+    const at::Tensor opacities,             // [..., N]
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const int64_t chunk_size,
+    const at::Tensor viewmats, // [..., C, 4, 4]
+    const at::Tensor Ks,       // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const CameraModelType camera_model
+) {
+    check_storage_geometry(
+        means, quats, scales, opacities, dequant, chunk_size, viewmats, Ks
+    );
+    return projection_ewa_3dgs_packed_fwd_impl(
+        means,
+        c10::nullopt,
+        quats,
+        scales,
+        opacities,
+        dequant,
+        chunk_size,
+        viewmats,
+        Ks,
+        image_width,
+        image_height,
+        eps2d,
+        near_plane,
+        far_plane,
+        radius_clip,
+        calc_compensations,
+        true,
+        camera_model
+    );
+}
+
 std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
 projection_ewa_3dgs_packed_bwd(
     // fwd inputs
@@ -462,28 +828,29 @@ projection_ewa_3dgs_packed_bwd(
     const bool sparse_grad
 ) {
     DEVICE_GUARD(means);
-    CHECK_INPUT(means);
+    CHECK_CUDA_OR_CPU(means);
+    CHECK_CONTIGUOUS(means);
     if (covars.has_value()) {
-        CHECK_INPUT(covars.value());
+        CHECK_INPUT_LIKE(covars.value(), means);
     } else {
         assert(quats.has_value() && scales.has_value());
-        CHECK_INPUT(quats.value());
-        CHECK_INPUT(scales.value());
+        CHECK_INPUT_LIKE(quats.value(), means);
+        CHECK_INPUT_LIKE(scales.value(), means);
     }
-    CHECK_INPUT(viewmats);
-    CHECK_INPUT(Ks);
-    CHECK_INPUT(batch_ids);
-    CHECK_INPUT(camera_ids);
-    CHECK_INPUT(gaussian_ids);
-    CHECK_INPUT(conics);
-    CHECK_INPUT(v_means2d);
-    CHECK_INPUT(v_depths);
-    CHECK_INPUT(v_conics);
+    CHECK_INPUT_LIKE(viewmats, means);
+    CHECK_INPUT_LIKE(Ks, means);
+    CHECK_INPUT_LIKE(batch_ids, means);
+    CHECK_INPUT_LIKE(camera_ids, means);
+    CHECK_INPUT_LIKE(gaussian_ids, means);
+    CHECK_INPUT_LIKE(conics, means);
+    CHECK_INPUT_LIKE(v_means2d, means);
+    CHECK_INPUT_LIKE(v_depths, means);
+    CHECK_INPUT_LIKE(v_conics, means);
     if (compensations.has_value()) {
-        CHECK_INPUT(compensations.value());
+        CHECK_INPUT_LIKE(compensations.value(), means);
     }
     if (v_compensations.has_value()) {
-        CHECK_INPUT(v_compensations.value());
+        CHECK_INPUT_LIKE(v_compensations.value(), means);
         assert(compensations.has_value());
     }
 
@@ -511,7 +878,10 @@ projection_ewa_3dgs_packed_bwd(
         v_viewmats = at::zeros_like(viewmats, opt);
     }
 
-    launch_projection_ewa_3dgs_packed_bwd_kernel(
+    auto launch = means.is_cpu()
+                      ? launch_projection_ewa_3dgs_packed_bwd_kernel_cpu
+                      : launch_projection_ewa_3dgs_packed_bwd_kernel;
+    launch(
         // fwd inputs
         means,
         covars,
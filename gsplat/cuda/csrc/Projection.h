@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <tuple>
 #include "Cameras.h"
 
 namespace at {
@@ -43,6 +44,8 @@ void launch_projection_ewa_3dgs_fused_fwd_kernel(
     const at::optional<at::Tensor> quats,  // [..., N, 4] optional
     const at::optional<at::Tensor> scales, // [..., N, 3] optional
     const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
     const at::Tensor viewmats,             // [..., C, 4, 4]
     const at::Tensor Ks,                   // [..., C, 3, 3]
     const uint32_t image_width,
@@ -53,11 +56,12 @@ void launch_projection_ewa_3dgs_fused_fwd_kernel(
     const float radius_clip,
     const CameraModelType camera_model,
     // outputs
-    at::Tensor radii,                      // [..., C, N, 2]
-    at::Tensor means2d,                    // [..., C, N, 2]
-    at::Tensor depths,                     // [..., C, N]
-    at::Tensor conics,                     // [..., C, N, 3]
-    at::optional<at::Tensor> compensations // [..., C, N] optional
+    at::Tensor radii,                       // [..., C, N, 2]
+    at::Tensor means2d,                     // [..., C, N, 2]
+    at::Tensor depths,                      // [..., C, N]
+    at::Tensor conics,                      // [..., C, N, 3]
+    at::optional<at::Tensor> compensations, // [..., C, N] optional
+    at::optional<at::Tensor> out_opacities  // [..., C, N] optional
 );
 void launch_projection_ewa_3dgs_fused_bwd_kernel(
     // inputs
@@ -90,6 +94,64 @@ void launch_projection_ewa_3dgs_fused_bwd_kernel(
     at::Tensor v_viewmats // [..., C, 4, 4]
 );
 
+// CPU counterparts of the two launchers above.
+void launch_projection_ewa_3dgs_fused_fwd_kernel_cpu(
+    // inputs
+    const at::Tensor means,                // [..., N, 3]
+    const at::optional<at::Tensor> covars, // [..., N, 6] optional
+    const at::optional<at::Tensor> quats,  // [..., N, 4] optional
+    const at::optional<at::Tensor> scales, // [..., N, 3] optional
+    const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    const at::Tensor viewmats,             // [..., C, 4, 4]
+    const at::Tensor Ks,                   // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const CameraModelType camera_model,
+    // outputs
+    at::Tensor radii,                       // [..., C, N, 2]
+    at::Tensor means2d,                     // [..., C, N, 2]
+    at::Tensor depths,                      // [..., C, N]
+    at::Tensor conics,                      // [..., C, N, 3]
+    at::optional<at::Tensor> compensations, // [..., C, N] optional
+    at::optional<at::Tensor> out_opacities  // [..., C, N] optional
+);
+void launch_projection_ewa_3dgs_fused_bwd_kernel_cpu(
+    // inputs
+    // fwd inputs
+    const at::Tensor means,                // [..., N, 3]
+    const at::optional<at::Tensor> covars, // [..., N, 6] optional
+    const at::optional<at::Tensor> quats,  // [..., N, 4] optional
+    const at::optional<at::Tensor> scales, // [..., N, 3] optional
+    const at::Tensor viewmats,             // [..., C, 4, 4]
+    const at::Tensor Ks,                   // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const CameraModelType camera_model,
+    // fwd outputs
+    const at::Tensor radii,                       // [..., C, N, 2]
+    const at::Tensor conics,                      // [..., C, N, 3]
+    const at::optional<at::Tensor> compensations, // [..., C, N] optional
+    // grad outputs
+    const at::Tensor v_means2d,                     // [..., C, N, 2]
+    const at::Tensor v_depths,                      // [..., C, N]
+    const at::Tensor v_conics,                      // [..., C, N, 3]
+    const at::optional<at::Tensor> v_compensations, // [..., C, N] optional
+    const bool viewmats_requires_grad,
+    // outputs
+    at::Tensor v_means,   // [..., N, 3]
+    at::Tensor v_covars,  // [..., N, 3, 3]
+    at::Tensor v_quats,   // [..., N, 4]
+    at::Tensor v_scales,  // [..., N, 3]
+    at::Tensor v_viewmats // [..., C, 4, 4]
+);
+
 void launch_projection_ewa_3dgs_packed_fwd_kernel(
     // inputs
     const at::Tensor means,                // [..., N, 3]
@@ -97,6 +159,8 @@ void launch_projection_ewa_3dgs_packed_fwd_kernel(
     const at::optional<at::Tensor> quats,  // [..., N, 4] optional
     const at::optional<at::Tensor> scales, // [..., N, 3] optional
     const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
     const at::Tensor viewmats,             // [..., C, 4, 4]
     const at::Tensor Ks,                   // [..., C, 3, 3]
     const uint32_t image_width,
@@ -109,16 +173,17 @@ void launch_projection_ewa_3dgs_packed_fwd_kernel(
         block_accum, // [B * C * blocks_per_row] packing helper
     const CameraModelType camera_model,
     // outputs
-    at::optional<at::Tensor> block_cnts,   // [B * C * blocks_per_row] packing helper
-    at::optional<at::Tensor> indptr,       // [B * C + 1]
-    at::optional<at::Tensor> batch_ids,    // [nnz]
-    at::optional<at::Tensor> camera_ids,   // [nnz]
-    at::optional<at::Tensor> gaussian_ids, // [nnz]
-    at::optional<at::Tensor> radii,        // [nnz, 2]
-    at::optional<at::Tensor> means2d,      // [nnz, 2]
-    at::optional<at::Tensor> depths,       // [nnz]
-    at::optional<at::Tensor> conics,       // [nnz, 3]
-    at::optional<at::Tensor> compensations // [nnz] optional
+    at::optional<at::Tensor> block_cnts,    // [B * C * blocks_per_row] packing helper
+    at::optional<at::Tensor> indptr,        // [B * C + 1]
+    at::optional<at::Tensor> batch_ids,     // [nnz]
+    at::optional<at::Tensor> camera_ids,    // [nnz]
+    at::optional<at::Tensor> gaussian_ids,  // [nnz]
+    at::optional<at::Tensor> radii,         // [nnz, 2]
+    at::optional<at::Tensor> means2d,       // [nnz, 2]
+    at::optional<at::Tensor> depths,        // [nnz]
+    at::optional<at::Tensor> conics,        // [nnz, 3]
+    at::optional<at::Tensor> compensations, // [nnz] optional
+    at::optional<at::Tensor> out_opacities  // [nnz] optional
 );
 void launch_projection_ewa_3dgs_packed_bwd_kernel(
     // fwd inputs
@@ -152,6 +217,74 @@ void launch_projection_ewa_3dgs_packed_bwd_kernel(
     at::optional<at::Tensor> v_viewmats // [..., C, 4, 4] Optional
 );
 
+// CPU counterparts of the two packed launchers above. The CPU forward projects
+// every Gaussian once and compacts the visible ones on the fly, so instead of
+// being launched twice it allocates and returns the [nnz] outputs, in the
+// order of `projection_ewa_3dgs_storage_packed_fwd` in Ops.h (the opacities
+// are only returned with `return_opacities`).
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+projection_ewa_3dgs_packed_fwd_cpu(
+    const at::Tensor means,                   // [..., N, 3]
+    const at::optional<at::Tensor> covars,    // [..., N, 6] optional
+    const at::optional<at::Tensor> quats,     // [..., N, 4] optional
+    const at::optional<at::Tensor> scales,    // [..., N, 3] optional
+    const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant,   // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    const at::Tensor viewmats, // [..., C, 4, 4]
+    const at::Tensor Ks,       // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const bool return_opacities,
+    const CameraModelType camera_model
+);
+void launch_projection_ewa_3dgs_packed_bwd_kernel_cpu(
+    // fwd inputs
+    const at::Tensor means,                // [..., N, 3]
+    const at::optional<at::Tensor> covars, // [..., N, 6]
+    const at::optional<at::Tensor> quats,  // [..., N, 4]
+    const at::optional<at::Tensor> scales, // [..., N, 3]
+    const at::Tensor viewmats,             // [..., C, 4, 4]
+    const at::Tensor Ks,                   // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const CameraModelType camera_model,
+    // fwd outputs
+    const at::Tensor batch_ids,                   // [nnz]
+    const at::Tensor camera_ids,                  // [nnz]
+    const at::Tensor gaussian_ids,                // [nnz]
+    const at::Tensor conics,                      // [nnz, 3]
+    const at::optional<at::Tensor> compensations, // [nnz] optional
+    // grad outputs
+    const at::Tensor v_means2d,                     // [nnz, 2]
+    const at::Tensor v_depths,                      // [nnz]
+    const at::Tensor v_conics,                      // [nnz, 3]
+    const at::optional<at::Tensor> v_compensations, // [nnz] optional
+    const bool sparse_grad,
+    // grad inputs
+    at::Tensor v_means,                 // [..., N, 3] or [nnz, 3]
+    at::optional<at::Tensor> v_covars,  // [..., N, 6] or [nnz, 6] Optional
+    at::optional<at::Tensor> v_quats,   // [..., N, 4] or [nnz, 4] Optional
+    at::optional<at::Tensor> v_scales,  // [..., N, 3] or [nnz, 3] Optional
+    at::optional<at::Tensor> v_viewmats // [..., C, 4, 4] Optional
+);
+
 void launch_projection_2dgs_fused_fwd_kernel(
     // inputs
     const at::Tensor means,    // [..., N, 3]
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Common.h"
+#include "Utils.cuh"
+#include "UtilsCPU.h"
+
+// Per-Gaussian building blocks shared by the fused and packed CPU projections.
+
+namespace gsplat {
+
+// The world-space Gaussians of one chunk, stored SoA. They are staged once and
+// then projected into every camera, so the covariance is built from
+// (quat, scale) once per Gaussian instead of once per (camera, Gaussian).
+struct GaussianChunkCPU {
+    vec3 means[CPU_CHUNK_SIZE];
+    mat3 covars[CPU_CHUNK_SIZE];
+    vec4 quats[CPU_CHUNK_SIZE];
+    vec3 scales[CPU_CHUNK_SIZE];
+};
+
+// A camera with its world-to-camera transform in glm layout.
+struct CameraCPU {
+    mat3 R;
+    vec3 t;
+    float fx, fy, cx, cy;
+};
+
+// The projection of one Gaussian into one camera.
+struct ProjectedGaussianCPU {
+    int32_t radius[2];
+    vec2 mean2d;
+    float depth;
+    vec3 conic;
+    float compensation;
+};
+
+// attr_t is the storage type of the means, quats and scales, which differs
+// from scalar_t when they are stored in float16 or uint8 (see Utils.cuh).
+template <typename scalar_t, typename attr_t>
+inline void load_gaussian(
+    const int64_t g, // index of the Gaussian in [B * N]
+    const attr_t *__restrict__ means,    // [B, N, 3]
+    const scalar_t *__restrict__ covars, // [B, N, 6] optional
+    const attr_t *__restrict__ quats,    // [B, N, 4] optional
+    const attr_t *__restrict__ scales,   // [B, N, 3] optional
+    const float *__restrict__ dequant,   // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    vec3 &mean,
+    mat3 &covar,
+    vec4 &quat,
+    vec3 &scale
+) {
+    load_storage_geometry(
+        g,
+        means,
+        covars != nullptr ? nullptr : quats,
+        scales,
+        dequant,
+        chunk_size,
+        mean,
+        quat,
+        scale
+    );
+    if (covars != nullptr) {
+        const scalar_t *c = covars + g * 6;
+        covar = mat3(
+            c[0],
+            c[1],
+            c[2], // 1st column
+            c[1],
+            c[3],
+            c[4], // 2nd column
+            c[2],
+            c[4],
+            c[5] // 3rd column
+        );
+    } else {
+        // compute from quaternions and scales
+        quat_scale_to_covar_preci(quat, scale, &covar, nullptr);
+    }
+}
+
+template <typename scalar_t, typename attr_t>
+inline void stage_gaussian_chunk(
+    const int64_t offset, // index of the first Gaussian in [B * N]
+    const int64_t n,      // number of Gaussians in this chunk
+    const attr_t *__restrict__ means,    // [B, N, 3]
+    const scalar_t *__restrict__ covars, // [B, N, 6] optional
+    const attr_t *__restrict__ quats,    // [B, N, 4] optional
+    const attr_t *__restrict__ scales,   // [B, N, 3] optional
+    const float *__restrict__ dequant,   // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    GaussianChunkCPU &chunk
+) {
+    for (int64_t i = 0; i < n; ++i) {
+        load_gaussian(
+            offset + i,
+            means,
+            covars,
+            quats,
+            scales,
+            dequant,
+            chunk_size,
+            chunk.means[i],
+            chunk.covars[i],
+            chunk.quats[i],
+            chunk.scales[i]
+        );
+    }
+}
+
+template <typename scalar_t>
+inline void load_camera(
+    const scalar_t *__restrict__ viewmat, // [4, 4]
+    const scalar_t *__restrict__ K,       // [3, 3]
+    CameraCPU &camera
+) {
+    // glm is column-major but input is row-major
+    camera.R = mat3(
+        viewmat[0],
+        viewmat[4],
+        viewmat[8], // 1st column
+        viewmat[1],
+        viewmat[5],
+        viewmat[9], // 2nd column
+        viewmat[2],
+        viewmat[6],
+        viewmat[10] // 3rd column
+    );
+    camera.t = vec3(viewmat[3], viewmat[7], viewmat[11]);
+    camera.fx = K[0];
+    camera.cx = K[2];
+    camera.fy = K[4];
+    camera.cy = K[5];
+}
+
+// Project a world-space Gaussian into a camera. Returns false if the Gaussian
+// is culled, in which case `out` is left untouched. `opacity` is optional and
+// enables the opacity-aware culling and bounding box; `compensated` tells
+// whether the compensation will be applied to the opacity later on.
+template <typename scalar_t>
+inline bool project_ewa_3dgs_cpu(
+    const vec3 &mean,
+    const mat3 &covar,
+    const scalar_t *opacity, // optional
+    const bool compensated,
+    const CameraCPU &camera,
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const CameraModelType camera_model,
+    ProjectedGaussianCPU &out
+) {
+    // transform Gaussian center to camera space
+    vec3 mean_c;
+    posW2C(camera.R, camera.t, mean, mean_c);
+    if (mean_c.z < near_plane || mean_c.z > far_plane) {
+        return false;
+    }
+
+    // transform Gaussian covariance to camera space
+    mat3 covar_c;
+    covarW2C(camera.R, covar, covar_c);
+
+    mat2 covar2d;
+    vec2 mean2d;
+    switch (camera_model) {
+    case CameraModelType::PINHOLE: // perspective projection
+        persp_proj(
+            mean_c,
+            covar_c,
+            camera.fx,
+            camera.fy,
+            camera.cx,
+            camera.cy,
+            image_width,
+            image_height,
+            covar2d,
+            mean2d
+        );
+        break;
+    case CameraModelType::ORTHO: // orthographic projection
+        ortho_proj(
+            mean_c,
+            covar_c,
+            camera.fx,
+            camera.fy,
+            camera.cx,
+            camera.cy,
+            image_width,
+            image_height,
+            covar2d,
+            mean2d
+        );
+        break;
+    case CameraModelType::FISHEYE: // fisheye projection
+        fisheye_proj(
+            mean_c,
+            covar_c,
+            camera.fx,
+            camera.fy,
+            camera.cx,
+            camera.cy,
+            image_width,
+            image_height,
+            covar2d,
+            mean2d
+        );
+        break;
+    }
+
+    float compensation;
+    const float det = add_blur(eps2d, covar2d, compensation);
+    if (det <= 0.f) {
+        return false;
+    }
+
+    // compute the inverse of the 2d covariance
+    const mat2 covar2d_inv = glm::inverse(covar2d);
+
+    float extend = 3.33f;
+    if (opacity != nullptr) {
+        float alpha = *opacity;
+        if (compensated) {
+            // we assume compensation term will be applied later on.
+            alpha *= compensation;
+        }
+        if (alpha < ALPHA_THRESHOLD) {
+            return false;
+        }
+        // Compute opacity-aware bounding box.
+        // https://arxiv.org/pdf/2402.00525 Section B.2
+        extend = std::min(
+            extend, std::sqrt(2.0f * std::log(alpha / ALPHA_THRESHOLD))
+        );
+    }
+
+    // compute tight rectangular bounding box (non differentiable)
+    // https://arxiv.org/pdf/2402.00525
+    const float radius_x = std::ceil(extend * std::sqrt(covar2d[0][0]));
+    const float radius_y = std::ceil(extend * std::sqrt(covar2d[1][1]));
+
+    if (radius_x <= radius_clip && radius_y <= radius_clip) {
+        return false;
+    }
+
+    // mask out gaussians outside the image region
+    if (mean2d.x + radius_x <= 0 || mean2d.x - radius_x >= image_width ||
+        mean2d.y + radius_y <= 0 || mean2d.y - radius_y >= image_height) {
+        return false;
+    }
+
+    out.radius[0] = (int32_t)radius_x;
+    out.radius[1] = (int32_t)radius_y;
+    out.mean2d = mean2d;
+    out.depth = mean_c.z;
+    out.conic = vec3(covar2d_inv[0][0], covar2d_inv[0][1], covar2d_inv[1][1]);
+    out.compensation = compensation;
+    return true;
+}
+
+// Backward of `project_ewa_3dgs_cpu` for a visible Gaussian. The gradients
+// w.r.t. the world-space mean and covariance and the camera pose are
+// accumulated into `v_mean`, `v_covar`, `v_R` and `v_t`.
+template <typename scalar_t>
+inline void project_ewa_3dgs_vjp_cpu(
+    const vec3 &mean,
+    const mat3 &covar,
+    const CameraCPU &camera,
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const CameraModelType camera_model,
+    const scalar_t *__restrict__ conic,          // [3]
+    const scalar_t *__restrict__ compensation,   // [1] optional
+    const scalar_t *__restrict__ v_mean2d,       // [2]
+    const scalar_t *__restrict__ v_depth,        // [1]
+    const scalar_t *__restrict__ v_conic,        // [3]
+    const scalar_t *__restrict__ v_compensation, // [1] optional
+    vec3 &v_mean,
+    mat3 &v_covar,
+    mat3 &v_R,
+    vec3 &v_t
+) {
+    // vjp: compute the inverse of the 2d covariance
+    const mat2 covar2d_inv = mat2(conic[0], conic[1], conic[1], conic[2]);
+    const mat2 v_covar2d_inv =
+        mat2(v_conic[0], v_conic[1] * .5f, v_conic[1] * .5f, v_conic[2]);
+    mat2 v_covar2d(0.f);
+    inverse_vjp(covar2d_inv, v_covar2d_inv, v_covar2d);
+
+    if (v_compensation != nullptr) {
+        // vjp: compensation term
+        add_blur_vjp(
+            eps2d, covar2d_inv, *compensation, *v_compensation, v_covar2d
+        );
+    }
+
+    // transform Gaussian to camera space
+    vec3 mean_c;
+    posW2C(camera.R, camera.t, mean, mean_c);
+    mat3 covar_c;
+    covarW2C(camera.R, covar, covar_c);
+
+    // vjp: perspective projection
+    const vec2 v_mean2d_ = vec2(v_mean2d[0], v_mean2d[1]);
+    mat3 v_covar_c(0.f);
+    vec3 v_mean_c(0.f);
+    switch (camera_model) {
+    case CameraModelType::PINHOLE: // perspective projection
+        persp_proj_vjp(
+            mean_c,
+            covar_c,
+            camera.fx,
+            camera.fy,
+            camera.cx,
+            camera.cy,
+            image_width,
+            image_height,
+            v_covar2d,
+            v_mean2d_,
+            v_mean_c,
+            v_covar_c
+        );
+        break;
+    case CameraModelType::ORTHO: // orthographic projection
+        ortho_proj_vjp(
+            mean_c,
+            covar_c,
+            camera.fx,
+            camera.fy,
+            camera.cx,
+            camera.cy,
+            image_width,
+            image_height,
+            v_covar2d,
+            v_mean2d_,
+            v_mean_c,
+            v_covar_c
+        );
+        break;
+    case CameraModelType::FISHEYE: // fisheye projection
+        fisheye_proj_vjp(
+            mean_c,
+            covar_c,
+            camera.fx,
+            camera.fy,
+            camera.cx,
+            camera.cy,
+            image_width,
+            image_height,
+            v_covar2d,
+            v_mean2d_,
+            v_mean_c,
+            v_covar_c
+        );
+        break;
+    }
+
+    // add contribution from v_depths
+    v_mean_c.z += *v_depth;
+
+    // vjp: transform Gaussian covariance to camera space
+    posW2C_VJP(camera.R, camera.t, mean, v_mean_c, v_R, v_t, v_mean);
+    covarW2C_VJP(camera.R, covar, v_covar_c, v_R, v_covar);
+}
+
+// Write the gradient w.r.t. a world-space covariance as either the packed
+// upper triangle (`v_covar6`) or the quaternion and scale it was built from.
+template <typename scalar_t>
+inline void write_covar_vjp(
+    const mat3 &v_covar,
+    const vec4 &quat,
+    const vec3 &scale,
+    scalar_t *__restrict__ v_covar6, // [6] optional
+    scalar_t *__restrict__ v_quat4,  // [4] optional
+    scalar_t *__restrict__ v_scale3  // [3] optional
+) {
+    if (v_covar6 != nullptr) {
+        // Output gradients w.r.t. the covariance matrix
+        v_covar6[0] = v_covar[0][0];
+        v_covar6[1] = v_covar[0][1] + v_covar[1][0];
+        v_covar6[2] = v_covar[0][2] + v_covar[2][0];
+        v_covar6[3] = v_covar[1][1];
+        v_covar6[4] = v_covar[1][2] + v_covar[2][1];
+        v_covar6[5] = v_covar[2][2];
+    } else {
+        // Directly output gradients w.r.t. the quaternion and scale
+        const mat3 rotmat = quat_to_rotmat(quat);
+        vec4 v_quat(0.f);
+        vec3 v_scale(0.f);
+        quat_scale_to_covar_vjp(quat, scale, rotmat, v_covar, v_quat, v_scale);
+        for (uint32_t k = 0; k < 4; k++) {
+            v_quat4[k] = v_quat[k];
+        }
+        for (uint32_t k = 0; k < 3; k++) {
+            v_scale3[k] = v_scale[k];
+        }
+    }
+}
+
+// Add the [3, 4] gradient of a world-to-camera transform to a viewmat.
+template <typename T>
+inline void accumulate_viewmat_vjp(
+    const mat3 &v_R, const vec3 &v_t, T *__restrict__ v_viewmat
+) {
+    for (uint32_t r = 0; r < 3; r++) { // rows
+        for (uint32_t c = 0; c < 3; c++) { // cols
+            v_viewmat[r * 4 + c] += v_R[c][r];
+        }
+        v_viewmat[r * 4 + 3] += v_t[r];
+    }
+}
+
+} // namespace gsplat
@@ -3,6 +3,7 @@
 #include <ATen/cuda/Atomic.cuh>
 #include <c10/cuda/CUDAStream.h>
 #include <cooperative_groups.h>
+#include <type_traits>
 
 #include "Common.h"
 #include "Projection.h"
@@ -12,16 +13,20 @@ namespace gsplat {
 
 namespace cg = cooperative_groups;
 
-template <typename scalar_t>
+// attr_t is the storage type of the means, quats, scales and opacities, which
+// differs from scalar_t when they are stored in float16 or uint8.
+template <typename scalar_t, typename attr_t>
 __global__ void projection_ewa_3dgs_fused_fwd_kernel(
     const uint32_t B,
     const uint32_t C,
     const uint32_t N,
-    const scalar_t *__restrict__ means,    // [B, N, 3]
+    const attr_t *__restrict__ means,      // [B, N, 3]
     const scalar_t *__restrict__ covars,   // [B, N, 6] optional
-    const scalar_t *__restrict__ quats,    // [B, N, 4] optional
-    const scalar_t *__restrict__ scales,   // [B, N, 3] optional
-    const scalar_t *__restrict__ opacities, // [B, N] optional
+    const attr_t *__restrict__ quats,      // [B, N, 4] optional
+    const attr_t *__restrict__ scales,     // [B, N, 3] optional
+    const attr_t *__restrict__ opacities,  // [B, N] optional
+    const float *__restrict__ dequant,     // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
     const scalar_t *__restrict__ viewmats, // [B, C, 4, 4]
     const scalar_t *__restrict__ Ks,       // [B, C, 3, 3]
     const uint32_t image_width,
@@ -35,8 +40,9 @@ __global__ void projection_ewa_3dgs_fused_fwd_kernel(
     int32_t *__restrict__ radii,         // [B, C, N, 2]
     scalar_t *__restrict__ means2d,      // [B, C, N, 2]
     scalar_t *__restrict__ depths,       // [B, C, N]
-    scalar_t *__restrict__ conics,       // [B, C, N, 3]
-    scalar_t *__restrict__ compensations // [B, C, N] optional
+    scalar_t *__restrict__ conics,        // [B, C, N, 3]
+    scalar_t *__restrict__ compensations, // [B, C, N] optional
+    scalar_t *__restrict__ out_opacities  // [B, C, N] optional
 ) {
     // parallelize over B * C * N.
     uint32_t idx = cg::this_grid().thread_rank();
@@ -47,8 +53,7 @@ __global__ void projection_ewa_3dgs_fused_fwd_kernel(
     const uint32_t cid = (idx / N) % C; // camera id
     const uint32_t gid = idx % N; // gaussian id
 
-    // shift pointers to the current camera and gaussian
-    means += bid * N * 3 + gid * 3;
+    // shift pointers to the current camera
     viewmats += bid * C * 16 + cid * 16;
     Ks += bid * C * 9 + cid * 9;
 
@@ -66,9 +71,25 @@ __global__ void projection_ewa_3dgs_fused_fwd_kernel(
     );
     vec3 t = vec3(viewmats[3], viewmats[7], viewmats[11]);
 
+    // read (and dequantize) the Gaussian
+    vec3 mean;
+    vec4 quat;
+    vec3 scale;
+    load_storage_geometry(
+        bid * N + gid,
+        means,
+        quats,
+        scales,
+        dequant,
+        chunk_size,
+        mean,
+        quat,
+        scale
+    );
+
     // transform Gaussian center to camera space
     vec3 mean_c;
-    posW2C(R, t, glm::make_vec3(means), mean_c);
+    posW2C(R, t, mean, mean_c);
     if (mean_c.z < near_plane || mean_c.z > far_plane) {
         radii[idx * 2] = 0;
         radii[idx * 2 + 1] = 0;
@@ -92,11 +113,7 @@ __global__ void projection_ewa_3dgs_fused_fwd_kernel(
         );
     } else {
         // compute from quaternions and scales
-        quats += bid * N * 4 + gid * 4;
-        scales += bid * N * 3 + gid * 3;
-        quat_scale_to_covar_preci(
-            glm::make_vec4(quats), glm::make_vec3(scales), &covar, nullptr
-        );
+        quat_scale_to_covar_preci(quat, scale, &covar, nullptr);
     }
     mat3 covar_c;
     covarW2C(R, covar, covar_c);
@@ -163,7 +180,11 @@ __global__ void projection_ewa_3dgs_fused_fwd_kernel(
 
     float extend = 3.33f;
     if (opacities != nullptr) {
-        float opacity = opacities[bid * N + gid];
+        float opacity =
+            load_storage_opacity(bid * N + gid, opacities, dequant, chunk_size);
+        if (out_opacities != nullptr) {
+            out_opacities[idx] = opacity;
+        }
         if (compensations != nullptr) {
             // we assume compensation term will be applied later on.
             opacity *= compensation;
@@ -218,6 +239,8 @@ void launch_projection_ewa_3dgs_fused_fwd_kernel(
     const at::optional<at::Tensor> quats,  // [..., N, 4] optional
     const at::optional<at::Tensor> scales, // [..., N, 3] optional
     const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
     const at::Tensor viewmats,             // [..., C, 4, 4]
     const at::Tensor Ks,                   // [..., C, 3, 3]
     const uint32_t image_width,
@@ -231,8 +254,9 @@ void launch_projection_ewa_3dgs_fused_fwd_kernel(
     at::Tensor radii,                      // [..., C, N, 2]
     at::Tensor means2d,                    // [..., C, N, 2]
     at::Tensor depths,                     // [..., C, N]
-    at::Tensor conics,                     // [..., C, N, 3]
-    at::optional<at::Tensor> compensations // [..., C, N] optional
+    at::Tensor conics,                      // [..., C, N, 3]
+    at::optional<at::Tensor> compensations, // [..., C, N] optional
+    at::optional<at::Tensor> out_opacities  // [..., C, N] optional
 ) {
     uint32_t N = means.size(-2);    // number of gaussians
     uint32_t C = viewmats.size(-3); // number of cameras
@@ -248,11 +272,19 @@ void launch_projection_ewa_3dgs_fused_fwd_kernel(
         return;
     }
 
-    AT_DISPATCH_FLOATING_TYPES(
+    // The attributes stored in float16 or uint8 are computed in float32.
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::kHalf,
+        at::kByte,
         means.scalar_type(),
         "projection_ewa_3dgs_fused_fwd_kernel",
         [&]() {
-            projection_ewa_3dgs_fused_fwd_kernel<scalar_t>
+            using attr_t = scalar_t;
+            using compute_t = std::conditional_t<
+                std::is_same_v<attr_t, double>,
+                double,
+                float>;
+            projection_ewa_3dgs_fused_fwd_kernel<compute_t, attr_t>
                 <<<grid,
                    threads,
                    shmem_size,
@@ -260,17 +292,20 @@ void launch_projection_ewa_3dgs_fused_fwd_kernel(
                     B,
                     C,
                     N,
-                    means.data_ptr<scalar_t>(),
-                    covars.has_value() ? covars.value().data_ptr<scalar_t>()
+                    means.data_ptr<attr_t>(),
+                    covars.has_value() ? covars.value().data_ptr<compute_t>()
                                        : nullptr,
-                    quats.has_value() ? quats.value().data_ptr<scalar_t>()
+                    quats.has_value() ? quats.value().data_ptr<attr_t>()
                                       : nullptr,
-                    scales.has_value() ? scales.value().data_ptr<scalar_t>()
+                    scales.has_value() ? scales.value().data_ptr<attr_t>()
                                        : nullptr,
-                    opacities.has_value() ? opacities.value().data_ptr<scalar_t>()
+                    opacities.has_value() ? opacities.value().data_ptr<attr_t>()
                                          : nullptr,
-                    viewmats.data_ptr<scalar_t>(),
-                    Ks.data_ptr<scalar_t>(),
+                    dequant.has_value() ? dequant.value().data_ptr<float>()
+                                        : nullptr,
+                    chunk_size,
+                    viewmats.data_ptr<compute_t>(),
+                    Ks.data_ptr<compute_t>(),
                     image_width,
                     image_height,
                     eps2d,
@@ -279,11 +314,14 @@ void launch_projection_ewa_3dgs_fused_fwd_kernel(
                     radius_clip,
                     camera_model,
                     radii.data_ptr<int32_t>(),
-                    means2d.data_ptr<scalar_t>(),
-                    depths.data_ptr<scalar_t>(),
-                    conics.data_ptr<scalar_t>(),
+                    means2d.data_ptr<compute_t>(),
+                    depths.data_ptr<compute_t>(),
+                    conics.data_ptr<compute_t>(),
                     compensations.has_value()
-                        ? compensations.value().data_ptr<scalar_t>()
+                        ? compensations.value().data_ptr<compute_t>()
+                        : nullptr,
+                    out_opacities.has_value()
+                        ? out_opacities.value().data_ptr<compute_t>()
                         : nullptr
                 );
         }
@@ -0,0 +1,463 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "Common.h"
+#include "Projection.h"
+#include "ProjectionEWA3DGSCPU.h"
+#include "Utils.cuh"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+////////////////////////////////////////////////////////////////
+// Forward (CPU)
+////////////////////////////////////////////////////////////////
+
+// attr_t is the storage type of the means, quats, scales and opacities, which
+// differs from scalar_t when they are stored in float16 or uint8.
+template <typename scalar_t, typename attr_t>
+void projection_ewa_3dgs_fused_fwd_cpu(
+    const uint32_t B,
+    const uint32_t C,
+    const uint32_t N,
+    const attr_t *__restrict__ means,      // [B, N, 3]
+    const scalar_t *__restrict__ covars,   // [B, N, 6] optional
+    const attr_t *__restrict__ quats,      // [B, N, 4] optional
+    const attr_t *__restrict__ scales,     // [B, N, 3] optional
+    const attr_t *__restrict__ opacities,  // [B, N] optional
+    const float *__restrict__ dequant,     // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    const scalar_t *__restrict__ viewmats, // [B, C, 4, 4]
+    const scalar_t *__restrict__ Ks,       // [B, C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const CameraModelType camera_model,
+    // outputs
+    int32_t *__restrict__ radii,          // [B, C, N, 2]
+    scalar_t *__restrict__ means2d,       // [B, C, N, 2]
+    scalar_t *__restrict__ depths,        // [B, C, N]
+    scalar_t *__restrict__ conics,        // [B, C, N, 3]
+    scalar_t *__restrict__ compensations, // [B, C, N] optional
+    scalar_t *__restrict__ out_opacities  // [B, C, N] optional
+) {
+    const int64_t n_chunks = (N + CPU_CHUNK_SIZE - 1) / CPU_CHUNK_SIZE;
+
+    // parallelize over B * chunks of N; every task projects its chunk into
+    // all C cameras.
+    at::parallel_for(0, B * n_chunks, 1, [&](int64_t begin, int64_t end) {
+        std::unique_ptr<GaussianChunkCPU> chunk(new GaussianChunkCPU);
+        for (int64_t task = begin; task < end; ++task) {
+            const uint32_t bid = task / n_chunks; // batch id
+            const uint32_t gid0 = (task % n_chunks) * CPU_CHUNK_SIZE;
+            const int64_t n = std::min<int64_t>(CPU_CHUNK_SIZE, N - gid0);
+            stage_gaussian_chunk(
+                (int64_t)bid * N + gid0,
+                n,
+                means,
+                covars,
+                quats,
+                scales,
+                dequant,
+                chunk_size,
+                *chunk
+            );
+            float chunk_opacities[CPU_CHUNK_SIZE];
+            if (opacities != nullptr) {
+                for (int64_t i = 0; i < n; ++i) {
+                    chunk_opacities[i] = load_storage_opacity(
+                        (int64_t)bid * N + gid0 + i,
+                        opacities,
+                        dequant,
+                        chunk_size
+                    );
+                }
+            }
+
+            for (uint32_t cid = 0; cid < C; ++cid) {
+                CameraCPU camera;
+                load_camera(
+                    viewmats + (bid * C + cid) * 16,
+                    Ks + (bid * C + cid) * 9,
+                    camera
+                );
+
+                for (int64_t i = 0; i < n; ++i) {
+                    const uint32_t gid = gid0 + i;
+                    const int64_t idx = ((int64_t)bid * C + cid) * N + gid;
+
+                    ProjectedGaussianCPU proj;
+                    const bool visible = project_ewa_3dgs_cpu(
+                        chunk->means[i],
+                        chunk->covars[i],
+                        opacities == nullptr ? nullptr : chunk_opacities + i,
+                        compensations != nullptr,
+                        camera,
+                        image_width,
+                        image_height,
+                        eps2d,
+                        near_plane,
+                        far_plane,
+                        radius_clip,
+                        camera_model,
+                        proj
+                    );
+                    if (!visible) {
+                        radii[idx * 2] = 0;
+                        radii[idx * 2 + 1] = 0;
+                        continue;
+                    }
+
+                    // write to outputs
+                    radii[idx * 2] = proj.radius[0];
+                    radii[idx * 2 + 1] = proj.radius[1];
+                    means2d[idx * 2] = proj.mean2d.x;
+                    means2d[idx * 2 + 1] = proj.mean2d.y;
+                    depths[idx] = proj.depth;
+                    conics[idx * 3] = proj.conic[0];
+                    conics[idx * 3 + 1] = proj.conic[1];
+                    conics[idx * 3 + 2] = proj.conic[2];
+                    if (compensations != nullptr) {
+                        compensations[idx] = proj.compensation;
+                    }
+                    if (out_opacities != nullptr) {
+                        out_opacities[idx] = chunk_opacities[i];
+                    }
+                }
+            }
+        }
+    });
+}
+
+void launch_projection_ewa_3dgs_fused_fwd_kernel_cpu(
+    // inputs
+    const at::Tensor means,                   // [..., N, 3]
+    const at::optional<at::Tensor> covars,    // [..., N, 6] optional
+    const at::optional<at::Tensor> quats,     // [..., N, 4] optional
+    const at::optional<at::Tensor> scales,    // [..., N, 3] optional
+    const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant,   // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    const at::Tensor viewmats,                // [..., C, 4, 4]
+    const at::Tensor Ks,                      // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const CameraModelType camera_model,
+    // outputs
+    at::Tensor radii,                       // [..., C, N, 2]
+    at::Tensor means2d,                     // [..., C, N, 2]
+    at::Tensor depths,                      // [..., C, N]
+    at::Tensor conics,                      // [..., C, N, 3]
+    at::optional<at::Tensor> compensations, // [..., C, N] optional
+    at::optional<at::Tensor> out_opacities  // [..., C, N] optional
+) {
+    uint32_t N = means.size(-2);          // number of gaussians
+    uint32_t C = viewmats.size(-3);       // number of cameras
+    uint32_t B = means.numel() / (N * 3); // number of batches
+
+    if (B * C * N == 0) {
+        return;
+    }
+
+    // The attributes stored in float16 or uint8 are computed in float32.
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::kHalf,
+        at::kByte,
+        means.scalar_type(),
+        "projection_ewa_3dgs_fused_fwd_cpu",
+        [&]() {
+            using attr_t = scalar_t;
+            using compute_t = std::conditional_t<
+                std::is_same_v<attr_t, double>,
+                double,
+                float>;
+            projection_ewa_3dgs_fused_fwd_cpu<compute_t, attr_t>(
+                B,
+                C,
+                N,
+                means.data_ptr<attr_t>(),
+                covars.has_value() ? covars.value().data_ptr<compute_t>()
+                                   : nullptr,
+                quats.has_value() ? quats.value().data_ptr<attr_t>() : nullptr,
+                scales.has_value() ? scales.value().data_ptr<attr_t>()
+                                   : nullptr,
+                opacities.has_value() ? opacities.value().data_ptr<attr_t>()
+                                      : nullptr,
+                dequant.has_value() ? dequant.value().data_ptr<float>()
+                                    : nullptr,
+                chunk_size,
+                viewmats.data_ptr<compute_t>(),
+                Ks.data_ptr<compute_t>(),
+                image_width,
+                image_height,
+                eps2d,
+                near_plane,
+                far_plane,
+                radius_clip,
+                camera_model,
+                radii.data_ptr<int32_t>(),
+                means2d.data_ptr<compute_t>(),
+                depths.data_ptr<compute_t>(),
+                conics.data_ptr<compute_t>(),
+                compensations.has_value()
+                    ? compensations.value().data_ptr<compute_t>()
+                    : nullptr,
+                out_opacities.has_value()
+                    ? out_opacities.value().data_ptr<compute_t>()
+                    : nullptr
+            );
+        }
+    );
+}
+
+
+////////////////////////////////////////////////////////////////
+// Backward (CPU)
+////////////////////////////////////////////////////////////////
+
+// A chunk of Gaussians is owned by a single task, so the gradients w.r.t. the
+// Gaussians are summed over the cameras locally and written once. The
+// gradients w.r.t. the cameras are summed into per-thread buffers that are
+// reduced at the end.
+template <typename scalar_t>
+void projection_ewa_3dgs_fused_bwd_cpu(
+    // fwd inputs
+    const uint32_t B,
+    const uint32_t C,
+    const uint32_t N,
+    const scalar_t *__restrict__ means,    // [B, N, 3]
+    const scalar_t *__restrict__ covars,   // [B, N, 6] optional
+    const scalar_t *__restrict__ quats,    // [B, N, 4] optional
+    const scalar_t *__restrict__ scales,   // [B, N, 3] optional
+    const scalar_t *__restrict__ viewmats, // [B, C, 4, 4]
+    const scalar_t *__restrict__ Ks,       // [B, C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const CameraModelType camera_model,
+    // fwd outputs
+    const int32_t *__restrict__ radii,          // [B, C, N, 2]
+    const scalar_t *__restrict__ conics,        // [B, C, N, 3]
+    const scalar_t *__restrict__ compensations, // [B, C, N] optional
+    // grad outputs
+    const scalar_t *__restrict__ v_means2d,       // [B, C, N, 2]
+    const scalar_t *__restrict__ v_depths,        // [B, C, N]
+    const scalar_t *__restrict__ v_conics,        // [B, C, N, 3]
+    const scalar_t *__restrict__ v_compensations, // [B, C, N] optional
+    // grad inputs
+    scalar_t *__restrict__ v_means,   // [B, N, 3]
+    scalar_t *__restrict__ v_covars,  // [B, N, 6] optional
+    scalar_t *__restrict__ v_quats,   // [B, N, 4] optional
+    scalar_t *__restrict__ v_scales,  // [B, N, 3] optional
+    scalar_t *__restrict__ v_viewmats // [B, C, 4, 4] optional
+) {
+    const int64_t n_chunks = (N + CPU_CHUNK_SIZE - 1) / CPU_CHUNK_SIZE;
+
+    // per-thread [B, C, 3, 4] gradients of the viewmats
+    const int64_t n_threads = at::get_num_threads();
+    std::vector<float> v_viewmats_partial;
+    if (v_viewmats != nullptr) {
+        v_viewmats_partial.assign(n_threads * B * C * 12, 0.f);
+    }
+
+    at::parallel_for(0, B * n_chunks, 1, [&](int64_t begin, int64_t end) {
+        std::unique_ptr<GaussianChunkCPU> chunk(new GaussianChunkCPU);
+        std::vector<vec3> v_mean(CPU_CHUNK_SIZE);
+        std::vector<mat3> v_covar(CPU_CHUNK_SIZE);
+        float *v_viewmats_thread =
+            v_viewmats == nullptr
+                ? nullptr
+                : v_viewmats_partial.data() +
+                      at::get_thread_num() * (int64_t)B * C * 12;
+
+        for (int64_t task = begin; task < end; ++task) {
+            const uint32_t bid = task / n_chunks; // batch id
+            const uint32_t gid0 = (task % n_chunks) * CPU_CHUNK_SIZE;
+            const int64_t n = std::min<int64_t>(CPU_CHUNK_SIZE, N - gid0);
+            stage_gaussian_chunk(
+                (int64_t)bid * N + gid0,
+                n,
+                means,
+                covars,
+                quats,
+                scales,
+                nullptr,
+                0,
+                *chunk
+            );
+            std::fill_n(v_mean.begin(), n, vec3(0.f));
+            std::fill_n(v_covar.begin(), n, mat3(0.f));
+
+            for (uint32_t cid = 0; cid < C; ++cid) {
+                CameraCPU camera;
+                load_camera(
+                    viewmats + (bid * C + cid) * 16,
+                    Ks + (bid * C + cid) * 9,
+                    camera
+                );
+                mat3 v_R(0.f);
+                vec3 v_t(0.f);
+
+                for (int64_t i = 0; i < n; ++i) {
+                    const int64_t idx =
+                        ((int64_t)bid * C + cid) * N + gid0 + i;
+                    if (radii[idx * 2] <= 0 || radii[idx * 2 + 1] <= 0) {
+                        continue;
+                    }
+                    project_ewa_3dgs_vjp_cpu(
+                        chunk->means[i],
+                        chunk->covars[i],
+                        camera,
+                        image_width,
+                        image_height,
+                        eps2d,
+                        camera_model,
+                        conics + idx * 3,
+                        compensations == nullptr ? nullptr
+                                                 : compensations + idx,
+                        v_means2d + idx * 2,
+                        v_depths + idx,
+                        v_conics + idx * 3,
+                        v_compensations == nullptr ? nullptr
+                                                   : v_compensations + idx,
+                        v_mean[i],
+                        v_covar[i],
+                        v_R,
+                        v_t
+                    );
+                }
+
+                if (v_viewmats_thread != nullptr) {
+                    accumulate_viewmat_vjp(
+                        v_R, v_t, v_viewmats_thread + (bid * C + cid) * 12
+                    );
+                }
+            }
+
+            // write out the gradients of this chunk. The quat/scale vjp is
+            // linear in v_covar, so it is applied once to the sum over the
+            // cameras.
+            for (int64_t i = 0; i < n; ++i) {
+                const int64_t g = (int64_t)bid * N + gid0 + i;
+                for (uint32_t k = 0; k < 3; k++) {
+                    v_means[g * 3 + k] = v_mean[i][k];
+                }
+                write_covar_vjp(
+                    v_covar[i],
+                    chunk->quats[i],
+                    chunk->scales[i],
+                    v_covars == nullptr ? nullptr : v_covars + g * 6,
+                    v_quats == nullptr ? nullptr : v_quats + g * 4,
+                    v_scales == nullptr ? nullptr : v_scales + g * 3
+                );
+            }
+        }
+    });
+
+    if (v_viewmats != nullptr) {
+        for (int64_t tid = 0; tid < n_threads; ++tid) {
+            const float *partial =
+                v_viewmats_partial.data() + tid * (int64_t)B * C * 12;
+            for (int64_t bc = 0; bc < (int64_t)B * C; ++bc) {
+                for (uint32_t k = 0; k < 12; k++) {
+                    v_viewmats[bc * 16 + k] += partial[bc * 12 + k];
+                }
+            }
+        }
+    }
+}
+
+void launch_projection_ewa_3dgs_fused_bwd_kernel_cpu(
+    // inputs
+    // fwd inputs
+    const at::Tensor means,                // [..., N, 3]
+    const at::optional<at::Tensor> covars, // [..., N, 6] optional
+    const at::optional<at::Tensor> quats,  // [..., N, 4] optional
+    const at::optional<at::Tensor> scales, // [..., N, 3] optional
+    const at::Tensor viewmats,             // [..., C, 4, 4]
+    const at::Tensor Ks,                   // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const CameraModelType camera_model,
+    // fwd outputs
+    const at::Tensor radii,                       // [..., C, N, 2]
+    const at::Tensor conics,                      // [..., C, N, 3]
+    const at::optional<at::Tensor> compensations, // [..., C, N] optional
+    // grad outputs
+    const at::Tensor v_means2d,                     // [..., C, N, 2]
+    const at::Tensor v_depths,                      // [..., C, N]
+    const at::Tensor v_conics,                      // [..., C, N, 3]
+    const at::optional<at::Tensor> v_compensations, // [..., C, N] optional
+    const bool viewmats_requires_grad,
+    // outputs
+    at::Tensor v_means,   // [..., N, 3]
+    at::Tensor v_covars,  // [..., N, 3, 3]
+    at::Tensor v_quats,   // [..., N, 4]
+    at::Tensor v_scales,  // [..., N, 3]
+    at::Tensor v_viewmats // [..., C, 4, 4]
+) {
+    uint32_t N = means.size(-2);          // number of gaussians
+    uint32_t C = viewmats.size(-3);       // number of cameras
+    uint32_t B = means.numel() / (N * 3); // number of batches
+
+    if (B * C * N == 0) {
+        return;
+    }
+
+    AT_DISPATCH_FLOATING_TYPES(
+        means.scalar_type(),
+        "projection_ewa_3dgs_fused_bwd_cpu",
+        [&]() {
+            projection_ewa_3dgs_fused_bwd_cpu<scalar_t>(
+                B,
+                C,
+                N,
+                means.data_ptr<scalar_t>(),
+                covars.has_value() ? covars.value().data_ptr<scalar_t>()
+                                   : nullptr,
+                covars.has_value() ? nullptr
+                                   : quats.value().data_ptr<scalar_t>(),
+                covars.has_value() ? nullptr
+                                   : scales.value().data_ptr<scalar_t>(),
+                viewmats.data_ptr<scalar_t>(),
+                Ks.data_ptr<scalar_t>(),
+                image_width,
+                image_height,
+                eps2d,
+                camera_model,
+                radii.data_ptr<int32_t>(),
+                conics.data_ptr<scalar_t>(),
+                compensations.has_value()
+                    ? compensations.value().data_ptr<scalar_t>()
+                    : nullptr,
+                v_means2d.data_ptr<scalar_t>(),
+                v_depths.data_ptr<scalar_t>(),
+                v_conics.data_ptr<scalar_t>(),
+                v_compensations.has_value()
+                    ? v_compensations.value().data_ptr<scalar_t>()
+                    : nullptr,
+                v_means.data_ptr<scalar_t>(),
+                covars.has_value() ? v_covars.data_ptr<scalar_t>() : nullptr,
+                covars.has_value() ? nullptr : v_quats.data_ptr<scalar_t>(),
+                covars.has_value() ? nullptr : v_scales.data_ptr<scalar_t>(),
+                viewmats_requires_grad ? v_viewmats.data_ptr<scalar_t>()
+                                       : nullptr
+            );
+        }
+    );
+}
+
+} // namespace gsplat
@@ -4,6 +4,7 @@
 #include <c10/cuda/CUDAStream.h>
 #include <cooperative_groups.h>
 #include <cub/cub.cuh>
+#include <type_traits>
 
 #include "Common.h"
 #include "Projection.h"
@@ -13,16 +14,20 @@ namespace gsplat {
 
 namespace cg = cooperative_groups;
 
-template <typename scalar_t>
+// attr_t is the storage type of the means, quats, scales and opacities, which
+// differs from scalar_t when they are stored in float16 or uint8.
+template <typename scalar_t, typename attr_t>
 __global__ void projection_ewa_3dgs_packed_fwd_kernel(
     const uint32_t B,
     const uint32_t C,
     const uint32_t N,
-    const scalar_t *__restrict__ means,    // [B, N, 3]
+    const attr_t *__restrict__ means,      // [B, N, 3]
     const scalar_t *__restrict__ covars,   // [B, N, 6] Optional
-    const scalar_t *__restrict__ quats,    // [B, N, 4] Optional
-    const scalar_t *__restrict__ scales,   // [B, N, 3] Optional
-    const scalar_t *__restrict__ opacities, // [B, N] optional
+    const attr_t *__restrict__ quats,      // [B, N, 4] Optional
+    const attr_t *__restrict__ scales,     // [B, N, 3] Optional
+    const attr_t *__restrict__ opacities,  // [B, N] optional
+    const float *__restrict__ dequant,     // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
     const scalar_t *__restrict__ viewmats, // [B, C, 4, 4]
     const scalar_t *__restrict__ Ks,       // [B, C, 3, 3]
     const uint32_t image_width,
@@ -35,16 +40,17 @@ __global__ void projection_ewa_3dgs_packed_fwd_kernel(
         *__restrict__ block_accum, // [B * C * blocks_per_row] packing helper
     const CameraModelType camera_model,
     // outputs
-    int32_t *__restrict__ block_cnts,    // [B * C * blocks_per_row] packing helper
-    int32_t *__restrict__ indptr,        // [B * C + 1]
-    int64_t *__restrict__ batch_ids,       // [nnz]
-    int64_t *__restrict__ camera_ids,    // [nnz]
-    int64_t *__restrict__ gaussian_ids,  // [nnz]
-    int32_t *__restrict__ radii,         // [nnz, 2]
-    scalar_t *__restrict__ means2d,      // [nnz, 2]
-    scalar_t *__restrict__ depths,       // [nnz]
-    scalar_t *__restrict__ conics,       // [nnz, 3]
-    scalar_t *__restrict__ compensations // [nnz] optional
+    int32_t *__restrict__ block_cnts,     // [B * C * blocks_per_row] packing helper
+    int32_t *__restrict__ indptr,         // [B * C + 1]
+    int64_t *__restrict__ batch_ids,      // [nnz]
+    int64_t *__restrict__ camera_ids,     // [nnz]
+    int64_t *__restrict__ gaussian_ids,   // [nnz]
+    int32_t *__restrict__ radii,          // [nnz, 2]
+    scalar_t *__restrict__ means2d,       // [nnz, 2]
+    scalar_t *__restrict__ depths,        // [nnz]
+    scalar_t *__restrict__ conics,        // [nnz, 3]
+    scalar_t *__restrict__ compensations, // [nnz] optional
+    scalar_t *__restrict__ out_opacities  // [nnz] optional
 ) {
     int32_t blocks_per_row = gridDim.x;
     int32_t row_idx = blockIdx.y;
@@ -60,9 +66,24 @@ __global__ void projection_ewa_3dgs_packed_fwd_kernel(
     // check if points are with camera near and far plane
     vec3 mean_c;
     mat3 R;
+    vec4 quat;
+    vec3 scale;
     if (valid) {
-        // shift pointers to the current camera and gaussian
-        means += bid * N * 3 + gid * 3;
+        // read (and dequantize) the Gaussian
+        vec3 mean;
+        load_storage_geometry(
+            bid * N + gid,
+            means,
+            covars != nullptr ? nullptr : quats,
+            scales,
+            dequant,
+            chunk_size,
+            mean,
+            quat,
+            scale
+        );
+
+        // shift pointers to the current camera
         viewmats += bid * C * 16 + cid * 16;
 
         // glm is column-major but input is row-major
@@ -80,7 +101,7 @@ __global__ void projection_ewa_3dgs_packed_fwd_kernel(
         vec3 t = vec3(viewmats[3], viewmats[7], viewmats[11]);
 
         // transform Gaussian center to camera space
-        posW2C(R, t, glm::make_vec3(means), mean_c);
+        posW2C(R, t, mean, mean_c);
         if (mean_c.z < near_plane || mean_c.z > far_plane) {
             valid = false;
         }
@@ -111,11 +132,7 @@ __global__ void projection_ewa_3dgs_packed_fwd_kernel(
             );
         } else {
             // if not then compute it from quaternions and scales
-            quats += bid * N * 4 + gid * 4;
-            scales += bid * N * 3 + gid * 3;
-            quat_scale_to_covar_preci(
-                glm::make_vec4(quats), glm::make_vec3(scales), &covar, nullptr
-            );
+            quat_scale_to_covar_preci(quat, scale, &covar, nullptr);
         }
         mat3 covar_c;
         covarW2C(R, covar, covar_c);
@@ -177,20 +194,24 @@ __global__ void projection_ewa_3dgs_packed_fwd_kernel(
 
     // check if the points are in the image region
     float radius_x, radius_y;
+    float opacity;
     if (valid) {
         float extend = 3.33f;
         if (opacities != nullptr) {
-            float opacity = opacities[col_idx];
+            opacity = load_storage_opacity(
+                bid * N + gid, opacities, dequant, chunk_size
+            );
+            float alpha = opacity;
             if (compensations != nullptr) {
                 // we assume compensation term will be applied later on.
-                opacity *= compensation;
+                alpha *= compensation;
             }    
-            if (opacity < ALPHA_THRESHOLD) {
+            if (alpha < ALPHA_THRESHOLD) {
                 valid = false;
             }
             // Compute opacity-aware bounding box.
             // https://arxiv.org/pdf/2402.00525 Section B.2
-            extend = min(extend, sqrt(2.0f * __logf(opacity / ALPHA_THRESHOLD)));
+            extend = min(extend, sqrt(2.0f * __logf(alpha / ALPHA_THRESHOLD)));
         }
         
         // compute tight rectangular bounding box (non differentiable)
@@ -250,6 +271,9 @@ __global__ void projection_ewa_3dgs_packed_fwd_kernel(
             if (compensations != nullptr) {
                 compensations[thread_data] = compensation;
             }
+            if (out_opacities != nullptr) {
+                out_opacities[thread_data] = opacity;
+            }
         }
         // lane 0 of the first block in each row writes the indptr
         if (threadIdx.x == 0 && block_col_idx == 0) {
@@ -270,6 +294,8 @@ void launch_projection_ewa_3dgs_packed_fwd_kernel(
     const at::optional<at::Tensor> quats,  // [..., N, 4] optional
     const at::optional<at::Tensor> scales, // [..., N, 3] optional
     const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
     const at::Tensor viewmats,             // [..., C, 4, 4]
     const at::Tensor Ks,                   // [..., C, 3, 3]
     const uint32_t image_width,
@@ -282,16 +308,17 @@ void launch_projection_ewa_3dgs_packed_fwd_kernel(
         block_accum, // [B * C * blocks_per_row] packing helper
     const CameraModelType camera_model,
     // outputs
-    at::optional<at::Tensor> block_cnts,   // [B * C * blocks_per_row] packing helper
-    at::optional<at::Tensor> indptr,       // [B * C + 1]
-    at::optional<at::Tensor> batch_ids,    // [nnz]
-    at::optional<at::Tensor> camera_ids,   // [nnz]
-    at::optional<at::Tensor> gaussian_ids, // [nnz]
-    at::optional<at::Tensor> radii,        // [nnz, 2]
-    at::optional<at::Tensor> means2d,      // [nnz, 2]
-    at::optional<at::Tensor> depths,       // [nnz]
-    at::optional<at::Tensor> conics,       // [nnz, 3]
-    at::optional<at::Tensor> compensations // [nnz] optional
+    at::optional<at::Tensor> block_cnts,    // [B * C * blocks_per_row] packing helper
+    at::optional<at::Tensor> indptr,        // [B * C + 1]
+    at::optional<at::Tensor> batch_ids,     // [nnz]
+    at::optional<at::Tensor> camera_ids,    // [nnz]
+    at::optional<at::Tensor> gaussian_ids,  // [nnz]
+    at::optional<at::Tensor> radii,         // [nnz, 2]
+    at::optional<at::Tensor> means2d,       // [nnz, 2]
+    at::optional<at::Tensor> depths,        // [nnz]
+    at::optional<at::Tensor> conics,        // [nnz, 3]
+    at::optional<at::Tensor> compensations, // [nnz] optional
+    at::optional<at::Tensor> out_opacities  // [nnz] optional
 ) {
     uint32_t N = means.size(-2);          // number of gaussians
     uint32_t C = viewmats.size(-3);       // number of cameras
@@ -311,11 +338,19 @@ void launch_projection_ewa_3dgs_packed_fwd_kernel(
         return;
     }
 
-    AT_DISPATCH_FLOATING_TYPES(
+    // The attributes stored in float16 or uint8 are computed in float32.
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::kHalf,
+        at::kByte,
         means.scalar_type(),
         "projection_ewa_3dgs_packed_fwd_kernel",
         [&]() {
-            projection_ewa_3dgs_packed_fwd_kernel<scalar_t>
+            using attr_t = scalar_t;
+            using compute_t = std::conditional_t<
+                std::is_same_v<attr_t, double>,
+                double,
+                float>;
+            projection_ewa_3dgs_packed_fwd_kernel<compute_t, attr_t>
                 <<<grid,
                    threads,
                    shmem_size,
@@ -323,17 +358,20 @@ void launch_projection_ewa_3dgs_packed_fwd_kernel(
                     B,
                     C,
                     N,
-                    means.data_ptr<scalar_t>(),
-                    covars.has_value() ? covars.value().data_ptr<scalar_t>()
+                    means.data_ptr<attr_t>(),
+                    covars.has_value() ? covars.value().data_ptr<compute_t>()
                                        : nullptr,
-                    quats.has_value() ? quats.value().data_ptr<scalar_t>()
+                    quats.has_value() ? quats.value().data_ptr<attr_t>()
                                       : nullptr,
-                    scales.has_value() ? scales.value().data_ptr<scalar_t>()
-                                       : nullptr,
-                    opacities.has_value() ? opacities.value().data_ptr<scalar_t>()
+                    scales.has_value() ? scales.value().data_ptr<attr_t>()
                                        : nullptr,
-                    viewmats.data_ptr<scalar_t>(),
-                    Ks.data_ptr<scalar_t>(),
+                    opacities.has_value() ? opacities.value().data_ptr<attr_t>()
+                                          : nullptr,
+                    dequant.has_value() ? dequant.value().data_ptr<float>()
+                                        : nullptr,
+                    chunk_size,
+                    viewmats.data_ptr<compute_t>(),
+                    Ks.data_ptr<compute_t>(),
                     image_width,
                     image_height,
                     eps2d,
@@ -360,14 +398,17 @@ void launch_projection_ewa_3dgs_packed_fwd_kernel(
                         : nullptr,
                     radii.has_value() ? radii.value().data_ptr<int32_t>()
                                       : nullptr,
-                    means2d.has_value() ? means2d.value().data_ptr<scalar_t>()
+                    means2d.has_value() ? means2d.value().data_ptr<compute_t>()
                                         : nullptr,
-                    depths.has_value() ? depths.value().data_ptr<scalar_t>()
+                    depths.has_value() ? depths.value().data_ptr<compute_t>()
                                        : nullptr,
-                    conics.has_value() ? conics.value().data_ptr<scalar_t>()
+                    conics.has_value() ? conics.value().data_ptr<compute_t>()
                                        : nullptr,
                     compensations.has_value()
-                        ? compensations.value().data_ptr<scalar_t>()
+                        ? compensations.value().data_ptr<compute_t>()
+                        : nullptr,
+                    out_opacities.has_value()
+                        ? out_opacities.value().data_ptr<compute_t>()
                         : nullptr
                 );
         }
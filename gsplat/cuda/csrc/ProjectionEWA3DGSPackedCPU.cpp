@@ -0,0 +1,651 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Functions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "Common.h"
+#include "Projection.h"
+#include "ProjectionEWA3DGSCPU.h"
+#include "Utils.cuh"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// A visible (camera, Gaussian) pair, kept in a per-thread buffer until the
+// final offsets are known.
+struct PackedProjectionCPU {
+    uint32_t gid;
+    float opacity;
+    ProjectedGaussianCPU proj;
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////////
+// Forward (CPU)
+////////////////////////////////////////////////////////////////
+
+// Unlike the CUDA kernel, which projects everything twice (once to count and
+// once to write), every Gaussian is projected once: each thread appends the
+// visible ones to its own buffer, the per-(row, chunk) counts are
+// prefix-summed, and the buffers are copied to their final offsets.
+// attr_t is the storage type of the means, quats, scales and opacities, which
+// differs from scalar_t when they are stored in float16 or uint8.
+template <typename scalar_t, typename attr_t>
+void projection_ewa_3dgs_packed_fwd_cpu(
+    const uint32_t B,
+    const uint32_t C,
+    const uint32_t N,
+    const attr_t *__restrict__ means,      // [B, N, 3]
+    const scalar_t *__restrict__ covars,   // [B, N, 6] optional
+    const attr_t *__restrict__ quats,      // [B, N, 4] optional
+    const attr_t *__restrict__ scales,     // [B, N, 3] optional
+    const attr_t *__restrict__ opacities,  // [B, N] optional
+    const float *__restrict__ dequant,     // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    const scalar_t *__restrict__ viewmats, // [B, C, 4, 4]
+    const scalar_t *__restrict__ Ks,       // [B, C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const bool return_opacities,
+    const CameraModelType camera_model,
+    const at::TensorOptions opt,
+    // outputs
+    at::Tensor &indptr,        // [B * C + 1]
+    at::Tensor &batch_ids,     // [nnz]
+    at::Tensor &camera_ids,    // [nnz]
+    at::Tensor &gaussian_ids,  // [nnz]
+    at::Tensor &radii,         // [nnz, 2]
+    at::Tensor &means2d,       // [nnz, 2]
+    at::Tensor &depths,        // [nnz]
+    at::Tensor &conics,        // [nnz, 3]
+    at::Tensor &compensations, // [nnz] optional
+    at::Tensor &out_opacities  // [nnz] optional
+) {
+    const int64_t n_chunks = (N + CPU_CHUNK_SIZE - 1) / CPU_CHUNK_SIZE;
+    const int64_t n_tasks = (int64_t)B * n_chunks;
+    const int64_t n_rows = (int64_t)B * C;
+
+    // one pass: compact the visible Gaussians of every (task, camera) into the
+    // buffer of the thread running the task.
+    std::vector<std::vector<PackedProjectionCPU>> buffers(
+        at::get_num_threads()
+    );
+    std::vector<int32_t> task_threads(n_tasks);
+    std::vector<int64_t> seg_starts(n_tasks * C); // [n_tasks, C]
+    // [n_rows, n_chunks] counts, scanned into offsets
+    std::vector<int64_t> seg_offsets(n_rows * n_chunks + 1);
+
+    at::parallel_for(0, n_tasks, 1, [&](int64_t begin, int64_t end) {
+        const int32_t tid = at::get_thread_num();
+        std::vector<PackedProjectionCPU> &buffer = buffers[tid];
+        std::unique_ptr<GaussianChunkCPU> chunk(new GaussianChunkCPU);
+        for (int64_t task = begin; task < end; ++task) {
+            const uint32_t bid = task / n_chunks; // batch id
+            const int64_t chunk_id = task % n_chunks;
+            const uint32_t gid0 = chunk_id * CPU_CHUNK_SIZE;
+            const int64_t n = std::min<int64_t>(CPU_CHUNK_SIZE, N - gid0);
+            stage_gaussian_chunk(
+                (int64_t)bid * N + gid0,
+                n,
+                means,
+                covars,
+                quats,
+                scales,
+                dequant,
+                chunk_size,
+                *chunk
+            );
+            float chunk_opacities[CPU_CHUNK_SIZE];
+            if (opacities != nullptr) {
+                for (int64_t i = 0; i < n; ++i) {
+                    chunk_opacities[i] = load_storage_opacity(
+                        (int64_t)bid * N + gid0 + i,
+                        opacities,
+                        dequant,
+                        chunk_size
+                    );
+                }
+            }
+            task_threads[task] = tid;
+
+            for (uint32_t cid = 0; cid < C; ++cid) {
+                CameraCPU camera;
+                load_camera(
+                    viewmats + (bid * C + cid) * 16,
+                    Ks + (bid * C + cid) * 9,
+                    camera
+                );
+
+                const int64_t start = buffer.size();
+                for (int64_t i = 0; i < n; ++i) {
+                    const uint32_t gid = gid0 + i;
+                    PackedProjectionCPU packed;
+                    packed.gid = gid;
+                    packed.opacity =
+                        opacities == nullptr ? 0.f : chunk_opacities[i];
+                    const bool visible = project_ewa_3dgs_cpu(
+                        chunk->means[i],
+                        chunk->covars[i],
+                        opacities == nullptr ? nullptr : chunk_opacities + i,
+                        calc_compensations,
+                        camera,
+                        image_width,
+                        image_height,
+                        eps2d,
+                        near_plane,
+                        far_plane,
+                        radius_clip,
+                        camera_model,
+                        packed.proj
+                    );
+                    if (visible) {
+                        buffer.push_back(packed);
+                    }
+                }
+                const int64_t seg =
+                    ((int64_t)bid * C + cid) * n_chunks + chunk_id;
+                seg_starts[task * C + cid] = start;
+                // counts are shifted by one for the exclusive scan below
+                seg_offsets[seg + 1] = buffer.size() - start;
+            }
+        }
+    });
+
+    // the segments are ordered by (row, chunk), so the scanned counts are the
+    // output offsets and every row starts at its first chunk.
+    seg_offsets[0] = 0;
+    for (int64_t s = 0; s < n_rows * n_chunks; ++s) {
+        seg_offsets[s + 1] += seg_offsets[s];
+    }
+    const int64_t nnz = seg_offsets[n_rows * n_chunks];
+
+    indptr = at::empty({n_rows + 1}, opt.dtype(at::kInt));
+    batch_ids = at::empty({nnz}, opt.dtype(at::kLong));
+    camera_ids = at::empty({nnz}, opt.dtype(at::kLong));
+    gaussian_ids = at::empty({nnz}, opt.dtype(at::kLong));
+    radii = at::empty({nnz, 2}, opt.dtype(at::kInt));
+    means2d = at::empty({nnz, 2}, opt);
+    depths = at::empty({nnz}, opt);
+    conics = at::empty({nnz, 3}, opt);
+    if (calc_compensations) {
+        compensations = at::empty({nnz}, opt);
+    }
+    if (return_opacities) {
+        out_opacities = at::empty({nnz}, opt);
+    }
+
+    int32_t *indptr_ptr = indptr.data_ptr<int32_t>();
+    for (int64_t row = 0; row <= n_rows; ++row) {
+        indptr_ptr[row] = seg_offsets[row * n_chunks];
+    }
+    if (nnz == 0) {
+        return;
+    }
+
+    int64_t *batch_ids_ptr = batch_ids.data_ptr<int64_t>();
+    int64_t *camera_ids_ptr = camera_ids.data_ptr<int64_t>();
+    int64_t *gaussian_ids_ptr = gaussian_ids.data_ptr<int64_t>();
+    int32_t *radii_ptr = radii.data_ptr<int32_t>();
+    scalar_t *means2d_ptr = means2d.data_ptr<scalar_t>();
+    scalar_t *depths_ptr = depths.data_ptr<scalar_t>();
+    scalar_t *conics_ptr = conics.data_ptr<scalar_t>();
+    scalar_t *compensations_ptr =
+        calc_compensations ? compensations.data_ptr<scalar_t>() : nullptr;
+    scalar_t *opacities_ptr =
+        return_opacities ? out_opacities.data_ptr<scalar_t>() : nullptr;
+
+    // stitch the per-thread buffers into the outputs
+    at::parallel_for(
+        0, n_rows * n_chunks, 16, [&](int64_t begin, int64_t end) {
+            for (int64_t s = begin; s < end; ++s) {
+                const int64_t row = s / n_chunks;
+                const int64_t task = (row / C) * n_chunks + s % n_chunks;
+                const PackedProjectionCPU *src =
+                    buffers[task_threads[task]].data() +
+                    seg_starts[task * C + row % C];
+                for (int64_t idx = seg_offsets[s]; idx < seg_offsets[s + 1];
+                     ++idx, ++src) {
+                    const ProjectedGaussianCPU &proj = src->proj;
+                    batch_ids_ptr[idx] = row / C;
+                    camera_ids_ptr[idx] = row % C;
+                    gaussian_ids_ptr[idx] = src->gid;
+                    radii_ptr[idx * 2] = proj.radius[0];
+                    radii_ptr[idx * 2 + 1] = proj.radius[1];
+                    means2d_ptr[idx * 2] = proj.mean2d.x;
+                    means2d_ptr[idx * 2 + 1] = proj.mean2d.y;
+                    depths_ptr[idx] = proj.depth;
+                    conics_ptr[idx * 3] = proj.conic[0];
+                    conics_ptr[idx * 3 + 1] = proj.conic[1];
+                    conics_ptr[idx * 3 + 2] = proj.conic[2];
+                    if (compensations_ptr != nullptr) {
+                        compensations_ptr[idx] = proj.compensation;
+                    }
+                    if (opacities_ptr != nullptr) {
+                        opacities_ptr[idx] = src->opacity;
+                    }
+                }
+            }
+        }
+    );
+}
+
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+projection_ewa_3dgs_packed_fwd_cpu(
+    const at::Tensor means,                   // [..., N, 3]
+    const at::optional<at::Tensor> covars,    // [..., N, 6] optional
+    const at::optional<at::Tensor> quats,     // [..., N, 4] optional
+    const at::optional<at::Tensor> scales,    // [..., N, 3] optional
+    const at::optional<at::Tensor> opacities, // [..., N] optional
+    const at::optional<at::Tensor> dequant,   // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    const at::Tensor viewmats, // [..., C, 4, 4]
+    const at::Tensor Ks,       // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const bool return_opacities,
+    const CameraModelType camera_model
+) {
+    uint32_t N = means.size(-2);    // number of gaussians
+    uint32_t C = viewmats.size(-3); // number of cameras
+    uint32_t B = 1;                 // number of batches
+    for (int64_t d = 0; d < means.dim() - 2; ++d) {
+        B *= means.size(d);
+    }
+
+    at::Tensor indptr, batch_ids, camera_ids, gaussian_ids, radii, means2d,
+        depths, conics, compensations, out_opacities;
+    // The attributes stored in float16 or uint8 are computed in float32.
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::kHalf,
+        at::kByte,
+        means.scalar_type(),
+        "projection_ewa_3dgs_packed_fwd_cpu",
+        [&]() {
+            using attr_t = scalar_t;
+            using compute_t = std::conditional_t<
+                std::is_same_v<attr_t, double>,
+                double,
+                float>;
+            projection_ewa_3dgs_packed_fwd_cpu<compute_t, attr_t>(
+                B,
+                C,
+                N,
+                means.data_ptr<attr_t>(),
+                covars.has_value() ? covars.value().data_ptr<compute_t>()
+                                   : nullptr,
+                covars.has_value() ? nullptr
+                                   : quats.value().data_ptr<attr_t>(),
+                covars.has_value() ? nullptr
+                                   : scales.value().data_ptr<attr_t>(),
+                opacities.has_value() ? opacities.value().data_ptr<attr_t>()
+                                      : nullptr,
+                dequant.has_value() ? dequant.value().data_ptr<float>()
+                                    : nullptr,
+                chunk_size,
+                viewmats.data_ptr<compute_t>(),
+                Ks.data_ptr<compute_t>(),
+                image_width,
+                image_height,
+                eps2d,
+                near_plane,
+                far_plane,
+                radius_clip,
+                calc_compensations,
+                return_opacities,
+                camera_model,
+                viewmats.options(),
+                indptr,
+                batch_ids,
+                camera_ids,
+                gaussian_ids,
+                radii,
+                means2d,
+                depths,
+                conics,
+                compensations,
+                out_opacities
+            );
+        }
+    );
+    return std::make_tuple(
+        indptr,
+        batch_ids,
+        camera_ids,
+        gaussian_ids,
+        radii,
+        means2d,
+        depths,
+        conics,
+        compensations,
+        out_opacities
+    );
+}
+
+////////////////////////////////////////////////////////////////
+// Backward (CPU)
+////////////////////////////////////////////////////////////////
+
+// With `sparse_grad` every nnz writes its own row. Otherwise the nnz are
+// bucketed by Gaussian with a counting sort and each Gaussian sums its
+// buckets, which avoids atomics and keeps the summation order deterministic.
+// The gradients w.r.t. the cameras are summed into per-thread buffers that are
+// reduced at the end.
+template <typename scalar_t>
+void projection_ewa_3dgs_packed_bwd_cpu(
+    // fwd inputs
+    const uint32_t B,
+    const uint32_t C,
+    const uint32_t N,
+    const int64_t nnz,
+    const scalar_t *__restrict__ means,    // [B, N, 3]
+    const scalar_t *__restrict__ covars,   // [B, N, 6] optional
+    const scalar_t *__restrict__ quats,    // [B, N, 4] optional
+    const scalar_t *__restrict__ scales,   // [B, N, 3] optional
+    const scalar_t *__restrict__ viewmats, // [B, C, 4, 4]
+    const scalar_t *__restrict__ Ks,       // [B, C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const CameraModelType camera_model,
+    // fwd outputs
+    const int64_t *__restrict__ batch_ids,      // [nnz]
+    const int64_t *__restrict__ camera_ids,     // [nnz]
+    const int64_t *__restrict__ gaussian_ids,   // [nnz]
+    const scalar_t *__restrict__ conics,        // [nnz, 3]
+    const scalar_t *__restrict__ compensations, // [nnz] optional
+    // grad outputs
+    const scalar_t *__restrict__ v_means2d,       // [nnz, 2]
+    const scalar_t *__restrict__ v_depths,        // [nnz]
+    const scalar_t *__restrict__ v_conics,        // [nnz, 3]
+    const scalar_t *__restrict__ v_compensations, // [nnz] optional
+    const bool sparse_grad, // whether the outputs are in COO format [nnz, ...]
+    // grad inputs
+    scalar_t *__restrict__ v_means,   // [B, N, 3] or [nnz, 3]
+    scalar_t *__restrict__ v_covars,  // [B, N, 6] or [nnz, 6] optional
+    scalar_t *__restrict__ v_quats,   // [B, N, 4] or [nnz, 4] optional
+    scalar_t *__restrict__ v_scales,  // [B, N, 3] or [nnz, 3] optional
+    scalar_t *__restrict__ v_viewmats // [B, C, 4, 4] optional
+) {
+    // per-thread [B, C, 3, 4] gradients of the viewmats
+    const int64_t n_threads = at::get_num_threads();
+    std::vector<float> v_viewmats_partial;
+    if (v_viewmats != nullptr) {
+        v_viewmats_partial.assign(n_threads * B * C * 12, 0.f);
+    }
+
+    // vjp of the nnz-th projection, accumulated into (v_mean, v_covar)
+    auto nnz_vjp = [&](const int64_t idx,
+                       const vec3 &mean,
+                       const mat3 &covar,
+                       vec3 &v_mean,
+                       mat3 &v_covar) {
+        const int64_t row = batch_ids[idx] * C + camera_ids[idx];
+        CameraCPU camera;
+        load_camera(viewmats + row * 16, Ks + row * 9, camera);
+        mat3 v_R(0.f);
+        vec3 v_t(0.f);
+        project_ewa_3dgs_vjp_cpu(
+            mean,
+            covar,
+            camera,
+            image_width,
+            image_height,
+            eps2d,
+            camera_model,
+            conics + idx * 3,
+            compensations == nullptr ? nullptr : compensations + idx,
+            v_means2d + idx * 2,
+            v_depths + idx,
+            v_conics + idx * 3,
+            v_compensations == nullptr ? nullptr : v_compensations + idx,
+            v_mean,
+            v_covar,
+            v_R,
+            v_t
+        );
+        if (v_viewmats != nullptr) {
+            accumulate_viewmat_vjp(
+                v_R,
+                v_t,
+                v_viewmats_partial.data() +
+                    (at::get_thread_num() * (int64_t)B * C + row) * 12
+            );
+        }
+    };
+
+    if (sparse_grad) {
+        // write out results with sparse layout
+        at::parallel_for(0, nnz, 256, [&](int64_t begin, int64_t end) {
+            for (int64_t idx = begin; idx < end; ++idx) {
+                vec3 mean, scale;
+                mat3 covar;
+                vec4 quat;
+                load_gaussian(
+                    batch_ids[idx] * N + gaussian_ids[idx],
+                    means,
+                    covars,
+                    quats,
+                    scales,
+                    nullptr,
+                    0,
+                    mean,
+                    covar,
+                    quat,
+                    scale
+                );
+                vec3 v_mean(0.f);
+                mat3 v_covar(0.f);
+                nnz_vjp(idx, mean, covar, v_mean, v_covar);
+                for (uint32_t k = 0; k < 3; k++) {
+                    v_means[idx * 3 + k] = v_mean[k];
+                }
+                write_covar_vjp(
+                    v_covar,
+                    quat,
+                    scale,
+                    v_covars == nullptr ? nullptr : v_covars + idx * 6,
+                    v_quats == nullptr ? nullptr : v_quats + idx * 4,
+                    v_scales == nullptr ? nullptr : v_scales + idx * 3
+                );
+            }
+        });
+    } else {
+        // bucket the nnz by Gaussian, keeping their order within a bucket
+        const int64_t n_gaussians = (int64_t)B * N;
+        std::vector<int64_t> bucket_offsets(n_gaussians + 1, 0);
+        for (int64_t idx = 0; idx < nnz; ++idx) {
+            bucket_offsets[batch_ids[idx] * N + gaussian_ids[idx] + 1]++;
+        }
+        for (int64_t g = 0; g < n_gaussians; ++g) {
+            bucket_offsets[g + 1] += bucket_offsets[g];
+        }
+        std::vector<int64_t> bucketed(nnz);
+        {
+            std::vector<int64_t> cursor(
+                bucket_offsets.begin(), bucket_offsets.end() - 1
+            );
+            for (int64_t idx = 0; idx < nnz; ++idx) {
+                bucketed[cursor[batch_ids[idx] * N + gaussian_ids[idx]]++] =
+                    idx;
+            }
+        }
+
+        // write out results with dense layout. The quat/scale vjp is linear
+        // in v_covar, so it is applied once to the sum over the buckets.
+        at::parallel_for(
+            0, n_gaussians, CPU_CHUNK_SIZE, [&](int64_t begin, int64_t end) {
+                for (int64_t g = begin; g < end; ++g) {
+                    if (bucket_offsets[g] == bucket_offsets[g + 1]) {
+                        continue;
+                    }
+                    vec3 mean, scale;
+                    mat3 covar;
+                    vec4 quat;
+                    load_gaussian(
+                        g,
+                        means,
+                        covars,
+                        quats,
+                        scales,
+                        nullptr,
+                        0,
+                        mean,
+                        covar,
+                        quat,
+                        scale
+                    );
+                    vec3 v_mean(0.f);
+                    mat3 v_covar(0.f);
+                    for (int64_t b = bucket_offsets[g];
+                         b < bucket_offsets[g + 1];
+                         ++b) {
+                        nnz_vjp(bucketed[b], mean, covar, v_mean, v_covar);
+                    }
+                    for (uint32_t k = 0; k < 3; k++) {
+                        v_means[g * 3 + k] = v_mean[k];
+                    }
+                    write_covar_vjp(
+                        v_covar,
+                        quat,
+                        scale,
+                        v_covars == nullptr ? nullptr : v_covars + g * 6,
+                        v_quats == nullptr ? nullptr : v_quats + g * 4,
+                        v_scales == nullptr ? nullptr : v_scales + g * 3
+                    );
+                }
+            }
+        );
+    }
+
+    if (v_viewmats != nullptr) {
+        for (int64_t tid = 0; tid < n_threads; ++tid) {
+            const float *partial =
+                v_viewmats_partial.data() + tid * (int64_t)B * C * 12;
+            for (int64_t bc = 0; bc < (int64_t)B * C; ++bc) {
+                for (uint32_t k = 0; k < 12; k++) {
+                    v_viewmats[bc * 16 + k] += partial[bc * 12 + k];
+                }
+            }
+        }
+    }
+}
+
+void launch_projection_ewa_3dgs_packed_bwd_kernel_cpu(
+    // fwd inputs
+    const at::Tensor means,                // [..., N, 3]
+    const at::optional<at::Tensor> covars, // [..., N, 6]
+    const at::optional<at::Tensor> quats,  // [..., N, 4]
+    const at::optional<at::Tensor> scales, // [..., N, 3]
+    const at::Tensor viewmats,             // [..., C, 4, 4]
+    const at::Tensor Ks,                   // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const CameraModelType camera_model,
+    // fwd outputs
+    const at::Tensor batch_ids,                   // [nnz]
+    const at::Tensor camera_ids,                  // [nnz]
+    const at::Tensor gaussian_ids,                // [nnz]
+    const at::Tensor conics,                      // [nnz, 3]
+    const at::optional<at::Tensor> compensations, // [nnz] optional
+    // grad outputs
+    const at::Tensor v_means2d,                     // [nnz, 2]
+    const at::Tensor v_depths,                      // [nnz]
+    const at::Tensor v_conics,                      // [nnz, 3]
+    const at::optional<at::Tensor> v_compensations, // [nnz] optional
+    const bool sparse_grad,
+    // grad inputs
+    at::Tensor v_means,                 // [..., N, 3] or [nnz, 3]
+    at::optional<at::Tensor> v_covars,  // [..., N, 6] or [nnz, 6] Optional
+    at::optional<at::Tensor> v_quats,   // [..., N, 4] or [nnz, 4] Optional
+    at::optional<at::Tensor> v_scales,  // [..., N, 3] or [nnz, 3] Optional
+    at::optional<at::Tensor> v_viewmats // [..., C, 4, 4] Optional
+) {
+    uint32_t N = means.size(-2);          // number of gaussians
+    uint32_t C = viewmats.size(-3);       // number of cameras
+    int64_t nnz = batch_ids.size(0);      // number of non-zero elements
+
+    if (nnz == 0) {
+        return;
+    }
+    uint32_t B = means.numel() / (N * 3); // number of batches
+
+    AT_DISPATCH_FLOATING_TYPES(
+        means.scalar_type(),
+        "projection_ewa_3dgs_packed_bwd_cpu",
+        [&]() {
+            projection_ewa_3dgs_packed_bwd_cpu<scalar_t>(
+                B,
+                C,
+                N,
+                nnz,
+                means.data_ptr<scalar_t>(),
+                covars.has_value() ? covars.value().data_ptr<scalar_t>()
+                                   : nullptr,
+                covars.has_value() ? nullptr
+                                   : quats.value().data_ptr<scalar_t>(),
+                covars.has_value() ? nullptr
+                                   : scales.value().data_ptr<scalar_t>(),
+                viewmats.data_ptr<scalar_t>(),
+                Ks.data_ptr<scalar_t>(),
+                image_width,
+                image_height,
+                eps2d,
+                camera_model,
+                batch_ids.data_ptr<int64_t>(),
+                camera_ids.data_ptr<int64_t>(),
+                gaussian_ids.data_ptr<int64_t>(),
+                conics.data_ptr<scalar_t>(),
+                compensations.has_value()
+                    ? compensations.value().data_ptr<scalar_t>()
+                    : nullptr,
+                v_means2d.data_ptr<scalar_t>(),
+                v_depths.data_ptr<scalar_t>(),
+                v_conics.data_ptr<scalar_t>(),
+                v_compensations.has_value()
+                    ? v_compensations.value().data_ptr<scalar_t>()
+                    : nullptr,
+                sparse_grad,
+                v_means.data_ptr<scalar_t>(),
+                v_covars.has_value() ? v_covars.value().data_ptr<scalar_t>()
+                                     : nullptr,
+                v_quats.has_value() ? v_quats.value().data_ptr<scalar_t>()
+                                    : nullptr,
+                v_scales.has_value() ? v_scales.value().data_ptr<scalar_t>()
+                                     : nullptr,
+                v_viewmats.has_value()
+                    ? v_viewmats.value().data_ptr<scalar_t>()
+                    : nullptr
+            );
+        }
+    );
+}
+
+} // namespace gsplat
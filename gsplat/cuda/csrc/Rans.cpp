@@ -0,0 +1,103 @@
+#include <ATen/TensorUtils.h>
+#include <ATen/core/Tensor.h>
+#include <tuple>
+
+#include <ATen/Functions.h>
+#include <ATen/NativeFunctions.h>
+
+#include "Common.h" // where all the macros are defined
+#include "Ops.h"    // a collection of all gsplat operators
+#include "Rans.h"   // where the CPU functions are declared
+
+namespace gsplat {
+
+namespace {
+
+// Number of byte columns of the channels.
+int64_t check_bits(const at::Tensor bits, const int64_t C) {
+    TORCH_CHECK(bits.is_cpu(), "bits must be a CPU tensor");
+    CHECK_CONTIGUOUS(bits);
+    TORCH_CHECK(
+        bits.scalar_type() == at::kInt && bits.numel() == C,
+        "bits must be an int32 tensor with one value per channel"
+    );
+    int64_t S = 0;
+    for (int64_t c = 0; c < C; ++c) {
+        const int64_t b = bits.data_ptr<int32_t>()[c];
+        TORCH_CHECK(b >= 1 && b <= 16, "bits must be in [1, 16]");
+        S += rans_planes(b);
+    }
+    return S;
+}
+
+} // namespace
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> rans_encode(
+    const at::Tensor q,    // [N, C]
+    const at::Tensor bits, // [C]
+    const int64_t width,
+    const int64_t tile_rows
+) {
+    TORCH_CHECK(q.is_cpu(), "q must be a CPU tensor");
+    CHECK_CONTIGUOUS(q);
+    TORCH_CHECK(
+        q.scalar_type() == at::kInt && q.dim() == 2,
+        "q must be an int32 tensor of shape [N, C]"
+    );
+    TORCH_CHECK(
+        width > 0 && tile_rows > 0, "width and tile_rows must be positive"
+    );
+    const int64_t S = check_bits(bits, q.size(1));
+
+    const int64_t H = (q.size(0) + width - 1) / width;
+    const int64_t n_tiles = (H + tile_rows - 1) / tile_rows;
+    at::Tensor freqs = at::empty({S, 256}, q.options());
+    at::Tensor tile_sizes = at::empty({n_tiles}, q.options().dtype(at::kLong));
+    at::Tensor data =
+        rans_encode_cpu(q, bits, width, tile_rows, freqs, tile_sizes);
+    return std::make_tuple(freqs, tile_sizes, data);
+}
+
+at::Tensor rans_decode(
+    const at::Tensor freqs,      // [S, 256]
+    const at::Tensor tile_sizes, // [n_tiles]
+    const at::Tensor data,       // [size]
+    const at::Tensor bits,       // [C]
+    const int64_t n,
+    const int64_t width,
+    const int64_t tile_rows
+) {
+    TORCH_CHECK(
+        freqs.is_cpu() && tile_sizes.is_cpu() && data.is_cpu(),
+        "freqs, tile_sizes and data must be CPU tensors"
+    );
+    CHECK_CONTIGUOUS(freqs);
+    CHECK_CONTIGUOUS(tile_sizes);
+    CHECK_CONTIGUOUS(data);
+    TORCH_CHECK(
+        width > 0 && tile_rows > 0, "width and tile_rows must be positive"
+    );
+    const int64_t S = check_bits(bits, bits.numel());
+    TORCH_CHECK(
+        freqs.scalar_type() == at::kInt && freqs.size(0) == S &&
+            freqs.size(1) == 256,
+        "freqs must be an int32 tensor of shape [S, 256]"
+    );
+    TORCH_CHECK(
+        tile_sizes.scalar_type() == at::kLong &&
+            tile_sizes.numel() ==
+                ((n + width - 1) / width + tile_rows - 1) / tile_rows,
+        "tile_sizes must be an int64 tensor with one size per tile"
+    );
+    TORCH_CHECK(
+        data.scalar_type() == at::kByte &&
+            tile_sizes.sum().item<int64_t>() == data.numel(),
+        "data must be a uint8 tensor of sum(tile_sizes) bytes"
+    );
+
+    at::Tensor q = at::empty({n, bits.numel()}, freqs.options());
+    rans_decode_cpu(freqs, tile_sizes, data, bits, width, tile_rows, q);
+    return q;
+}
+
+} // namespace gsplat
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+class Tensor;
+}
+
+namespace gsplat {
+
+// The rANS codec only has a CPU implementation.
+//
+// The N cells of a quantized attribute are laid out row-major on a grid of
+// `width` columns. Every value is predicted from its left, up and up-left
+// neighbors with the median edge detector of JPEG-LS, and the zigzagged
+// residual is split in one or two bytes (8 bits, then bits - 8). Each of
+// these byte columns has its own frequency table. The grid is cut into tiles
+// of `tile_rows` rows that are predicted and entropy coded independently, so
+// that they are encoded and decoded in parallel.
+
+// Number of byte columns of a channel of the given bit depth.
+inline int64_t rans_planes(const int64_t bits) { return bits > 8 ? 2 : 1; }
+
+// Encode the quantized grid. Returns the concatenated tile streams.
+at::Tensor rans_encode_cpu(
+    const at::Tensor q,    // [N, C] int32, values in [0, 2^bits)
+    const at::Tensor bits, // [C] int32, in [1, 16]
+    const int64_t width,
+    const int64_t tile_rows,
+    // outputs
+    at::Tensor freqs,     // [S, 256] int32, S = sum of rans_planes(bits)
+    at::Tensor tile_sizes // [n_tiles] int64
+);
+
+void rans_decode_cpu(
+    const at::Tensor freqs,      // [S, 256] int32
+    const at::Tensor tile_sizes, // [n_tiles] int64
+    const at::Tensor data,       // [sum(tile_sizes)] uint8
+    const at::Tensor bits,       // [C] int32
+    const int64_t width,
+    const int64_t tile_rows,
+    // outputs
+    at::Tensor q // [N, C] int32
+);
+
+} // namespace gsplat
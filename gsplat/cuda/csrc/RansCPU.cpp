@@ -0,0 +1,473 @@
+#include <ATen/Functions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "Common.h"
+#include "Rans.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Byte-wise rANS with a 32-bit state kept in [RANS_L, 256 * RANS_L) and
+// probabilities quantized to RANS_SCALE_BITS bits.
+constexpr uint32_t RANS_SCALE_BITS = 12;
+constexpr uint32_t RANS_SCALE = 1u << RANS_SCALE_BITS;
+constexpr uint32_t RANS_L = 1u << 23;
+// Interleaved states: the symbol k of a tile is coded with the state k % 4,
+// so that the decoder has 4 independent dependency chains.
+constexpr int RANS_STATES = 4;
+
+// A byte column of the grid: its channel, and the shift of its byte in the
+// zigzagged residual.
+struct Plane {
+    int64_t channel;
+    int shift;
+};
+
+std::vector<Plane> make_planes(const at::Tensor bits) {
+    std::vector<Plane> planes;
+    for (int64_t c = 0; c < bits.numel(); ++c) {
+        for (int64_t p = 0; p < rans_planes(bits.data_ptr<int32_t>()[c]); ++p) {
+            planes.push_back({c, int(8 * p)});
+        }
+    }
+    return planes;
+}
+
+// Median edge detector of JPEG-LS: the clamp of a + b - c to [min(a, b),
+// max(a, b)]. The residuals of a sorted grid make the comparisons
+// unpredictable and GCC keeps them as branches, so the min/max are done with
+// sign masks (exact for the 16-bit values of the grids).
+GSPLAT_CPU_INLINE int32_t median_edge(
+    const int32_t a, const int32_t b, const int32_t c
+) {
+    const int32_t d = a - b;
+    const int32_t lt = d >> 31; // -1 if a < b
+    const int32_t lo = b + (d & lt);
+    const int32_t hi = a - (d & lt);
+    int32_t p = a + b - c;
+    const int32_t below = p - lo;
+    p -= below & (below >> 31);
+    const int32_t above = p - hi;
+    p -= above & ~(above >> 31);
+    return p;
+}
+
+// Prediction of the value v of a channel from its left, up and up-left
+// neighbors. The first row of a tile only looks left, the first column only
+// up.
+GSPLAT_CPU_INLINE int32_t predict(
+    const int32_t *__restrict__ v, // the value of the channel in q [N, C]
+    const bool first_row,
+    const bool first_column,
+    const int64_t W,
+    const int64_t C
+) {
+    if (first_row) {
+        return first_column ? 0 : v[-C];
+    }
+    if (first_column) {
+        return v[-W * C];
+    }
+    return median_edge(v[-C], v[-W * C], v[-W * C - C]);
+}
+
+// Residual in [-2^(bits-1), 2^(bits-1)) mapped to [0, 2^bits).
+GSPLAT_CPU_INLINE uint32_t zigzag(const int32_t residual, const int32_t bits) {
+    int32_t d = residual & ((1 << bits) - 1);
+    if (d >= (1 << (bits - 1))) {
+        d -= 1 << bits;
+    }
+    return uint32_t(d << 1) ^ uint32_t(d >> 31);
+}
+
+GSPLAT_CPU_INLINE int32_t unzigzag(const uint32_t z) {
+    return int32_t(z >> 1) ^ -int32_t(z & 1);
+}
+
+// Scale the counts of a byte column so that they sum to RANS_SCALE, keeping
+// every occurring byte at a frequency of at least 1.
+void normalize_counts(const int64_t *counts, int32_t *freqs) {
+    const uint64_t total = std::accumulate(counts, counts + 256, uint64_t(0));
+    if (total == 0) {
+        std::fill_n(freqs, 256, 0);
+        freqs[0] = RANS_SCALE;
+        return;
+    }
+    int64_t sum = 0;
+    for (int s = 0; s < 256; ++s) {
+        freqs[s] = counts[s] == 0
+                       ? 0
+                       : std::max<int32_t>(1, counts[s] * RANS_SCALE / total);
+        sum += freqs[s];
+    }
+    // give the rounding error to the most frequent bytes
+    while (sum != RANS_SCALE) {
+        int best = 0;
+        for (int s = 1; s < 256; ++s) {
+            if (freqs[s] > freqs[best]) {
+                best = s;
+            }
+        }
+        if (sum < RANS_SCALE) {
+            freqs[best] += RANS_SCALE - sum;
+            sum = RANS_SCALE;
+        } else {
+            const int64_t step =
+                std::min<int64_t>(sum - RANS_SCALE, freqs[best] - 1);
+            freqs[best] -= step;
+            sum -= step;
+            if (step == 0) {
+                break;
+            }
+        }
+    }
+}
+
+GSPLAT_CPU_TARGET_CLONES void rans_symbols_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const int32_t *__restrict__ q, // [N, C]
+    const int32_t *__restrict__ bits,
+    const Plane *__restrict__ planes,
+    const int64_t S,
+    const int64_t W,
+    const int64_t C,
+    const int64_t tile_rows,
+    uint8_t *__restrict__ symbols // [N, S]
+) {
+    std::vector<uint32_t> z(C);
+    for (int64_t i = begin; i < end; ++i) {
+        const bool first_row = (i / W) % tile_rows == 0;
+        const bool first_column = i % W == 0;
+        for (int64_t c = 0; c < C; ++c) {
+            const int32_t *v = q + i * C + c;
+            const int32_t pred = predict(v, first_row, first_column, W, C);
+            z[c] = zigzag(*v - pred, bits[c]);
+        }
+        for (int64_t s = 0; s < S; ++s) {
+            const uint32_t z_s = z[planes[s].channel] >> planes[s].shift;
+            symbols[i * S + s] = z_s & 0xFF;
+        }
+    }
+}
+
+// Decoding entry of a slot of a frequency table.
+struct RansSlot {
+    uint16_t freq;
+    uint16_t bias; // slot - start of the symbol
+    uint8_t symbol;
+};
+
+// Encode the symbols of a tile backwards from `end`. Returns the first
+// written byte.
+uint8_t *encode_tile(
+    const uint8_t *__restrict__ symbols,
+    const int64_t n,
+    const int64_t S,
+    const int32_t *__restrict__ freqs,  // [S, 256]
+    const int32_t *__restrict__ starts, // [S, 256]
+    uint8_t *end
+) {
+    uint8_t *ptr = end;
+    uint32_t states[RANS_STATES];
+    std::fill_n(states, RANS_STATES, RANS_L);
+    for (int64_t k = n - 1; k >= 0; --k) {
+        const int64_t s = k % S;
+        const uint32_t freq = freqs[s * 256 + symbols[k]];
+        const uint32_t start = starts[s * 256 + symbols[k]];
+        const uint32_t x_max = ((RANS_L >> RANS_SCALE_BITS) << 8) * freq;
+        uint32_t x = states[k % RANS_STATES];
+        while (x >= x_max) {
+            *--ptr = x & 0xFF;
+            x >>= 8;
+        }
+        states[k % RANS_STATES] =
+            ((x / freq) << RANS_SCALE_BITS) + (x % freq) + start;
+    }
+    for (int j = RANS_STATES - 1; j >= 0; --j) {
+        ptr -= 4;
+        for (int b = 0; b < 4; ++b) {
+            ptr[b] = (states[j] >> (8 * b)) & 0xFF;
+        }
+    }
+    return ptr;
+}
+
+// Decode the n symbols of a tile.
+GSPLAT_CPU_TARGET_CLONES void decode_symbols_cpu(
+    const uint8_t *__restrict__ ptr,
+    const uint8_t *__restrict__ ptr_end,
+    const int64_t n,
+    const int64_t S,
+    const RansSlot *__restrict__ slots, // [S, RANS_SCALE]
+    uint8_t *__restrict__ symbols       // [n]
+) {
+    // reads past the end of a corrupted stream give zeros
+    auto next_byte = [&]() -> uint32_t {
+        return ptr < ptr_end ? *ptr++ : 0;
+    };
+    uint32_t states[RANS_STATES] = {};
+    for (int j = 0; j < RANS_STATES; ++j) {
+        for (int b = 0; b < 4; ++b) {
+            states[j] |= next_byte() << (8 * b);
+        }
+    }
+    // the table of the symbol k is the one of the column k % S
+    int64_t s = 0;
+    auto decode = [&](uint32_t &x) -> uint8_t {
+        const RansSlot slot = slots[s * RANS_SCALE + (x & (RANS_SCALE - 1))];
+        x = slot.freq * (x >> RANS_SCALE_BITS) + slot.bias;
+        s = s + 1 == S ? 0 : s + 1;
+        return slot.symbol;
+    };
+    int64_t k = 0;
+    for (; k + RANS_STATES <= n; k += RANS_STATES) {
+        for (int j = 0; j < RANS_STATES; ++j) {
+            symbols[k + j] = decode(states[j]);
+        }
+        for (int j = 0; j < RANS_STATES; ++j) {
+            while (states[j] < RANS_L) {
+                states[j] = (states[j] << 8) | next_byte();
+            }
+        }
+    }
+    for (int j = 0; k < n; ++k, ++j) {
+        symbols[k] = decode(states[j]);
+    }
+}
+
+// Rebuild the cells [begin, end) of a tile from their symbols. The residual
+// of the channel c is made of the symbols lo[c] and (if hi_mask[c]) hi[c].
+GSPLAT_CPU_TARGET_CLONES void reconstruct_tile_cpu(
+    const uint8_t *__restrict__ symbols,  // [end - begin, S]
+    const int64_t begin,
+    const int64_t end,
+    const int64_t *__restrict__ lo,       // [C]
+    const int64_t *__restrict__ hi,       // [C]
+    const uint32_t *__restrict__ hi_mask, // [C]
+    const int32_t *__restrict__ masks,    // [C]
+    const int64_t S,
+    const int64_t W,
+    const int64_t C,
+    int32_t *__restrict__ q // [N, C]
+) {
+    for (int64_t row = begin; row < end; row += W) {
+        const int64_t row_end = std::min(end, row + W);
+        for (int64_t i = row; i < row_end; ++i) {
+            const uint8_t *cell = symbols + (i - begin) * S;
+            for (int64_t c = 0; c < C; ++c) {
+                const uint32_t z =
+                    cell[lo[c]] | ((uint32_t(cell[hi[c]]) << 8) & hi_mask[c]);
+                int32_t *v = q + i * C + c;
+                const int32_t pred = predict(v, row == begin, i == row, W, C);
+                *v = (pred + unzigzag(z)) & masks[c];
+            }
+        }
+    }
+}
+
+} // namespace
+
+at::Tensor rans_encode_cpu(
+    const at::Tensor q,    // [N, C] int32, values in [0, 2^bits)
+    const at::Tensor bits, // [C] int32, in [1, 16]
+    const int64_t width,
+    const int64_t tile_rows,
+    // outputs
+    at::Tensor freqs,     // [S, 256] int32, S = sum of rans_planes(bits)
+    at::Tensor tile_sizes // [n_tiles] int64
+) {
+    const int64_t N = q.size(0);
+    const int64_t C = q.size(1);
+    const int64_t S = freqs.size(0);
+    const int64_t n_tiles = tile_sizes.size(0);
+    const int64_t tile_cells = tile_rows * width;
+    const int32_t *q_ptr = q.data_ptr<int32_t>();
+    const int32_t *bits_ptr = bits.data_ptr<int32_t>();
+    int32_t *freqs_ptr = freqs.data_ptr<int32_t>();
+    int64_t *tile_sizes_ptr = tile_sizes.data_ptr<int64_t>();
+    const std::vector<Plane> planes = make_planes(bits);
+
+    std::vector<uint8_t> symbols(N * S);
+    at::parallel_for(0, N, CPU_CHUNK_SIZE, [&](int64_t begin, int64_t end) {
+        rans_symbols_cpu(
+            begin,
+            end,
+            q_ptr,
+            bits_ptr,
+            planes.data(),
+            S,
+            width,
+            C,
+            tile_rows,
+            symbols.data()
+        );
+    });
+
+    // byte histograms of the columns, per tile then summed
+    std::vector<int64_t> counts(n_tiles * S * 256, 0);
+    at::parallel_for(0, n_tiles, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t t = begin; t < end; ++t) {
+            int64_t *tile_counts = counts.data() + t * S * 256;
+            const int64_t i_end = std::min(N, (t + 1) * tile_cells);
+            for (int64_t i = t * tile_cells; i < i_end; ++i) {
+                for (int64_t s = 0; s < S; ++s) {
+                    tile_counts[s * 256 + symbols[i * S + s]]++;
+                }
+            }
+        }
+    });
+    std::vector<int32_t> starts(S * 256);
+    for (int64_t s = 0; s < S; ++s) {
+        std::vector<int64_t> column(256, 0);
+        for (int64_t t = 0; t < n_tiles; ++t) {
+            for (int b = 0; b < 256; ++b) {
+                column[b] += counts[(t * S + s) * 256 + b];
+            }
+        }
+        normalize_counts(column.data(), freqs_ptr + s * 256);
+        std::exclusive_scan(
+            freqs_ptr + s * 256,
+            freqs_ptr + (s + 1) * 256,
+            starts.data() + s * 256,
+            0
+        );
+    }
+
+    // every symbol takes at most RANS_SCALE_BITS bits, plus the final states
+    std::vector<std::vector<uint8_t>> streams(n_tiles);
+    std::vector<uint8_t *> stream_begins(n_tiles);
+    at::parallel_for(0, n_tiles, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t t = begin; t < end; ++t) {
+            const int64_t i_begin = t * tile_cells;
+            const int64_t n = (std::min(N, i_begin + tile_cells) - i_begin) * S;
+            streams[t].resize(2 * n + 4 * RANS_STATES);
+            stream_begins[t] = encode_tile(
+                symbols.data() + i_begin * S,
+                n,
+                S,
+                freqs_ptr,
+                starts.data(),
+                streams[t].data() + streams[t].size()
+            );
+            tile_sizes_ptr[t] =
+                streams[t].data() + streams[t].size() - stream_begins[t];
+        }
+    });
+
+    std::vector<int64_t> offsets(n_tiles + 1, 0);
+    std::partial_sum(
+        tile_sizes_ptr, tile_sizes_ptr + n_tiles, offsets.begin() + 1
+    );
+    at::Tensor data =
+        at::empty({offsets[n_tiles]}, q.options().dtype(at::kByte));
+    uint8_t *data_ptr = data.data_ptr<uint8_t>();
+    at::parallel_for(0, n_tiles, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t t = begin; t < end; ++t) {
+            std::memcpy(
+                data_ptr + offsets[t], stream_begins[t], tile_sizes_ptr[t]
+            );
+            std::vector<uint8_t>().swap(streams[t]);
+        }
+    });
+    return data;
+}
+
+void rans_decode_cpu(
+    const at::Tensor freqs,      // [S, 256] int32
+    const at::Tensor tile_sizes, // [n_tiles] int64
+    const at::Tensor data,       // [sum(tile_sizes)] uint8
+    const at::Tensor bits,       // [C] int32
+    const int64_t width,
+    const int64_t tile_rows,
+    // outputs
+    at::Tensor q // [N, C] int32
+) {
+    const int64_t N = q.size(0);
+    const int64_t C = q.size(1);
+    const int64_t S = freqs.size(0);
+    const int64_t n_tiles = tile_sizes.size(0);
+    const int64_t tile_cells = tile_rows * width;
+    const int32_t *freqs_ptr = freqs.data_ptr<int32_t>();
+    const int64_t *tile_sizes_ptr = tile_sizes.data_ptr<int64_t>();
+    const uint8_t *data_ptr = data.data_ptr<uint8_t>();
+    const int32_t *bits_ptr = bits.data_ptr<int32_t>();
+    int32_t *q_ptr = q.data_ptr<int32_t>();
+    const std::vector<Plane> planes = make_planes(bits);
+
+    std::vector<RansSlot> slots(S * RANS_SCALE);
+    for (int64_t s = 0; s < S; ++s) {
+        const int32_t *f = freqs_ptr + s * 256;
+        int64_t start = 0;
+        for (int b = 0; b < 256; ++b) {
+            TORCH_CHECK(
+                f[b] >= 0 && start + f[b] <= RANS_SCALE,
+                "invalid rANS frequency table"
+            );
+            for (int64_t slot = start; slot < start + f[b]; ++slot) {
+                slots[s * RANS_SCALE + slot] = {
+                    uint16_t(f[b]), uint16_t(slot - start), uint8_t(b)
+                };
+            }
+            start += f[b];
+        }
+        TORCH_CHECK(start == RANS_SCALE, "invalid rANS frequency table");
+    }
+
+    std::vector<int64_t> offsets(n_tiles + 1, 0);
+    std::partial_sum(
+        tile_sizes_ptr, tile_sizes_ptr + n_tiles, offsets.begin() + 1
+    );
+    std::vector<int64_t> lo(C), hi(C);
+    std::vector<uint32_t> hi_mask(C, 0);
+    std::vector<int32_t> masks(C);
+    for (int64_t s = 0; s < S; ++s) {
+        const int64_t c = planes[s].channel;
+        if (planes[s].shift == 0) {
+            lo[c] = hi[c] = s;
+        } else {
+            hi[c] = s;
+            hi_mask[c] = 0xFF00;
+        }
+    }
+    for (int64_t c = 0; c < C; ++c) {
+        masks[c] = (1 << bits_ptr[c]) - 1;
+    }
+    at::parallel_for(0, n_tiles, 1, [&](int64_t begin, int64_t end) {
+        std::vector<uint8_t> symbols(tile_cells * S);
+        for (int64_t t = begin; t < end; ++t) {
+            const int64_t i_begin = t * tile_cells;
+            const int64_t i_end = std::min(N, i_begin + tile_cells);
+            decode_symbols_cpu(
+                data_ptr + offsets[t],
+                data_ptr + offsets[t + 1],
+                (i_end - i_begin) * S,
+                S,
+                slots.data(),
+                symbols.data()
+            );
+            reconstruct_tile_cpu(
+                symbols.data(),
+                i_begin,
+                i_end,
+                lo.data(),
+                hi.data(),
+                hi_mask.data(),
+                masks.data(),
+                S,
+                width,
+                C,
+                q_ptr
+            );
+        }
+    });
+}
+
+} // namespace gsplat
@@ -34,17 +34,18 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> rasterize_to_pixels_3dgs_fwd(
     const at::Tensor flatten_ids   // [n_isects]
 ) {
     DEVICE_GUARD(means2d);
-    CHECK_INPUT(means2d);
-    CHECK_INPUT(conics);
-    CHECK_INPUT(colors);
-    CHECK_INPUT(opacities);
-    CHECK_INPUT(tile_offsets);
-    CHECK_INPUT(flatten_ids);
+    CHECK_CUDA_OR_CPU(means2d);
+    CHECK_CONTIGUOUS(means2d);
+    CHECK_INPUT_LIKE(conics, means2d);
+    CHECK_INPUT_LIKE(colors, means2d);
+    CHECK_INPUT_LIKE(opacities, means2d);
+    CHECK_INPUT_LIKE(tile_offsets, means2d);
+    CHECK_INPUT_LIKE(flatten_ids, means2d);
     if (backgrounds.has_value()) {
-        CHECK_INPUT(backgrounds.value());
+        CHECK_INPUT_LIKE(backgrounds.value(), means2d);
     }
     if (masks.has_value()) {
-        CHECK_INPUT(masks.value());
+        CHECK_INPUT_LIKE(masks.value(), means2d);
     }
 
     auto opt = means2d.options();
@@ -63,6 +64,26 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> rasterize_to_pixels_3dgs_fwd(
     last_ids_dims.append({image_height, image_width});
     at::Tensor last_ids = at::empty(last_ids_dims, opt.dtype(at::kInt));
 
+    if (means2d.is_cpu()) {
+        launch_rasterize_to_pixels_3dgs_fwd_kernel_cpu(
+            means2d,
+            conics,
+            colors,
+            opacities,
+            backgrounds,
+            masks,
+            image_width,
+            image_height,
+            tile_size,
+            tile_offsets,
+            flatten_ids,
+            renders,
+            alphas,
+            last_ids
+        );
+        return std::make_tuple(renders, alphas, last_ids);
+    }
+
 #define __LAUNCH_KERNEL__(N)                                                   \
     case N:                                                                    \
         launch_rasterize_to_pixels_3dgs_fwd_kernel<N>(                         \
@@ -140,21 +161,22 @@ rasterize_to_pixels_3dgs_bwd(
     bool absgrad
 ) {
     DEVICE_GUARD(means2d);
-    CHECK_INPUT(means2d);
-    CHECK_INPUT(conics);
-    CHECK_INPUT(colors);
-    CHECK_INPUT(opacities);
-    CHECK_INPUT(tile_offsets);
-    CHECK_INPUT(flatten_ids);
-    CHECK_INPUT(render_alphas);
-    CHECK_INPUT(last_ids);
-    CHECK_INPUT(v_render_colors);
-    CHECK_INPUT(v_render_alphas);
+    CHECK_CUDA_OR_CPU(means2d);
+    CHECK_CONTIGUOUS(means2d);
+    CHECK_INPUT_LIKE(conics, means2d);
+    CHECK_INPUT_LIKE(colors, means2d);
+    CHECK_INPUT_LIKE(opacities, means2d);
+    CHECK_INPUT_LIKE(tile_offsets, means2d);
+    CHECK_INPUT_LIKE(flatten_ids, means2d);
+    CHECK_INPUT_LIKE(render_alphas, means2d);
+    CHECK_INPUT_LIKE(last_ids, means2d);
+    CHECK_INPUT_LIKE(v_render_colors, means2d);
+    CHECK_INPUT_LIKE(v_render_alphas, means2d);
     if (backgrounds.has_value()) {
-        CHECK_INPUT(backgrounds.value());
+        CHECK_INPUT_LIKE(backgrounds.value(), means2d);
     }
     if (masks.has_value()) {
-        CHECK_INPUT(masks.value());
+        CHECK_INPUT_LIKE(masks.value(), means2d);
     }
 
     uint32_t channels = colors.size(-1);
@@ -168,6 +190,34 @@ rasterize_to_pixels_3dgs_bwd(
         v_means2d_abs = at::zeros_like(means2d);
     }
 
+    if (means2d.is_cpu()) {
+        launch_rasterize_to_pixels_3dgs_bwd_kernel_cpu(
+            means2d,
+            conics,
+            colors,
+            opacities,
+            backgrounds,
+            masks,
+            image_width,
+            image_height,
+            tile_size,
+            tile_offsets,
+            flatten_ids,
+            render_alphas,
+            last_ids,
+            v_render_colors,
+            v_render_alphas,
+            absgrad ? c10::optional<at::Tensor>(v_means2d_abs) : c10::nullopt,
+            v_means2d,
+            v_conics,
+            v_colors,
+            v_opacities
+        );
+        return std::make_tuple(
+            v_means2d_abs, v_means2d, v_conics, v_colors, v_opacities
+        );
+    }
+
 #define __LAUNCH_KERNEL__(N)                                                   \
     case N:                                                                    \
         launch_rasterize_to_pixels_3dgs_bwd_kernel<N>(                         \
@@ -37,6 +37,29 @@ void launch_rasterize_to_pixels_3dgs_fwd_kernel(
     at::Tensor last_ids // [..., image_height, image_width]
 );
 
+// CPU counterpart of `launch_rasterize_to_pixels_3dgs_fwd_kernel`. The number
+// of channels is read from `colors` at runtime.
+void launch_rasterize_to_pixels_3dgs_fwd_kernel_cpu(
+    // Gaussian parameters
+    const at::Tensor means2d,   // [..., N, 2] or [nnz, 2]
+    const at::Tensor conics,    // [..., N, 3] or [nnz, 3]
+    const at::Tensor colors,    // [..., N, channels] or [nnz, channels]
+    const at::Tensor opacities, // [..., N]  or [nnz]
+    const at::optional<at::Tensor> backgrounds, // [..., channels]
+    const at::optional<at::Tensor> masks,       // [..., tile_height, tile_width]
+    // image size
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const uint32_t tile_size,
+    // intersections
+    const at::Tensor tile_offsets, // [..., tile_height, tile_width]
+    const at::Tensor flatten_ids,  // [n_isects]
+    // outputs
+    at::Tensor renders, // [..., image_height, image_width, channels]
+    at::Tensor alphas,  // [..., image_height, image_width]
+    at::Tensor last_ids // [..., image_height, image_width]
+);
+
 template <uint32_t CDIM>
 void launch_rasterize_to_pixels_3dgs_bwd_kernel(
     // Gaussian parameters
@@ -67,6 +90,37 @@ void launch_rasterize_to_pixels_3dgs_bwd_kernel(
     at::Tensor v_opacities                  // [..., N] or [nnz]
 );
 
+// CPU counterpart of `launch_rasterize_to_pixels_3dgs_bwd_kernel`. The number
+// of channels is read from `colors` at runtime.
+void launch_rasterize_to_pixels_3dgs_bwd_kernel_cpu(
+    // Gaussian parameters
+    const at::Tensor means2d,                   // [..., N, 2] or [nnz, 2]
+    const at::Tensor conics,                    // [..., N, 3] or [nnz, 3]
+    const at::Tensor colors,                    // [..., N, 3] or [nnz, 3]
+    const at::Tensor opacities,                 // [..., N] or [nnz]
+    const at::optional<at::Tensor> backgrounds, // [..., 3]
+    const at::optional<at::Tensor> masks,       // [..., tile_height, tile_width]
+    // image size
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const uint32_t tile_size,
+    // intersections
+    const at::Tensor tile_offsets,    // [..., tile_height, tile_width]
+    const at::Tensor flatten_ids,     // [n_isects]
+    // forward outputs
+    const at::Tensor render_alphas,   // [..., image_height, image_width, 1]
+    const at::Tensor last_ids,        // [..., image_height, image_width]
+    // gradients of outputs
+    const at::Tensor v_render_colors, // [..., image_height, image_width, 3]
+    const at::Tensor v_render_alphas, // [..., image_height, image_width, 1]
+    // outputs
+    at::optional<at::Tensor> v_means2d_abs, // [..., N, 2] or [nnz, 2]
+    at::Tensor v_means2d,                   // [..., N, 2] or [nnz, 2]
+    at::Tensor v_conics,                    // [..., N, 3] or [nnz, 3]
+    at::Tensor v_colors,                    // [..., N, 3] or [nnz, 3]
+    at::Tensor v_opacities                  // [..., N] or [nnz]
+);
+
 /////////////////////////////////////////////////
 // rasterize_to_indices_3dgs
 /////////////////////////////////////////////////
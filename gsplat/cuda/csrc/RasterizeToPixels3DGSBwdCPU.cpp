@@ -0,0 +1,328 @@
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Common.h"
+#include "Rasterization.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+////////////////////////////////////////////////////////////////
+// Backward (CPU)
+////////////////////////////////////////////////////////////////
+
+// The CPU version walks every tile back to front like
+// `rasterize_to_pixels_3dgs_bwd_kernel`, but instead of reducing over a warp
+// and issuing atomics it works in two passes:
+//
+// 1. Tiles are distributed over the intra-op thread pool. An intersection
+//    belongs to exactly one tile, so the gradient of each intersection (summed
+//    over the pixels of its tile) is written to a private row of an
+//    [n_isects, D] buffer without any synchronization.
+// 2. The intersections are bucketed by Gaussian and each Gaussian sums its own
+//    rows, so every output element is written by a single thread.
+//
+// The scratch memory is proportional to the number of intersections rather
+// than to (number of threads x number of Gaussians).
+void launch_rasterize_to_pixels_3dgs_bwd_kernel_cpu(
+    // Gaussian parameters
+    const at::Tensor means2d,                   // [..., N, 2] or [nnz, 2]
+    const at::Tensor conics,                    // [..., N, 3] or [nnz, 3]
+    const at::Tensor colors,                    // [..., N, channels] or [nnz, channels]
+    const at::Tensor opacities,                 // [..., N] or [nnz]
+    const at::optional<at::Tensor> backgrounds, // [..., channels]
+    const at::optional<at::Tensor> masks,       // [..., tile_height, tile_width]
+    // image size
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const uint32_t tile_size,
+    // intersections
+    const at::Tensor tile_offsets,    // [..., tile_height, tile_width]
+    const at::Tensor flatten_ids,     // [n_isects]
+    // forward outputs
+    const at::Tensor render_alphas,   // [..., image_height, image_width, 1]
+    const at::Tensor last_ids,        // [..., image_height, image_width]
+    // gradients of outputs
+    const at::Tensor v_render_colors, // [..., image_height, image_width, channels]
+    const at::Tensor v_render_alphas, // [..., image_height, image_width, 1]
+    // outputs
+    at::optional<at::Tensor> v_means2d_abs, // [..., N, 2] or [nnz, 2]
+    at::Tensor v_means2d,                   // [..., N, 2] or [nnz, 2]
+    at::Tensor v_conics,                    // [..., N, 3] or [nnz, 3]
+    at::Tensor v_colors,                    // [..., N, channels] or [nnz, channels]
+    at::Tensor v_opacities                  // [..., N] or [nnz]
+) {
+    const uint32_t channels = colors.size(-1);
+    const uint32_t I = render_alphas.numel() / (image_height * image_width);
+    const uint32_t tile_height = tile_offsets.size(-2);
+    const uint32_t tile_width = tile_offsets.size(-1);
+    const int64_t n_tiles = tile_height * tile_width;
+    const int32_t n_isects = flatten_ids.size(0);
+    const int64_t n_pixels = image_height * image_width;
+    const int64_t n_gaussians = opacities.numel();
+    const bool absgrad = v_means2d_abs.has_value();
+
+    if (n_isects == 0) {
+        return;
+    }
+
+    const float *means2d_ptr = means2d.data_ptr<float>();
+    const float *conics_ptr = conics.data_ptr<float>();
+    const float *colors_ptr = colors.data_ptr<float>();
+    const float *opacities_ptr = opacities.data_ptr<float>();
+    const float *backgrounds_ptr =
+        backgrounds.has_value() ? backgrounds.value().data_ptr<float>()
+                                : nullptr;
+    const bool *masks_ptr =
+        masks.has_value() ? masks.value().data_ptr<bool>() : nullptr;
+    const int32_t *tile_offsets_ptr = tile_offsets.data_ptr<int32_t>();
+    const int32_t *flatten_ids_ptr = flatten_ids.data_ptr<int32_t>();
+    const float *render_alphas_ptr = render_alphas.data_ptr<float>();
+    const int32_t *last_ids_ptr = last_ids.data_ptr<int32_t>();
+    const float *v_render_colors_ptr = v_render_colors.data_ptr<float>();
+    const float *v_render_alphas_ptr = v_render_alphas.data_ptr<float>();
+
+    // layout of a row of the per-intersection gradients
+    const int64_t OFF_XY = 0, OFF_CONIC = 2, OFF_OPAC = 5, OFF_ABS = 6;
+    const int64_t OFF_RGB = absgrad ? 8 : 6;
+    const int64_t D = OFF_RGB + channels;
+    // every row is written by the tile pass below, no need to zero it
+    std::unique_ptr<float[]> isect_grads(new float[n_isects * D]);
+
+    at::parallel_for(0, I * n_tiles, 1, [&](int64_t begin, int64_t end) {
+        // per-worker scratch, reused by all the tiles of this chunk
+        const uint32_t block_size = tile_size * tile_size;
+        std::vector<float> px(block_size), py(block_size);
+        std::vector<float> T(block_size), T_final(block_size);
+        std::vector<int32_t> bin_final(block_size);
+        std::vector<float> v_alpha_final(block_size);
+        std::vector<float> valid(block_size), vis(block_size);
+        std::vector<float> ra(block_size), fac(block_size);
+        std::vector<float> v_alpha(block_size);
+        // [channels, pix]
+        std::vector<float> v_rgb_pix(block_size * channels);
+        std::vector<float> buffer(block_size * channels);
+
+        for (int64_t flat_tile = begin; flat_tile < end; ++flat_tile) {
+            const uint32_t image_id = flat_tile / n_tiles;
+            const uint32_t tile_id = flat_tile % n_tiles;
+            const uint32_t i0 = (tile_id / tile_width) * tile_size;
+            const uint32_t j0 = (tile_id % tile_width) * tile_size;
+
+            const int32_t range_start = tile_offsets_ptr[flat_tile];
+            const int32_t range_end = flat_tile == I * n_tiles - 1
+                                          ? n_isects
+                                          : tile_offsets_ptr[flat_tile + 1];
+            if (range_end <= range_start) {
+                continue;
+            }
+            // masked and out-of-image tiles contribute no gradient
+            if ((masks_ptr != nullptr && !masks_ptr[flat_tile]) ||
+                i0 >= image_height || j0 >= image_width) {
+                std::fill(
+                    isect_grads.get() + range_start * D,
+                    isect_grads.get() + range_end * D,
+                    0.f
+                );
+                continue;
+            }
+            const uint32_t rows = std::min(tile_size, image_height - i0);
+            const uint32_t cols = std::min(tile_size, image_width - j0);
+            const int32_t n_pix = rows * cols;
+            const float *bg = backgrounds_ptr == nullptr
+                                  ? nullptr
+                                  : backgrounds_ptr + image_id * channels;
+
+            // gather the per-pixel state of the tile
+            int32_t max_bin_final = -1;
+            for (uint32_t r = 0; r < rows; ++r) {
+                for (uint32_t c = 0; c < cols; ++c) {
+                    const int32_t p = r * cols + c;
+                    const int64_t pix_id =
+                        image_id * n_pixels + (i0 + r) * image_width + j0 + c;
+                    px[p] = (float)(j0 + c) + 0.5f;
+                    py[p] = (float)(i0 + r) + 0.5f;
+                    // this is the T AFTER the last gaussian in this pixel
+                    T_final[p] = 1.0f - render_alphas_ptr[pix_id];
+                    T[p] = T_final[p];
+                    // index of last gaussian to contribute to this pixel
+                    bin_final[p] = last_ids_ptr[pix_id];
+                    max_bin_final = std::max(max_bin_final, bin_final[p]);
+                    // the contribution of the background to v_alpha is the
+                    // same for every gaussian of this pixel
+                    float v_bg = 0.f;
+                    for (uint32_t k = 0; k < channels; ++k) {
+                        const float v_c =
+                            v_render_colors_ptr[pix_id * channels + k];
+                        v_rgb_pix[k * n_pix + p] = v_c;
+                        buffer[k * n_pix + p] = 0.f;
+                        if (bg != nullptr) {
+                            v_bg += bg[k] * v_c;
+                        }
+                    }
+                    v_alpha_final[p] = v_render_alphas_ptr[pix_id] - v_bg;
+                }
+            }
+
+            // gaussians behind the last contributor of every pixel of this
+            // tile have no gradient
+            const int32_t last_idx = std::min(range_end - 1, max_bin_final);
+            if (last_idx + 1 < range_end) {
+                std::fill(
+                    isect_grads.get() + std::max(last_idx + 1, range_start) * D,
+                    isect_grads.get() + range_end * D,
+                    0.f
+                );
+            }
+
+            // walk the intersections of this tile back to front
+            for (int32_t idx = last_idx; idx >= range_start; --idx) {
+                const int32_t g = flatten_ids_ptr[idx];
+                const float mx = means2d_ptr[g * 2];
+                const float my = means2d_ptr[g * 2 + 1];
+                const float ca = conics_ptr[g * 3];
+                const float cb = conics_ptr[g * 3 + 1];
+                const float cc = conics_ptr[g * 3 + 2];
+                const float opac = opacities_ptr[g];
+                float *grad = isect_grads.get() + idx * D;
+
+                int32_t n_valid = 0;
+#pragma omp simd reduction(+ : n_valid)
+                for (int32_t p = 0; p < n_pix; ++p) {
+                    const float dx = mx - px[p];
+                    const float dy = my - py[p];
+                    const float sigma =
+                        0.5f * (ca * dx * dx + cc * dy * dy) + cb * dx * dy;
+                    const float vis_p = fast_expf(-sigma);
+                    const float a = opac * vis_p;
+                    const float alpha = select_f(a > 0.999f, 0.999f, a);
+                    // non-short-circuit logic keeps the loop branch-free
+                    const bool v = (idx <= bin_final[p]) & (sigma >= 0.f) &
+                                   (alpha >= ALPHA_THRESHOLD);
+                    // compute the current T for this gaussian
+                    const float ra_p = 1.0f / (1.0f - alpha);
+                    const float T_p = select_f(v, T[p] * ra_p, T[p]);
+                    T[p] = T_p;
+                    valid[p] = v ? 1.f : 0.f;
+                    vis[p] = vis_p;
+                    ra[p] = ra_p;
+                    fac[p] = select_f(v, alpha * T_p, 0.f);
+                    v_alpha[p] = T_final[p] * ra_p * v_alpha_final[p];
+                    n_valid += v;
+                }
+                if (n_valid == 0) {
+                    std::fill_n(grad, D, 0.f);
+                    continue;
+                }
+
+                // update v_rgb and v_alpha for this gaussian, then the
+                // accumulated color of the gaussians behind it
+                const float *c_ptr = colors_ptr + (int64_t)g * channels;
+                for (uint32_t k = 0; k < channels; ++k) {
+                    const float ck = c_ptr[k];
+                    const float *v_c = v_rgb_pix.data() + k * n_pix;
+                    float *buf_k = buffer.data() + k * n_pix;
+                    float v_rgb_k = 0.f;
+#pragma omp simd reduction(+ : v_rgb_k)
+                    for (int32_t p = 0; p < n_pix; ++p) {
+                        v_alpha[p] += (ck * T[p] - buf_k[p] * ra[p]) * v_c[p];
+                        v_rgb_k += fac[p] * v_c[p];
+                        buf_k[p] += ck * fac[p];
+                    }
+                    grad[OFF_RGB + k] = v_rgb_k;
+                }
+
+                float v_x = 0.f, v_y = 0.f, v_x_abs = 0.f, v_y_abs = 0.f;
+                float v_ca = 0.f, v_cb = 0.f, v_cc = 0.f, v_opac = 0.f;
+#pragma omp simd reduction(+ : v_x, v_y, v_x_abs, v_y_abs, v_ca, v_cb, v_cc, v_opac)
+                for (int32_t p = 0; p < n_pix; ++p) {
+                    const float dx = mx - px[p];
+                    const float dy = my - py[p];
+                    const bool v =
+                        (valid[p] != 0.f) & (opac * vis[p] <= 0.999f);
+                    const float v_sigma =
+                        select_f(v, -opac * vis[p] * v_alpha[p], 0.f);
+                    const float v_xl = v_sigma * (ca * dx + cb * dy);
+                    const float v_yl = v_sigma * (cb * dx + cc * dy);
+                    v_ca += 0.5f * v_sigma * dx * dx;
+                    v_cb += v_sigma * dx * dy;
+                    v_cc += 0.5f * v_sigma * dy * dy;
+                    v_x += v_xl;
+                    v_y += v_yl;
+                    v_x_abs += std::fabs(v_xl);
+                    v_y_abs += std::fabs(v_yl);
+                    v_opac += select_f(v, vis[p] * v_alpha[p], 0.f);
+                }
+                grad[OFF_XY] = v_x;
+                grad[OFF_XY + 1] = v_y;
+                grad[OFF_CONIC] = v_ca;
+                grad[OFF_CONIC + 1] = v_cb;
+                grad[OFF_CONIC + 2] = v_cc;
+                grad[OFF_OPAC] = v_opac;
+                if (absgrad) {
+                    grad[OFF_ABS] = v_x_abs;
+                    grad[OFF_ABS + 1] = v_y_abs;
+                }
+            }
+        }
+    });
+
+    // Bucket the intersections by gaussian (counting sort, in order of
+    // intersection so that the reduction below is deterministic).
+    std::vector<int64_t> g_offsets(n_gaussians + 1, 0);
+    for (int32_t idx = 0; idx < n_isects; ++idx) {
+        g_offsets[flatten_ids_ptr[idx] + 1]++;
+    }
+    for (int64_t g = 0; g < n_gaussians; ++g) {
+        g_offsets[g + 1] += g_offsets[g];
+    }
+    std::vector<int32_t> g_isects(n_isects);
+    {
+        std::vector<int64_t> cursor(g_offsets.begin(), g_offsets.end() - 1);
+        for (int32_t idx = 0; idx < n_isects; ++idx) {
+            g_isects[cursor[flatten_ids_ptr[idx]]++] = idx;
+        }
+    }
+
+    float *v_means2d_ptr = v_means2d.data_ptr<float>();
+    float *v_conics_ptr = v_conics.data_ptr<float>();
+    float *v_colors_ptr = v_colors.data_ptr<float>();
+    float *v_opacities_ptr = v_opacities.data_ptr<float>();
+    float *v_means2d_abs_ptr =
+        absgrad ? v_means2d_abs.value().data_ptr<float>() : nullptr;
+
+    at::parallel_for(0, n_gaussians, 1024, [&](int64_t begin, int64_t end) {
+        std::vector<float> acc(D);
+        for (int64_t g = begin; g < end; ++g) {
+            if (g_offsets[g] == g_offsets[g + 1]) {
+                continue;
+            }
+            std::fill(acc.begin(), acc.end(), 0.f);
+            for (int64_t i = g_offsets[g]; i < g_offsets[g + 1]; ++i) {
+                const float *grad = isect_grads.get() + g_isects[i] * D;
+#pragma omp simd
+                for (int64_t d = 0; d < D; ++d) {
+                    acc[d] += grad[d];
+                }
+            }
+            v_means2d_ptr[g * 2] = acc[OFF_XY];
+            v_means2d_ptr[g * 2 + 1] = acc[OFF_XY + 1];
+            v_conics_ptr[g * 3] = acc[OFF_CONIC];
+            v_conics_ptr[g * 3 + 1] = acc[OFF_CONIC + 1];
+            v_conics_ptr[g * 3 + 2] = acc[OFF_CONIC + 2];
+            v_opacities_ptr[g] = acc[OFF_OPAC];
+            if (absgrad) {
+                v_means2d_abs_ptr[g * 2] = acc[OFF_ABS];
+                v_means2d_abs_ptr[g * 2 + 1] = acc[OFF_ABS + 1];
+            }
+            for (uint32_t k = 0; k < channels; ++k) {
+                v_colors_ptr[g * channels + k] = acc[OFF_RGB + k];
+            }
+        }
+    });
+}
+
+} // namespace gsplat
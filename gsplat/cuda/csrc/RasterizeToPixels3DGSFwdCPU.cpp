@@ -0,0 +1,193 @@
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <vector>
+
+#include "Common.h"
+#include "Rasterization.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+////////////////////////////////////////////////////////////////
+// Forward (CPU)
+////////////////////////////////////////////////////////////////
+
+// The CPU version follows the same tile / tile_offsets / flatten_ids contract
+// as `rasterize_to_pixels_3dgs_fwd_kernel`. Tiles are distributed over the
+// intra-op thread pool; within a tile, each Gaussian is evaluated against all
+// pixels of the tile at once (pixels are stored SoA so the loop vectorizes),
+// and the tile stops as soon as every pixel has saturated.
+void launch_rasterize_to_pixels_3dgs_fwd_kernel_cpu(
+    // Gaussian parameters
+    const at::Tensor means2d,   // [..., N, 2] or [nnz, 2]
+    const at::Tensor conics,    // [..., N, 3] or [nnz, 3]
+    const at::Tensor colors,    // [..., N, channels] or [nnz, channels]
+    const at::Tensor opacities, // [..., N]  or [nnz]
+    const at::optional<at::Tensor> backgrounds, // [..., channels]
+    const at::optional<at::Tensor> masks,       // [..., tile_height, tile_width]
+    // image size
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const uint32_t tile_size,
+    // intersections
+    const at::Tensor tile_offsets, // [..., tile_height, tile_width]
+    const at::Tensor flatten_ids,  // [n_isects]
+    // outputs
+    at::Tensor renders, // [..., image_height, image_width, channels]
+    at::Tensor alphas,  // [..., image_height, image_width]
+    at::Tensor last_ids // [..., image_height, image_width]
+) {
+    const uint32_t channels = colors.size(-1);
+    const uint32_t I = alphas.numel() / (image_height * image_width);
+    const uint32_t tile_height = tile_offsets.size(-2);
+    const uint32_t tile_width = tile_offsets.size(-1);
+    const int64_t n_tiles = tile_height * tile_width;
+    const int32_t n_isects = flatten_ids.size(0);
+    const int64_t n_pixels = image_height * image_width;
+
+    const float *means2d_ptr = means2d.data_ptr<float>();
+    const float *conics_ptr = conics.data_ptr<float>();
+    const float *colors_ptr = colors.data_ptr<float>();
+    const float *opacities_ptr = opacities.data_ptr<float>();
+    const float *backgrounds_ptr =
+        backgrounds.has_value() ? backgrounds.value().data_ptr<float>()
+                                : nullptr;
+    const bool *masks_ptr =
+        masks.has_value() ? masks.value().data_ptr<bool>() : nullptr;
+    const int32_t *tile_offsets_ptr = tile_offsets.data_ptr<int32_t>();
+    const int32_t *flatten_ids_ptr = flatten_ids.data_ptr<int32_t>();
+    float *renders_ptr = renders.data_ptr<float>();
+    float *alphas_ptr = alphas.data_ptr<float>();
+    int32_t *last_ids_ptr = last_ids.data_ptr<int32_t>();
+
+    at::parallel_for(0, I * n_tiles, 1, [&](int64_t begin, int64_t end) {
+        // per-worker scratch, reused by all the tiles of this chunk
+        const uint32_t block_size = tile_size * tile_size;
+        std::vector<float> px(block_size), py(block_size);
+        std::vector<float> T(block_size), vis(block_size);
+        std::vector<int32_t> cur_idx(block_size), done(block_size);
+        std::vector<float> pix_out(block_size * channels); // [channels, pix]
+
+        for (int64_t flat_tile = begin; flat_tile < end; ++flat_tile) {
+            const uint32_t image_id = flat_tile / n_tiles;
+            const uint32_t tile_id = flat_tile % n_tiles;
+            const uint32_t i0 = (tile_id / tile_width) * tile_size;
+            const uint32_t j0 = (tile_id % tile_width) * tile_size;
+            if (i0 >= image_height || j0 >= image_width) {
+                continue;
+            }
+            const uint32_t rows = std::min(tile_size, image_height - i0);
+            const uint32_t cols = std::min(tile_size, image_width - j0);
+            const int32_t n_pix = rows * cols;
+
+            float *tile_renders = renders_ptr + image_id * n_pixels * channels;
+            float *tile_alphas = alphas_ptr + image_id * n_pixels;
+            int32_t *tile_last_ids = last_ids_ptr + image_id * n_pixels;
+            const float *bg = backgrounds_ptr == nullptr
+                                  ? nullptr
+                                  : backgrounds_ptr + image_id * channels;
+
+            // when the mask is provided, render the background color and
+            // skip if this tile is labeled as False
+            if (masks_ptr != nullptr && !masks_ptr[flat_tile]) {
+                for (uint32_t r = 0; r < rows; ++r) {
+                    for (uint32_t c = 0; c < cols; ++c) {
+                        const int64_t pix_id = (i0 + r) * image_width + j0 + c;
+                        for (uint32_t k = 0; k < channels; ++k) {
+                            tile_renders[pix_id * channels + k] =
+                                bg == nullptr ? 0.f : bg[k];
+                        }
+                        tile_alphas[pix_id] = 0.f;
+                        tile_last_ids[pix_id] = 0;
+                    }
+                }
+                continue;
+            }
+
+            for (uint32_t r = 0; r < rows; ++r) {
+                for (uint32_t c = 0; c < cols; ++c) {
+                    px[r * cols + c] = (float)(j0 + c) + 0.5f;
+                    py[r * cols + c] = (float)(i0 + r) + 0.5f;
+                }
+            }
+            std::fill_n(T.begin(), n_pix, 1.f);
+            std::fill_n(cur_idx.begin(), n_pix, 0);
+            std::fill_n(done.begin(), n_pix, 0);
+            std::fill_n(pix_out.begin(), n_pix * channels, 0.f);
+
+            // the intersections of this tile, front to back
+            const int32_t range_start = tile_offsets_ptr[flat_tile];
+            const int32_t range_end = flat_tile == I * n_tiles - 1
+                                          ? n_isects
+                                          : tile_offsets_ptr[flat_tile + 1];
+
+            int32_t n_alive = n_pix;
+            for (int32_t idx = range_start; idx < range_end && n_alive > 0;
+                 ++idx) {
+                const int32_t g = flatten_ids_ptr[idx];
+                const float mx = means2d_ptr[g * 2];
+                const float my = means2d_ptr[g * 2 + 1];
+                const float ca = conics_ptr[g * 3];
+                const float cb = conics_ptr[g * 3 + 1];
+                const float cc = conics_ptr[g * 3 + 2];
+                const float opac = opacities_ptr[g];
+
+                int32_t n_hit = 0, n_sat = 0;
+#pragma omp simd reduction(+ : n_hit, n_sat)
+                for (int32_t p = 0; p < n_pix; ++p) {
+                    const float dx = mx - px[p];
+                    const float dy = my - py[p];
+                    const float sigma =
+                        0.5f * (ca * dx * dx + cc * dy * dy) + cb * dx * dy;
+                    const float a = opac * fast_expf(-sigma);
+                    const float alpha = select_f(a > 0.999f, 0.999f, a);
+                    const float next_T = T[p] * (1.0f - alpha);
+                    // non-short-circuit logic keeps the loop branch-free
+                    const bool hit = (done[p] == 0) & (sigma >= 0.f) &
+                                     (alpha >= ALPHA_THRESHOLD);
+                    // this pixel is done: exclusive
+                    const bool sat = hit & (next_T <= 1e-4f);
+                    const bool contrib = hit & !sat;
+                    vis[p] = contrib ? alpha * T[p] : 0.f;
+                    T[p] = contrib ? next_T : T[p];
+                    cur_idx[p] = contrib ? idx : cur_idx[p];
+                    done[p] = sat ? 1 : done[p];
+                    n_hit += contrib;
+                    n_sat += sat;
+                }
+                n_alive -= n_sat;
+                if (n_hit == 0) {
+                    continue;
+                }
+
+                const float *c_ptr = colors_ptr + (int64_t)g * channels;
+                for (uint32_t k = 0; k < channels; ++k) {
+                    const float ck = c_ptr[k];
+                    float *out_k = pix_out.data() + k * n_pix;
+#pragma omp simd
+                    for (int32_t p = 0; p < n_pix; ++p) {
+                        out_k[p] += ck * vis[p];
+                    }
+                }
+            }
+
+            for (uint32_t r = 0; r < rows; ++r) {
+                for (uint32_t c = 0; c < cols; ++c) {
+                    const int32_t p = r * cols + c;
+                    const int64_t pix_id = (i0 + r) * image_width + j0 + c;
+                    // T is the transmittance AFTER the last gaussian
+                    tile_alphas[pix_id] = 1.0f - T[p];
+                    for (uint32_t k = 0; k < channels; ++k) {
+                        const float out = pix_out[k * n_pix + p];
+                        tile_renders[pix_id * channels + k] =
+                            bg == nullptr ? out : (out + T[p] * bg[k]);
+                    }
+                    // index in bin of last gaussian in this pixel
+                    tile_last_ids[pix_id] = cur_idx[p];
+                }
+            }
+        }
+    });
+}
+
+} // namespace gsplat
@@ -20,14 +20,17 @@ std::tuple<at::Tensor, at::Tensor> relocation(
     const int n_max
 ) {
     DEVICE_GUARD(opacities);
-    CHECK_INPUT(opacities);
-    CHECK_INPUT(scales);
-    CHECK_INPUT(ratios);
-    CHECK_INPUT(binoms);
+    CHECK_CUDA_OR_CPU(opacities);
+    CHECK_CONTIGUOUS(opacities);
+    CHECK_INPUT_LIKE(scales, opacities);
+    CHECK_INPUT_LIKE(ratios, opacities);
+    CHECK_INPUT_LIKE(binoms, opacities);
     at::Tensor new_opacities = at::empty_like(opacities);
     at::Tensor new_scales = at::empty_like(scales);
 
-    launch_relocation_kernel(
+    auto launch = opacities.is_cpu() ? launch_relocation_kernel_cpu
+                                     : launch_relocation_kernel;
+    launch(
         opacities, scales, ratios, binoms, n_max, new_opacities, new_scales
     );
     return std::make_tuple(new_opacities, new_scales);
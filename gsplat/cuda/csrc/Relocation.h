@@ -20,4 +20,17 @@ void launch_relocation_kernel(
     at::Tensor new_scales     // [N, 3]
 );
 
+// CPU counterpart of the launcher above.
+void launch_relocation_kernel_cpu(
+    // inputs
+    at::Tensor opacities, // [N]
+    at::Tensor scales,    // [N, 3]
+    at::Tensor ratios,    // [N]
+    at::Tensor binoms,    // [n_max, n_max]
+    const int n_max,
+    // outputs
+    at::Tensor new_opacities, // [N]
+    at::Tensor new_scales     // [N, 3]
+);
+
 }
\ No newline at end of file
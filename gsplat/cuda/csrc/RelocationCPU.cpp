@@ -0,0 +1,140 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <cmath>
+#include <vector>
+
+#include "Common.h"
+#include "Relocation.h"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Number of Gaussians evaluated together in the SIMD loops.
+constexpr int64_t RELOCATION_LANES = 16;
+
+// Equation (9) in "3D Gaussian Splatting as Markov Chain Monte Carlo".
+//
+// Exchanging the two sums of the CUDA kernel, the denominator for a ratio n is
+// a polynomial in the new opacity a,
+//   sum_{k=0}^{n-1} (-1)^k / sqrt(k+1) * S[n][k] * a^{k+1},
+//   S[n][k] = sum_{i=k+1}^{n} binoms[i-1][k],
+// whose coefficients only depend on (n, k). They are tabulated once per call
+// in `series` ([n_max, n_max], n_max^2 floats, which stays in L1/L2), so that
+// each Gaussian costs a Horner evaluation of degree n instead of n^2 terms.
+template <typename scalar_t>
+GSPLAT_CPU_TARGET_CLONES void relocation_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const scalar_t *__restrict__ opacities, // [N]
+    const scalar_t *__restrict__ scales,    // [N, 3]
+    const int *__restrict__ ratios,         // [N]
+    const float *__restrict__ series,       // [n_max, n_max]
+    const int n_max,
+    scalar_t *__restrict__ new_opacities, // [N]
+    scalar_t *__restrict__ new_scales     // [N, 3]
+) {
+    for (int64_t base = begin; base < end; base += RELOCATION_LANES) {
+        const int64_t n = std::min(RELOCATION_LANES, end - base);
+
+        float opacity[RELOCATION_LANES], a[RELOCATION_LANES];
+        float acc[RELOCATION_LANES];
+        int32_t row[RELOCATION_LANES];
+        int n_hi = 1;
+        for (int64_t l = 0; l < RELOCATION_LANES; ++l) {
+            const int ratio =
+                l < n ? std::min(std::max(ratios[base + l], 1), n_max) : 1;
+            opacity[l] = l < n ? static_cast<float>(opacities[base + l]) : 0.f;
+            // compute new opacity
+            a[l] = 1.0f - std::pow(1.0f - opacity[l], 1.0f / ratio);
+            row[l] = (ratio - 1) * n_max;
+            acc[l] = 0.f;
+            n_hi = std::max(n_hi, ratio);
+        }
+
+        // compute new scale. The coefficients past the degree of a lane are
+        // zero, so all lanes can run up to the largest one.
+        for (int k = n_hi - 1; k >= 0; --k) {
+#pragma omp simd
+            for (int64_t l = 0; l < RELOCATION_LANES; ++l) {
+                acc[l] = acc[l] * a[l] + series[row[l] + k];
+            }
+        }
+
+        for (int64_t l = 0; l < n; ++l) {
+            const int64_t idx = base + l;
+            const float coeff = opacity[l] / (acc[l] * a[l]);
+            new_opacities[idx] = a[l];
+            for (int i = 0; i < 3; ++i) {
+                new_scales[idx * 3 + i] = coeff * scales[idx * 3 + i];
+            }
+        }
+    }
+}
+
+} // namespace
+
+void launch_relocation_kernel_cpu(
+    // inputs
+    at::Tensor opacities, // [N]
+    at::Tensor scales,    // [N, 3]
+    at::Tensor ratios,    // [N]
+    at::Tensor binoms,    // [n_max, n_max]
+    const int n_max,
+    // outputs
+    at::Tensor new_opacities, // [N]
+    at::Tensor new_scales     // [N, 3]
+) {
+    const int64_t N = opacities.size(0);
+    if (N == 0) {
+        return;
+    }
+
+    AT_DISPATCH_FLOATING_TYPES(
+        opacities.scalar_type(),
+        "relocation_cpu",
+        [&]() {
+            // series[n - 1][k] = (-1)^k / sqrt(k + 1) * sum_{i=k+1}^{n}
+            // binoms[i - 1][k], built in double since the terms alternate.
+            const scalar_t *binoms_ptr = binoms.data_ptr<scalar_t>();
+            std::vector<float> series(n_max * n_max, 0.f);
+            for (int k = 0; k < n_max; ++k) {
+                const double sign_k = (k % 2 == 0) ? 1.0 : -1.0;
+                const double w = sign_k / std::sqrt(static_cast<double>(k + 1));
+                double binom_sum = 0.0;
+                for (int i = k + 1; i <= n_max; ++i) {
+                    binom_sum += binoms_ptr[(i - 1) * n_max + k];
+                    series[(i - 1) * n_max + k] = w * binom_sum;
+                }
+            }
+
+            const scalar_t *opacities_ptr = opacities.data_ptr<scalar_t>();
+            const scalar_t *scales_ptr = scales.data_ptr<scalar_t>();
+            const int *ratios_ptr = ratios.data_ptr<int>();
+            scalar_t *new_opacities_ptr = new_opacities.data_ptr<scalar_t>();
+            scalar_t *new_scales_ptr = new_scales.data_ptr<scalar_t>();
+            at::parallel_for(
+                0,
+                N,
+                64 * RELOCATION_LANES,
+                [&](int64_t begin, int64_t end) {
+                    relocation_cpu<scalar_t>(
+                        begin,
+                        end,
+                        opacities_ptr,
+                        scales_ptr,
+                        ratios_ptr,
+                        series.data(),
+                        n_max,
+                        new_opacities_ptr,
+                        new_scales_ptr
+                    );
+                }
+            );
+        }
+    );
+}
+
+} // namespace gsplat
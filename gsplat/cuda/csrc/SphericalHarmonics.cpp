@@ -9,6 +9,7 @@
 #include "Common.h"             // where all the macros are defined
 #include "Ops.h"                // a collection of all gsplat operators
 #include "SphericalHarmonics.h" // where the launch function is declared
+#include "Utils.cuh"            // for the storage of the Gaussians
 
 namespace gsplat {
 
@@ -19,22 +20,156 @@ at::Tensor spherical_harmonics_fwd(
     const at::optional<at::Tensor> masks // [...]
 ) {
     DEVICE_GUARD(dirs);
-    CHECK_INPUT(dirs);
-    CHECK_INPUT(coeffs);
+    CHECK_CUDA_OR_CPU(dirs);
+    CHECK_CONTIGUOUS(dirs);
+    CHECK_INPUT_LIKE(coeffs, dirs);
     if (masks.has_value()) {
-        CHECK_INPUT(masks.value());
+        CHECK_INPUT_LIKE(masks.value(), dirs);
     }
     TORCH_CHECK(coeffs.size(-1) == 3, "coeffs must have last dimension 3");
     TORCH_CHECK(dirs.size(-1) == 3, "dirs must have last dimension 3");
 
     at::Tensor colors = at::empty_like(dirs); // [..., 3]
 
-    launch_spherical_harmonics_fwd_kernel(
+    auto launch = dirs.is_cpu() ? launch_spherical_harmonics_fwd_kernel_cpu
+                                : launch_spherical_harmonics_fwd_kernel;
+    launch(
         degrees_to_use, dirs, coeffs, masks, colors
     );
     return colors; // [..., 3]
 }
 
+at::Tensor spherical_harmonics_storage_fwd(
+    const uint32_t degrees_to_use,
+    const at::Tensor means,                        // [N, 3]
+    const at::Tensor coeffs,                       // [N, K, 3]
+    const at::optional<at::Tensor> means_dequant,  // [n_chunks, 2, 11]
+    const at::optional<at::Tensor> coeffs_dequant, // [n_chunks, 2, K * 3]
+    const int64_t chunk_size,
+    const at::Tensor campos,                     // [C, 3]
+    const at::optional<at::Tensor> camera_ids,   // [nnz] optional
+    const at::optional<at::Tensor> gaussian_ids, // [nnz] optional
+    const at::optional<at::Tensor> masks         // [C, N] or [nnz] optional
+) {
+    DEVICE_GUARD(means);
+    CHECK_CUDA_OR_CPU(means);
+    CHECK_CONTIGUOUS(means);
+    CHECK_INPUT_LIKE(coeffs, means);
+    CHECK_INPUT_LIKE(campos, means);
+    if (means_dequant.has_value()) {
+        CHECK_INPUT_LIKE(means_dequant.value(), means);
+    }
+    if (coeffs_dequant.has_value()) {
+        CHECK_INPUT_LIKE(coeffs_dequant.value(), means);
+    }
+    if (camera_ids.has_value()) {
+        CHECK_INPUT_LIKE(camera_ids.value(), means);
+    }
+    if (gaussian_ids.has_value()) {
+        CHECK_INPUT_LIKE(gaussian_ids.value(), means);
+    }
+    if (masks.has_value()) {
+        CHECK_INPUT_LIKE(masks.value(), means);
+    }
+    TORCH_CHECK(
+        means.dim() == 2 && means.size(1) == 3, "means must have shape [N, 3]"
+    );
+    TORCH_CHECK(
+        coeffs.dim() == 3 && coeffs.size(0) == means.size(0) &&
+            coeffs.size(-1) == 3,
+        "coeffs must have shape [N, K, 3]"
+    );
+    const at::ScalarType storage = means.scalar_type();
+    TORCH_CHECK(
+        storage == at::kFloat || storage == at::kHalf || storage == at::kByte,
+        "means must be stored in float32, float16 or uint8"
+    );
+    TORCH_CHECK(
+        coeffs.scalar_type() == storage,
+        "means and coeffs must have the same dtype"
+    );
+    TORCH_CHECK(
+        campos.scalar_type() == at::kFloat && campos.dim() == 2 &&
+            campos.size(1) == 3,
+        "campos must be a float32 tensor of shape [C, 3]"
+    );
+    TORCH_CHECK(
+        means_dequant.has_value() == (storage == at::kByte) &&
+            coeffs_dequant.has_value() == (storage == at::kByte),
+        "means_dequant and coeffs_dequant must be given if and only if the "
+        "Gaussians are stored in uint8"
+    );
+    const int64_t N = means.size(0);
+    if (storage == at::kByte) {
+        const int64_t n_chunks =
+            chunk_size > 0 ? (N + chunk_size - 1) / chunk_size : 0;
+        TORCH_CHECK(chunk_size > 0, "chunk_size must be positive");
+        TORCH_CHECK(
+            means_dequant.value().scalar_type() == at::kFloat &&
+                means_dequant.value().dim() == 3 &&
+                means_dequant.value().size(0) == n_chunks &&
+                means_dequant.value().size(1) == 2 &&
+                means_dequant.value().size(2) == STORAGE_GEOMETRY_CHANNELS,
+            "means_dequant must be a float32 tensor of shape [n_chunks, 2, 11]"
+        );
+        TORCH_CHECK(
+            coeffs_dequant.value().scalar_type() == at::kFloat &&
+                coeffs_dequant.value().dim() == 3 &&
+                coeffs_dequant.value().size(0) == n_chunks &&
+                coeffs_dequant.value().size(1) == 2 &&
+                coeffs_dequant.value().size(2) == coeffs.size(1) * 3,
+            "coeffs_dequant must be a float32 tensor of shape "
+            "[n_chunks, 2, K * 3]"
+        );
+    }
+    TORCH_CHECK(
+        camera_ids.has_value() == gaussian_ids.has_value(),
+        "camera_ids and gaussian_ids must be given together"
+    );
+    const bool packed = camera_ids.has_value();
+    const int64_t M = packed ? camera_ids.value().numel() : campos.size(0) * N;
+    if (packed) {
+        TORCH_CHECK(
+            camera_ids.value().scalar_type() == at::kLong &&
+                gaussian_ids.value().scalar_type() == at::kLong &&
+                gaussian_ids.value().numel() == M,
+            "camera_ids and gaussian_ids must be int64 tensors of shape [nnz]"
+        );
+    }
+    if (masks.has_value()) {
+        TORCH_CHECK(
+            masks.value().scalar_type() == at::kBool &&
+                masks.value().numel() == M,
+            "masks must be a bool tensor with one value per pair"
+        );
+    }
+
+    at::Tensor colors = at::empty({M, 3}, campos.options()); // [M, 3]
+    if (masks.has_value()) {
+        // masked pairs are not evaluated
+        colors.zero_();
+    }
+
+    auto launch = means.is_cpu()
+                      ? launch_spherical_harmonics_storage_fwd_kernel_cpu
+                      : launch_spherical_harmonics_storage_fwd_kernel;
+    launch(
+        degrees_to_use,
+        means,
+        coeffs,
+        means_dequant,
+        coeffs_dequant,
+        chunk_size,
+        campos,
+        camera_ids,
+        gaussian_ids,
+        masks,
+        colors
+    );
+    // [nnz, 3] or [C, N, 3]
+    return packed ? colors : colors.view({campos.size(0), N, 3});
+}
+
 std::tuple<at::Tensor, at::Tensor> spherical_harmonics_bwd(
     const uint32_t K,
     const uint32_t degrees_to_use,
@@ -45,11 +180,12 @@ std::tuple<at::Tensor, at::Tensor> spherical_harmonics_bwd(
     bool compute_v_dirs
 ) {
     DEVICE_GUARD(dirs);
-    CHECK_INPUT(dirs);
-    CHECK_INPUT(coeffs);
-    CHECK_INPUT(v_colors);
+    CHECK_CUDA_OR_CPU(dirs);
+    CHECK_CONTIGUOUS(dirs);
+    CHECK_INPUT_LIKE(coeffs, dirs);
+    CHECK_INPUT_LIKE(v_colors, dirs);
     if (masks.has_value()) {
-        CHECK_INPUT(masks.value());
+        CHECK_INPUT_LIKE(masks.value(), dirs);
     }
     TORCH_CHECK(v_colors.size(-1) == 3, "v_colors must have last dimension 3");
     TORCH_CHECK(coeffs.size(-1) == 3, "coeffs must have last dimension 3");
@@ -62,10 +198,9 @@ std::tuple<at::Tensor, at::Tensor> spherical_harmonics_bwd(
         v_dirs = at::zeros_like(dirs);
     }
 
-    at::cuda::CUDAStream stream = at::cuda::getCurrentCUDAStream();
-    uint32_t n_elements = N;
-    uint32_t shmem_size = 0;
-    launch_spherical_harmonics_bwd_kernel(
+    auto launch = dirs.is_cpu() ? launch_spherical_harmonics_bwd_kernel_cpu
+                                : launch_spherical_harmonics_bwd_kernel;
+    launch(
         degrees_to_use,
         dirs,
         coeffs,
@@ -30,4 +30,62 @@ void launch_spherical_harmonics_bwd_kernel(
     at::optional<at::Tensor> v_dirs // [..., 3]
 );
 
+// Evaluates the stored Gaussians gaussian_ids[m] from the camera centers
+// campos[camera_ids[m]], or every (camera, Gaussian) pair of [C, N] if the ids
+// are not given. See `spherical_harmonics_storage_fwd` in Ops.h.
+void launch_spherical_harmonics_storage_fwd_kernel(
+    // inputs
+    const uint32_t degrees_to_use,
+    const at::Tensor means,                        // [N, 3]
+    const at::Tensor coeffs,                       // [N, K, 3]
+    const at::optional<at::Tensor> means_dequant,  // [n_chunks, 2, 11]
+    const at::optional<at::Tensor> coeffs_dequant, // [n_chunks, 2, K * 3]
+    const uint32_t chunk_size,
+    const at::Tensor campos,                     // [C, 3]
+    const at::optional<at::Tensor> camera_ids,   // [M] optional
+    const at::optional<at::Tensor> gaussian_ids, // [M] optional
+    const at::optional<at::Tensor> masks,        // [M] optional
+    // outputs
+    at::Tensor colors // [M, 3]
+);
+
+// CPU counterparts of the three launchers above.
+void launch_spherical_harmonics_fwd_kernel_cpu(
+    // inputs
+    const uint32_t degrees_to_use,
+    const at::Tensor dirs,                // [..., 3]
+    const at::Tensor coeffs,              // [..., K, 3]
+    const at::optional<at::Tensor> masks, // [...]
+    // outputs
+    at::Tensor colors // [..., 3]
+);
+
+void launch_spherical_harmonics_bwd_kernel_cpu(
+    // inputs
+    const uint32_t degrees_to_use,
+    const at::Tensor dirs,                // [..., 3]
+    const at::Tensor coeffs,              // [..., K, 3]
+    const at::optional<at::Tensor> masks, // [...]
+    const at::Tensor v_colors,            // [..., 3]
+    // outputs
+    at::Tensor v_coeffs,            // [..., K, 3]
+    at::optional<at::Tensor> v_dirs // [..., 3]
+);
+
+void launch_spherical_harmonics_storage_fwd_kernel_cpu(
+    // inputs
+    const uint32_t degrees_to_use,
+    const at::Tensor means,                        // [N, 3]
+    const at::Tensor coeffs,                       // [N, K, 3]
+    const at::optional<at::Tensor> means_dequant,  // [n_chunks, 2, 11]
+    const at::optional<at::Tensor> coeffs_dequant, // [n_chunks, 2, K * 3]
+    const uint32_t chunk_size,
+    const at::Tensor campos,                     // [C, 3]
+    const at::optional<at::Tensor> camera_ids,   // [M] optional
+    const at::optional<at::Tensor> gaussian_ids, // [M] optional
+    const at::optional<at::Tensor> masks,        // [M] optional
+    // outputs
+    at::Tensor colors // [M, 3]
+);
+
 } // namespace gsplat
\ No newline at end of file
@@ -0,0 +1,753 @@
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Tensor.h>
+#include <cmath>
+#include <type_traits>
+
+#include "Common.h"
+#include "SphericalHarmonics.h"
+#include "Utils.cuh"
+#include "UtilsCPU.h"
+
+namespace gsplat {
+
+namespace {
+
+// Number of directions evaluated together: one AVX-512 register, or two AVX2
+// ones, of floats. Everything per-lane is stored SoA as [..][SH_LANES].
+constexpr int64_t SH_LANES = 16;
+
+// Number of Gaussians a worker takes from the thread pool at a time.
+constexpr int64_t SH_GRAIN = 64 * SH_LANES;
+
+// Gather the directions of a batch. Unused lanes point to +z so that they stay
+// finite.
+template <typename scalar_t>
+GSPLAT_CPU_INLINE void sh_gather_dirs_lanes(
+    const int64_t n,
+    const int64_t *ids,
+    const scalar_t *dirs, // [N, 3]
+    float *x,
+    float *y,
+    float *z
+) {
+    for (int64_t l = 0; l < SH_LANES; ++l) {
+        const bool active = l < n;
+        const scalar_t *dir = dirs + (active ? ids[l] : 0) * 3;
+        x[l] = active ? static_cast<float>(dir[0]) : 0.f;
+        y[l] = active ? static_cast<float>(dir[1]) : 0.f;
+        z[l] = active ? static_cast<float>(dir[2]) : 1.f;
+    }
+}
+
+// Same for the directions from the cameras cids[l] to the stored means gids[l],
+// dequantized if they are stored in uint8.
+template <typename attr_t>
+GSPLAT_CPU_INLINE void sh_storage_dirs_lanes(
+    const int64_t n,
+    const int64_t *cids,
+    const int64_t *gids,
+    const attr_t *means,  // [N, 3]
+    const float *dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    const float *campos, // [C, 3]
+    float *x,
+    float *y,
+    float *z
+) {
+    for (int64_t l = 0; l < SH_LANES; ++l) {
+        if (l >= n) {
+            x[l] = y[l] = 0.f;
+            z[l] = 1.f;
+            continue;
+        }
+        const AttrReader<attr_t> mean = attr_reader(
+            means,
+            gids[l],
+            3,
+            dequant,
+            chunk_size,
+            STORAGE_GEOMETRY_CHANNELS,
+            STORAGE_MEANS_OFFSET
+        );
+        const float *origin = campos + cids[l] * 3;
+        x[l] = mean[0] - origin[0];
+        y[l] = mean[1] - origin[1];
+        z[l] = mean[2] - origin[2];
+    }
+}
+
+// Normalize the directions of a batch when the degree needs them.
+template <uint32_t DEGREE>
+GSPLAT_CPU_INLINE void
+sh_normalize_dirs_lanes(float *x, float *y, float *z, float *inorm) {
+    if constexpr (DEGREE < 1) {
+        return;
+    }
+#pragma omp simd
+    for (int64_t l = 0; l < SH_LANES; ++l) {
+        inorm[l] = 1.f / std::sqrt(x[l] * x[l] + y[l] * y[l] + z[l] * z[l]);
+        x[l] *= inorm[l];
+        y[l] *= inorm[l];
+        z[l] *= inorm[l];
+    }
+}
+
+// Transpose the [K, 3] coefficients of a batch to [B, 3, SH_LANES],
+// dequantizing them if they are stored in uint8.
+template <uint32_t DEGREE, typename attr_t>
+GSPLAT_CPU_INLINE void sh_load_coeffs_lanes(
+    const uint32_t K,
+    const int64_t n,
+    const int64_t *ids,
+    const attr_t *coeffs, // [N, K, 3]
+    const float *dequant, // [n_chunks, 2, K * 3] optional
+    const uint32_t chunk_size,
+    float (*coef)[3][SH_LANES]
+) {
+    constexpr uint32_t B = (DEGREE + 1) * (DEGREE + 1);
+    for (int64_t l = 0; l < SH_LANES; ++l) {
+        const AttrReader<attr_t> src = attr_reader(
+            coeffs, l < n ? ids[l] : 0, K * 3, dequant, chunk_size, K * 3, 0
+        );
+        for (uint32_t k = 0; k < B; ++k) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                coef[k][c][l] = l < n ? src[k * 3 + c] : 0.f;
+            }
+        }
+    }
+}
+
+// The SH bases up to DEGREE at unit directions, with the polynomials of
+// Sloan, "Efficient Spherical Harmonic Evaluation", JCGT 2013, as in
+// `sh_coeffs_to_color_fast` of the CUDA kernel.
+template <uint32_t DEGREE>
+GSPLAT_CPU_INLINE void sh_bases_lanes(
+    const float *x, const float *y, const float *z, float (*sh)[SH_LANES]
+) {
+#pragma omp simd
+    for (int64_t l = 0; l < SH_LANES; ++l) {
+        sh[0][l] = 0.2820947917738781f;
+        if constexpr (DEGREE >= 1) {
+            sh[1][l] = -0.48860251190292f * y[l];
+            sh[2][l] = 0.48860251190292f * z[l];
+            sh[3][l] = -0.48860251190292f * x[l];
+        }
+        if constexpr (DEGREE >= 2) {
+            const float z2 = z[l] * z[l];
+            const float fTmp0B = -1.092548430592079f * z[l];
+            const float fC1 = x[l] * x[l] - y[l] * y[l];
+            const float fS1 = 2.f * x[l] * y[l];
+            const float pSH6 = 0.9461746957575601f * z2 - 0.3153915652525201f;
+            sh[4][l] = 0.5462742152960395f * fS1;
+            sh[5][l] = fTmp0B * y[l];
+            sh[6][l] = pSH6;
+            sh[7][l] = fTmp0B * x[l];
+            sh[8][l] = 0.5462742152960395f * fC1;
+            if constexpr (DEGREE >= 3) {
+                const float fTmp0C =
+                    -2.285228997322329f * z2 + 0.4570457994644658f;
+                const float fTmp1B = 1.445305721320277f * z[l];
+                const float fC2 = x[l] * fC1 - y[l] * fS1;
+                const float fS2 = x[l] * fS1 + y[l] * fC1;
+                const float pSH12 =
+                    z[l] * (1.865881662950577f * z2 - 1.119528997770346f);
+                sh[9][l] = -0.5900435899266435f * fS2;
+                sh[10][l] = fTmp1B * fS1;
+                sh[11][l] = fTmp0C * y[l];
+                sh[12][l] = pSH12;
+                sh[13][l] = fTmp0C * x[l];
+                sh[14][l] = fTmp1B * fC1;
+                sh[15][l] = -0.5900435899266435f * fC2;
+                if constexpr (DEGREE >= 4) {
+                    const float fTmp0D =
+                        z[l] * (-4.683325804901025f * z2 + 2.007139630671868f);
+                    const float fTmp1C =
+                        3.31161143515146f * z2 - 0.47308734787878f;
+                    const float fTmp2B = -1.770130769779931f * z[l];
+                    const float fC3 = x[l] * fC2 - y[l] * fS2;
+                    const float fS3 = x[l] * fS2 + y[l] * fC2;
+                    sh[16][l] = 0.6258357354491763f * fS3;
+                    sh[17][l] = fTmp2B * fS2;
+                    sh[18][l] = fTmp1C * fS1;
+                    sh[19][l] = fTmp0D * y[l];
+                    sh[20][l] = 1.984313483298443f * z[l] * pSH12 -
+                                1.006230589874905f * pSH6;
+                    sh[21][l] = fTmp0D * x[l];
+                    sh[22][l] = fTmp1C * fC1;
+                    sh[23][l] = fTmp2B * fC2;
+                    sh[24][l] = 0.6258357354491763f * fC3;
+                }
+            }
+        }
+    }
+}
+
+// Gradient w.r.t. the unit direction of sum_k g[k] * sh_k(dir), where g[k] is
+// the color gradient already contracted with the coefficients of basis k.
+// Same derivatives as `sh_coeffs_to_color_fast_vjp` of the CUDA kernel.
+template <uint32_t DEGREE>
+GSPLAT_CPU_INLINE void sh_bases_vjp_lanes(
+    const float *x,
+    const float *y,
+    const float *z,
+    const float (*g)[SH_LANES],
+    float *v_x,
+    float *v_y,
+    float *v_z
+) {
+#pragma omp simd
+    for (int64_t l = 0; l < SH_LANES; ++l) {
+        float vx = -0.48860251190292f * g[3][l];
+        float vy = -0.48860251190292f * g[1][l];
+        float vz = 0.48860251190292f * g[2][l];
+        if constexpr (DEGREE >= 2) {
+            const float z2 = z[l] * z[l];
+            const float fTmp0B = -1.092548430592079f * z[l];
+            const float fC1 = x[l] * x[l] - y[l] * y[l];
+            const float fS1 = 2.f * x[l] * y[l];
+            const float fC1_x = 2.f * x[l];
+            const float fC1_y = -2.f * y[l];
+            const float fS1_x = 2.f * y[l];
+            const float fS1_y = 2.f * x[l];
+            const float pSH6_z = 2.f * 0.9461746957575601f * z[l];
+            vx += 0.5462742152960395f * fS1_x * g[4][l] +
+                  0.5462742152960395f * fC1_x * g[8][l] + fTmp0B * g[7][l];
+            vy += 0.5462742152960395f * fS1_y * g[4][l] +
+                  0.5462742152960395f * fC1_y * g[8][l] + fTmp0B * g[5][l];
+            vz += pSH6_z * g[6][l] - 1.092548430592079f * x[l] * g[7][l] -
+                  1.092548430592079f * y[l] * g[5][l];
+            if constexpr (DEGREE >= 3) {
+                const float fTmp0C =
+                    -2.285228997322329f * z2 + 0.4570457994644658f;
+                const float fTmp1B = 1.445305721320277f * z[l];
+                const float fC2 = x[l] * fC1 - y[l] * fS1;
+                const float fS2 = x[l] * fS1 + y[l] * fC1;
+                const float pSH12 =
+                    z[l] * (1.865881662950577f * z2 - 1.119528997770346f);
+                const float fTmp0C_z = -2.285228997322329f * 2.f * z[l];
+                const float fC2_x = fC1 + x[l] * fC1_x - y[l] * fS1_x;
+                const float fC2_y = x[l] * fC1_y - fS1 - y[l] * fS1_y;
+                const float fS2_x = fS1 + x[l] * fS1_x + y[l] * fC1_x;
+                const float fS2_y = x[l] * fS1_y + fC1 + y[l] * fC1_y;
+                const float pSH12_z =
+                    3.f * 1.865881662950577f * z2 - 1.119528997770346f;
+                vx += -0.5900435899266435f * fS2_x * g[9][l] +
+                      -0.5900435899266435f * fC2_x * g[15][l] +
+                      fTmp1B * fS1_x * g[10][l] + fTmp1B * fC1_x * g[14][l] +
+                      fTmp0C * g[13][l];
+                vy += -0.5900435899266435f * fS2_y * g[9][l] +
+                      -0.5900435899266435f * fC2_y * g[15][l] +
+                      fTmp1B * fS1_y * g[10][l] + fTmp1B * fC1_y * g[14][l] +
+                      fTmp0C * g[11][l];
+                vz += pSH12_z * g[12][l] + fTmp0C_z * x[l] * g[13][l] +
+                      fTmp0C_z * y[l] * g[11][l] +
+                      1.445305721320277f * fC1 * g[14][l] +
+                      1.445305721320277f * fS1 * g[10][l];
+                if constexpr (DEGREE >= 4) {
+                    const float fTmp0D =
+                        z[l] * (-4.683325804901025f * z2 + 2.007139630671868f);
+                    const float fTmp1C =
+                        3.31161143515146f * z2 - 0.47308734787878f;
+                    const float fTmp2B = -1.770130769779931f * z[l];
+                    const float fTmp0D_z =
+                        3.f * -4.683325804901025f * z2 + 2.007139630671868f;
+                    const float fTmp1C_z = 2.f * 3.31161143515146f * z[l];
+                    const float fTmp2B_z = -1.770130769779931f;
+                    const float fC3_x = fC2 + x[l] * fC2_x - y[l] * fS2_x;
+                    const float fC3_y = x[l] * fC2_y - fS2 - y[l] * fS2_y;
+                    const float fS3_x = fS2 + y[l] * fC2_x + x[l] * fS2_x;
+                    const float fS3_y = x[l] * fS2_y + fC2 + y[l] * fC2_y;
+                    const float pSH20_z =
+                        1.984313483298443f * (pSH12 + z[l] * pSH12_z) +
+                        -1.006230589874905f * pSH6_z;
+                    vx += 0.6258357354491763f * fS3_x * g[16][l] +
+                          0.6258357354491763f * fC3_x * g[24][l] +
+                          fTmp2B * fS2_x * g[17][l] +
+                          fTmp2B * fC2_x * g[23][l] +
+                          fTmp1C * fS1_x * g[18][l] +
+                          fTmp1C * fC1_x * g[22][l] + fTmp0D * g[21][l];
+                    vy += 0.6258357354491763f * fS3_y * g[16][l] +
+                          0.6258357354491763f * fC3_y * g[24][l] +
+                          fTmp2B * fS2_y * g[17][l] +
+                          fTmp2B * fC2_y * g[23][l] +
+                          fTmp1C * fS1_y * g[18][l] +
+                          fTmp1C * fC1_y * g[22][l] + fTmp0D * g[19][l];
+                    vz += pSH20_z * g[20][l] + fTmp0D_z * x[l] * g[21][l] +
+                          fTmp0D_z * y[l] * g[19][l] +
+                          fTmp1C_z * fC1 * g[22][l] +
+                          fTmp1C_z * fS1 * g[18][l] +
+                          fTmp2B_z * fC2 * g[23][l] +
+                          fTmp2B_z * fS2 * g[17][l];
+                }
+            }
+        }
+        v_x[l] = vx;
+        v_y[l] = vy;
+        v_z[l] = vz;
+    }
+}
+
+// Evaluate the gathered directions of a batch, the lane l with the
+// coefficients cids[l], and write its color to colors[ids[l]].
+template <uint32_t DEGREE, typename scalar_t, typename attr_t>
+GSPLAT_CPU_INLINE void sh_fwd_lanes(
+    const uint32_t K,
+    const int64_t n,
+    const int64_t *ids,
+    const int64_t *cids,
+    float *x,
+    float *y,
+    float *z,
+    const attr_t *coeffs, // [N', K, 3]
+    const float *dequant, // [n_chunks, 2, K * 3] optional
+    const uint32_t chunk_size,
+    scalar_t *colors // [N, 3]
+) {
+    constexpr uint32_t B = (DEGREE + 1) * (DEGREE + 1);
+    float inorm[SH_LANES];
+    float sh[B][SH_LANES];
+    float coef[B][3][SH_LANES];
+    float rgb[3][SH_LANES];
+
+    sh_normalize_dirs_lanes<DEGREE>(x, y, z, inorm);
+    sh_load_coeffs_lanes<DEGREE>(K, n, cids, coeffs, dequant, chunk_size, coef);
+    sh_bases_lanes<DEGREE>(x, y, z, sh);
+    for (uint32_t c = 0; c < 3; ++c) {
+#pragma omp simd
+        for (int64_t l = 0; l < SH_LANES; ++l) {
+            rgb[c][l] = 0.f;
+        }
+        for (uint32_t k = 0; k < B; ++k) {
+#pragma omp simd
+            for (int64_t l = 0; l < SH_LANES; ++l) {
+                rgb[c][l] += sh[k][l] * coef[k][c][l];
+            }
+        }
+    }
+    for (int64_t l = 0; l < n; ++l) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            colors[ids[l] * 3 + c] = rgb[c][l];
+        }
+    }
+}
+
+// Call fn(std::integral_constant<uint32_t, DEGREE>()) for the degree in use.
+template <typename Fn>
+GSPLAT_CPU_INLINE void
+sh_dispatch_degree(const uint32_t degrees_to_use, Fn &&fn) {
+    switch (degrees_to_use) {
+    case 0:
+        fn(std::integral_constant<uint32_t, 0>());
+        break;
+    case 1:
+        fn(std::integral_constant<uint32_t, 1>());
+        break;
+    case 2:
+        fn(std::integral_constant<uint32_t, 2>());
+        break;
+    case 3:
+        fn(std::integral_constant<uint32_t, 3>());
+        break;
+    default:
+        fn(std::integral_constant<uint32_t, 4>());
+        break;
+    }
+}
+
+// Gradient w.r.t. the (unnormalized) directions of a batch, DEGREE >= 1.
+template <uint32_t DEGREE, typename scalar_t>
+GSPLAT_CPU_INLINE void sh_bwd_dirs_lanes(
+    const uint32_t K,
+    const int64_t n,
+    const int64_t *ids,
+    const scalar_t *coeffs, // [N, K, 3]
+    const float *x,
+    const float *y,
+    const float *z,
+    const float *inorm,
+    const float (*v_rgb)[SH_LANES],
+    scalar_t *v_dirs // [N, 3]
+) {
+    constexpr uint32_t B = (DEGREE + 1) * (DEGREE + 1);
+    float coef[B][3][SH_LANES];
+    float g[B][SH_LANES];
+    sh_load_coeffs_lanes<DEGREE>(K, n, ids, coeffs, nullptr, 0, coef);
+    for (uint32_t k = 0; k < B; ++k) {
+#pragma omp simd
+        for (int64_t l = 0; l < SH_LANES; ++l) {
+            g[k][l] = v_rgb[0][l] * coef[k][0][l] +
+                      v_rgb[1][l] * coef[k][1][l] +
+                      v_rgb[2][l] * coef[k][2][l];
+        }
+    }
+    float v_x[SH_LANES], v_y[SH_LANES], v_z[SH_LANES];
+    sh_bases_vjp_lanes<DEGREE>(x, y, z, g, v_x, v_y, v_z);
+    // back through the normalization of dir
+#pragma omp simd
+    for (int64_t l = 0; l < SH_LANES; ++l) {
+        const float v_dot_n = v_x[l] * x[l] + v_y[l] * y[l] + v_z[l] * z[l];
+        v_x[l] = (v_x[l] - v_dot_n * x[l]) * inorm[l];
+        v_y[l] = (v_y[l] - v_dot_n * y[l]) * inorm[l];
+        v_z[l] = (v_z[l] - v_dot_n * z[l]) * inorm[l];
+    }
+    for (int64_t l = 0; l < n; ++l) {
+        v_dirs[ids[l] * 3] = v_x[l];
+        v_dirs[ids[l] * 3 + 1] = v_y[l];
+        v_dirs[ids[l] * 3 + 2] = v_z[l];
+    }
+}
+
+template <uint32_t DEGREE, typename scalar_t>
+GSPLAT_CPU_INLINE void sh_bwd_lanes(
+    const uint32_t K,
+    const int64_t n,
+    const int64_t *ids,
+    const scalar_t *dirs,     // [N, 3]
+    const scalar_t *coeffs,   // [N, K, 3]
+    const scalar_t *v_colors, // [N, 3]
+    scalar_t *v_coeffs,       // [N, K, 3]
+    scalar_t *v_dirs          // [N, 3] optional
+) {
+    constexpr uint32_t B = (DEGREE + 1) * (DEGREE + 1);
+    float x[SH_LANES], y[SH_LANES], z[SH_LANES], inorm[SH_LANES];
+    float sh[B][SH_LANES];
+    float v_rgb[3][SH_LANES];
+
+    sh_gather_dirs_lanes(n, ids, dirs, x, y, z);
+    sh_normalize_dirs_lanes<DEGREE>(x, y, z, inorm);
+    for (int64_t l = 0; l < SH_LANES; ++l) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            v_rgb[c][l] =
+                l < n ? static_cast<float>(v_colors[ids[l] * 3 + c]) : 0.f;
+        }
+    }
+    sh_bases_lanes<DEGREE>(x, y, z, sh);
+
+    // the bases beyond DEGREE keep the zeros v_coeffs was allocated with
+    for (int64_t l = 0; l < n; ++l) {
+        scalar_t *v_coeff = v_coeffs + ids[l] * K * 3;
+        for (uint32_t k = 0; k < B; ++k) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                v_coeff[k * 3 + c] = sh[k][l] * v_rgb[c][l];
+            }
+        }
+    }
+
+    // the degree 0 basis is constant: v_dirs keeps its zeros
+    if constexpr (DEGREE >= 1) {
+        if (v_dirs != nullptr) {
+            sh_bwd_dirs_lanes<DEGREE>(
+                K, n, ids, coeffs, x, y, z, inorm, v_rgb, v_dirs
+            );
+        }
+    }
+}
+
+// Evaluate the Gaussians [begin, end) SH_LANES at a time. Masked Gaussians are
+// skipped when forming the batches so they cost no lanes; their colors are
+// zero.
+template <typename scalar_t>
+GSPLAT_CPU_TARGET_CLONES void spherical_harmonics_fwd_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const uint32_t K,
+    const uint32_t degrees_to_use,
+    const scalar_t *__restrict__ dirs,   // [N, 3]
+    const scalar_t *__restrict__ coeffs, // [N, K, 3]
+    const bool *__restrict__ masks,      // [N]
+    scalar_t *__restrict__ colors        // [N, 3]
+) {
+    int64_t ids[SH_LANES];
+    float x[SH_LANES], y[SH_LANES], z[SH_LANES];
+    int64_t n = 0;
+    for (int64_t idx = begin; idx < end; ++idx) {
+        if (masks != nullptr && !masks[idx]) {
+            colors[idx * 3] = colors[idx * 3 + 1] = colors[idx * 3 + 2] = 0;
+        } else {
+            ids[n++] = idx;
+        }
+        if (n == SH_LANES || (idx == end - 1 && n > 0)) {
+            sh_gather_dirs_lanes(n, ids, dirs, x, y, z);
+            sh_dispatch_degree(degrees_to_use, [&](auto degree) {
+                sh_fwd_lanes<decltype(degree)::value>(
+                    K, n, ids, ids, x, y, z, coeffs, nullptr, 0, colors
+                );
+            });
+            n = 0;
+        }
+    }
+}
+
+// Same for the pairs [begin, end) of a stored Gaussian and a camera, with the
+// direction from the camera center to the (dequantized) mean. The pair idx is
+// (camera_ids[idx], gaussian_ids[idx]), or (idx / N, idx % N) without the ids.
+template <typename attr_t>
+GSPLAT_CPU_TARGET_CLONES void spherical_harmonics_storage_fwd_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t N,
+    const uint32_t K,
+    const uint32_t degrees_to_use,
+    const attr_t *__restrict__ means,         // [N, 3]
+    const attr_t *__restrict__ coeffs,        // [N, K, 3]
+    const float *__restrict__ means_dequant,  // [n_chunks, 2, 11] optional
+    const float *__restrict__ coeffs_dequant, // [n_chunks, 2, K * 3] optional
+    const uint32_t chunk_size,
+    const float *__restrict__ campos,         // [C, 3]
+    const int64_t *__restrict__ camera_ids,   // [M] optional
+    const int64_t *__restrict__ gaussian_ids, // [M] optional
+    const bool *__restrict__ masks,           // [M] optional
+    float *__restrict__ colors                // [M, 3]
+) {
+    int64_t ids[SH_LANES], cids[SH_LANES], gids[SH_LANES];
+    float x[SH_LANES], y[SH_LANES], z[SH_LANES];
+    int64_t n = 0;
+    for (int64_t idx = begin; idx < end; ++idx) {
+        if (masks != nullptr && !masks[idx]) {
+            colors[idx * 3] = colors[idx * 3 + 1] = colors[idx * 3 + 2] = 0.f;
+        } else {
+            cids[n] = camera_ids == nullptr ? idx / N : camera_ids[idx];
+            gids[n] = gaussian_ids == nullptr ? idx % N : gaussian_ids[idx];
+            ids[n++] = idx;
+        }
+        if (n == SH_LANES || (idx == end - 1 && n > 0)) {
+            sh_storage_dirs_lanes(
+                n, cids, gids, means, means_dequant, chunk_size, campos, x, y, z
+            );
+            sh_dispatch_degree(degrees_to_use, [&](auto degree) {
+                sh_fwd_lanes<decltype(degree)::value>(
+                    K,
+                    n,
+                    ids,
+                    gids,
+                    x,
+                    y,
+                    z,
+                    coeffs,
+                    coeffs_dequant,
+                    chunk_size,
+                    colors
+                );
+            });
+            n = 0;
+        }
+    }
+}
+
+template <typename scalar_t>
+GSPLAT_CPU_TARGET_CLONES void spherical_harmonics_bwd_cpu(
+    const int64_t begin,
+    const int64_t end,
+    const uint32_t K,
+    const uint32_t degrees_to_use,
+    const scalar_t *__restrict__ dirs,     // [N, 3]
+    const scalar_t *__restrict__ coeffs,   // [N, K, 3]
+    const bool *__restrict__ masks,        // [N]
+    const scalar_t *__restrict__ v_colors, // [N, 3]
+    scalar_t *__restrict__ v_coeffs,       // [N, K, 3]
+    scalar_t *__restrict__ v_dirs          // [N, 3] optional
+) {
+    int64_t ids[SH_LANES];
+    int64_t n = 0;
+    for (int64_t idx = begin; idx < end; ++idx) {
+        if (masks == nullptr || masks[idx]) {
+            ids[n++] = idx;
+        }
+        if (n == SH_LANES || (idx == end - 1 && n > 0)) {
+            switch (degrees_to_use) {
+            case 0:
+                sh_bwd_lanes<0>(
+                    K, n, ids, dirs, coeffs, v_colors, v_coeffs, v_dirs
+                );
+                break;
+            case 1:
+                sh_bwd_lanes<1>(
+                    K, n, ids, dirs, coeffs, v_colors, v_coeffs, v_dirs
+                );
+                break;
+            case 2:
+                sh_bwd_lanes<2>(
+                    K, n, ids, dirs, coeffs, v_colors, v_coeffs, v_dirs
+                );
+                break;
+            case 3:
+                sh_bwd_lanes<3>(
+                    K, n, ids, dirs, coeffs, v_colors, v_coeffs, v_dirs
+                );
+                break;
+            default:
+                sh_bwd_lanes<4>(
+                    K, n, ids, dirs, coeffs, v_colors, v_coeffs, v_dirs
+                );
+                break;
+            }
+            n = 0;
+        }
+    }
+}
+
+} // namespace
+
+void launch_spherical_harmonics_fwd_kernel_cpu(
+    // inputs
+    const uint32_t degrees_to_use,
+    const at::Tensor dirs,                // [..., 3]
+    const at::Tensor coeffs,              // [..., K, 3]
+    const at::optional<at::Tensor> masks, // [...]
+    // outputs
+    at::Tensor colors // [..., 3]
+) {
+    const uint32_t K = coeffs.size(-2);
+    const int64_t N = dirs.numel() / 3;
+    if (N == 0) {
+        return;
+    }
+
+    AT_DISPATCH_FLOATING_TYPES(
+        dirs.scalar_type(),
+        "spherical_harmonics_fwd_cpu",
+        [&]() {
+            const scalar_t *dirs_ptr = dirs.data_ptr<scalar_t>();
+            const scalar_t *coeffs_ptr = coeffs.data_ptr<scalar_t>();
+            const bool *masks_ptr =
+                masks.has_value() ? masks.value().data_ptr<bool>() : nullptr;
+            scalar_t *colors_ptr = colors.data_ptr<scalar_t>();
+            at::parallel_for(0, N, SH_GRAIN, [&](int64_t begin, int64_t end) {
+                spherical_harmonics_fwd_cpu<scalar_t>(
+                    begin,
+                    end,
+                    K,
+                    degrees_to_use,
+                    dirs_ptr,
+                    coeffs_ptr,
+                    masks_ptr,
+                    colors_ptr
+                );
+            });
+        }
+    );
+}
+
+void launch_spherical_harmonics_bwd_kernel_cpu(
+    // inputs
+    const uint32_t degrees_to_use,
+    const at::Tensor dirs,                // [..., 3]
+    const at::Tensor coeffs,              // [..., K, 3]
+    const at::optional<at::Tensor> masks, // [...]
+    const at::Tensor v_colors,            // [..., 3]
+    // outputs
+    at::Tensor v_coeffs,            // [..., K, 3]
+    at::optional<at::Tensor> v_dirs // [..., 3]
+) {
+    const uint32_t K = coeffs.size(-2);
+    const int64_t N = dirs.numel() / 3;
+    if (N == 0) {
+        return;
+    }
+
+    AT_DISPATCH_FLOATING_TYPES(
+        dirs.scalar_type(),
+        "spherical_harmonics_bwd_cpu",
+        [&]() {
+            const scalar_t *dirs_ptr = dirs.data_ptr<scalar_t>();
+            const scalar_t *coeffs_ptr = coeffs.data_ptr<scalar_t>();
+            const bool *masks_ptr =
+                masks.has_value() ? masks.value().data_ptr<bool>() : nullptr;
+            const scalar_t *v_colors_ptr = v_colors.data_ptr<scalar_t>();
+            scalar_t *v_coeffs_ptr = v_coeffs.data_ptr<scalar_t>();
+            scalar_t *v_dirs_ptr = v_dirs.has_value()
+                                       ? v_dirs.value().data_ptr<scalar_t>()
+                                       : nullptr;
+            at::parallel_for(0, N, SH_GRAIN, [&](int64_t begin, int64_t end) {
+                spherical_harmonics_bwd_cpu<scalar_t>(
+                    begin,
+                    end,
+                    K,
+                    degrees_to_use,
+                    dirs_ptr,
+                    coeffs_ptr,
+                    masks_ptr,
+                    v_colors_ptr,
+                    v_coeffs_ptr,
+                    v_dirs_ptr
+                );
+            });
+        }
+    );
+}
+
+void launch_spherical_harmonics_storage_fwd_kernel_cpu(
+    // inputs
+    const uint32_t degrees_to_use,
+    const at::Tensor means,                        // [N, 3]
+    const at::Tensor coeffs,                       // [N, K, 3]
+    const at::optional<at::Tensor> means_dequant,  // [n_chunks, 2, 11]
+    const at::optional<at::Tensor> coeffs_dequant, // [n_chunks, 2, K * 3]
+    const uint32_t chunk_size,
+    const at::Tensor campos,                     // [C, 3]
+    const at::optional<at::Tensor> camera_ids,   // [M] optional
+    const at::optional<at::Tensor> gaussian_ids, // [M] optional
+    const at::optional<at::Tensor> masks,        // [M] optional
+    // outputs
+    at::Tensor colors // [M, 3]
+) {
+    const int64_t N = means.size(0);
+    const uint32_t K = coeffs.size(-2);
+    const int64_t M = colors.size(0);
+    if (M == 0) {
+        return;
+    }
+
+    // The attributes stored in float16 or uint8 are computed in float32.
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::kHalf,
+        at::kByte,
+        coeffs.scalar_type(),
+        "spherical_harmonics_storage_fwd_cpu",
+        [&]() {
+            const scalar_t *means_ptr = means.data_ptr<scalar_t>();
+            const scalar_t *coeffs_ptr = coeffs.data_ptr<scalar_t>();
+            const float *means_dequant_ptr =
+                means_dequant.has_value()
+                    ? means_dequant.value().data_ptr<float>()
+                    : nullptr;
+            const float *coeffs_dequant_ptr =
+                coeffs_dequant.has_value()
+                    ? coeffs_dequant.value().data_ptr<float>()
+                    : nullptr;
+            const float *campos_ptr = campos.data_ptr<float>();
+            const int64_t *camera_ids_ptr =
+                camera_ids.has_value() ? camera_ids.value().data_ptr<int64_t>()
+                                       : nullptr;
+            const int64_t *gaussian_ids_ptr =
+                gaussian_ids.has_value()
+                    ? gaussian_ids.value().data_ptr<int64_t>()
+                    : nullptr;
+            const bool *masks_ptr =
+                masks.has_value() ? masks.value().data_ptr<bool>() : nullptr;
+            float *colors_ptr = colors.data_ptr<float>();
+            at::parallel_for(0, M, SH_GRAIN, [&](int64_t begin, int64_t end) {
+                spherical_harmonics_storage_fwd_cpu<scalar_t>(
+                    begin,
+                    end,
+                    N,
+                    K,
+                    degrees_to_use,
+                    means_ptr,
+                    coeffs_ptr,
+                    means_dequant_ptr,
+                    coeffs_dequant_ptr,
+                    chunk_size,
+                    campos_ptr,
+                    camera_ids_ptr,
+                    gaussian_ids_ptr,
+                    masks_ptr,
+                    colors_ptr
+                );
+            });
+        }
+    );
+}
+
+} // namespace gsplat
@@ -17,12 +17,13 @@ namespace cg = cooperative_groups;
 // Sloan, JCGT 2013 See https://jcgt.org/published/0002/02/06/ for reference
 // implementation
 
-template <typename scalar_t>
+// `coeffs` is either a pointer or an AttrReader of the (stored) coefficients.
+template <typename scalar_t, typename coeffs_t>
 __device__ void sh_coeffs_to_color_fast(
-    const uint32_t degree,  // degree of SH to be evaluated
-    const uint32_t c,       // color channel
-    const vec3 &dir,        // [3]
-    const scalar_t *coeffs, // [K, 3]
+    const uint32_t degree, // degree of SH to be evaluated
+    const uint32_t c,      // color channel
+    const vec3 &dir,       // [3]
+    const coeffs_t coeffs, // [K, 3]
     // output
     scalar_t *colors // [3]
 ) {
@@ -444,6 +445,130 @@ void launch_spherical_harmonics_fwd_kernel(
     );
 }
 
+// The stored Gaussian g is evaluated from the camera c, with g and c read
+// from gaussian_ids and camera_ids, or from the dense [C, N] layout if they
+// are not given. attr_t is the storage type of the means and coefficients.
+template <typename attr_t>
+__global__ void spherical_harmonics_storage_fwd_kernel(
+    const uint32_t M,
+    const uint32_t N,
+    const uint32_t K,
+    const uint32_t degrees_to_use,
+    const attr_t *__restrict__ means,         // [N, 3]
+    const attr_t *__restrict__ coeffs,        // [N, K, 3]
+    const float *__restrict__ means_dequant,  // [n_chunks, 2, 11] optional
+    const float *__restrict__ coeffs_dequant, // [n_chunks, 2, K * 3] optional
+    const uint32_t chunk_size,
+    const vec3 *__restrict__ campos,          // [C, 3]
+    const int64_t *__restrict__ camera_ids,   // [M] optional
+    const int64_t *__restrict__ gaussian_ids, // [M] optional
+    const bool *__restrict__ masks,           // [M] optional
+    float *__restrict__ colors                // [M, 3]
+) {
+    // parallelize over M * 3
+    uint32_t idx = cg::this_grid().thread_rank();
+    if (idx >= M * 3) {
+        return;
+    }
+    uint32_t elem_id = idx / 3;
+    uint32_t c = idx % 3; // color channel
+    if (masks != nullptr && !masks[elem_id]) {
+        return;
+    }
+    const int64_t cid =
+        camera_ids == nullptr ? elem_id / N : camera_ids[elem_id];
+    const int64_t gid =
+        gaussian_ids == nullptr ? elem_id % N : gaussian_ids[elem_id];
+
+    // the direction from the camera to the (dequantized) mean
+    const AttrReader<attr_t> mean = attr_reader(
+        means,
+        gid,
+        3,
+        means_dequant,
+        chunk_size,
+        STORAGE_GEOMETRY_CHANNELS,
+        STORAGE_MEANS_OFFSET
+    );
+    sh_coeffs_to_color_fast(
+        degrees_to_use,
+        c,
+        vec3(mean[0], mean[1], mean[2]) - campos[cid],
+        attr_reader(coeffs, gid, K * 3, coeffs_dequant, chunk_size, K * 3, 0),
+        colors + elem_id * 3
+    );
+}
+
+void launch_spherical_harmonics_storage_fwd_kernel(
+    // inputs
+    const uint32_t degrees_to_use,
+    const at::Tensor means,                        // [N, 3]
+    const at::Tensor coeffs,                       // [N, K, 3]
+    const at::optional<at::Tensor> means_dequant,  // [n_chunks, 2, 11]
+    const at::optional<at::Tensor> coeffs_dequant, // [n_chunks, 2, K * 3]
+    const uint32_t chunk_size,
+    const at::Tensor campos,                     // [C, 3]
+    const at::optional<at::Tensor> camera_ids,   // [M] optional
+    const at::optional<at::Tensor> gaussian_ids, // [M] optional
+    const at::optional<at::Tensor> masks,        // [M] optional
+    // outputs
+    at::Tensor colors // [M, 3]
+) {
+    const uint32_t N = means.size(0);
+    const uint32_t K = coeffs.size(-2);
+    const uint32_t M = colors.size(0);
+
+    // parallelize over M * 3
+    int64_t n_elements = M * 3;
+    dim3 threads(256);
+    dim3 grid((n_elements + threads.x - 1) / threads.x);
+    int64_t shmem_size = 0; // No shared memory used in this kernel
+
+    if (n_elements == 0) {
+        // skip the kernel launch if there are no elements
+        return;
+    }
+
+    // The attributes stored in float16 or uint8 are computed in float32.
+    AT_DISPATCH_FLOATING_TYPES_AND2(
+        at::kHalf,
+        at::kByte,
+        coeffs.scalar_type(),
+        "spherical_harmonics_storage_fwd_kernel",
+        [&]() {
+            spherical_harmonics_storage_fwd_kernel<scalar_t>
+                <<<grid,
+                   threads,
+                   shmem_size,
+                   at::cuda::getCurrentCUDAStream()>>>(
+                    M,
+                    N,
+                    K,
+                    degrees_to_use,
+                    means.data_ptr<scalar_t>(),
+                    coeffs.data_ptr<scalar_t>(),
+                    means_dequant.has_value()
+                        ? means_dequant.value().data_ptr<float>()
+                        : nullptr,
+                    coeffs_dequant.has_value()
+                        ? coeffs_dequant.value().data_ptr<float>()
+                        : nullptr,
+                    chunk_size,
+                    reinterpret_cast<vec3 *>(campos.data_ptr<float>()),
+                    camera_ids.has_value()
+                        ? camera_ids.value().data_ptr<int64_t>()
+                        : nullptr,
+                    gaussian_ids.has_value()
+                        ? gaussian_ids.value().data_ptr<int64_t>()
+                        : nullptr,
+                    masks.has_value() ? masks.value().data_ptr<bool>()
+                                      : nullptr,
+                    colors.data_ptr<float>()
+                );
+        }
+    );
+}
+
 template <typename scalar_t>
 __global__ void spherical_harmonics_bwd_kernel(
     const uint32_t N,
@@ -23,9 +23,38 @@ PYBIND11_MODULE(TORCH_EXTENSION_NAME, m) {
 
     m.def("spherical_harmonics_fwd", &gsplat::spherical_harmonics_fwd);
     m.def("spherical_harmonics_bwd", &gsplat::spherical_harmonics_bwd);
+    m.def(
+        "spherical_harmonics_storage_fwd",
+        &gsplat::spherical_harmonics_storage_fwd
+    );
 
     m.def("adam", &gsplat::adam);
     m.def("relocation", &gsplat::relocation);
+    m.def("densification_stats", &gsplat::densification_stats);
+    m.def("compact_rows", &gsplat::compact_rows);
+    m.def("lod_tree_build", &gsplat::lod_tree_build);
+    m.def("lod_tree_cut", &gsplat::lod_tree_cut);
+    m.def("frustum_index_build", &gsplat::frustum_index_build);
+    m.def("frustum_index_refit", &gsplat::frustum_index_refit);
+    m.def("frustum_index_query", &gsplat::frustum_index_query);
+    m.def("kdtree_build", &gsplat::kdtree_build);
+    m.def("kdtree_query", &gsplat::kdtree_query);
+    // run without the GIL, so that several exports can use Python threads
+    m.def(
+        "export_ply",
+        &gsplat::export_ply,
+        py::call_guard<py::gil_scoped_release>()
+    );
+    m.def(
+        "encode_ply_compressed",
+        &gsplat::encode_ply_compressed,
+        py::call_guard<py::gil_scoped_release>()
+    );
+    m.def("decode_ply_compressed", &gsplat::decode_ply_compressed);
+    m.def("kmeans_l1", &gsplat::kmeans_l1);
+    m.def("plas_sort", &gsplat::plas_sort);
+    m.def("rans_encode", &gsplat::rans_encode);
+    m.def("rans_decode", &gsplat::rans_decode);
 
     m.def("intersect_tile", &gsplat::intersect_tile);
     m.def("intersect_offset", &gsplat::intersect_offset);
@@ -38,10 +67,18 @@ PYBIND11_MODULE(TORCH_EXTENSION_NAME, m) {
     m.def(
         "projection_ewa_3dgs_fused_bwd", &gsplat::projection_ewa_3dgs_fused_bwd
     );
+    m.def(
+        "projection_ewa_3dgs_storage_fwd",
+        &gsplat::projection_ewa_3dgs_storage_fwd
+    );
     m.def(
         "projection_ewa_3dgs_packed_fwd",
         &gsplat::projection_ewa_3dgs_packed_fwd
     );
+    m.def(
+        "projection_ewa_3dgs_storage_packed_fwd",
+        &gsplat::projection_ewa_3dgs_storage_packed_fwd
+    );
     m.def(
         "projection_ewa_3dgs_packed_bwd",
         &gsplat::projection_ewa_3dgs_packed_bwd
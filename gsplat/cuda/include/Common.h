@@ -15,8 +15,20 @@ namespace gsplat {
 #define CHECK_INPUT(x)                                                         \
     CHECK_CUDA(x);                                                             \
     CHECK_CONTIGUOUS(x)
+// Operators that also have a CPU implementation accept inputs on either
+// device. The first input selects the implementation and all the others must
+// live on the same device.
+#define CHECK_CUDA_OR_CPU(x)                                                   \
+    TORCH_CHECK(x.is_cuda() || x.is_cpu(), #x " must be a CUDA or CPU tensor")
+#define CHECK_INPUT_LIKE(x, ref)                                               \
+    TORCH_CHECK(                                                               \
+        x.device() == ref.device(), #x " must be on the same device as " #ref  \
+    );                                                                         \
+    CHECK_CONTIGUOUS(x)
 #define DEVICE_GUARD(_ten)                                                     \
-    const at::cuda::OptionalCUDAGuard device_guard(device_of(_ten));
+    const at::cuda::OptionalCUDAGuard device_guard(                            \
+        _ten.is_cuda() ? device_of(_ten) : c10::nullopt                        \
+    );
 
 // https://github.com/pytorch/pytorch/blob/233305a852e1cd7f319b15b5137074c9eac455f6/aten/src/ATen/cuda/cub.cuh#L38-L46
 // handle the temporary storage and 'twice' calls for cub API
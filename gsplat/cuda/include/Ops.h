@@ -2,6 +2,8 @@
 #pragma once
 
 #include <ATen/core/Tensor.h>
+#include <string>
+#include <vector>
 
 #include "Cameras.h"
 #include "Common.h"
@@ -87,6 +89,39 @@ projection_ewa_3dgs_fused_bwd(
     const bool viewmats_requires_grad
 );
 
+// Forward-only `projection_ewa_3dgs_fused_fwd` for inference, with the means,
+// quats, scales and opacities stored in float32, float16 or uint8. The uint8
+// Gaussians are dequantized in the kernel with the per-chunk scales and
+// offsets of `dequant`, in which the scales are in log space. On top of the
+// outputs of `projection_ewa_3dgs_fused_fwd`, returns the opacities read by
+// the kernel as float32 [..., C, N], so that they need not be dequantized
+// again for the rasterization.
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+projection_ewa_3dgs_storage_fwd(
+    const at::Tensor means,                 // [..., N, 3]
+    const at::Tensor quats,                 // [..., N, 4]
+    const at::Tensor scales,                // [..., N, 3]
+    const at::Tensor opacities,             // [..., N]
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const int64_t chunk_size,
+    const at::Tensor viewmats, // [..., C, 4, 4]
+    const at::Tensor Ks,       // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const CameraModelType camera_model
+);
+
 // On top of fusing the operations like `projection_ewa_3dgs_fused_{fwd, bwd}`,
 // The packed version compresses the [C, N, D] tensors (both intermidiate and
 // output) into a jagged format [nnz, D], leveraging the sparsity of these
@@ -122,6 +157,38 @@ projection_ewa_3dgs_packed_fwd(
     const bool calc_compensations,
     const CameraModelType camera_model
 );
+// Packed counterpart of `projection_ewa_3dgs_storage_fwd`: the outputs of
+// `projection_ewa_3dgs_packed_fwd`, followed by the opacities read by the
+// kernel as float32 [nnz].
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+projection_ewa_3dgs_storage_packed_fwd(
+    const at::Tensor means,                 // [..., N, 3]
+    const at::Tensor quats,                 // [..., N, 4]
+    const at::Tensor scales,                // [..., N, 3]
+    const at::Tensor opacities,             // [..., N]
+    const at::optional<at::Tensor> dequant, // [n_chunks, 2, 11] optional
+    const int64_t chunk_size,
+    const at::Tensor viewmats, // [..., C, 4, 4]
+    const at::Tensor Ks,       // [..., C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float eps2d,
+    const float near_plane,
+    const float far_plane,
+    const float radius_clip,
+    const bool calc_compensations,
+    const CameraModelType camera_model
+);
 std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
 projection_ewa_3dgs_packed_bwd(
     // fwd inputs
@@ -167,6 +234,27 @@ std::tuple<at::Tensor, at::Tensor> spherical_harmonics_bwd(
     bool compute_v_dirs
 );
 
+// Forward-only `spherical_harmonics_fwd` for inference, evaluated directly
+// from the stored Gaussians: the pair m is the Gaussian gaussian_ids[m] seen
+// from the camera center campos[camera_ids[m]], or every (camera, Gaussian)
+// pair of [C, N] if the ids are not given. The view directions are computed
+// in the kernel from the means, and the means and coefficients, stored in
+// float32, float16 or uint8, are dequantized there with the per-chunk scales
+// and offsets of `means_dequant` and `coeffs_dequant`. Returns float32 colors
+// of shape [nnz, 3] or [C, N, 3]; the masked pairs are zero.
+at::Tensor spherical_harmonics_storage_fwd(
+    const uint32_t degrees_to_use,
+    const at::Tensor means,                        // [N, 3]
+    const at::Tensor coeffs,                       // [N, K, 3]
+    const at::optional<at::Tensor> means_dequant,  // [n_chunks, 2, 11]
+    const at::optional<at::Tensor> coeffs_dequant, // [n_chunks, 2, K * 3]
+    const int64_t chunk_size,
+    const at::Tensor campos,                     // [C, 3]
+    const at::optional<at::Tensor> camera_ids,   // [nnz] optional
+    const at::optional<at::Tensor> gaussian_ids, // [nnz] optional
+    const at::optional<at::Tensor> masks         // [C, N] or [nnz] optional
+);
+
 // Fused Adam that supports a valid mask to skip updating certain parameters.
 // Note skipping is not equivalent with zeroing out the gradients, which will
 // still update parameters with momentum.
@@ -182,6 +270,34 @@ void adam(
     const float eps
 );
 
+// Accumulate the densification statistics of the projected Gaussians in place,
+// in a single pass over the unpacked ([C, N, 2], with a projection counted if
+// both radii are positive) or packed ([nnz, 2], with `gaussian_ids`) data:
+// grad2d += |grads * (scale_x, scale_y)|, count += 1 and, if given,
+// max_radii = max(max_radii, max(radii) * radius_scale).
+void densification_stats(
+    const at::Tensor &grads,                     // [C, N, 2] or [nnz, 2]
+    const at::Tensor &radii,                     // [C, N, 2] or [nnz, 2]
+    const at::optional<at::Tensor> gaussian_ids, // [nnz] optional
+    const float scale_x,
+    const float scale_y,
+    const float radius_scale,
+    at::Tensor &grad2d,                      // [N]
+    at::Tensor &count,                       // [N]
+    const at::optional<at::Tensor> max_radii // [N] optional
+);
+
+// Compact the rows of several tensors with the same number of rows in a single
+// pass: every output holds the rows of its input where `keep` is set, in order,
+// followed by the rows `append` of the input, or zeros where `zero_append` is
+// set (e.g. for the optimizer states of split Gaussians).
+std::vector<at::Tensor> compact_rows(
+    const std::vector<at::Tensor> &inputs, // each [N, ...]
+    const at::Tensor &keep,                // [N] bool
+    const at::optional<at::Tensor> append, // [M] int64 optional
+    const std::vector<bool> &zero_append   // one flag per input
+);
+
 // GS Tile Intersection
 std::tuple<at::Tensor, at::Tensor, at::Tensor> intersect_tile(
     const at::Tensor means2d,                    // [..., C, N, 2] or [nnz, 2]
@@ -290,6 +406,163 @@ std::tuple<at::Tensor, at::Tensor> relocation(
     const int n_max
 );
 
+// Level-of-detail tree over the Gaussians (CPU only). The inner nodes merge
+// their children by moment matching; the cut selects, for a set of cameras,
+// the coarsest nodes whose projection is at most `pixel_size` pixels.
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+lod_tree_build(
+    const at::Tensor means,     // [N, 3]
+    const at::Tensor quats,     // [N, 4]
+    const at::Tensor scales,    // [N, 3]
+    const at::Tensor opacities, // [N]
+    const at::Tensor colors     // [N, D]
+);
+at::Tensor lod_tree_cut(
+    const at::Tensor bounds,        // [N + M, 4]
+    const at::Tensor child_offsets, // [M + 1]
+    const at::Tensor children,      // [N + M - 1]
+    const at::Tensor viewmats,      // [C, 4, 4]
+    const at::Tensor Ks,            // [C, 3, 3]
+    const float pixel_size,
+    const float near_plane
+);
+
+// Frustum culling index over the Gaussian bounding spheres (CPU only). The
+// query returns the (camera, Gaussian) pairs whose sphere intersects the
+// frustum of the camera, widened by `padding` pixels.
+std::tuple<at::Tensor, at::Tensor, at::Tensor> frustum_index_build(
+    const at::Tensor means, // [N, 3]
+    const at::Tensor radii, // [N]
+    const int64_t leaf_size
+);
+void frustum_index_refit(
+    const at::Tensor order, // [N]
+    const at::Tensor means, // [N, 3]
+    const at::Tensor radii, // [N]
+    const int64_t leaf_size,
+    at::Tensor spheres,    // [N, 4]
+    at::Tensor node_bounds // [2P, 6]
+);
+std::tuple<at::Tensor, at::Tensor> frustum_index_query(
+    const at::Tensor order,       // [N]
+    const at::Tensor spheres,     // [N, 4]
+    const at::Tensor node_bounds, // [2P, 6]
+    const int64_t leaf_size,
+    const at::Tensor viewmats, // [C, 4, 4]
+    const at::Tensor Ks,       // [C, 3, 3]
+    const uint32_t image_width,
+    const uint32_t image_height,
+    const float near_plane,
+    const float far_plane,
+    const float padding,
+    const CameraModelType camera_model
+);
+
+// k-d tree over 3D points (CPU only). The query returns the distances to the
+// exact k nearest points of every query and their indices, sorted by distance,
+// padded with inf and -1 when the tree has fewer than k points.
+std::tuple<at::Tensor, at::Tensor, at::Tensor> kdtree_build(
+    const at::Tensor points, // [N, 3]
+    const int64_t leaf_size
+);
+std::tuple<at::Tensor, at::Tensor> kdtree_query(
+    const at::Tensor order,       // [N]
+    const at::Tensor points,      // [N, 3]
+    const at::Tensor node_bounds, // [2P, 6]
+    const int64_t leaf_size,
+    const at::Tensor queries, // [M, 3]
+    const int64_t k
+);
+
+// Write the splats to a PLY file, streamed in chunks of `chunk_size` rows so
+// that the memory stays bounded whatever the number of splats. The splats with
+// a NaN or Inf attribute are skipped. Returns the number of written splats.
+int64_t export_ply(
+    const std::string &path,
+    const at::Tensor means,     // [N, 3]
+    const at::Tensor scales,    // [N, 3]
+    const at::Tensor quats,     // [N, 4]
+    const at::Tensor opacities, // [N]
+    const at::Tensor sh0,       // [N, 1, 3]
+    const at::Tensor shN,       // [N, K, 3]
+    const int64_t chunk_size
+);
+
+// Sort and encode the splats in the `ply_compressed` layout. Returns the
+// data of the chunk, vertex and sh elements.
+std::tuple<at::Tensor, at::Tensor, at::Tensor> encode_ply_compressed(
+    const at::Tensor means,  // [N, 3]
+    const at::Tensor scales, // [N, 3]
+    const at::Tensor quats,  // [N, 4]
+    const at::Tensor colors, // [N, 3]
+    const at::Tensor alphas, // [N]
+    const at::Tensor shN,    // [N, S]
+    const int64_t chunk_size
+);
+
+// Decode the splats of a `ply_compressed` file, given the data of its chunk,
+// vertex and sh elements.
+std::tuple<
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor,
+    at::Tensor>
+decode_ply_compressed(
+    const at::Tensor chunks,   // [n_chunks, 18] float32
+    const at::Tensor vertices, // [N, 4] int32 (bits of uint32)
+    const at::Tensor sh        // [N, 3K] uint8
+);
+
+// K-means clustering of the rows of x with the Manhattan distance. Returns the
+// centroids and the label of every row.
+std::tuple<at::Tensor, at::Tensor> kmeans_l1(
+    const at::Tensor x, // [N, D]
+    const int64_t n_clusters,
+    const int64_t n_iters,
+    const int64_t batch_size,
+    const int64_t n_probe,
+    const int64_t seed
+);
+
+// Sort the rows of params on a grid of `width` columns so that neighbors are
+// similar. Returns the permutation of the rows in row-major grid order.
+at::Tensor plas_sort(
+    const at::Tensor params, // [N, C]
+    const int64_t width,
+    const double shrink_factor,
+    const double improvement_break,
+    const int64_t seed
+);
+
+// Entropy code the quantized rows of q laid out on a grid of `width` columns.
+// Returns the frequency tables, the byte size of every tile and the streams.
+std::tuple<at::Tensor, at::Tensor, at::Tensor> rans_encode(
+    const at::Tensor q,    // [N, C]
+    const at::Tensor bits, // [C]
+    const int64_t width,
+    const int64_t tile_rows
+);
+// Decode the n rows encoded by rans_encode.
+at::Tensor rans_decode(
+    const at::Tensor freqs,      // [S, 256]
+    const at::Tensor tile_sizes, // [n_tiles]
+    const at::Tensor data,       // [size]
+    const at::Tensor bits,       // [C]
+    const int64_t n,
+    const int64_t width,
+    const int64_t tile_rows
+);
+
 // Projection for 2DGS
 std::tuple<
     at::Tensor,
@@ -2,12 +2,136 @@
 
 #include "Common.h"
 
+#include <cmath>
+
+#ifdef __CUDACC__
 #include <cooperative_groups.h>
 #include <cooperative_groups/reduce.h>
+#endif
+
+// The math helpers below (everything but the warp reductions) are shared with
+// the CPU implementations of the operators, so they are compiled for both the
+// host and the device.
+#ifdef __CUDACC__
+#define GSPLAT_HOST_DEVICE __host__ __device__
+#else
+#define GSPLAT_HOST_DEVICE
+#endif
 
 namespace gsplat {
 
-namespace cg = cooperative_groups;
+// `rsqrtf` is a device-only intrinsic.
+inline GSPLAT_HOST_DEVICE float rsqrt_hd(const float x) {
+#ifdef __CUDA_ARCH__
+    return rsqrtf(x);
+#else
+    return 1.f / std::sqrt(x);
+#endif
+}
+
+///////////////////////////////
+// Attribute Storage
+///////////////////////////////
+
+// For inference, the attributes of the Gaussians can be stored in float16 or
+// in uint8 instead of float32, and are dequantized where the kernels read
+// them. A uint8 attribute of D channels comes with a `dequant` tensor of shape
+// [n_chunks, 2, D] holding the scale and the offset of every channel for each
+// chunk of `chunk_size` consecutive Gaussians.
+//
+// The geometry (means, quats, scales, opacities) shares one dequant tensor of
+// STORAGE_GEOMETRY_CHANNELS channels, in which the scales are stored in log
+// space.
+constexpr uint32_t STORAGE_GEOMETRY_CHANNELS = 11;
+constexpr uint32_t STORAGE_MEANS_OFFSET = 0;
+constexpr uint32_t STORAGE_QUATS_OFFSET = 3;
+constexpr uint32_t STORAGE_SCALES_OFFSET = 7;
+constexpr uint32_t STORAGE_OPACITIES_OFFSET = 10;
+
+// The channels of one attribute of one Gaussian, read as float.
+template <typename attr_t> struct AttrReader {
+    const attr_t *attrs;
+    const float *scales;  // optional
+    const float *offsets; // optional
+
+    inline GSPLAT_HOST_DEVICE float operator[](const int64_t c) const {
+        const float v = static_cast<float>(attrs[c]);
+        return scales == nullptr ? v : v * scales[c] + offsets[c];
+    }
+};
+
+// Reader of the D_attr channels of the Gaussian g, whose dequantization
+// parameters start at the channel c0 of the D channels of `dequant`.
+template <typename attr_t>
+inline GSPLAT_HOST_DEVICE AttrReader<attr_t> attr_reader(
+    const attr_t *attrs, // [N, D_attr]
+    const int64_t g,
+    const uint32_t D_attr,
+    const float *dequant, // [n_chunks, 2, D] optional
+    const uint32_t chunk_size,
+    const uint32_t D,
+    const uint32_t c0
+) {
+    AttrReader<attr_t> reader{attrs + g * D_attr, nullptr, nullptr};
+    if (dequant != nullptr) {
+        const float *d = dequant + (g / chunk_size) * 2 * D;
+        reader.scales = d + c0;
+        reader.offsets = d + D + c0;
+    }
+    return reader;
+}
+
+// Read the mean of the Gaussian g, and its quat and scale unless they are
+// not given (when the covariances are).
+template <typename attr_t>
+inline GSPLAT_HOST_DEVICE void load_storage_geometry(
+    const int64_t g,
+    const attr_t *means,  // [N, 3]
+    const attr_t *quats,  // [N, 4] optional
+    const attr_t *scales, // [N, 3] optional
+    const float *dequant, // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size,
+    vec3 &mean,
+    vec4 &quat,
+    vec3 &scale
+) {
+    constexpr uint32_t D = STORAGE_GEOMETRY_CHANNELS;
+    const AttrReader<attr_t> m =
+        attr_reader(means, g, 3, dequant, chunk_size, D, STORAGE_MEANS_OFFSET);
+    mean = vec3(m[0], m[1], m[2]);
+    if (quats == nullptr || scales == nullptr) {
+        return;
+    }
+    const AttrReader<attr_t> q =
+        attr_reader(quats, g, 4, dequant, chunk_size, D, STORAGE_QUATS_OFFSET);
+    const AttrReader<attr_t> s = attr_reader(
+        scales, g, 3, dequant, chunk_size, D, STORAGE_SCALES_OFFSET
+    );
+    quat = vec4(q[0], q[1], q[2], q[3]);
+    scale = vec3(s[0], s[1], s[2]);
+    if (dequant != nullptr) {
+        scale = vec3(expf(scale[0]), expf(scale[1]), expf(scale[2]));
+    }
+}
+
+// Read the opacity of the Gaussian g.
+template <typename attr_t>
+inline GSPLAT_HOST_DEVICE float load_storage_opacity(
+    const int64_t g,
+    const attr_t *opacities, // [N]
+    const float *dequant,    // [n_chunks, 2, 11] optional
+    const uint32_t chunk_size
+) {
+    return attr_reader(
+        opacities,
+        g,
+        1,
+        dequant,
+        chunk_size,
+        STORAGE_GEOMETRY_CHANNELS,
+        STORAGE_OPACITIES_OFFSET
+    )[0];
+}
 
 ///////////////////////////////
 // Coordinate Transformations
@@ -15,7 +139,7 @@ namespace cg = cooperative_groups;
 
 // Transforms a 3D position from world coordinates to camera coordinates.
 // [R | t] is the world-to-camera transformation.
-inline __device__ void posW2C(
+inline GSPLAT_HOST_DEVICE void posW2C(
     const mat3 R,
     const vec3 t,
     const vec3 pW, // Input position in world coordinates
@@ -27,7 +151,7 @@ inline __device__ void posW2C(
 // Computes the vector-Jacobian product (VJP) for posW2C.
 // This function computes gradients of the transformation with respect to
 // inputs.
-inline __device__ void posW2C_VJP(
+inline GSPLAT_HOST_DEVICE void posW2C_VJP(
     // Forward inputs
     const mat3 R,
     const vec3 t,
@@ -48,7 +172,7 @@ inline __device__ void posW2C_VJP(
 }
 
 // Transforms a covariance matrix from world coordinates to camera coordinates.
-inline __device__ void covarW2C(
+inline GSPLAT_HOST_DEVICE void covarW2C(
     const mat3 R,
     const mat3 covarW, // Input covariance matrix in world coordinates
     mat3 &covarC       // Output covariance matrix in camera coordinates
@@ -59,7 +183,7 @@ inline __device__ void covarW2C(
 // Computes the vector-Jacobian product (VJP) for covarW2C.
 // This function computes gradients of the transformation with respect to
 // inputs.
-inline __device__ void covarW2C_VJP(
+inline GSPLAT_HOST_DEVICE void covarW2C_VJP(
     // Forward inputs
     const mat3 R,
     const mat3 covarW, // Input covariance matrix in world coordinates
@@ -79,6 +203,10 @@ inline __device__ void covarW2C_VJP(
     v_covarW += glm::transpose(R) * v_covarC * R;
 }
 
+#ifdef __CUDACC__
+
+namespace cg = cooperative_groups;
+
 ///////////////////////////////
 // Reduce
 ///////////////////////////////
@@ -135,14 +263,16 @@ template <class WarpT> inline __device__ void warpMax(float &val, WarpT &warp) {
     val = cg::reduce(warp, val, cg::greater<float>());
 }
 
+#endif // __CUDACC__
+
 ///////////////////////////////
 // Quaternion
 ///////////////////////////////
 
-inline __device__ mat3 quat_to_rotmat(const vec4 quat) {
+inline GSPLAT_HOST_DEVICE mat3 quat_to_rotmat(const vec4 quat) {
     float w = quat[0], x = quat[1], y = quat[2], z = quat[3];
     // normalize
-    float inv_norm = rsqrt(x * x + y * y + z * z + w * w);
+    float inv_norm = rsqrt_hd(x * x + y * y + z * z + w * w);
     x *= inv_norm;
     y *= inv_norm;
     z *= inv_norm;
@@ -163,11 +293,11 @@ inline __device__ mat3 quat_to_rotmat(const vec4 quat) {
     );
 }
 
-inline __device__ void
+inline GSPLAT_HOST_DEVICE void
 quat_to_rotmat_vjp(const vec4 quat, const mat3 v_R, vec4 &v_quat) {
     float w = quat[0], x = quat[1], y = quat[2], z = quat[3];
     // normalize
-    float inv_norm = rsqrt(x * x + y * y + z * z + w * w);
+    float inv_norm = rsqrt_hd(x * x + y * y + z * z + w * w);
     x *= inv_norm;
     y *= inv_norm;
     z *= inv_norm;
@@ -188,7 +318,7 @@ quat_to_rotmat_vjp(const vec4 quat, const mat3 v_R, vec4 &v_quat) {
     v_quat += (v_quat_n - glm::dot(v_quat_n, quat_n) * quat_n) * inv_norm;
 }
 
-inline __device__ void quat_scale_to_covar_preci(
+inline GSPLAT_HOST_DEVICE void quat_scale_to_covar_preci(
     const vec4 quat,
     const vec3 scale,
     // optional outputs
@@ -221,7 +351,7 @@ inline __device__ void quat_scale_to_covar_preci(
     }
 }
 
-inline __device__ void quat_scale_to_covar_vjp(
+inline GSPLAT_HOST_DEVICE void quat_scale_to_covar_vjp(
     // fwd inputs
     const vec4 quat,
     const vec3 scale,
@@ -260,7 +390,7 @@ inline __device__ void quat_scale_to_covar_vjp(
         R[2][0] * v_M[2][0] + R[2][1] * v_M[2][1] + R[2][2] * v_M[2][2];
 }
 
-inline __device__ void quat_scale_to_preci_vjp(
+inline GSPLAT_HOST_DEVICE void quat_scale_to_preci_vjp(
     // fwd inputs
     const vec4 quat,
     const vec3 scale,
@@ -302,7 +432,7 @@ inline __device__ void quat_scale_to_preci_vjp(
         (R[2][0] * v_M[2][0] + R[2][1] * v_M[2][1] + R[2][2] * v_M[2][2]);
 }
 
-inline __device__ void quat_scale_to_covar_preci_half(
+inline GSPLAT_HOST_DEVICE void quat_scale_to_covar_preci_half(
     const vec4 quat,
     const vec3 scale,
     // optional outputs
@@ -333,7 +463,7 @@ inline __device__ void quat_scale_to_covar_preci_half(
     }
 }
 
-inline __device__ void quat_scale_to_preci_half_vjp(
+inline GSPLAT_HOST_DEVICE void quat_scale_to_preci_half_vjp(
     // fwd inputs
     const vec4 quat,
     const vec3 scale,
@@ -370,24 +500,24 @@ inline __device__ void quat_scale_to_preci_half_vjp(
 // Misc
 ///////////////////////////////
 
-inline __device__ void
+inline GSPLAT_HOST_DEVICE void
 inverse_vjp(const mat2 Minv, const mat2 v_Minv, mat2 &v_M) {
     // P = M^-1
     // df/dM = -P * df/dP * P
     v_M += -Minv * v_Minv * Minv;
 }
 
-inline __device__ float
+inline GSPLAT_HOST_DEVICE float
 add_blur(const float eps2d, mat2 &covar, float &compensation) {
     float det_orig = covar[0][0] * covar[1][1] - covar[0][1] * covar[1][0];
     covar[0][0] += eps2d;
     covar[1][1] += eps2d;
     float det_blur = covar[0][0] * covar[1][1] - covar[0][1] * covar[1][0];
-    compensation = sqrt(max(0.f, det_orig / det_blur));
+    compensation = sqrtf(fmaxf(0.f, det_orig / det_blur));
     return det_blur;
 }
 
-inline __device__ void add_blur_vjp(
+inline GSPLAT_HOST_DEVICE void add_blur_vjp(
     const float eps2d,
     const mat2 conic_blur,
     const float compensation,
@@ -426,7 +556,7 @@ inline __device__ void add_blur_vjp(
 // Projection Related
 ///////////////////////////////
 
-inline __device__ void ortho_proj(
+inline GSPLAT_HOST_DEVICE void ortho_proj(
     // inputs
     const vec3 mean3d,
     const mat3 cov3d,
@@ -455,7 +585,7 @@ inline __device__ void ortho_proj(
     mean2d = vec2({fx * x + cx, fy * y + cy});
 }
 
-inline __device__ void ortho_proj_vjp(
+inline GSPLAT_HOST_DEVICE void ortho_proj_vjp(
     // fwd inputs
     const vec3 mean3d,
     const mat3 cov3d,
@@ -495,7 +625,7 @@ inline __device__ void ortho_proj_vjp(
     v_mean3d += vec3(fx * v_mean2d[0], fy * v_mean2d[1], 0.f);
 }
 
-inline __device__ void persp_proj(
+inline GSPLAT_HOST_DEVICE void persp_proj(
     // inputs
     const vec3 mean3d,
     const mat3 cov3d,
@@ -520,8 +650,8 @@ inline __device__ void persp_proj(
 
     float rz = 1.f / z;
     float rz2 = rz * rz;
-    float tx = z * min(lim_x_pos, max(-lim_x_neg, x * rz));
-    float ty = z * min(lim_y_pos, max(-lim_y_neg, y * rz));
+    float tx = z * fminf(lim_x_pos, fmaxf(-lim_x_neg, x * rz));
+    float ty = z * fminf(lim_y_pos, fmaxf(-lim_y_neg, y * rz));
 
     // mat3x2 is 3 columns x 2 rows.
     mat3x2 J = mat3x2(
@@ -536,7 +666,7 @@ inline __device__ void persp_proj(
     mean2d = vec2({fx * x * rz + cx, fy * y * rz + cy});
 }
 
-inline __device__ void persp_proj_vjp(
+inline GSPLAT_HOST_DEVICE void persp_proj_vjp(
     // fwd inputs
     const vec3 mean3d,
     const mat3 cov3d,
@@ -564,8 +694,8 @@ inline __device__ void persp_proj_vjp(
 
     float rz = 1.f / z;
     float rz2 = rz * rz;
-    float tx = z * min(lim_x_pos, max(-lim_x_neg, x * rz));
-    float ty = z * min(lim_y_pos, max(-lim_y_neg, y * rz));
+    float tx = z * fminf(lim_x_pos, fmaxf(-lim_x_neg, x * rz));
+    float ty = z * fminf(lim_y_pos, fmaxf(-lim_y_neg, y * rz));
 
     // mat3x2 is 3 columns x 2 rows.
     mat3x2 J = mat3x2(
@@ -615,7 +745,7 @@ inline __device__ void persp_proj_vjp(
                   2.f * fy * ty * rz3 * v_J[2][1];
 }
 
-inline __device__ void fisheye_proj(
+inline GSPLAT_HOST_DEVICE void fisheye_proj(
     // inputs
     const vec3 mean3d,
     const mat3 cov3d,
@@ -655,7 +785,7 @@ inline __device__ void fisheye_proj(
     cov2d = J * cov3d * glm::transpose(J);
 }
 
-inline __device__ void fisheye_proj_vjp(
+inline GSPLAT_HOST_DEVICE void fisheye_proj_vjp(
     // fwd inputs
     const vec3 mean3d,
     const mat3 cov3d,
@@ -756,15 +886,16 @@ inline __device__ void fisheye_proj_vjp(
     v_mean3d.z += dL_dtz_raw;
 }
 
-inline __device__ vec3 safe_normalize(vec3 v) {
+inline GSPLAT_HOST_DEVICE vec3 safe_normalize(vec3 v) {
     const float l = v.x * v.x + v.y * v.y + v.z * v.z;
-    return l > 0.0f ? (v * rsqrtf(l)) : v;
+    return l > 0.0f ? (v * rsqrt_hd(l)) : v;
 }
 
-inline __device__ vec3 safe_normalize_bw(const vec3 &v, const vec3 &d_out) {
+inline GSPLAT_HOST_DEVICE vec3
+safe_normalize_bw(const vec3 &v, const vec3 &d_out) {
     const float l = v.x * v.x + v.y * v.y + v.z * v.z;
     if (l > 0.0f) {
-        const float il = rsqrtf(l);
+        const float il = rsqrt_hd(l);
         const float il3 = (il * il * il);
         return il * d_out - il3 * glm::dot(d_out, v) * v;
     }
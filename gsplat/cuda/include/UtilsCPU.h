@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Host-side helpers shared by the CPU implementations of the operators
+// (the `*CPU.cpp` files). Everything here is plain C++ so that it can be
+// compiled by the host compiler without nvcc.
+//
+// The per-element helpers are written so that loops calling them can be
+// vectorized by the compiler under `#pragma omp simd`.
+
+namespace gsplat {
+
+// Number of Gaussians a CPU worker stages and processes at a time, playing the
+// role of the thread block of the CUDA kernels.
+constexpr int64_t CPU_CHUNK_SIZE = 256;
+
+// Runtime ISA dispatch for the CPU kernels. A function marked with
+// GSPLAT_CPU_TARGET_CLONES is compiled once per x86-64 level (AVX-512, AVX2,
+// baseline) and the loader binds the best clone for the running CPU, so a
+// single build uses the wide vector units where they exist. Only the marked
+// function is cloned: the helpers it calls should be GSPLAT_CPU_INLINE, and
+// since lambdas (e.g. `at::parallel_for` bodies) are compiled for the
+// baseline, the marked function should be called from inside them rather
+// than the other way round.
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones) && (defined(__clang__) || __GNUC__ >= 11)
+#define GSPLAT_CPU_TARGET_CLONES                                               \
+    __attribute__((target_clones(                                              \
+        "arch=x86-64-v4", "arch=x86-64-v3", "default"                          \
+    )))
+#endif
+#endif
+#ifndef GSPLAT_CPU_TARGET_CLONES
+#define GSPLAT_CPU_TARGET_CLONES
+#endif
+
+#if defined(_MSC_VER)
+#define GSPLAT_CPU_INLINE __forceinline
+#else
+#define GSPLAT_CPU_INLINE inline __attribute__((always_inline))
+#endif
+
+// Branch-free `c ? x : y` for floats. GCC refuses to if-convert a float
+// ternary whose result feeds more float arithmetic (under the default
+// -ftrapping-math), which silently turns a SIMD loop back into scalar code.
+// Selecting on the bit patterns sidesteps that.
+inline float select_f(const bool c, const float x, const float y) {
+    int32_t xi, yi;
+    std::memcpy(&xi, &x, sizeof(float));
+    std::memcpy(&yi, &y, sizeof(float));
+    const int32_t m = -static_cast<int32_t>(c);
+    const int32_t ri = (xi & m) | (yi & ~m);
+    float r;
+    std::memcpy(&r, &ri, sizeof(float));
+    return r;
+}
+
+// exp(x) for float, within a few ulp over the normal range. Unlike std::exp
+// it is plain arithmetic so it vectorizes; it plays the role of `__expf` in
+// the CUDA kernels.
+inline float fast_expf(float x) {
+    // keep 2^n representable as a normal float
+    x = select_f(x < -87.3f, -87.3f, x);
+    x = select_f(x > 88.3f, 88.3f, x);
+    // exp(x) = 2^n * exp(r), n = round(x / ln2), |r| <= ln2 / 2. Adding
+    // 1.5 * 2^23 rounds to an integer that can be read from the mantissa bits,
+    // avoiding a float-to-int conversion.
+    const float t = x * 1.44269504f + 12582912.f;
+    const float fn = t - 12582912.f;
+    int32_t n;
+    std::memcpy(&n, &t, sizeof(float));
+    n -= 0x4B400000;
+    // Cody-Waite split of ln2 to keep r accurate
+    const float r = (x - fn * 0.693359375f) + fn * 2.12194440e-4f;
+    // Cephes polynomial for exp(r) on [-ln2/2, ln2/2]
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    const float er = p * r * r + r + 1.f;
+    const int32_t bits = (n + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(float));
+    return er * scale;
+}
+
+// Spread the lower 10 bits of v so that there are two zero bits between
+// consecutive ones.
+inline uint32_t expand_bits_10(uint32_t v) {
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+// 30-bit Morton code of a point given in [0, 1)^3 (clamped, NaN maps to 0),
+// with x in the most significant bit of every triplet.
+inline uint32_t morton_code_30(float x, float y, float z) {
+    const uint32_t xi = x > 0.f ? std::min(x * 1024.f, 1023.f) : 0.f;
+    const uint32_t yi = y > 0.f ? std::min(y * 1024.f, 1023.f) : 0.f;
+    const uint32_t zi = z > 0.f ? std::min(z * 1024.f, 1023.f) : 0.f;
+    return (expand_bits_10(xi) << 2) | (expand_bits_10(yi) << 1) |
+           expand_bits_10(zi);
+}
+
+} // namespace gsplat
@@ -0,0 +1,151 @@
+from dataclasses import dataclass
+from typing import Tuple
+
+import torch
+from torch import Tensor
+from typing_extensions import Literal
+
+from .cuda._wrapper import _make_lazy_cuda_func, _make_lazy_cuda_obj
+
+
+# Extent of a Gaussian in standard deviations, as in the projection: beyond it
+# the Gaussian falls below 1/255 of its peak and is not rasterized.
+GAUSSIAN_EXTENT = 3.33
+
+
+def _bounding_radii(scales: Tensor) -> Tensor:
+    # radius of the sphere around the ellipsoid at GAUSSIAN_EXTENT sigmas
+    return GAUSSIAN_EXTENT * scales.max(dim=-1).values
+
+
+@dataclass
+class FrustumIndex:
+    """A bounding volume hierarchy over the 3.33-sigma bounding spheres of a set
+    of Gaussians, to find the Gaussians in the view frustum of the cameras
+    without projecting all of them.
+
+    The Gaussians are sorted along a Morton curve of their means and grouped into
+    buckets of `leaf_size`, which are the leaves of a complete binary tree of
+    axis-aligned boxes. The index lives on CPU.
+
+    The order of the Gaussians is fixed at build time: :meth:`refit` updates the
+    boxes when the Gaussians move (e.g. after an optimizer step), which keeps the
+    query exact but makes it slower as the Gaussians drift away from their
+    initial positions. The index has to be rebuilt when Gaussians are added or
+    removed (e.g. after densification).
+    """
+
+    leaf_size: int
+    order: Tensor  # [N], int64
+    spheres: Tensor  # [N, 4], in the index order
+    node_bounds: Tensor  # [2P, 6], (min, max) corners
+
+    @property
+    def n_gaussians(self) -> int:
+        return self.order.shape[0]
+
+    @torch.no_grad()
+    def refit(
+        self,
+        means: Tensor,  # [N, 3]
+        scales: Tensor,  # [N, 3]
+    ) -> None:
+        """Update the index in place for new means and scales of the same
+        Gaussians."""
+        assert means.shape == (self.n_gaussians, 3), means.shape
+        assert scales.shape == (self.n_gaussians, 3), scales.shape
+        means = means.detach().to("cpu").contiguous()
+        radii = _bounding_radii(scales.detach().to("cpu", means.dtype))
+        _make_lazy_cuda_func("frustum_index_refit")(
+            self.order,
+            means,
+            radii.contiguous(),
+            self.leaf_size,
+            self.spheres,
+            self.node_bounds,
+        )
+
+    @torch.no_grad()
+    def query(
+        self,
+        viewmats: Tensor,  # [C, 4, 4]
+        Ks: Tensor,  # [C, 3, 3]
+        width: int,
+        height: int,
+        near_plane: float = 0.01,
+        far_plane: float = 1e10,
+        padding: float = 16.0,
+        camera_model: Literal["pinhole", "ortho", "fisheye", "ftheta"] = "pinhole",
+    ) -> Tuple[Tensor, Tensor]:
+        """Find the Gaussians whose bounding sphere intersects the view frustum
+        of each camera.
+
+        The image is widened by `padding` pixels on each side to account for the
+        2D blur added by the projection. For the fisheye and ftheta camera
+        models, only the near and far planes are tested.
+
+        Args:
+            viewmats: World-to-camera matrices. [C, 4, 4]
+            Ks: Camera intrinsics. [C, 3, 3]
+            width: Image width.
+            height: Image height.
+            near_plane: Near plane distance. Default is 0.01.
+            far_plane: Far plane distance. Default is 1e10.
+            padding: Margin in pixels around the image. Default is 16.0.
+            camera_model: The camera model. Default is "pinhole".
+
+        Returns:
+            A tuple, in the layout of the packed projection:
+
+            **camera_ids**: The camera indices of the candidates. [nnz]
+
+            **gaussian_ids**: The Gaussian indices of the candidates. [nnz]
+
+            The candidates are grouped by camera, on the device of the viewmats.
+        """
+        assert viewmats.dim() == 3 and viewmats.shape[1:] == (4, 4), viewmats.shape
+        assert Ks.shape == viewmats.shape[:1] + (3, 3), Ks.shape
+        camera_ids, gaussian_ids = _make_lazy_cuda_func("frustum_index_query")(
+            self.order,
+            self.spheres,
+            self.node_bounds,
+            self.leaf_size,
+            viewmats.detach().to("cpu", torch.float32).contiguous(),
+            Ks.detach().to("cpu", torch.float32).contiguous(),
+            width,
+            height,
+            near_plane,
+            far_plane,
+            padding,
+            _make_lazy_cuda_obj(f"CameraModelType.{camera_model.upper()}"),
+        )
+        return camera_ids.to(viewmats.device), gaussian_ids.to(viewmats.device)
+
+
+@torch.no_grad()
+def build_frustum_index(
+    means: Tensor,  # [N, 3]
+    scales: Tensor,  # [N, 3]
+    leaf_size: int = 32,
+) -> FrustumIndex:
+    """Build a :class:`FrustumIndex` over a set of Gaussians.
+
+    Args:
+        means: The 3D centers of the Gaussians. [N, 3]
+        scales: The scales of the Gaussians. [N, 3]
+        leaf_size: Number of Gaussians per leaf of the tree. Default is 32.
+
+    Returns:
+        The :class:`FrustumIndex`, on CPU.
+    """
+    N = means.shape[0]
+    assert means.shape == (N, 3), means.shape
+    assert scales.shape == (N, 3), scales.shape
+    means = means.detach().to("cpu").contiguous()
+    radii = _bounding_radii(scales.detach().to("cpu", means.dtype))
+    order, spheres, node_bounds = _make_lazy_cuda_func("frustum_index_build")(
+        means, radii.contiguous(), leaf_size
+    )
+    return FrustumIndex(
+        leaf_size=leaf_size, order=order, spheres=spheres, node_bounds=node_bounds
+    )
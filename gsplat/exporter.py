@@ -1,11 +1,20 @@
 import math
+import os
 import struct
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+from contextlib import contextmanager
+from dataclasses import dataclass, field
 from io import BytesIO
-from typing import Literal, Optional
+from typing import Dict, List, Literal, Optional, Sequence, Tuple
 
 import numpy as np
 import torch
 
+from .checkpoint import load_checkpoint
+from .cuda._wrapper import _make_lazy_cuda_func
+
 
 def sh2rgb(sh: torch.Tensor) -> torch.Tensor:
     """Convert Sphere Harmonics to RGB
@@ -79,8 +88,8 @@ def sort_centers(centers: torch.Tensor, indices: torch.Tensor) -> torch.Tensor:
     # Compute Morton codes using vectorized operations
     morton = encode_morton3_vec(x, y, z)
 
-    # Sort indices based on Morton codes
-    sorted_indices = indices[torch.argsort(morton).to(indices.device)]
+    # Sort indices based on Morton codes, keeping the order of equal codes
+    sorted_indices = indices[torch.argsort(morton, stable=True).to(indices.device)]
 
     return sorted_indices
 
@@ -191,6 +200,13 @@ def pack_rotation(q: torch.Tensor) -> torch.Tensor:
     return result
 
 
+def _has_native() -> bool:
+    """Whether the native CPU encoders of the extension are available."""
+    from .cuda._backend import _C
+
+    return _C is not None
+
+
 def splat2ply_bytes_compressed(
     means: torch.Tensor,
     scales: torch.Tensor,
@@ -200,6 +216,8 @@ def splat2ply_bytes_compressed(
     shN: torch.Tensor,
     chunk_max_size: int = 256,
     opacity_threshold: float = 1 / 255,
+    native: Optional[bool] = None,
+    encoded: Optional[Tuple[torch.Tensor, torch.Tensor, torch.Tensor]] = None,
 ) -> bytes:
     """Return the binary compressed Ply file. Used by Supersplat viewer.
 
@@ -212,25 +230,35 @@ def splat2ply_bytes_compressed(
         shN (torch.Tensor): Spherical harmonics. Shape (N, K*3)
         chunk_max_size (int): Maximum number of splats per chunk. Default: 256
         opacity_threshold (float): Opacity threshold. Default: 1 / 255
+        native (bool): Sort and encode the chunks in parallel with the native
+            CPU encoder, which gives the same bytes as the PyTorch
+            implementation. Default: None, which uses it when the extension is
+            available
+        encoded (tuple): The chunks already encoded by :func:`encode_chunks` with
+            the same arguments, which are then only written out. Default: None
 
     Returns:
         bytes: Binary compressed Ply file representing the model.
     """
 
-    # Filter the splats with too low opacity
-    mask = torch.sigmoid(opacities) > opacity_threshold
-    means = means[mask]
-    scales = scales[mask]
-    sh0_colors = sh2rgb(sh0)
-    sh0_colors = sh0_colors[mask]
-    shN = shN[mask]
-    quats = quats[mask]
-    opacities = opacities[mask]
-
-    num_splats = means.shape[0]
-    n_chunks = num_splats // chunk_max_size + (num_splats % chunk_max_size != 0)
-    indices = torch.arange(num_splats)
-    indices = sort_centers(means, indices)
+    if encoded is not None:
+        chunk_data, splat_data, sh_data = encoded
+        num_splats = splat_data.shape[0]
+        n_chunks = chunk_data.shape[0]
+    else:
+        # Filter the splats with too low opacity
+        mask = torch.sigmoid(opacities) > opacity_threshold
+        means = means[mask]
+        scales = scales[mask]
+        sh0_colors = sh2rgb(sh0)
+        sh0_colors = sh0_colors[mask]
+        shN = shN[mask]
+        quats = quats[mask]
+        opacities = opacities[mask]
+
+        num_splats = means.shape[0]
+        n_chunks = num_splats // chunk_max_size + (num_splats % chunk_max_size != 0)
+        alphas = 1 / (1 + torch.exp(-opacities))
 
     float_properties = [
         "min_x",
@@ -274,88 +302,260 @@ def splat2ply_bytes_compressed(
         buffer.write(f"property uchar f_rest_{j}\n".encode())
     buffer.write(b"end_header\n")
 
-    chunk_data = []
-    splat_data = []
-    sh_data = []
-    for chunk_idx in range(n_chunks):
-        chunk_end_idx = min((chunk_idx + 1) * chunk_max_size, num_splats)
-        chunk_start_idx = chunk_idx * chunk_max_size
-        splat_idxs = indices[chunk_start_idx:chunk_end_idx]
-
-        # Bounds
-        # Means
-        chunk_means = means[splat_idxs]
-        min_means = torch.min(chunk_means, dim=0).values
-        max_means = torch.max(chunk_means, dim=0).values
-        mean_bounds = torch.cat([min_means, max_means])
-        # Scales
-        chunk_scales = scales[splat_idxs]
-        min_scales = torch.min(chunk_scales, dim=0).values
-        max_scales = torch.max(chunk_scales, dim=0).values
-        min_scales = torch.clamp(min_scales, -20, 20)
-        max_scales = torch.clamp(max_scales, -20, 20)
-        scale_bounds = torch.cat([min_scales, max_scales])
-        # Colors
-        chunk_colors = sh0_colors[splat_idxs]
-        min_colors = torch.min(chunk_colors, dim=0).values
-        max_colors = torch.max(chunk_colors, dim=0).values
-        color_bounds = torch.cat([min_colors, max_colors])
-        chunk_data.extend([mean_bounds, scale_bounds, color_bounds])
-
-        # Quantized properties:
-        # Means
-        normalized_means = (chunk_means - min_means) / (max_means - min_means)
-        means_i = pack_111011(
-            normalized_means[:, 0],
-            normalized_means[:, 1],
-            normalized_means[:, 2],
-        )
-        # Quaternions
-        chunk_quats = quats[splat_idxs]
-        quat_i = pack_rotation(chunk_quats)
-        # Scales
-        normalized_scales = (chunk_scales - min_scales) / (max_scales - min_scales)
-        scales_i = pack_111011(
-            normalized_scales[:, 0],
-            normalized_scales[:, 1],
-            normalized_scales[:, 2],
-        )
-        # Colors
-        normalized_colors = (chunk_colors - min_colors) / (max_colors - min_colors)
-        chunk_opacities = opacities[splat_idxs]
-        chunk_opacities = 1 / (1 + torch.exp(-chunk_opacities))
-        chunk_opacities = chunk_opacities.unsqueeze(-1)
-        normalized_colors_i = torch.cat([normalized_colors, chunk_opacities], dim=-1)
-        color_i = pack_8888(
-            normalized_colors_i[:, 0],
-            normalized_colors_i[:, 1],
-            normalized_colors_i[:, 2],
-            normalized_colors_i[:, 3],
+    if native is None:
+        native = _has_native()
+    if encoded is None and native:
+        chunk_data, splat_data, sh_data = _make_lazy_cuda_func("encode_ply_compressed")(
+            means.detach().float().cpu().contiguous(),
+            scales.detach().float().cpu().contiguous(),
+            quats.detach().float().cpu().contiguous(),
+            sh0_colors.detach().float().cpu().contiguous(),
+            alphas.detach().float().cpu().contiguous(),
+            shN.detach().float().cpu().contiguous(),
+            chunk_max_size,
         )
-        splat_data_chunk = torch.stack([means_i, quat_i, scales_i, color_i], dim=1)
-        splat_data_chunk = splat_data_chunk.ravel().to(torch.int64)
-        splat_data.extend([splat_data_chunk])
-
-        # Quantized spherical harmonics
-        shN_chunk = shN[splat_idxs]
-        shN_chunk_quantized = (shN_chunk / 8 + 0.5) * 256
-        shN_chunk_quantized = torch.clamp(torch.trunc(shN_chunk_quantized), 0, 255)
-        shN_chunk_quantized = shN_chunk_quantized.to(torch.uint8)
-        sh_data.extend([shN_chunk_quantized.ravel()])
+    elif encoded is None:
+        indices = torch.arange(num_splats)
+        indices = sort_centers(means, indices)
+        chunk_data = []
+        splat_data = []
+        sh_data = []
+        for chunk_idx in range(n_chunks):
+            chunk_end_idx = min((chunk_idx + 1) * chunk_max_size, num_splats)
+            chunk_start_idx = chunk_idx * chunk_max_size
+            splat_idxs = indices[chunk_start_idx:chunk_end_idx]
+
+            # Bounds
+            # Means
+            chunk_means = means[splat_idxs]
+            min_means = torch.min(chunk_means, dim=0).values
+            max_means = torch.max(chunk_means, dim=0).values
+            mean_bounds = torch.cat([min_means, max_means])
+            # Scales
+            chunk_scales = scales[splat_idxs]
+            min_scales = torch.min(chunk_scales, dim=0).values
+            max_scales = torch.max(chunk_scales, dim=0).values
+            min_scales = torch.clamp(min_scales, -20, 20)
+            max_scales = torch.clamp(max_scales, -20, 20)
+            scale_bounds = torch.cat([min_scales, max_scales])
+            # Colors
+            chunk_colors = sh0_colors[splat_idxs]
+            min_colors = torch.min(chunk_colors, dim=0).values
+            max_colors = torch.max(chunk_colors, dim=0).values
+            color_bounds = torch.cat([min_colors, max_colors])
+            chunk_data.extend([mean_bounds, scale_bounds, color_bounds])
+
+            # Quantized properties:
+            # Means
+            normalized_means = (chunk_means - min_means) / (max_means - min_means)
+            means_i = pack_111011(
+                normalized_means[:, 0],
+                normalized_means[:, 1],
+                normalized_means[:, 2],
+            )
+            # Quaternions
+            chunk_quats = quats[splat_idxs]
+            quat_i = pack_rotation(chunk_quats)
+            # Scales
+            normalized_scales = (chunk_scales - min_scales) / (max_scales - min_scales)
+            scales_i = pack_111011(
+                normalized_scales[:, 0],
+                normalized_scales[:, 1],
+                normalized_scales[:, 2],
+            )
+            # Colors
+            normalized_colors = (chunk_colors - min_colors) / (max_colors - min_colors)
+            chunk_opacities = alphas[splat_idxs].unsqueeze(-1)
+            normalized_colors_i = torch.cat(
+                [normalized_colors, chunk_opacities], dim=-1
+            )
+            color_i = pack_8888(
+                normalized_colors_i[:, 0],
+                normalized_colors_i[:, 1],
+                normalized_colors_i[:, 2],
+                normalized_colors_i[:, 3],
+            )
+            splat_data_chunk = torch.stack([means_i, quat_i, scales_i, color_i], dim=1)
+            splat_data_chunk = splat_data_chunk.ravel().to(torch.int64)
+            splat_data.extend([splat_data_chunk])
+
+            # Quantized spherical harmonics
+            shN_chunk = shN[splat_idxs]
+            shN_chunk_quantized = (shN_chunk / 8 + 0.5) * 256
+            shN_chunk_quantized = torch.clamp(torch.trunc(shN_chunk_quantized), 0, 255)
+            shN_chunk_quantized = shN_chunk_quantized.to(torch.uint8)
+            sh_data.extend([shN_chunk_quantized.ravel()])
+        chunk_data = torch.cat(chunk_data)
+        splat_data = torch.cat(splat_data)
+        sh_data = torch.cat(sh_data)
 
     float_dtype = np.dtype(np.float32).newbyteorder("<")
     uint32_dtype = np.dtype(np.uint32).newbyteorder("<")
     uint8_dtype = np.dtype(np.uint8)
 
-    buffer.write(
-        torch.cat(chunk_data).detach().cpu().numpy().astype(float_dtype).tobytes()
-    )
-    buffer.write(
-        torch.cat(splat_data).detach().cpu().numpy().astype(uint32_dtype).tobytes()
+    buffer.write(chunk_data.detach().cpu().numpy().astype(float_dtype).tobytes())
+    buffer.write(splat_data.detach().cpu().numpy().astype(uint32_dtype).tobytes())
+    buffer.write(sh_data.detach().cpu().numpy().astype(uint8_dtype).tobytes())
+
+    return buffer.getvalue()
+
+
+def encode_chunks(
+    means: torch.Tensor,
+    scales: torch.Tensor,
+    quats: torch.Tensor,
+    opacities: torch.Tensor,
+    sh0: torch.Tensor,
+    shN: torch.Tensor,
+    chunk_max_size: int = 256,
+    opacity_threshold: float = 1 / 255,
+) -> Tuple[torch.Tensor, torch.Tensor, torch.Tensor]:
+    """Filter, sort and encode the splats in chunks with the native CPU encoder.
+
+    This is the work shared by the "ply_compressed" and "chunked" formats, see
+    :func:`splat2ply_bytes_compressed` for the arguments.
+
+    Returns:
+        tuple: The chunk bounds [n_chunks, 18], the packed splats [M, 4] and the
+        quantized SH coefficients [M, K*3] of the M splats above the threshold.
+    """
+    # Filter the splats with too low opacity
+    mask = torch.sigmoid(opacities) > opacity_threshold
+    return _make_lazy_cuda_func("encode_ply_compressed")(
+        means[mask].detach().float().cpu().contiguous(),
+        scales[mask].detach().float().cpu().contiguous(),
+        quats[mask].detach().float().cpu().contiguous(),
+        sh2rgb(sh0[mask]).detach().float().cpu().contiguous(),
+        (1 / (1 + torch.exp(-opacities[mask]))).detach().float().cpu().contiguous(),
+        shN[mask].detach().float().cpu().contiguous(),
+        chunk_max_size,
     )
+
+
+# The chunked format: a header, the chunks of packed splats and, at the end, a
+# table that gives for every chunk its bounds, byte offset, number of splats
+# and mask of stored SH bands, followed by the offset of the table.
+CHUNKED_MAGIC = b"GSCHUNK\0"
+CHUNKED_VERSION = 1
+CHUNKED_CHUNK_SIZE = 256
+# magic, version, SH degree, number of splats and of chunks
+CHUNKED_HEADER = struct.Struct("<8sIIQQ")
+# offset of the table, magic
+CHUNKED_TRAILER = struct.Struct("<Q8s")
+CHUNKED_TABLE_DTYPE = np.dtype(
+    [
+        ("bounds", "<f4", (18,)),
+        ("offset", "<u8"),
+        ("count", "<u4"),
+        ("sh_mask", "<u4"),
+    ]
+)
+
+
+def splat2chunked_bytes(
+    means: torch.Tensor,
+    scales: torch.Tensor,
+    quats: torch.Tensor,
+    opacities: torch.Tensor,
+    sh0: torch.Tensor,
+    shN: torch.Tensor,
+    opacity_threshold: float = 1 / 255,
+    encoded: Optional[Tuple[torch.Tensor, torch.Tensor, torch.Tensor]] = None,
+) -> bytes:
+    """Return the binary chunked file. Loaded by :class:`gsplat.ChunkedSplats`.
+
+    The splats are sorted and packed in chunks of 256 like in the compressed Ply
+    file. Every chunk is stored contiguously: the packed words of its splats,
+    then their SH coefficients band by band, skipping the bands whose
+    coefficients are all quantized to zero. The table at the end of the file
+    gives for every chunk its bounds (the first 6 are the bounding box of the
+    means), byte offset, number of splats and mask of stored SH bands, so that
+    a reader can fetch only the chunks and the SH degrees it needs.
+
+    Args:
+        means (torch.Tensor): Splat means. Shape (N, 3)
+        scales (torch.Tensor): Splat scales. Shape (N, 3)
+        quats (torch.Tensor): Splat quaternions. Shape (N, 4)
+        opacities (torch.Tensor): Splat opacities. Shape (N,)
+        sh0 (torch.Tensor): Spherical harmonics. Shape (N, 3)
+        shN (torch.Tensor): Spherical harmonics. Shape (N, K*3)
+        opacity_threshold (float): Opacity threshold. Default: 1 / 255
+        encoded (tuple): The chunks already encoded by :func:`encode_chunks` with
+            the same arguments, which are then only laid out. Default: None
+
+    Returns:
+        bytes: Binary chunked file representing the model.
+    """
+    K = shN.shape[1] // 3
+    sh_degree = math.isqrt(K + 1) - 1
+    assert (sh_degree + 1) ** 2 - 1 == K, f"Expected (d + 1)^2 - 1 SH bands, got {K}"
+
+    if encoded is None:
+        encoded = encode_chunks(
+            means,
+            scales,
+            quats,
+            opacities,
+            sh0,
+            shN,
+            CHUNKED_CHUNK_SIZE,
+            opacity_threshold,
+        )
+    chunk_data, splat_data, sh_data = encoded
+    num_splats = splat_data.shape[0]
+    n_chunks = chunk_data.shape[0]
+    counts = torch.full((n_chunks,), CHUNKED_CHUNK_SIZE, dtype=torch.int64)
+    if n_chunks > 0:
+        counts[-1] = num_splats - (n_chunks - 1) * CHUNKED_CHUNK_SIZE
+
+    # SH bands of degree 1 to sh_degree, a band is stored if any of its
+    # coefficients in the chunk is not quantized to 0 (128)
+    sh_data = sh_data.view(num_splats, 3, K)
+    bands = [
+        sh_data[:, :, d * d - 1 : (d + 1) ** 2 - 1].contiguous()
+        for d in range(1, sh_degree + 1)
+    ]
+    sh_masks = torch.zeros(n_chunks, dtype=torch.int64)
+    sizes = counts * 16
+    for d, band in enumerate(bands):
+        # 3 channels of 2 * degree + 1 coefficients
+        width = 3 * (2 * (d + 1) + 1)
+        nonzero = torch.zeros(n_chunks * CHUNKED_CHUNK_SIZE, dtype=torch.bool)
+        nonzero[:num_splats] = (band != 128).flatten(1).any(dim=1)
+        stored = nonzero.view(n_chunks, CHUNKED_CHUNK_SIZE).any(dim=1)
+        sh_masks |= stored.to(torch.int64) << d
+        sizes += stored * counts * width
+    # 4-byte aligned chunks
+    sizes = (sizes + 3) // 4 * 4
+    offsets = CHUNKED_HEADER.size + torch.cumsum(sizes, dim=0) - sizes
+
+    table = np.zeros(n_chunks, dtype=CHUNKED_TABLE_DTYPE)
+    table["bounds"] = chunk_data.numpy()
+    table["offset"] = offsets.numpy()
+    table["count"] = counts.numpy()
+    table["sh_mask"] = sh_masks.numpy()
+
+    buffer = BytesIO()
     buffer.write(
-        torch.cat(sh_data).detach().cpu().numpy().astype(uint8_dtype).tobytes()
+        CHUNKED_HEADER.pack(
+            CHUNKED_MAGIC, CHUNKED_VERSION, sh_degree, num_splats, n_chunks
+        )
     )
+    uint32_dtype = np.dtype(np.uint32).newbyteorder("<")
+    splat_data = splat_data.numpy().astype(uint32_dtype)
+    bands = [band.numpy() for band in bands]
+    for chunk_idx, (size, sh_mask) in enumerate(zip(sizes.tolist(), sh_masks.tolist())):
+        start = chunk_idx * CHUNKED_CHUNK_SIZE
+        end = min(start + CHUNKED_CHUNK_SIZE, num_splats)
+        chunk = [splat_data[start:end].tobytes()]
+        for d, band in enumerate(bands):
+            if sh_mask >> d & 1:
+                chunk.append(band[start:end].tobytes())
+        chunk = b"".join(chunk)
+        buffer.write(chunk + bytes(size - len(chunk)))
+    table_offset = buffer.tell()
+    buffer.write(table.tobytes())
+    buffer.write(CHUNKED_TRAILER.pack(table_offset, CHUNKED_MAGIC))
 
     return buffer.getvalue()
 
@@ -423,6 +623,7 @@ def splat2splat_bytes(
     quats: torch.Tensor,
     opacities: torch.Tensor,
     sh0: torch.Tensor,
+    indices: Optional[torch.Tensor] = None,
 ) -> bytes:
     """Return the binary Splat file. Supported by antimatter15 viewer.
 
@@ -432,6 +633,8 @@ def splat2splat_bytes(
         quats (torch.Tensor): Splat quaternions. Shape (N, 4)
         opacities (torch.Tensor): Splat opacities. Shape (N,)
         sh0 (torch.Tensor): Spherical harmonics. Shape (N, 3)
+        indices (torch.Tensor): The Morton order of the splats given by
+            :func:`sort_centers`, computed if not provided. Shape (N,)
 
     Returns:
         bytes: Binary Splat file representing the model.
@@ -448,7 +651,8 @@ def splat2splat_bytes(
 
     # Sort splats
     num_splats = means.shape[0]
-    indices = sort_centers(means, torch.arange(num_splats))
+    if indices is None:
+        indices = sort_centers(means, torch.arange(num_splats))
 
     # Reorder everything
     means = means[indices]
@@ -456,58 +660,34 @@ def splat2splat_bytes(
     colors = colors[indices]
     rots = rots[indices]
 
-    float_dtype = np.dtype(np.float32).newbyteorder("<")
-    means_np = means.detach().cpu().numpy().astype(float_dtype)
-    scales_np = scales.detach().cpu().numpy().astype(float_dtype)
-    colors_np = colors.detach().cpu().numpy().astype(np.uint8)
-    rots_np = rots.detach().cpu().numpy().astype(np.uint8)
-
-    buffer = BytesIO()
-    for i in range(num_splats):
-        buffer.write(means_np[i].tobytes())
-        buffer.write(scales_np[i].tobytes())
-        buffer.write(colors_np[i].tobytes())
-        buffer.write(rots_np[i].tobytes())
+    # Interleave the splats, 32 bytes each
+    splat_dtype = np.dtype(
+        [
+            ("mean", "<f4", (3,)),
+            ("scale", "<f4", (3,)),
+            ("color", "u1", (4,)),
+            ("rot", "u1", (4,)),
+        ]
+    )
+    splat_data = np.empty(num_splats, dtype=splat_dtype)
+    splat_data["mean"] = means.detach().cpu().numpy()
+    splat_data["scale"] = scales.detach().cpu().numpy()
+    splat_data["color"] = colors.detach().cpu().numpy()
+    splat_data["rot"] = rots.detach().cpu().numpy()
 
-    return buffer.getvalue()
+    return splat_data.tobytes()
 
 
-def export_splats(
+def _filter_splats(
     means: torch.Tensor,
     scales: torch.Tensor,
     quats: torch.Tensor,
     opacities: torch.Tensor,
     sh0: torch.Tensor,
     shN: torch.Tensor,
-    format: Literal["ply", "splat", "ply_compressed"] = "ply",
-    save_to: Optional[str] = None,
-) -> bytes:
-    """Export a Gaussian Splats model to bytes.
-    The three supported formats are:
-    - ply: A standard PLY file format. Supported by most viewers.
-    - splat: A custom Splat file format. Supported by antimatter15 viewer.
-    - ply_compressed: A compressed PLY file format. Used by Supersplat viewer.
-
-    Args:
-        means (torch.Tensor): Splat means. Shape (N, 3)
-        scales (torch.Tensor): Splat scales. Shape (N, 3)
-        quats (torch.Tensor): Splat quaternions. Shape (N, 4)
-        opacities (torch.Tensor): Splat opacities. Shape (N,)
-        sh0 (torch.Tensor): Spherical harmonics. Shape (N, 1, 3)
-        shN (torch.Tensor): Spherical harmonics. Shape (N, K, 3)
-        format (str): Export format. Options: "ply", "splat", "ply_compressed". Default: "ply"
-        save_to (str): Output file path. If provided, the bytes will be written to file.
-    """
-    total_splats = means.shape[0]
-    assert means.shape == (total_splats, 3), "Means must be of shape (N, 3)"
-    assert scales.shape == (total_splats, 3), "Scales must be of shape (N, 3)"
-    assert quats.shape == (total_splats, 4), "Quaternions must be of shape (N, 4)"
-    assert opacities.shape == (total_splats,), "Opacities must be of shape (N,)"
-    assert sh0.shape == (total_splats, 1, 3), "sh0 must be of shape (N, 1, 3)"
-    assert (
-        shN.ndim == 3 and shN.shape[0] == total_splats and shN.shape[2] == 3
-    ), f"shN must be of shape (N, K, 3), got {shN.shape}"
-
+) -> Tuple[torch.Tensor, ...]:
+    """Flatten the spherical harmonics to (N, 3) and (N, K * 3), and drop the
+    splats with NaN or Inf values."""
     # Reshape spherical harmonics
     sh0 = sh0.squeeze(1)  # Shape (N, 3)
     shN = shN.permute(0, 2, 1).reshape(means.shape[0], -1)  # Shape (N, K * 3)
@@ -520,8 +700,8 @@ def export_splats(
         | torch.isinf(scales).any(dim=1)
         | torch.isnan(quats).any(dim=1)
         | torch.isinf(quats).any(dim=1)
-        | torch.isnan(opacities).any(dim=0)
-        | torch.isinf(opacities).any(dim=0)
+        | torch.isnan(opacities)
+        | torch.isinf(opacities)
         | torch.isnan(sh0).any(dim=1)
         | torch.isinf(sh0).any(dim=1)
         | torch.isnan(shN).any(dim=1)
@@ -536,6 +716,85 @@ def export_splats(
     opacities = opacities[valid_mask]
     sh0 = sh0[valid_mask]
     shN = shN[valid_mask]
+    return means, scales, quats, opacities, sh0, shN
+
+
+def _check_splats(
+    means: torch.Tensor,
+    scales: torch.Tensor,
+    quats: torch.Tensor,
+    opacities: torch.Tensor,
+    sh0: torch.Tensor,
+    shN: torch.Tensor,
+) -> None:
+    total_splats = means.shape[0]
+    assert means.shape == (total_splats, 3), "Means must be of shape (N, 3)"
+    assert scales.shape == (total_splats, 3), "Scales must be of shape (N, 3)"
+    assert quats.shape == (total_splats, 4), "Quaternions must be of shape (N, 4)"
+    assert opacities.shape == (total_splats,), "Opacities must be of shape (N,)"
+    assert sh0.shape == (total_splats, 1, 3), "sh0 must be of shape (N, 1, 3)"
+    assert (
+        shN.ndim == 3 and shN.shape[0] == total_splats and shN.shape[2] == 3
+    ), f"shN must be of shape (N, K, 3), got {shN.shape}"
+
+
+def export_splats(
+    means: torch.Tensor,
+    scales: torch.Tensor,
+    quats: torch.Tensor,
+    opacities: torch.Tensor,
+    sh0: torch.Tensor,
+    shN: torch.Tensor,
+    format: Literal["ply", "splat", "ply_compressed", "chunked"] = "ply",
+    save_to: Optional[str] = None,
+    streaming: bool = False,
+) -> Optional[bytes]:
+    """Export a Gaussian Splats model to bytes.
+    The four supported formats are:
+    - ply: A standard PLY file format. Supported by most viewers.
+    - splat: A custom Splat file format. Supported by antimatter15 viewer.
+    - ply_compressed: A compressed PLY file format. Used by Supersplat viewer.
+    - chunked: The chunks of the compressed PLY file with a spatial index, for
+      random access. Loaded by :class:`gsplat.ChunkedSplats`.
+
+    Args:
+        means (torch.Tensor): Splat means. Shape (N, 3)
+        scales (torch.Tensor): Splat scales. Shape (N, 3)
+        quats (torch.Tensor): Splat quaternions. Shape (N, 4)
+        opacities (torch.Tensor): Splat opacities. Shape (N,)
+        sh0 (torch.Tensor): Spherical harmonics. Shape (N, 1, 3)
+        shN (torch.Tensor): Spherical harmonics. Shape (N, K, 3)
+        format (str): Export format. Options: "ply", "splat", "ply_compressed", "chunked". Default: "ply"
+        save_to (str): Output file path. If provided, the bytes will be written to file.
+        streaming (bool): Write the file in chunks with a native writer instead of
+            building it in memory, so that the peak memory does not grow with the
+            number of splats. Requires `save_to` and the "ply" format, and returns
+            None. Default: False
+
+    Returns:
+        bytes: The exported file, or None when streaming.
+    """
+    _check_splats(means, scales, quats, opacities, sh0, shN)
+
+    if streaming:
+        assert format == "ply", "Streaming export only supports the ply format."
+        assert save_to is not None, "Streaming export requires save_to."
+        # the NaN/Inf filtering and the interleaving happen chunk by chunk
+        _make_lazy_cuda_func("export_ply")(
+            str(save_to),
+            means.detach(),
+            scales.detach(),
+            quats.detach(),
+            opacities.detach(),
+            sh0.detach(),
+            shN.detach(),
+            1 << 16,
+        )
+        return None
+
+    means, scales, quats, opacities, sh0, shN = _filter_splats(
+        means, scales, quats, opacities, sh0, shN
+    )
 
     if format == "ply":
         data = splat2ply_bytes(means, scales, quats, opacities, sh0, shN)
@@ -543,6 +802,8 @@ def export_splats(
         data = splat2splat_bytes(means, scales, quats, opacities, sh0)
     elif format == "ply_compressed":
         data = splat2ply_bytes_compressed(means, scales, quats, opacities, sh0, shN)
+    elif format == "chunked":
+        data = splat2chunked_bytes(means, scales, quats, opacities, sh0, shN)
     else:
         raise ValueError(f"Unsupported format: {format}")
 
@@ -551,3 +812,245 @@ def export_splats(
             binary_file.write(data)
 
     return data
+
+
+# File extension of every export format
+EXPORT_EXTENSIONS = {
+    "ply": ".ply",
+    "splat": ".splat",
+    "ply_compressed": ".compressed.ply",
+    "chunked": ".gsc",
+}
+
+
+@contextmanager
+def _timed(timings: Optional[Dict[str, float]], stage: str):
+    start = time.time()
+    yield
+    if timings is not None:
+        timings[stage] = timings.get(stage, 0.0) + time.time() - start
+
+
+def export_splats_multi(
+    means: torch.Tensor,
+    scales: torch.Tensor,
+    quats: torch.Tensor,
+    opacities: torch.Tensor,
+    sh0: torch.Tensor,
+    shN: torch.Tensor,
+    formats: Sequence[Literal["ply", "splat", "ply_compressed", "chunked"]],
+    save_to: Optional[Dict[str, str]] = None,
+    timings: Optional[Dict[str, float]] = None,
+) -> Dict[str, bytes]:
+    """Export a Gaussian Splats model to several formats in one pass.
+
+    Gives the same bytes as calling :func:`export_splats` for every format, but the
+    work the formats have in common is done once: the NaN/Inf filtering, the Morton
+    sort of the "splat" format, and the filtering, sort and encoding of the chunks
+    shared by the "ply_compressed" and "chunked" formats.
+
+    Args:
+        means, scales, quats, opacities, sh0, shN: The splats, as in
+            :func:`export_splats`.
+        formats (list): Export formats.
+        save_to (dict): Output file path of some formats. Default: None
+        timings (dict): If provided, the seconds spent in every stage ("filter",
+            "sort", "encode", one per format and "write") are added to it.
+            Default: None
+
+    Returns:
+        dict: The exported file of every format.
+    """
+    _check_splats(means, scales, quats, opacities, sh0, shN)
+    for format in formats:
+        if format not in EXPORT_EXTENSIONS:
+            raise ValueError(f"Unsupported format: {format}")
+
+    with _timed(timings, "filter"):
+        means, scales, quats, opacities, sh0, shN = _filter_splats(
+            means, scales, quats, opacities, sh0, shN
+        )
+    indices, encoded = None, None
+    if "splat" in formats:
+        with _timed(timings, "sort"):
+            indices = sort_centers(means, torch.arange(means.shape[0]))
+    # without the extension, the "ply_compressed" format encodes in PyTorch
+    if "chunked" in formats or ("ply_compressed" in formats and _has_native()):
+        with _timed(timings, "encode"):
+            encoded = encode_chunks(
+                means, scales, quats, opacities, sh0, shN, CHUNKED_CHUNK_SIZE
+            )
+
+    results = {}
+    for format in formats:
+        with _timed(timings, format):
+            if format == "ply":
+                data = splat2ply_bytes(means, scales, quats, opacities, sh0, shN)
+            elif format == "splat":
+                data = splat2splat_bytes(
+                    means, scales, quats, opacities, sh0, indices=indices
+                )
+            elif format == "ply_compressed":
+                data = splat2ply_bytes_compressed(
+                    means, scales, quats, opacities, sh0, shN, encoded=encoded
+                )
+            else:
+                data = splat2chunked_bytes(
+                    means, scales, quats, opacities, sh0, shN, encoded=encoded
+                )
+        results[format] = data
+        if save_to is not None and format in save_to:
+            with _timed(timings, "write"):
+                with open(save_to[format], "wb") as binary_file:
+                    binary_file.write(data)
+    return results
+
+
+def load_splats_checkpoint(path: str) -> Dict[str, torch.Tensor]:
+    """Load the splats of a checkpoint written by the example trainers, including
+    delta checkpoints, or of a file holding the dictionary of splats directly, on the
+    CPU."""
+    if path.endswith(".delta.pt"):
+        ckpt = load_checkpoint(path, map_location="cpu")
+    else:
+        ckpt = torch.load(path, map_location="cpu", weights_only=True)
+    splats = ckpt.get("splats", ckpt)
+    for key in ["means", "scales", "quats", "opacities", "sh0", "shN"]:
+        assert key in splats, f"{path} has no {key}"
+    return splats
+
+
+@dataclass
+class ExportReport:
+    """The outcome of exporting one checkpoint with :func:`export_checkpoints`."""
+
+    ckpt: str
+    files: Dict[str, str]  # format -> path
+    memory: int  # estimated peak memory in bytes
+    timings: Dict[str, float] = field(default_factory=dict)  # stage -> seconds
+    error: Optional[str] = None
+
+
+# Estimated peak memory of the export of a checkpoint, as a multiple of its size:
+# the loaded and the filtered splats, plus the output of every format.
+_EXPORT_MEMORY_BASE = 2.0
+_EXPORT_MEMORY_FACTORS = {
+    "ply": 1.0,
+    "splat": 0.5,
+    "ply_compressed": 0.5,
+    "chunked": 0.5,
+}
+
+
+class _MemoryBudget:
+    """Lets jobs run while their estimated memory fits in the budget. A job larger
+    than the whole budget runs alone."""
+
+    def __init__(self, budget: int):
+        self.budget = budget
+        self.used = 0
+        self.cond = threading.Condition()
+
+    def acquire(self, memory: int) -> None:
+        with self.cond:
+            while self.used > 0 and self.used + memory > self.budget:
+                self.cond.wait()
+            self.used += memory
+
+    def release(self, memory: int) -> None:
+        with self.cond:
+            self.used -= memory
+            self.cond.notify_all()
+
+
+def export_checkpoints(
+    ckpts: Sequence[str],
+    formats: Sequence[Literal["ply", "splat", "ply_compressed", "chunked"]] = ("ply",),
+    output_dir: Optional[str] = None,
+    num_workers: int = 4,
+    memory_budget: int = 8 * 1024**3,
+    verbose: bool = True,
+) -> List[ExportReport]:
+    """Export many checkpoints to several formats with a pool of workers.
+
+    Every checkpoint is loaded once and exported to all the formats with
+    :func:`export_splats_multi`. The checkpoints are scheduled in order over
+    `num_workers` threads, and a checkpoint only starts once its estimated peak
+    memory fits in `memory_budget` next to the running ones. A failed checkpoint is
+    reported and does not stop the others.
+
+    Args:
+        ckpts (list): Checkpoint paths, see :func:`load_splats_checkpoint`.
+        formats (list): Export formats. Default: ("ply",)
+        output_dir (str): Output directory. The file of a checkpoint `name.pt` is
+            `name` followed by the extension of the format (".ply", ".splat",
+            ".compressed.ply", ".gsc"). Default: next to the checkpoint.
+        num_workers (int): Number of checkpoints exported at the same time. Default: 4
+        memory_budget (int): Memory budget in bytes. Default: 8 GiB
+        verbose (bool): Print the timings of every checkpoint and a summary.
+            Default: True
+
+    Returns:
+        list: An :class:`ExportReport` per checkpoint, in order.
+    """
+    for format in formats:
+        if format not in EXPORT_EXTENSIONS:
+            raise ValueError(f"Unsupported format: {format}")
+    if output_dir is not None:
+        os.makedirs(output_dir, exist_ok=True)
+
+    reports = []
+    for ckpt in ckpts:
+        stem = os.path.splitext(os.path.basename(ckpt))[0]
+        out_dir = output_dir if output_dir is not None else os.path.dirname(ckpt)
+        files = {
+            format: os.path.join(out_dir, stem + EXPORT_EXTENSIONS[format])
+            for format in formats
+        }
+        factor = _EXPORT_MEMORY_BASE + sum(_EXPORT_MEMORY_FACTORS[f] for f in formats)
+        memory = int(os.path.getsize(ckpt) * factor)
+        reports.append(ExportReport(ckpt, files, memory))
+
+    budget = _MemoryBudget(memory_budget)
+
+    def run(report: ExportReport) -> None:
+        budget.acquire(report.memory)
+        try:
+            with _timed(report.timings, "load"):
+                splats = load_splats_checkpoint(report.ckpt)
+            export_splats_multi(
+                splats["means"],
+                splats["scales"],
+                splats["quats"],
+                splats["opacities"],
+                splats["sh0"],
+                splats["shN"],
+                formats,
+                save_to=report.files,
+                timings=report.timings,
+            )
+        except Exception as e:
+            report.error = f"{type(e).__name__}: {e}"
+        finally:
+            budget.release(report.memory)
+        if verbose:
+            stages = ", ".join(f"{k} {v:.2f}s" for k, v in report.timings.items())
+            status = f"failed ({report.error})" if report.error else stages
+            print(f"Exported {report.ckpt}: {status}")
+
+    start = time.time()
+    with ThreadPoolExecutor(max_workers=num_workers) as pool:
+        list(pool.map(run, reports))
+
+    if verbose:
+        totals: Dict[str, float] = {}
+        for report in reports:
+            for k, v in report.timings.items():
+                totals[k] = totals.get(k, 0.0) + v
+        n_failed = sum(report.error is not None for report in reports)
+        print(
+            f"Exported {len(reports) - n_failed}/{len(reports)} checkpoints in "
+            f"{time.time() - start:.2f}s, summed over the workers: "
+            + ", ".join(f"{k} {v:.2f}s" for k, v in totals.items())
+        )
+    return reports
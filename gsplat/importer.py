@@ -0,0 +1,455 @@
+import mmap
+from typing import Dict, List, Literal, Optional, Tuple
+
+import numpy as np
+import torch
+
+from .cuda._wrapper import _make_lazy_cuda_func
+from .culling import GAUSSIAN_EXTENT
+from .exporter import (
+    CHUNKED_CHUNK_SIZE,
+    CHUNKED_HEADER,
+    CHUNKED_MAGIC,
+    CHUNKED_TABLE_DTYPE,
+    CHUNKED_TRAILER,
+    CHUNKED_VERSION,
+)
+
+# numpy dtypes of the PLY scalar types
+_PLY_DTYPES = {
+    "char": "i1",
+    "int8": "i1",
+    "uchar": "u1",
+    "uint8": "u1",
+    "short": "i2",
+    "int16": "i2",
+    "ushort": "u2",
+    "uint16": "u2",
+    "int": "i4",
+    "int32": "i4",
+    "uint": "u4",
+    "uint32": "u4",
+    "float": "f4",
+    "float32": "f4",
+    "double": "f8",
+    "float64": "f8",
+}
+
+
+def _parse_ply_header(
+    buffer: mmap.mmap,
+) -> Dict[str, Tuple[int, int, List[Tuple[str, str]]]]:
+    """Parse the header of a binary little endian PLY file.
+
+    Args:
+        buffer (mmap.mmap): The mapped file.
+
+    Returns:
+        For each element name, its byte offset in the file, its count and its
+        list of (name, numpy dtype) properties.
+    """
+    end = buffer.find(b"end_header\n")
+    if not buffer[:4] == b"ply\n" or end < 0:
+        raise ValueError("Not a PLY file.")
+    offset = end + len(b"end_header\n")
+
+    elements = {}
+    order = []
+    for line in buffer[:end].decode("ascii").splitlines()[1:]:
+        tokens = line.split()
+        if not tokens or tokens[0] in ("comment", "obj_info"):
+            continue
+        if tokens[0] == "format":
+            if tokens[1] != "binary_little_endian":
+                raise ValueError(f"Unsupported PLY format: {tokens[1]}")
+        elif tokens[0] == "element":
+            order.append(tokens[1])
+            elements[tokens[1]] = [0, int(tokens[2]), []]
+        elif tokens[0] == "property":
+            if tokens[1] == "list":
+                raise ValueError("PLY list properties are not supported.")
+            elements[order[-1]][2].append((tokens[2], _PLY_DTYPES[tokens[1]]))
+
+    # the elements are stored one after the other
+    for name in order:
+        elements[name][0] = offset
+        row_size = sum(np.dtype(dtype).itemsize for _, dtype in elements[name][2])
+        offset += elements[name][1] * row_size
+    if offset > len(buffer):
+        raise ValueError("The PLY file is truncated.")
+    return {k: tuple(v) for k, v in elements.items()}
+
+
+def _frombuffer(
+    buffer: mmap.mmap, dtype: torch.dtype, shape: Tuple[int, ...], offset: int
+) -> torch.Tensor:
+    """A tensor viewing the mapped file, or an empty one."""
+    count = int(np.prod(shape))
+    if count == 0:
+        return torch.empty(shape, dtype=dtype)
+    return torch.frombuffer(buffer, dtype=dtype, count=count, offset=offset).view(
+        shape
+    )
+
+
+def _load_ply(
+    buffer: mmap.mmap, elements: Dict[str, Tuple[int, int, List[Tuple[str, str]]]]
+) -> Dict[str, torch.Tensor]:
+    offset, num_splats, properties = elements["vertex"]
+    names = [name for name, _ in properties]
+    columns = {name: i for i, name in enumerate(names)}
+
+    if all(dtype == "f4" for _, dtype in properties):
+        # zero-copy: a [N, D] tensor on the mapped file, sliced below
+        data = _frombuffer(buffer, torch.float32, (num_splats, len(names)), offset)
+    else:
+        records = np.frombuffer(
+            buffer,
+            dtype=np.dtype([(name, "<" + dtype) for name, dtype in properties]),
+            count=num_splats,
+            offset=offset,
+        )
+        data = torch.from_numpy(
+            np.stack([records[name].astype(np.float32) for name in names], axis=-1)
+        )
+
+    def gather(names: List[str]) -> torch.Tensor:
+        # a strided view when the properties are adjacent
+        idxs = [columns[name] for name in names]
+        if idxs == list(range(idxs[0], idxs[0] + len(idxs))):
+            return data[:, idxs[0] : idxs[0] + len(idxs)]
+        return data[:, idxs]
+
+    # f_rest_* are stored channel by channel
+    num_rest = sum(name.startswith("f_rest_") for name in names)
+    assert num_rest % 3 == 0, f"Expected 3 channels of f_rest, got {num_rest}"
+    if num_rest > 0:
+        shN = gather([f"f_rest_{i}" for i in range(num_rest)])
+    else:
+        shN = data.new_empty((num_splats, 0))
+    return {
+        "means": gather(["x", "y", "z"]),
+        "scales": gather([f"scale_{i}" for i in range(3)]),
+        "quats": gather([f"rot_{i}" for i in range(4)]),
+        "opacities": data[:, columns["opacity"]],
+        "sh0": gather([f"f_dc_{i}" for i in range(3)]).unsqueeze(1),
+        "shN": shN.unflatten(1, (3, num_rest // 3)).transpose(1, 2),
+    }
+
+
+def _decode_ply_compressed(
+    bounds: torch.Tensor, vertices: torch.Tensor, sh: torch.Tensor
+) -> Dict[str, torch.Tensor]:
+    means, scales, quats, opacities, sh0, shN = _make_lazy_cuda_func(
+        "decode_ply_compressed"
+    )(bounds, vertices, sh)
+    return {
+        "means": means,
+        "scales": scales,
+        "quats": quats,
+        "opacities": opacities,
+        "sh0": sh0,
+        "shN": shN,
+    }
+
+
+def _load_ply_compressed(
+    buffer: mmap.mmap, elements: Dict[str, Tuple[int, int, List[Tuple[str, str]]]]
+) -> Dict[str, torch.Tensor]:
+    chunk_offset, num_chunks, _ = elements["chunk"]
+    vertex_offset, num_splats, _ = elements["vertex"]
+    sh_offset, _, sh_properties = elements.get("sh", (0, num_splats, []))
+    chunks = _frombuffer(buffer, torch.float32, (num_chunks, 18), chunk_offset)
+    # the packed uint32 words are passed as int32 bits
+    vertices = _frombuffer(buffer, torch.int32, (num_splats, 4), vertex_offset)
+    sh = _frombuffer(buffer, torch.uint8, (num_splats, len(sh_properties)), sh_offset)
+    return _decode_ply_compressed(chunks, vertices, sh)
+
+
+def _load_splat(buffer: mmap.mmap) -> Dict[str, torch.Tensor]:
+    # 3 float means, 3 float scales, 4 uint8 colors and 4 uint8 rotations
+    num_splats = len(buffer) // 32
+    floats = _frombuffer(buffer, torch.float32, (num_splats, 8), 0)
+    data = _frombuffer(buffer, torch.uint8, (num_splats, 32), 0)
+
+    C0 = 0.28209479177387814
+    colors = data[:, 24:28].float() / 255
+    return {
+        "means": floats[:, 0:3],
+        "scales": torch.log(floats[:, 3:6]),
+        "quats": (data[:, 28:32].float() - 128) / 128,
+        "opacities": torch.logit(colors[:, 3], eps=1e-6),
+        "sh0": ((colors[:, :3] - 0.5) / C0).unsqueeze(1),
+        "shN": floats.new_empty((num_splats, 0, 3)),
+    }
+
+
+class ChunkedSplats:
+    """The splats of a chunked file, decoded chunk by chunk on demand.
+
+    The file written by :func:`gsplat.export_splats` with the "chunked" format
+    is memory mapped and only its table of chunks is read when opening it. The
+    chunks are decoded into :attr:`splats` by :meth:`fetch`, typically the ones
+    returned by :meth:`cull` for the current camera, first up to a low SH degree
+    and later up to the full one. The tensors of :attr:`splats` are allocated
+    for all the splats, but their memory is only committed by the operating
+    system as the chunks are decoded into it.
+
+    Chunk `i` holds the splats `256 * i` to `256 * i + counts[i]` of
+    :attr:`splats`, in Morton order.
+
+    Args:
+        path (str): Input file path.
+
+    Attributes:
+        num_splats (int): Number of splats.
+        num_chunks (int): Number of chunks.
+        sh_degree (int): Degree of the spherical harmonics.
+        bounds (torch.Tensor): The min/max of the means, scales and colors of
+            every chunk. The first 6 values are the bounding box of the chunk.
+            Shape (num_chunks, 18)
+        counts (torch.Tensor): Number of splats of every chunk. Shape (num_chunks,)
+        sh_masks (torch.Tensor): For every chunk, the bit `d - 1` is set when
+            the SH band of degree `d` is stored. Other bands are zero.
+            Shape (num_chunks,)
+        loaded_sh_degree (torch.Tensor): The SH degree up to which every chunk
+            is decoded, -1 if it is not. Shape (num_chunks,)
+        splats (Dict[str, torch.Tensor]): The decoded splats, with the same keys
+            and shapes as the output of :func:`gsplat.import_splats`.
+    """
+
+    def __init__(self, path: str):
+        with open(str(path), "rb") as f:
+            self._buffer = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_COPY)
+        magic, version, sh_degree, num_splats, num_chunks = (
+            CHUNKED_HEADER.unpack_from(self._buffer, 0)
+        )
+        if magic != CHUNKED_MAGIC:
+            raise ValueError("Not a chunked splat file.")
+        if version != CHUNKED_VERSION:
+            raise ValueError(f"Unsupported chunked file version: {version}")
+        table_offset, _ = CHUNKED_TRAILER.unpack_from(
+            self._buffer, len(self._buffer) - CHUNKED_TRAILER.size
+        )
+        table = np.frombuffer(
+            self._buffer,
+            dtype=CHUNKED_TABLE_DTYPE,
+            count=num_chunks,
+            offset=table_offset,
+        )
+        self.num_splats = num_splats
+        self.num_chunks = num_chunks
+        self.sh_degree = sh_degree
+        self.bounds = torch.from_numpy(table["bounds"].astype(np.float32))
+        self.counts = torch.from_numpy(table["count"].astype(np.int64))
+        self.sh_masks = torch.from_numpy(table["sh_mask"].astype(np.int64))
+        self._offsets = torch.from_numpy(table["offset"].astype(np.int64))
+        self.loaded_sh_degree = torch.full((num_chunks,), -1, dtype=torch.int64)
+
+        # the chunks are 4-byte aligned
+        self._words = _frombuffer(
+            self._buffer, torch.int32, (len(self._buffer) // 4,), 0
+        )
+        self._bytes = _frombuffer(self._buffer, torch.uint8, (len(self._buffer),), 0)
+
+        K = (sh_degree + 1) ** 2 - 1
+        self.splats = {
+            "means": torch.empty(num_splats, 3),
+            "scales": torch.empty(num_splats, 3),
+            "quats": torch.empty(num_splats, 4),
+            "opacities": torch.empty(num_splats),
+            "sh0": torch.empty(num_splats, 1, 3),
+            "shN": torch.empty(num_splats, K, 3),
+        }
+
+    def splat_ids(self, chunk_ids: torch.Tensor) -> torch.Tensor:
+        """The indices in :attr:`splats` of the splats of some chunks.
+
+        Args:
+            chunk_ids (torch.Tensor): Chunk indices. Shape (M,)
+
+        Returns:
+            Splat indices, chunk after chunk. Shape (sum(counts[chunk_ids]),)
+        """
+        rows = torch.arange(CHUNKED_CHUNK_SIZE)
+        ids = chunk_ids[:, None] * CHUNKED_CHUNK_SIZE + rows
+        return ids[rows < self.counts[chunk_ids][:, None]]
+
+    @torch.no_grad()
+    def cull(
+        self,
+        viewmat: torch.Tensor,
+        K: torch.Tensor,
+        width: int,
+        height: int,
+        near_plane: float = 0.01,
+        far_plane: float = 1e10,
+    ) -> torch.Tensor:
+        """The chunks whose bounding box intersects the frustum of a pinhole
+        camera, from the largest on screen to the smallest, so that fetching
+        them in order refines the view coarse-to-fine. The box of the means is
+        widened by the 3.33-sigma extent of the largest scale of the chunk.
+
+        Args:
+            viewmat (torch.Tensor): World-to-camera matrix. Shape (4, 4)
+            K (torch.Tensor): Camera intrinsics. Shape (3, 3)
+            width (int): Image width.
+            height (int): Image height.
+            near_plane (float): Near plane distance. Default: 0.01
+            far_plane (float): Far plane distance. Default: 1e10
+
+        Returns:
+            Chunk indices. Shape (M,)
+        """
+        viewmat = viewmat.detach().float().cpu()
+        K = K.detach().float().cpu()
+        # the splats reach beyond their means, up to the largest log-scale
+        radii = GAUSSIAN_EXTENT * torch.exp(self.bounds[:, 9:12]).amax(dim=-1)
+        lo = self.bounds[:, None, 0:3] - radii[:, None, None]
+        hi = self.bounds[:, None, 3:6] + radii[:, None, None]
+        bits = torch.tensor([[i & 1, i >> 1 & 1, i >> 2 & 1] for i in range(8)])
+        corners = torch.where(bits.bool(), hi, lo)  # [C, 8, 3]
+        x, y, z = (corners @ viewmat[:3, :3].T + viewmat[:3, 3]).unbind(-1)
+
+        # pixel coordinates times the depth, inside when all the values are <= 0
+        u = K[0, 0] * x + K[0, 2] * z
+        v = K[1, 1] * y + K[1, 2] * z
+        outside = torch.stack(
+            [near_plane - z, z - far_plane, -u, u - width * z, -v, v - height * z]
+        )
+        # culled when all the corners are outside of the same plane
+        visible = ~(outside > 0).all(dim=-1).any(dim=0)
+
+        chunk_ids = torch.where(visible)[0]
+        sizes = (hi - lo)[chunk_ids, 0].norm(dim=-1)
+        depths = z[chunk_ids].mean(dim=-1).clamp(min=near_plane)
+        return chunk_ids[torch.argsort(sizes / depths, descending=True)]
+
+    @torch.no_grad()
+    def fetch(
+        self, chunk_ids: torch.Tensor, sh_degree: Optional[int] = None
+    ) -> torch.Tensor:
+        """Decode the chunks that are not decoded up to an SH degree yet.
+
+        Args:
+            chunk_ids (torch.Tensor): Chunk indices. Shape (M,)
+            sh_degree (int): The SH degree to decode up to, the higher bands of
+                :attr:`splats` are left at zero. Default: the degree of the file.
+
+        Returns:
+            The indices in :attr:`splats` of the splats of the chunks, see
+            :meth:`splat_ids`.
+        """
+        if sh_degree is None:
+            sh_degree = self.sh_degree
+        sh_degree = min(sh_degree, self.sh_degree)
+        chunk_ids = chunk_ids.cpu().long()
+        ids = torch.unique(chunk_ids)
+        ids = ids[self.loaded_sh_degree[ids] < sh_degree]
+        # in batches to bound the size of the gather indices
+        for batch in ids.split(1024):
+            self._decode(batch, sh_degree)
+        self.loaded_sh_degree[ids] = sh_degree
+        return self.splat_ids(chunk_ids)
+
+    def _decode(self, ids: torch.Tensor, sh_degree: int) -> None:
+        # padded to 256 splats per chunk for the decoder
+        M, S = len(ids), CHUNKED_CHUNK_SIZE
+        rows = torch.arange(S)
+        counts = self.counts[ids]
+        valid = rows < counts[:, None]  # [M, S]
+
+        # 4 packed words per splat at the start of the chunk
+        words = (self._offsets[ids] // 4)[:, None, None] + rows[:, None] * 4
+        words = words + torch.arange(4)
+        vertices = self._words[torch.where(valid[..., None], words, 0)]
+
+        # then the stored SH bands, the others are zero (quantized to 128)
+        K = (self.sh_degree + 1) ** 2 - 1
+        sh = torch.full((M, S, 3, K), 128, dtype=torch.uint8)
+        offsets = self._offsets[ids] + counts * 16
+        for d in range(1, self.sh_degree + 1):
+            width = 3 * (2 * d + 1)
+            stored = (self.sh_masks[ids] >> (d - 1) & 1).bool()
+            if d <= sh_degree and stored.any():
+                idxs = offsets[stored][:, None, None] + rows[:, None] * width
+                idxs = idxs + torch.arange(width)
+                idxs = torch.where(valid[stored][..., None], idxs, 0)
+                band = self._bytes[idxs].view(-1, S, 3, 2 * d + 1)
+                sh[stored, :, :, d * d - 1 : (d + 1) ** 2 - 1] = band
+            offsets = offsets + stored * counts * width
+
+        decoded = _decode_ply_compressed(
+            self.bounds[ids].contiguous(),
+            vertices.view(M * S, 4),
+            sh.view(M * S, 3 * K),
+        )
+        dst = (ids[:, None] * S + rows)[valid]
+        for k, v in decoded.items():
+            self.splats[k].index_copy_(0, dst, v[valid.view(-1)])
+
+
+def import_splats(
+    path: str,
+    format: Optional[Literal["ply", "splat", "ply_compressed", "chunked"]] = None,
+) -> Dict[str, torch.Tensor]:
+    """Import a Gaussian Splats model written by :func:`gsplat.export_splats`,
+    or any binary PLY file with the same properties.
+
+    The file is memory mapped instead of read, so that the loading time does
+    not grow with the size of the file:
+
+    - ply: The tensors are (non-contiguous) views of the mapped file, and the
+      data is only read when they are accessed. The mapping is private: writing
+      to the tensors does not modify the file.
+    - ply_compressed: The chunks are decoded in parallel by a native decoder.
+      The splats are in the Morton order of the file and the values are
+      quantized.
+    - splat: The means are views of the mapped file. The other values are
+      converted back from the 8-bit colors and rotations and there are no
+      higher order SH coefficients.
+    - chunked: All the chunks are decoded, see :class:`gsplat.ChunkedSplats`
+      to decode them on demand.
+
+    Args:
+        path (str): Input file path.
+        format (str): Import format. Options: "ply", "splat", "ply_compressed",
+            "chunked". Default: inferred from the header, or from the ".splat"
+            extension.
+
+    Returns:
+        A dictionary of CPU tensors, with the same keys and shapes as the
+        arguments of :func:`gsplat.export_splats`:
+
+        - **means**. Splat means. Shape (N, 3)
+        - **scales**. Splat scales. Shape (N, 3)
+        - **quats**. Splat quaternions. Shape (N, 4)
+        - **opacities**. Splat opacities. Shape (N,)
+        - **sh0**. Spherical harmonics. Shape (N, 1, 3)
+        - **shN**. Spherical harmonics. Shape (N, K, 3)
+    """
+    path = str(path)
+    with open(path, "rb") as f:
+        # the tensors keep a reference to the mapping, which outlives the file
+        buffer = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_COPY)
+
+    if format is None and buffer[: len(CHUNKED_MAGIC)] == CHUNKED_MAGIC:
+        format = "chunked"
+    if format is None:
+        format = "splat" if path.endswith(".splat") else "ply"
+    if format == "splat":
+        return _load_splat(buffer)
+    if format == "chunked":
+        chunked = ChunkedSplats(path)
+        chunked.fetch(torch.arange(chunked.num_chunks))
+        return chunked.splats
+
+    elements = _parse_ply_header(buffer)
+    if format == "ply" and "chunk" in elements:
+        format = "ply_compressed"
+    if format == "ply":
+        return _load_ply(buffer, elements)
+    elif format == "ply_compressed":
+        return _load_ply_compressed(buffer, elements)
+    else:
+        raise ValueError(f"Unsupported format: {format}")
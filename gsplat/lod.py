@@ -0,0 +1,185 @@
+from dataclasses import dataclass
+from typing import Tuple
+
+import torch
+from torch import Tensor
+
+from .cuda._wrapper import _make_lazy_cuda_func
+
+
+@dataclass
+class LODTree:
+    """A level-of-detail hierarchy over a set of Gaussians.
+
+    The N input Gaussians are the leaves of the tree, with node ids [0, N). The
+    M inner nodes have ids [N, N + M) and the root is the last node. Every inner
+    node is a single Gaussian matched to the first and second moments of its
+    children, weighted by their opacity times their projected area, and its
+    colors are the weighted average of the children colors (which is exact for
+    SH coefficients since they are linear).
+
+    The tree is built and cut on CPU. Only the inner nodes are stored, the
+    leaves are read from the live Gaussian parameters when the tree is cut, so
+    gradients flow to every leaf that is part of a cut.
+    """
+
+    n_leaves: int
+    node_means: Tensor  # [M, 3]
+    node_quats: Tensor  # [M, 4]
+    node_scales: Tensor  # [M, 3]
+    node_opacities: Tensor  # [M]
+    node_colors: Tensor  # [M, ...]
+    child_offsets: Tensor  # [M + 1], int64
+    children: Tensor  # [N + M - 1], int64
+    bounds: Tensor  # [N + M, 4], bounding spheres (center, radius)
+
+    @property
+    def n_nodes(self) -> int:
+        return self.bounds.shape[0]
+
+    def cut(
+        self,
+        viewmats: Tensor,  # [C, 4, 4]
+        Ks: Tensor,  # [C, 3, 3]
+        pixel_size: float = 1.0,
+        near_plane: float = 0.01,
+    ) -> Tensor:
+        """Select the coarsest nodes that are at most `pixel_size` pixels large
+        in every camera.
+
+        A node is replaced by its children while the diameter of its bounding
+        sphere projects to more than `pixel_size` pixels in any of the cameras,
+        or while the sphere reaches closer than `near_plane` to a camera. The
+        selected nodes cover every leaf exactly once.
+
+        Args:
+            viewmats: World-to-camera matrices. [C, 4, 4]
+            Ks: Camera intrinsics. [C, 3, 3]
+            pixel_size: Largest on-screen size in pixels of a selected inner
+                node. Default is 1.0.
+            near_plane: Near plane distance. Default is 0.01.
+
+        Returns:
+            The ids of the selected nodes. [K], int64, on the device of the
+            viewmats.
+        """
+        assert viewmats.dim() == 3 and viewmats.shape[1:] == (4, 4), viewmats.shape
+        assert Ks.shape == viewmats.shape[:1] + (3, 3), Ks.shape
+        dtype = self.bounds.dtype
+        node_ids = _make_lazy_cuda_func("lod_tree_cut")(
+            self.bounds,
+            self.child_offsets,
+            self.children,
+            viewmats.detach().to("cpu", dtype).contiguous(),
+            Ks.detach().to("cpu", dtype).contiguous(),
+            pixel_size,
+            near_plane,
+        )
+        return node_ids.to(viewmats.device)
+
+    def gather(
+        self,
+        node_ids: Tensor,  # [K]
+        means: Tensor,  # [N, 3]
+        quats: Tensor,  # [N, 4]
+        scales: Tensor,  # [N, 3]
+        opacities: Tensor,  # [N]
+        colors: Tensor,  # [N, ...]
+    ) -> Tuple[Tensor, Tensor, Tensor, Tensor, Tensor, Tensor]:
+        """Gather the Gaussians of a set of nodes.
+
+        The leaves come first, in the order they appear in `node_ids`, followed
+        by the inner nodes.
+
+        Returns:
+            A tuple:
+
+            **node_ids**: The node ids in the order of the gathered Gaussians. [K]
+
+            **means**, **quats**, **scales**, **opacities**, **colors**: The
+            Gaussians of the nodes. [K, 3], [K, 4], [K, 3], [K], [K, ...]
+        """
+        N = self.n_leaves
+        assert means.shape[0] == N, (means.shape, N)
+        is_leaf = node_ids < N
+        leaf_ids = node_ids[is_leaf]
+        inner_ids = (node_ids[~is_leaf] - N).cpu()
+
+        def cat(leaf_values: Tensor, node_values: Tensor) -> Tensor:
+            node_values = node_values[inner_ids].to(leaf_values)
+            return torch.cat([leaf_values[leaf_ids], node_values], dim=0)
+
+        return (
+            torch.cat([leaf_ids, inner_ids.to(leaf_ids) + N]),
+            cat(means, self.node_means),
+            cat(quats, self.node_quats),
+            cat(scales, self.node_scales),
+            cat(opacities, self.node_opacities),
+            cat(colors, self.node_colors),
+        )
+
+
+@torch.no_grad()
+def build_lod_tree(
+    means: Tensor,  # [N, 3]
+    quats: Tensor,  # [N, 4]
+    scales: Tensor,  # [N, 3]
+    opacities: Tensor,  # [N]
+    colors: Tensor,  # [N, ...]
+) -> LODTree:
+    """Build a level-of-detail tree over a set of Gaussians.
+
+    The Gaussians are sorted along a Morton curve of their means and grouped
+    bottom-up by octree cell, at most 8 children per node. Each inner node is
+    the moment-matched merge of its children, see :class:`LODTree`.
+
+    The tree is built on CPU and stays there, whatever the input device. It has
+    to be rebuilt when the Gaussians change.
+
+    Args:
+        means: The 3D centers of the Gaussians. [N, 3]
+        quats: The quaternions (wxyz convension) of the Gaussians. [N, 4]
+        scales: The scales of the Gaussians. [N, 3]
+        opacities: The opacities of the Gaussians, after activation. [N]
+        colors: The colors or SH coefficients of the Gaussians. [N, ...]
+
+    Returns:
+        The :class:`LODTree`.
+    """
+    N = means.shape[0]
+    assert means.shape == (N, 3), means.shape
+    assert quats.shape == (N, 4), quats.shape
+    assert scales.shape == (N, 3), scales.shape
+    assert opacities.shape == (N,), opacities.shape
+    assert colors.shape[0] == N, colors.shape
+
+    def to_cpu(x: Tensor) -> Tensor:
+        return x.detach().to("cpu", means.dtype).contiguous()
+
+    (
+        node_means,
+        node_quats,
+        node_scales,
+        node_opacities,
+        node_colors,
+        child_offsets,
+        children,
+        bounds,
+    ) = _make_lazy_cuda_func("lod_tree_build")(
+        to_cpu(means),
+        to_cpu(quats),
+        to_cpu(scales),
+        to_cpu(opacities),
+        to_cpu(colors.reshape(N, -1)),
+    )
+    return LODTree(
+        n_leaves=N,
+        node_means=node_means,
+        node_quats=node_quats,
+        node_scales=node_scales,
+        node_opacities=node_opacities,
+        node_colors=node_colors.reshape(-1, *colors.shape[1:]),
+        child_offsets=child_offsets,
+        children=children,
+        bounds=bounds,
+    )
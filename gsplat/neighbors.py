@@ -0,0 +1,132 @@
+from dataclasses import dataclass
+from typing import Tuple
+
+import torch
+from torch import Tensor
+
+from .cuda._wrapper import _make_lazy_cuda_func
+
+
+@dataclass
+class KdTree:
+    """A k-d tree over a set of 3D points, for exact nearest neighbor queries.
+
+    The points are split at the median of the axis of largest extent down to
+    buckets of `leaf_size`, and every node keeps the bounding box of its points.
+    The build and the queries run in parallel on CPU, and the tree can be
+    queried any number of times, e.g. to initialize the scales of the Gaussians
+    from a point cloud and then to find floaters far from their neighbors.
+    """
+
+    leaf_size: int
+    order: Tensor  # [N], int64
+    points: Tensor  # [N, 3], in the tree order
+    node_bounds: Tensor  # [2P, 6], (min, max) corners
+
+    @property
+    def n_points(self) -> int:
+        return self.order.shape[0]
+
+    @torch.no_grad()
+    def query(
+        self,
+        queries: Tensor,  # [M, 3]
+        k: int = 4,
+    ) -> Tuple[Tensor, Tensor]:
+        """Find the k nearest points of every query.
+
+        Args:
+            queries: The query points. [M, 3]
+            k: Number of neighbors. Default is 4.
+
+        Returns:
+            A tuple, on the device of the queries:
+
+            **distances**: The Euclidean distances to the neighbors, sorted in
+            increasing order. [M, k]
+
+            **indices**: The indices of the neighbors in the points the tree was
+            built from. [M, k]
+
+            If the tree has fewer than k points, the missing neighbors have an
+            infinite distance and an index of -1.
+        """
+        assert queries.dim() == 2 and queries.shape[1] == 3, queries.shape
+        distances, indices = _make_lazy_cuda_func("kdtree_query")(
+            self.order,
+            self.points,
+            self.node_bounds,
+            self.leaf_size,
+            queries.detach().to("cpu", torch.float32).contiguous(),
+            k,
+        )
+        return distances.to(queries.device), indices.to(queries.device)
+
+    @torch.no_grad()
+    def query_self(self, k: int = 4) -> Tuple[Tensor, Tensor]:
+        """Find the k nearest points of every point of the tree, itself included.
+
+        The points are queried in the tree order, where neighbors are close in
+        memory, which is faster than :meth:`query` with the same points.
+
+        Returns:
+            A tuple **distances** and **indices**, as in :meth:`query`, in the
+            order of the points the tree was built from, on CPU. [N, k]
+        """
+        distances, indices = _make_lazy_cuda_func("kdtree_query")(
+            self.order,
+            self.points,
+            self.node_bounds,
+            self.leaf_size,
+            self.points,
+            k,
+        )
+        inverse = torch.empty_like(self.order)
+        inverse[self.order] = torch.arange(self.n_points)
+        return distances[inverse], indices[inverse]
+
+
+@torch.no_grad()
+def build_kdtree(
+    points: Tensor,  # [N, 3]
+    leaf_size: int = 16,
+) -> KdTree:
+    """Build a :class:`KdTree` over a set of points.
+
+    Args:
+        points: The 3D points, e.g. the means of the Gaussians. [N, 3]
+        leaf_size: Number of points per leaf of the tree. Default is 16.
+
+    Returns:
+        The :class:`KdTree`, on CPU.
+    """
+    assert points.dim() == 2 and points.shape[1] == 3, points.shape
+    points = points.detach().to("cpu", torch.float32).contiguous()
+    order, sorted_points, node_bounds = _make_lazy_cuda_func("kdtree_build")(
+        points, leaf_size
+    )
+    return KdTree(
+        leaf_size=leaf_size, order=order, points=sorted_points, node_bounds=node_bounds
+    )
+
+
+@torch.no_grad()
+def knn(
+    points: Tensor,  # [N, 3]
+    k: int = 4,
+) -> Tensor:
+    """Distances of every point to its k nearest points, itself included.
+
+    This is a drop-in replacement of the `sklearn.neighbors.NearestNeighbors`
+    query used to initialize the scales of the Gaussians from a point cloud.
+
+    Args:
+        points: The 3D points. [N, 3]
+        k: Number of neighbors. Default is 4.
+
+    Returns:
+        The distances in increasing order, on the device and with the dtype of
+        `points`. [N, k]
+    """
+    distances, _ = build_kdtree(points).query_self(k)
+    return distances.to(points)
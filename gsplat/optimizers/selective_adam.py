@@ -13,8 +13,8 @@ class SelectiveAdam(torch.optim.Adam):
     parameter visibility is controlled by an external mask.
 
     Additionally, the operations are fused into a single kernel. This optimizer
-    leverages the `adam` function from a CUDA backend for
-    optimized sparse updates.
+    leverages the `adam` function from the CUDA backend for
+    optimized sparse updates, which also runs on CPU parameters.
 
     This is one of the two optimizers mentioned in the Taming3DGS paper.
 
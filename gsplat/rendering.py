@@ -13,6 +13,7 @@ from .cuda._wrapper import (
     FThetaPolynomialType,
     fully_fused_projection,
     fully_fused_projection_2dgs,
+    fully_fused_projection_storage,
     fully_fused_projection_with_ut,
     isect_offset_encode,
     isect_tiles,
@@ -20,13 +21,17 @@ from .cuda._wrapper import (
     rasterize_to_pixels_2dgs,
     rasterize_to_pixels_eval3d,
     spherical_harmonics,
+    spherical_harmonics_storage,
 )
+from .culling import FrustumIndex
 from .distributed import (
     all_gather_int32,
     all_gather_tensor_list,
     all_to_all_int32,
     all_to_all_tensor_list,
 )
+from .lod import LODTree
+from .storage import Dequantization, dequantize
 from .utils import depth_to_normal, get_projection_matrix
 
 
@@ -67,6 +72,13 @@ def rasterization(
     # rolling shutter
     rolling_shutter: RollingShutterType = RollingShutterType.GLOBAL,
     viewmats_rs: Optional[Tensor] = None,  # [..., C, 4, 4]
+    # level of detail
+    lod_tree: Optional[LODTree] = None,
+    lod_pixel_size: float = 1.0,
+    # frustum culling
+    frustum_index: Optional[FrustumIndex] = None,
+    # compact storage
+    dequantization: Optional[Dequantization] = None,
 ) -> Tuple[Tensor, Tensor, Dict]:
     """Rasterize a set of 3D Gaussians (N) to a batch of image planes (C).
 
@@ -155,6 +167,15 @@ def rasterization(
         reference from the paper `3DGUT: Enabling Distorted Cameras and Secondary Rays in Gaussian Splatting
         <https://arxiv.org/abs/2412.12507>`_.
 
+    .. note::
+        **Compact Storage**: For inference, the Gaussians can be stored in float16 or
+        uint8 (see :func:`gsplat.quantize_gaussians`), which is inferred from the dtype
+        of `means`. The attributes are read and dequantized by the projection and
+        spherical harmonics kernels, which compute in float32, so no float32 copy of the
+        Gaussians is made. This is not differentiable, and only supported without
+        batch dimensions, per-camera colors, `covars`, UT, eval3d, LOD, frustum culling
+        or distributed mode.
+
     .. warning::
         This function is currently not differentiable w.r.t. the camera intrinsics `Ks`.
 
@@ -223,6 +244,23 @@ def rasterization(
         rolling_shutter: The rolling shutter type. Default `RollingShutterType.GLOBAL` means
             global shutter.
         viewmats_rs: The second viewmat when rolling shutter is used. Default is None.
+        lod_tree: A level-of-detail tree built with `gsplat.lod.build_lod_tree()` over
+            the input Gaussians. If provided, the tree is cut for the cameras so that
+            distant groups of Gaussians are replaced by their merged parents before the
+            projection, and `meta["lod_ids"]` holds the tree node of every rendered
+            Gaussian (ids >= N are merged nodes). Only supported without batch
+            dimensions, per-camera colors, `covars` or distributed mode. Default is None.
+        lod_pixel_size: Largest on-screen size in pixels of a merged node when
+            `lod_tree` is provided. Default is 1.0.
+        frustum_index: A spatial index built with `gsplat.culling.build_frustum_index()`
+            over the input Gaussians. If provided, only the Gaussians whose bounding
+            sphere intersects the view frustum of one of the cameras are passed to the
+            projection. `meta["gaussian_ids"]` still refers to the input Gaussians.
+            Only supported with `packed=True`, without batch dimensions, per-camera
+            colors, `covars`, `lod_tree` or distributed mode. Default is None.
+        dequantization: The per-chunk scales and offsets returned by
+            `gsplat.quantize_gaussians()` when the Gaussians are stored in uint8. In
+            that case `scales` are log-scales. Default is None.
 
     Returns:
         A tuple:
@@ -357,6 +395,77 @@ def rasterization(
         assert packed is False, "Packed mode is not supported with UT."
         assert sparse_grad is False, "Sparse grad is not supported with UT."
 
+    # Gaussians stored in float16 or uint8, for inference
+    storage = means.dtype in (torch.float16, torch.uint8)
+    if storage:
+        assert batch_dims == (), "Compact storage does not support batch dimensions."
+        assert covars is None, "Compact storage requires to provide quats and scales."
+        assert not (with_ut or with_eval3d), "Compact storage does not support UT."
+        assert lod_tree is None, "Compact storage is not supported with LOD."
+        assert frustum_index is None, "Compact storage is not supported with culling."
+        assert not distributed, "Compact storage is not supported in distributed mode."
+        assert colors.dim() == (
+            2 if sh_degree is None else 3
+        ), "Compact storage only supports per-Gaussian colors."
+        assert not torch.is_grad_enabled() or not any(
+            x.requires_grad for x in (means, quats, scales, opacities, colors)
+        ), "Compact storage is not differentiable."
+        assert (dequantization is not None) == (
+            means.dtype == torch.uint8
+        ), "dequantization is required if and only if the Gaussians are uint8."
+    else:
+        assert dequantization is None, "dequantization requires uint8 Gaussians."
+    if dequantization is not None:
+        chunk_size = dequantization.chunk_size
+        dequant_geometry = dequantization.geometry.to(device)
+        dequant_colors = dequantization.colors.to(device)
+    else:
+        chunk_size = 0
+        dequant_geometry, dequant_colors = None, None
+
+    if lod_tree is not None:
+        assert batch_dims == (), "LOD rendering does not support batch dimensions."
+        assert covars is None, "LOD rendering requires to provide quats and scales."
+        assert not distributed, "LOD rendering is not supported in distributed mode."
+        assert colors.dim() == (
+            2 if sh_degree is None else 3
+        ), "LOD rendering only supports per-Gaussian colors."
+        assert lod_tree.n_leaves == N, (lod_tree.n_leaves, N)
+        node_ids = lod_tree.cut(viewmats, Ks, lod_pixel_size, near_plane)
+        node_ids, means, quats, scales, opacities, colors = lod_tree.gather(
+            node_ids, means, quats, scales, opacities, colors
+        )
+        N = means.shape[0]
+        meta["lod_ids"] = node_ids
+
+    if frustum_index is not None:
+        assert packed, "Frustum culling is only supported in packed mode."
+        assert batch_dims == (), "Frustum culling does not support batch dimensions."
+        assert covars is None, "Frustum culling requires to provide quats and scales."
+        assert lod_tree is None, "Frustum culling is not supported with LOD."
+        assert not distributed, "Frustum culling is not supported in distributed mode."
+        assert colors.dim() == (
+            2 if sh_degree is None else 3
+        ), "Frustum culling only supports per-Gaussian colors."
+        assert frustum_index.n_gaussians == N, (frustum_index.n_gaussians, N)
+        _, candidate_ids = frustum_index.query(
+            viewmats,
+            Ks,
+            width,
+            height,
+            near_plane=near_plane,
+            far_plane=far_plane,
+            camera_model=camera_model,
+        )
+        # union over the cameras, in ascending order
+        is_candidate = torch.zeros(N, dtype=torch.bool, device=device)
+        is_candidate[candidate_ids] = True
+        candidate_ids = torch.where(is_candidate)[0]
+        means, quats, scales, opacities, colors = (
+            x[candidate_ids] for x in (means, quats, scales, opacities, colors)
+        )
+        N = len(candidate_ids)
+
     # Implement the multi-GPU strategy proposed in
     # `On Scaling Up 3D Gaussian Splatting Training <https://arxiv.org/abs/2406.18533>`.
     #
@@ -404,6 +513,29 @@ def rasterization(
             viewmats_rs=viewmats_rs,
         )
 
+    elif storage:
+        # Project the stored Gaussians to 2D, dequantizing them in the kernel, which
+        # also returns the float32 opacities it read.
+        *proj_results, opacities = fully_fused_projection_storage(
+            means,
+            quats,
+            scales,
+            opacities,
+            viewmats,
+            Ks,
+            width,
+            height,
+            dequant=dequant_geometry,
+            chunk_size=chunk_size,
+            eps2d=eps2d,
+            near_plane=near_plane,
+            far_plane=far_plane,
+            radius_clip=radius_clip,
+            packed=packed,
+            calc_compensations=(rasterize_mode == "antialiased"),
+            camera_model=camera_model,
+        )
+
     else:
         # Project Gaussians to 2D. Directly pass in {quats, scales} is faster than precomputing covars.
         proj_results = fully_fused_projection(
@@ -438,14 +570,16 @@ def rasterization(
             conics,
             compensations,
         ) = proj_results
-        opacities = opacities.view(B, N)[batch_ids, gaussian_ids]  # [nnz]
+        if not storage:
+            opacities = opacities.view(B, N)[batch_ids, gaussian_ids]  # [nnz]
         image_ids = batch_ids * C + camera_ids
     else:
         # The results are with shape [..., C, N, ...]. Only the elements with radii > 0 are valid.
         radii, means2d, depths, conics, compensations = proj_results
-        opacities = torch.broadcast_to(
-            opacities[..., None, :], batch_dims + (C, N)
-        )  # [..., C, N]
+        if not storage:
+            opacities = torch.broadcast_to(
+                opacities[..., None, :], batch_dims + (C, N)
+            )  # [..., C, N]
         batch_ids, camera_ids, gaussian_ids = None, None, None
         image_ids = None
 
@@ -468,7 +602,32 @@ def rasterization(
     )
 
     # Turn colors into [..., C, N, D] or [..., nnz, D] to pass into rasterize_to_pixels()
-    if sh_degree is None:
+    if storage:
+        # The stored colors are per-Gaussian, with shape [N, D] or [N, K, 3]
+        if sh_degree is None:
+            # the unpacked rasterization reads float32 colors: they are converted
+            # once per Gaussian and broadcast to the cameras
+            colors = dequantize(colors, gaussian_ids, dequant_colors, chunk_size)
+            if not packed:
+                colors = torch.broadcast_to(colors[None], (C, N, colors.shape[-1]))
+        else:
+            # the directions are computed in the kernel from the stored means
+            campos = torch.inverse(viewmats.float())[..., :3, 3]  # [C, 3]
+            colors = spherical_harmonics_storage(
+                sh_degree,
+                means,
+                colors,
+                campos,
+                camera_ids,
+                gaussian_ids,
+                dequant_geometry,
+                dequant_colors,
+                chunk_size,
+                masks=None if packed else (radii > 0).all(dim=-1),
+            )  # [nnz, 3] or [C, N, 3]
+            # make it apple-to-apple with Inria's CUDA Backend.
+            colors = torch.clamp_min(colors + 0.5, 0.0)
+    elif sh_degree is None:
         # Colors are post-activation values, with shape [..., N, D] or [..., C, N, D]
         if packed:
             if colors.dim() == num_batch_dims + 2:
@@ -767,6 +926,10 @@ def rasterization(
             dim=-1,
         )
 
+    if frustum_index is not None:
+        # map the ids back to the input Gaussians
+        meta["gaussian_ids"] = candidate_ids[meta["gaussian_ids"]]
+
     return render_colors, render_alphas, meta
 
 
@@ -0,0 +1,170 @@
+from dataclasses import dataclass
+from typing import Optional, Tuple
+
+import torch
+import torch.nn.functional as F
+from torch import Tensor
+
+# The channels of the geometry in `Dequantization.geometry`, as laid out in
+# `Utils.cuh`: means, quats, log-scales and opacities.
+GEOMETRY_CHANNELS = 11
+MEANS_OFFSET = 0
+QUATS_OFFSET = 3
+SCALES_OFFSET = 7
+OPACITIES_OFFSET = 10
+
+
+@dataclass
+class Dequantization:
+    """The per-chunk scales and offsets of Gaussians stored in uint8.
+
+    The Gaussians are cut into chunks of `chunk_size` consecutive Gaussians, and every
+    channel of every chunk is dequantized as `value * scale + offset`. The scales and
+    offsets are stored in `[n_chunks, 2, D]` tensors, where `[:, 0]` are the scales and
+    `[:, 1]` the offsets.
+    """
+
+    chunk_size: int
+    geometry: Tensor  # [n_chunks, 2, 11], means, quats, log-scales, opacities
+    colors: Tensor  # [n_chunks, 2, D], colors or flattened SH coefficients
+
+    def to(self, device: torch.device) -> "Dequantization":
+        return Dequantization(
+            self.chunk_size, self.geometry.to(device), self.colors.to(device)
+        )
+
+
+def _quantize_chunks(x: Tensor, chunk_size: int) -> Tuple[Tensor, Tensor]:
+    """Quantize [N, D] values to uint8 with a scale and an offset per channel for
+    each chunk of `chunk_size` rows."""
+    N, D = x.shape
+    n_chunks = (N + chunk_size - 1) // chunk_size
+    # pad the last chunk with its last row so that it does not widen the range
+    padding = x[-1:].expand(n_chunks * chunk_size - N, D)
+    chunks = torch.cat([x, padding]).view(n_chunks, chunk_size, D)
+    mins = chunks.amin(dim=1)  # [n_chunks, D]
+    maxs = chunks.amax(dim=1)  # [n_chunks, D]
+    scales = ((maxs - mins) / 255).clamp_min(1e-12)
+    q = ((chunks - mins[:, None]) / scales[:, None]).round().clamp(0, 255)
+    q = q.to(torch.uint8).view(-1, D)[:N]
+    return q.contiguous(), torch.stack([scales, mins], dim=1)
+
+
+@torch.no_grad()
+def quantize_gaussians(
+    means: Tensor,  # [N, 3]
+    quats: Tensor,  # [N, 4]
+    scales: Tensor,  # [N, 3]
+    opacities: Tensor,  # [N]
+    colors: Tensor,  # [N, D] or [N, K, 3]
+    dtype: torch.dtype = torch.float16,
+    chunk_size: int = 256,
+) -> Tuple[Tensor, Tensor, Tensor, Tensor, Tensor, Optional[Dequantization]]:
+    """Convert Gaussians to a compact storage for inference with
+    :func:`gsplat.rasterization`.
+
+    With `dtype=torch.float16`, the attributes are cast to half precision, which
+    halves their memory footprint. With `dtype=torch.uint8`, every channel is
+    quantized to 8 bits with a scale and an offset per chunk of `chunk_size`
+    consecutive Gaussians, which divides the memory footprint by four. In that case
+    the scales are quantized in log space, the quaternions are normalized first, and
+    the returned :class:`Dequantization` has to be passed to
+    :func:`gsplat.rasterization` along with the Gaussians. Spatially sorting the
+    Gaussians beforehand (e.g. along a Morton curve) tightens the per-chunk ranges.
+
+    The attributes are read and dequantized by the projection and spherical harmonics
+    kernels, which compute in float32.
+
+    Args:
+        means: The 3D centers of the Gaussians. [N, 3]
+        quats: The quaternions of the Gaussians. [N, 4]
+        scales: The scales of the Gaussians (post-activation). [N, 3]
+        opacities: The opacities of the Gaussians (post-activation). [N]
+        colors: The colors [N, D] or the SH coefficients [N, K, 3] of the Gaussians.
+        dtype: The storage type, torch.float16 or torch.uint8. Default: torch.float16.
+        chunk_size: Number of consecutive Gaussians sharing a scale and an offset in
+            uint8 storage. Default: 256.
+
+    Returns:
+        A tuple:
+
+        - **means**, **quats**, **scales**, **opacities**, **colors** in the storage
+          type. For uint8 storage the scales are log-scales.
+        - **dequantization**. A :class:`Dequantization` for uint8 storage, else None.
+    """
+    N = means.shape[0]
+    assert means.shape == (N, 3), means.shape
+    assert quats.shape == (N, 4), quats.shape
+    assert scales.shape == (N, 3), scales.shape
+    assert opacities.shape == (N,), opacities.shape
+    assert colors.shape[0] == N, colors.shape
+    assert chunk_size > 0, chunk_size
+
+    if dtype == torch.float16:
+        return (
+            means.half().contiguous(),
+            quats.half().contiguous(),
+            scales.half().contiguous(),
+            opacities.half().contiguous(),
+            colors.half().contiguous(),
+            None,
+        )
+    assert dtype == torch.uint8, f"Unsupported storage type {dtype}"
+
+    geometry = torch.cat(
+        [
+            means.float(),
+            F.normalize(quats.float(), dim=-1),
+            torch.log(scales.float()),
+            opacities.float()[:, None],
+        ],
+        dim=-1,
+    )  # [N, 11]
+    q_geometry, d_geometry = _quantize_chunks(geometry, chunk_size)
+    q_colors, d_colors = _quantize_chunks(colors.float().reshape(N, -1), chunk_size)
+    return (
+        q_geometry[:, MEANS_OFFSET:QUATS_OFFSET].contiguous(),
+        q_geometry[:, QUATS_OFFSET:SCALES_OFFSET].contiguous(),
+        q_geometry[:, SCALES_OFFSET:OPACITIES_OFFSET].contiguous(),
+        q_geometry[:, OPACITIES_OFFSET].contiguous(),
+        q_colors.view(colors.shape),
+        Dequantization(chunk_size, d_geometry, d_colors),
+    )
+
+
+def dequantize(
+    x: Tensor,  # [N, ...]
+    ids: Optional[Tensor] = None,  # [M]
+    dequant: Optional[Tensor] = None,  # [n_chunks, 2, D]
+    chunk_size: int = 0,
+    offset: int = 0,
+) -> Tensor:
+    """Gather the attributes of the Gaussians `ids` and convert them to float32.
+
+    The uint8 attributes are dequantized with the channels `[offset, offset + X)` of
+    `dequant`, where X is the number of channels of the attribute. If `ids` is None,
+    all the Gaussians are converted, chunk by chunk in place, without an index tensor.
+
+    Returns:
+        The attributes in float32. [M, ...], or [N, ...] if `ids` is None.
+    """
+    if ids is not None:
+        values = x[ids].float()
+    else:
+        values = x.float()
+    if dequant is None:
+        return values
+    shape = values.shape
+    values = values.reshape(shape[0], -1)
+    d = dequant[..., offset : offset + values.shape[1]]
+    if ids is not None:
+        d = d[ids // chunk_size]
+        return (values * d[:, 0] + d[:, 1]).view(shape)
+    # the full chunks, then the last partial one
+    n_full = shape[0] // chunk_size
+    full = values[: n_full * chunk_size].view(n_full, chunk_size, -1)
+    full.mul_(d[:n_full, 0, None]).add_(d[:n_full, 1, None])
+    if n_full * chunk_size < shape[0]:
+        rest = values[n_full * chunk_size :]
+        rest.mul_(d[n_full, 0]).add_(d[n_full, 1])
+    return values.view(shape)
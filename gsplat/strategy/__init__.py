@@ -1,3 +1,4 @@
 from .base import Strategy
 from .default import DefaultStrategy
 from .mcmc import MCMCStrategy
+from .pool import GaussianPool
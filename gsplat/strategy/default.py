@@ -1,11 +1,14 @@
 from dataclasses import dataclass
-from typing import Any, Dict, Tuple, Union
+from typing import Any, Dict, Optional, Tuple, Union
 
 import torch
 from typing_extensions import Literal
 
+from gsplat.cuda._wrapper import densification_stats
+
 from .base import Strategy
 from .ops import duplicate, remove, reset_opa, split
+from .pool import GaussianPool, get_pool
 
 
 @dataclass
@@ -58,6 +61,13 @@ class DefaultStrategy(Strategy):
         key_for_gradient (str): Which variable uses for densification strategy.
           3DGS uses "means2d" gradient and 2DGS uses a similar gradient which stores
           in variable "gradient_2dgs".
+        fused_stats (bool): Accumulate the running state with a single fused kernel
+          instead of a sequence of PyTorch ops. Default is False.
+        pool_capacity (int): If positive, keep the parameters and their optimizer
+          states in a :class:`GaussianPool` with room for this many GSs, so that
+          duplicating, splitting and pruning write in place instead of reallocating
+          every tensor. The pool grows beyond if needed. Note that pruning then changes
+          the order of the GSs. Default is 0 (disabled).
 
     Examples:
 
@@ -92,6 +102,8 @@ class DefaultStrategy(Strategy):
     revised_opacity: bool = False
     verbose: bool = False
     key_for_gradient: Literal["means2d", "gradient_2dgs"] = "means2d"
+    fused_stats: bool = False
+    pool_capacity: int = 0
 
     def initialize_state(self, scene_scale: float = 1.0) -> Dict[str, Any]:
         """Initialize and return the running state for this strategy.
@@ -169,8 +181,10 @@ class DefaultStrategy(Strategy):
             and step % self.refine_every == 0
             and step % self.reset_every >= self.pause_refine_after_reset
         ):
+            pool = get_pool(params, optimizers, state, self.pool_capacity)
+
             # grow GSs
-            n_dupli, n_split = self._grow_gs(params, optimizers, state, step)
+            n_dupli, n_split = self._grow_gs(params, optimizers, state, step, pool)
             if self.verbose:
                 print(
                     f"Step {step}: {n_dupli} GSs duplicated, {n_split} GSs split. "
@@ -178,7 +192,7 @@ class DefaultStrategy(Strategy):
                 )
 
             # prune GSs
-            n_prune = self._prune_gs(params, optimizers, state, step)
+            n_prune = self._prune_gs(params, optimizers, state, step, pool)
             if self.verbose:
                 print(
                     f"Step {step}: {n_prune} GSs pruned. "
@@ -190,7 +204,8 @@ class DefaultStrategy(Strategy):
             state["count"].zero_()
             if self.refine_scale2d_stop_iter > 0:
                 state["radii"].zero_()
-            torch.cuda.empty_cache()
+            if pool is None:
+                torch.cuda.empty_cache()
 
         if step % self.reset_every == 0 & step > 0:
             reset_opa(
@@ -217,13 +232,10 @@ class DefaultStrategy(Strategy):
         ]:
             assert key in info, f"{key} is required but missing."
 
-        # normalize grads to [-1, 1] screen space
         if self.absgrad:
-            grads = info[self.key_for_gradient].absgrad.clone()
+            grads = info[self.key_for_gradient].absgrad
         else:
-            grads = info[self.key_for_gradient].grad.clone()
-        grads[..., 0] *= info["width"] / 2.0 * info["n_cameras"]
-        grads[..., 1] *= info["height"] / 2.0 * info["n_cameras"]
+            grads = info[self.key_for_gradient].grad
 
         # initialize state on the first run
         n_gaussian = len(list(params.values())[0])
@@ -236,6 +248,25 @@ class DefaultStrategy(Strategy):
             assert "radii" in info, "radii is required but missing."
             state["radii"] = torch.zeros(n_gaussian, device=grads.device)
 
+        if self.fused_stats:
+            densification_stats(
+                grads,
+                info["radii"],
+                info["gaussian_ids"] if packed else None,
+                info["width"],
+                info["height"],
+                info["n_cameras"],
+                state["grad2d"],
+                state["count"],
+                state["radii"] if self.refine_scale2d_stop_iter > 0 else None,
+            )
+            return
+
+        # normalize grads to [-1, 1] screen space
+        grads = grads.clone()
+        grads[..., 0] *= info["width"] / 2.0 * info["n_cameras"]
+        grads[..., 1] *= info["height"] / 2.0 * info["n_cameras"]
+
         # update the running state
         if packed:
             # grads is [nnz, 2]
@@ -266,6 +297,7 @@ class DefaultStrategy(Strategy):
         optimizers: Dict[str, torch.optim.Optimizer],
         state: Dict[str, Any],
         step: int,
+        pool: Optional[GaussianPool] = None,
     ) -> Tuple[int, int]:
         count = state["count"]
         grads = state["grad2d"] / count.clamp_min(1)
@@ -287,7 +319,13 @@ class DefaultStrategy(Strategy):
 
         # first duplicate
         if n_dupli > 0:
-            duplicate(params=params, optimizers=optimizers, state=state, mask=is_dupli)
+            duplicate(
+                params=params,
+                optimizers=optimizers,
+                state=state,
+                mask=is_dupli,
+                pool=pool,
+            )
 
         # new GSs added by duplication will not be split
         is_split = torch.cat(
@@ -305,6 +343,7 @@ class DefaultStrategy(Strategy):
                 state=state,
                 mask=is_split,
                 revised_opacity=self.revised_opacity,
+                pool=pool,
             )
         return n_dupli, n_split
 
@@ -315,6 +354,7 @@ class DefaultStrategy(Strategy):
         optimizers: Dict[str, torch.optim.Optimizer],
         state: Dict[str, Any],
         step: int,
+        pool: Optional[GaussianPool] = None,
     ) -> int:
         is_prune = torch.sigmoid(params["opacities"].flatten()) < self.prune_opa
         if step > self.reset_every:
@@ -334,6 +374,12 @@ class DefaultStrategy(Strategy):
 
         n_prune = is_prune.sum().item()
         if n_prune > 0:
-            remove(params=params, optimizers=optimizers, state=state, mask=is_prune)
+            remove(
+                params=params,
+                optimizers=optimizers,
+                state=state,
+                mask=is_prune,
+                pool=pool,
+            )
 
         return n_prune
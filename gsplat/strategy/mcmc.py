@@ -1,12 +1,13 @@
 import math
 from dataclasses import dataclass
-from typing import Any, Dict, Union
+from typing import Any, Dict, Optional, Union
 
 import torch
 from torch import Tensor
 
 from .base import Strategy
 from .ops import inject_noise_to_position, relocate, sample_add
+from .pool import GaussianPool, get_pool
 
 
 @dataclass
@@ -29,6 +30,10 @@ class MCMCStrategy(Strategy):
         refine_every (int): Refine GSs every this steps. Default to 100.
         min_opacity (float): GSs with opacity below this value will be pruned. Default to 0.005.
         verbose (bool): Whether to print verbose information. Default to False.
+        pool_capacity (int): If positive, keep the parameters and their optimizer
+          states in a :class:`GaussianPool` with room for this many GSs, e.g.
+          `cap_max`, so that adding GSs writes in place instead of reallocating every
+          tensor. Default to 0 (disabled).
 
     Examples:
 
@@ -53,6 +58,7 @@ class MCMCStrategy(Strategy):
     refine_every: int = 100
     min_opacity: float = 0.005
     verbose: bool = False
+    pool_capacity: int = 0
 
     def initialize_state(self) -> Dict[str, Any]:
         """Initialize and return the running state for this strategy."""
@@ -130,14 +136,16 @@ class MCMCStrategy(Strategy):
                 print(f"Step {step}: Relocated {n_relocated_gs} GSs.")
 
             # add new GSs
-            n_new_gs = self._add_new_gs(params, optimizers, binoms)
+            pool = get_pool(params, optimizers, state, self.pool_capacity)
+            n_new_gs = self._add_new_gs(params, optimizers, binoms, pool)
             if self.verbose:
                 print(
                     f"Step {step}: Added {n_new_gs} GSs. "
                     f"Now having {len(params['means'])} GSs."
                 )
 
-            torch.cuda.empty_cache()
+            if pool is None:
+                torch.cuda.empty_cache()
 
         # add noise to GSs
         inject_noise_to_position(
@@ -171,6 +179,7 @@ class MCMCStrategy(Strategy):
         params: Union[Dict[str, torch.nn.Parameter], torch.nn.ParameterDict],
         optimizers: Dict[str, torch.optim.Optimizer],
         binoms: Tensor,
+        pool: Optional[GaussianPool] = None,
     ) -> int:
         current_n_points = len(params["means"])
         n_target = min(self.cap_max, int(1.05 * current_n_points))
@@ -183,5 +192,6 @@ class MCMCStrategy(Strategy):
                 n=n_gs,
                 binoms=binoms,
                 min_opacity=self.min_opacity,
+                pool=pool,
             )
         return n_gs
@@ -1,14 +1,17 @@
 import numpy as np
-from typing import Callable, Dict, List, Union
+from typing import Callable, Dict, List, Optional, Union
 
 import torch
 import torch.nn.functional as F
 from torch import Tensor
 
 from gsplat import quat_scale_to_covar_preci
+from gsplat.cuda._wrapper import compact_rows
 from gsplat.relocation import compute_relocation
 from gsplat.utils import normalized_quat_to_rotmat
 
+from .pool import GaussianPool
+
 
 @torch.no_grad()
 def _multinomial_sample(weights: Tensor, n: int, replacement: bool = True) -> Tensor:
@@ -89,12 +92,88 @@ def _update_param_with_optimizer(
             optimizer.state[new_param] = param_state
 
 
+def _has_compact_rows() -> bool:
+    """Whether :func:`compact_rows` is available, i.e. the extension is compiled.
+    Otherwise the ops gather the rows with PyTorch."""
+    from gsplat.cuda._backend import _C
+
+    return _C is not None
+
+
+@torch.no_grad()
+def _compact_with_optimizer(
+    params: Union[Dict[str, torch.nn.Parameter], torch.nn.ParameterDict],
+    optimizers: Dict[str, torch.optim.Optimizer],
+    state: Dict[str, Tensor],
+    keep: Tensor,
+    append: Optional[Tensor] = None,
+):
+    """Keep some rows of the parameters, the state in the optimizers and the extra
+    running state, and append copies of other rows after them.
+
+    All the tensors are compacted by a single :func:`compact_rows` call. The appended
+    rows have zero optimizer states.
+
+    Args:
+        params: A dictionary of parameters.
+        optimizers: A dictionary of optimizers, each corresponding to a parameter.
+        state: The extra running state, whose tensors are compacted too.
+        keep: A boolean mask of the rows to keep.
+        append: The indices of the rows to append. Default: None.
+    """
+    # (name, None) for a parameter, (name, key) for an optimizer state and
+    # (None, key) for the running state
+    slots, tensors, zero_append = [], [], []
+    for name, param in params.items():
+        slots.append((name, None))
+        tensors.append(param)
+        zero_append.append(False)
+        if name not in optimizers:
+            assert not param.requires_grad, (
+                f"Optimizer for {name} is not found, but the parameter is trainable."
+                f"Got requires_grad={param.requires_grad}"
+            )
+            continue
+        for key, v in optimizers[name].state[param].items():
+            if key != "step":
+                slots.append((name, key))
+                tensors.append(v)
+                zero_append.append(True)
+    for k, v in state.items():
+        if isinstance(v, torch.Tensor):
+            slots.append((None, k))
+            tensors.append(v)
+            zero_append.append(False)
+    outputs = dict(zip(slots, compact_rows(tensors, keep, append, zero_append)))
+
+    for name in list(params.keys()):
+        param = params[name]
+        new_param = torch.nn.Parameter(
+            outputs[(name, None)], requires_grad=param.requires_grad
+        )
+        params[name] = new_param
+        if name not in optimizers:
+            continue
+        optimizer = optimizers[name]
+        param_state = optimizer.state.pop(param, {})
+        for key in param_state.keys():
+            if key != "step":
+                param_state[key] = outputs[(name, key)]
+        for i in range(len(optimizer.param_groups)):
+            optimizer.param_groups[i]["params"] = [new_param]
+        optimizer.state[new_param] = param_state
+    for k, v in state.items():
+        if isinstance(v, torch.Tensor):
+            state[k] = outputs[(None, k)]
+
+
 @torch.no_grad()
 def duplicate(
     params: Union[Dict[str, torch.nn.Parameter], torch.nn.ParameterDict],
     optimizers: Dict[str, torch.optim.Optimizer],
     state: Dict[str, Tensor],
     mask: Tensor,
+    pool: Optional[GaussianPool] = None,
 ):
     """Inplace duplicate the Gaussian with the given mask.
 
@@ -102,6 +181,7 @@ def duplicate(
         params: A dictionary of parameters.
         optimizers: A dictionary of optimizers, each corresponding to a parameter.
         mask: A boolean mask to duplicate the Gaussians.
+        pool: If given, the new Gaussians are appended in place to this pool.
     """
     device = mask.device
     sel = torch.where(mask)[0]
@@ -113,7 +193,16 @@ def duplicate(
         return torch.cat([v, torch.zeros((len(sel), *v.shape[1:]), device=device)])
 
     # update the parameters and the state in the optimizers
-    _update_param_with_optimizer(param_fn, optimizer_fn, params, optimizers)
+    if pool is not None:
+        pool.grow({name: p[sel] for name, p in params.items()})
+    elif _has_compact_rows():
+        # the extra running state is compacted too
+        _compact_with_optimizer(
+            params, optimizers, state, torch.ones_like(mask), append=sel
+        )
+        return
+    else:
+        _update_param_with_optimizer(param_fn, optimizer_fn, params, optimizers)
     # update the extra running state
     for k, v in state.items():
         if isinstance(v, torch.Tensor):
@@ -127,6 +216,7 @@ def split(
     state: Dict[str, Tensor],
     mask: Tensor,
     revised_opacity: bool = False,
+    pool: Optional[GaussianPool] = None,
 ):
     """Inplace split the Gaussian with the given mask.
 
@@ -136,10 +226,11 @@ def split(
         mask: A boolean mask to split the Gaussians.
         revised_opacity: Whether to use revised opacity formulation
           from arXiv:2404.06109. Default: False.
+        pool: If given, the first half of the split Gaussians is written in place of
+          the selected ones and the second half is appended to this pool.
     """
     device = mask.device
     sel = torch.where(mask)[0]
-    rest = torch.where(~mask)[0]
 
     scales = torch.exp(params["scales"][sel])
     quats = F.normalize(params["quats"][sel], dim=-1)
@@ -151,7 +242,7 @@ def split(
         torch.randn(2, len(scales), 3, device=device),
     )  # [2, N, 3]
 
-    def param_fn(name: str, p: Tensor) -> Tensor:
+    def split_fn(name: str, p: Tensor) -> Tensor:
         repeats = [2] + [1] * (p.dim() - 1)
         if name == "means":
             p_split = (p[sel] + samples).reshape(-1, 3)  # [2N, 3]
@@ -162,7 +253,36 @@ def split(
             p_split = torch.logit(new_opacities).repeat(repeats)  # [2N]
         else:
             p_split = p[sel].repeat(repeats)
-        p_new = torch.cat([p[rest], p_split])
+        return p_split
+
+    if pool is not None:
+        rows = {}
+        for name, p in params.items():
+            p_split = split_fn(name, p)
+            p[sel] = p_split[: len(sel)]
+            rows[name] = p_split[len(sel) :]
+        pool.zero_state(sel)
+        pool.grow(rows)
+        for k, v in state.items():
+            if isinstance(v, torch.Tensor):
+                state[k] = torch.cat((v, v[sel]))
+        return
+
+    if _has_compact_rows():
+        # the other parameters and the running state of the split Gaussians are
+        # copies of the selected ones
+        names = ["means", "scales"] + (["opacities"] if revised_opacity else [])
+        p_splits = {name: split_fn(name, params[name]) for name in names}
+        _compact_with_optimizer(params, optimizers, state, ~mask, sel.repeat(2))
+        n_rest = len(mask) - len(sel)
+        for name, p_split in p_splits.items():
+            params[name][n_rest:] = p_split
+        return
+
+    rest = torch.where(~mask)[0]
+
+    def param_fn(name: str, p: Tensor) -> Tensor:
+        p_new = torch.cat([p[rest], split_fn(name, p)])
         p_new = torch.nn.Parameter(p_new, requires_grad=p.requires_grad)
         return p_new
 
@@ -186,6 +306,7 @@ def remove(
     optimizers: Dict[str, torch.optim.Optimizer],
     state: Dict[str, Tensor],
     mask: Tensor,
+    pool: Optional[GaussianPool] = None,
 ):
     """Inplace remove the Gaussian with the given mask.
 
@@ -193,7 +314,21 @@ def remove(
         params: A dictionary of parameters.
         optimizers: A dictionary of optimizers, each corresponding to a parameter.
         mask: A boolean mask to remove the Gaussians.
+        pool: If given, the removed Gaussians are overwritten in place by the last
+          ones of this pool, which changes the order of the Gaussians.
     """
+    if pool is not None:
+        holes, movers = pool.remove(mask)
+        for k, v in state.items():
+            if isinstance(v, torch.Tensor):
+                v[holes] = v[movers]
+                state[k] = v[: len(pool)]
+        return
+
+    if _has_compact_rows():
+        _compact_with_optimizer(params, optimizers, state, ~mask)
+        return
+
     sel = torch.where(~mask)[0]
 
     def param_fn(name: str, p: Tensor) -> Tensor:
@@ -305,6 +440,7 @@ def sample_add(
     n: int,
     binoms: Tensor,
     min_opacity: float = 0.005,
+    pool: Optional[GaussianPool] = None,
 ):
     opacities = torch.sigmoid(params["opacities"])
 
@@ -319,12 +455,15 @@ def sample_add(
     )
     new_opacities = torch.clamp(new_opacities, max=1.0 - eps, min=min_opacity)
 
-    def param_fn(name: str, p: Tensor) -> Tensor:
+    def update_fn(name: str, p: Tensor) -> Tensor:
         if name == "opacities":
             p[sampled_idxs] = torch.logit(new_opacities)
         elif name == "scales":
             p[sampled_idxs] = torch.log(new_scales)
-        p_new = torch.cat([p, p[sampled_idxs]])
+        return p[sampled_idxs]
+
+    def param_fn(name: str, p: Tensor) -> Tensor:
+        p_new = torch.cat([p, update_fn(name, p)])
         return torch.nn.Parameter(p_new, requires_grad=p.requires_grad)
 
     def optimizer_fn(key: str, v: Tensor) -> Tensor:
@@ -332,7 +471,10 @@ def sample_add(
         return torch.cat([v, v_new])
 
     # update the parameters and the state in the optimizers
-    _update_param_with_optimizer(param_fn, optimizer_fn, params, optimizers)
+    if pool is not None:
+        pool.grow({name: update_fn(name, p) for name, p in params.items()})
+    else:
+        _update_param_with_optimizer(param_fn, optimizer_fn, params, optimizers)
     # update the extra running state
     for k, v in state.items():
         v_new = torch.zeros((len(sampled_idxs), *v.shape[1:]), device=v.device)
@@ -0,0 +1,214 @@
+import math
+from typing import Any, Dict, Optional, Tuple, Union
+
+import torch
+from torch import Tensor
+
+
+def _aliases(x: Tensor, storage: Tensor) -> bool:
+    """Whether `x` is a view on the first rows of `storage`."""
+    return x.data_ptr() == storage.data_ptr() and x.shape[1:] == storage.shape[1:]
+
+
+class GaussianPool:
+    """Preallocated storage for the parameters of the Gaussians and their optimizer
+    states.
+
+    Every parameter is a view on the first `len(pool)` rows of a storage tensor with
+    room for `capacity` Gaussians, and so is every per-Gaussian optimizer state (e.g.
+    the moments of Adam). The ops in :mod:`gsplat.strategy.ops` take the pool to grow
+    and prune the Gaussians in place:
+
+    - New Gaussians are written after the active rows. The storages are only
+      reallocated when they are full, with `growth` times the needed capacity.
+    - Removed Gaussians are replaced by the last active ones, so that the active rows
+      stay contiguous and only the holes are copied. This does not preserve the order
+      of the Gaussians.
+
+    Parameters and optimizer states that were replaced outside of the pool, e.g. by
+    :func:`reset_opa` or when loading a checkpoint, are copied back into it by the
+    next operation.
+
+    Args:
+        params: A dictionary of parameters.
+        optimizers: A dictionary of optimizers, each corresponding to a parameter.
+        capacity: Number of Gaussians to reserve room for. Default: the current number.
+        growth: Capacity growth factor when the pool is full. Default: 1.5.
+    """
+
+    def __init__(
+        self,
+        params: Union[Dict[str, torch.nn.Parameter], torch.nn.ParameterDict],
+        optimizers: Dict[str, torch.optim.Optimizer],
+        capacity: int = 0,
+        growth: float = 1.5,
+    ):
+        assert growth > 1.0, growth
+        self.params = params
+        self.optimizers = optimizers
+        self.growth = growth
+        self.capacity = max(capacity, len(params["means"]))
+        self._n = 0
+        self._storages: Dict[str, Tensor] = {}
+        # name -> key of the optimizer state -> storage
+        self._states: Dict[str, Dict[str, Tensor]] = {}
+        self.sync()
+
+    def __len__(self) -> int:
+        """The number of active Gaussians."""
+        return self._n
+
+    def _replace_param(self, name: str, new_param: torch.nn.Parameter):
+        param = self.params[name]
+        self.params[name] = new_param
+        if name not in self.optimizers:
+            return
+        optimizer = self.optimizers[name]
+        param_state = optimizer.state.pop(param, {})
+        for i in range(len(optimizer.param_groups)):
+            optimizer.param_groups[i]["params"] = [new_param]
+        optimizer.state[new_param] = param_state
+
+    def _row_states(self, name: str) -> Dict[str, Tensor]:
+        """The optimizer states of a parameter that have a row per Gaussian."""
+        if name not in self.optimizers:
+            return {}
+        param = self.params[name]
+        param_state = self.optimizers[name].state.get(param, {})
+        return {
+            k: v
+            for k, v in param_state.items()
+            if isinstance(v, Tensor) and v.dim() > 0 and v.shape == param.shape
+        }
+
+    def _adopt(self, x: Tensor) -> Tensor:
+        storage = x.new_empty((self.capacity, *x.shape[1:]))
+        storage[: len(x)] = x
+        return storage
+
+    @torch.no_grad()
+    def sync(self):
+        """Copy into the pool the parameters and states replaced outside of it."""
+        n = len(self.params["means"])
+        if n > self.capacity:
+            self.capacity = math.ceil(n * self.growth)
+        for name in list(self.params.keys()):
+            param = self.params[name]
+            storage = self._storages.get(name, None)
+            if (
+                storage is None
+                or len(storage) != self.capacity
+                or not _aliases(param, storage)
+            ):
+                storage = self._adopt(param)
+                self._storages[name] = storage
+                self._replace_param(
+                    name,
+                    torch.nn.Parameter(storage[:n], requires_grad=param.requires_grad),
+                )
+
+            states = self._states.setdefault(name, {})
+            for key, v in self._row_states(name).items():
+                storage = states.get(key, None)
+                if (
+                    storage is None
+                    or len(storage) != self.capacity
+                    or not _aliases(v, storage)
+                ):
+                    storage = self._adopt(v)
+                    states[key] = storage
+                self.optimizers[name].state[self.params[name]][key] = storage[:n]
+        self._n = n
+
+    def _set_len(self, n: int):
+        for name, storage in self._storages.items():
+            param = self.params[name]
+            self._replace_param(
+                name, torch.nn.Parameter(storage[:n], requires_grad=param.requires_grad)
+            )
+            if name in self.optimizers:
+                param_state = self.optimizers[name].state[self.params[name]]
+                for key, state_storage in self._states[name].items():
+                    param_state[key] = state_storage[:n]
+        self._n = n
+
+    def reserve(self, n: int):
+        """Make room for at least `n` Gaussians."""
+        if n > self.capacity:
+            self.capacity = max(n, math.ceil(self.capacity * self.growth))
+            self.sync()
+
+    @torch.no_grad()
+    def zero_state(self, indices: Tensor):
+        """Reset the optimizer states of some active Gaussians."""
+        self.sync()
+        for states in self._states.values():
+            for storage in states.values():
+                storage[indices] = 0
+
+    @torch.no_grad()
+    def grow(self, rows: Dict[str, Tensor]):
+        """Append Gaussians with zero optimizer states.
+
+        Args:
+            rows: The values of the new Gaussians for every parameter.
+        """
+        self.sync()
+        assert rows.keys() == self._storages.keys(), (
+            f"Expected the new rows of {list(self._storages.keys())}, "
+            f"but got {list(rows.keys())}"
+        )
+        k = len(rows["means"])
+        self.reserve(self._n + k)
+        n = self._n
+        for name, storage in self._storages.items():
+            storage[n : n + k] = rows[name]
+        for states in self._states.values():
+            for storage in states.values():
+                storage[n : n + k] = 0
+        self._set_len(n + k)
+
+    @torch.no_grad()
+    def remove(self, mask: Tensor) -> Tuple[Tensor, Tensor]:
+        """Remove Gaussians by moving the last kept ones into their rows.
+
+        Args:
+            mask: A boolean mask of the active Gaussians to remove.
+
+        Returns:
+            A tuple:
+
+            - **holes**. The removed rows that were filled.
+            - **movers**. The rows moved into the holes.
+        """
+        self.sync()
+        keep = ~mask
+        m = int(keep.sum().item())
+        holes = torch.where(mask[:m])[0]
+        movers = torch.where(keep[m:])[0] + m
+        for storage in self._storages.values():
+            storage[holes] = storage[movers]
+        for states in self._states.values():
+            for storage in states.values():
+                storage[holes] = storage[movers]
+        self._set_len(m)
+        return holes, movers
+
+
+def get_pool(
+    params: Union[Dict[str, torch.nn.Parameter], torch.nn.ParameterDict],
+    optimizers: Dict[str, torch.optim.Optimizer],
+    state: Dict[str, Any],
+    capacity: int,
+) -> Optional[GaussianPool]:
+    """Return the pool kept in the running state of a strategy, or create it.
+
+    Returns None if `capacity` is not positive, i.e. the pool is disabled.
+    """
+    if capacity <= 0:
+        return None
+    if state.get("pool", None) is None:
+        state["pool"] = GaussianPool(params, optimizers, capacity=capacity)
+    pool = state["pool"]
+    assert pool.params is params, "The pool was created for other parameters."
+    return pool
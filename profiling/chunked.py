@@ -0,0 +1,146 @@
+"""Benchmark the chunked splat file on a synthetic scene.
+
+Random splats are spread over a large ground plane, written to a chunked file
+and loaded back in two ways: all at once (throughput), and progressively for a
+camera looking at a corner of the scene (time to first frame): open the file,
+cull the chunks, fetch them up to SH degree 0, render if CUDA is available,
+then refine them up to the full SH degree.
+
+Usage:
+```bash
+python profiling/chunked.py --num_splats 1000000 5000000
+```
+"""
+
+import os
+import tempfile
+import time
+
+import torch
+
+from gsplat.exporter import export_splats
+from gsplat.importer import ChunkedSplats
+
+
+def synthetic_scene(N: int, K: int, extent: float):
+    torch.manual_seed(42)
+    means = torch.rand(N, 3) * torch.tensor([extent, extent, extent / 20])
+    return {
+        "means": means,
+        "scales": torch.rand(N, 3) * 2 - 4,
+        "quats": torch.randn(N, 4),
+        "opacities": torch.randn(N) + 2,
+        "sh0": torch.randn(N, 1, 3),
+        "shN": torch.randn(N, K, 3) * 0.1,
+    }
+
+
+def render(splats, ids, viewmat, K, width, height):
+    from gsplat.rendering import rasterization
+
+    device = torch.device("cuda")
+    splats = {k: v[ids].to(device) for k, v in splats.items()}
+    colors, _, _ = rasterization(
+        splats["means"],
+        torch.nn.functional.normalize(splats["quats"], dim=-1),
+        torch.exp(splats["scales"]),
+        torch.sigmoid(splats["opacities"]),
+        torch.cat([splats["sh0"], splats["shN"]], dim=1),
+        viewmat[None].to(device),
+        K[None].to(device),
+        width,
+        height,
+        sh_degree=3,
+    )
+    torch.cuda.synchronize()
+    return colors
+
+
+def main(args):
+    from tabulate import tabulate
+
+    width, height = 1280, 720
+    K = torch.tensor(
+        [[1000.0, 0.0, width / 2], [0.0, 1000.0, height / 2], [0.0, 0.0, 1.0]]
+    )
+    # looking down at the corner of the scene from above
+    viewmat = torch.eye(4)
+    viewmat[:3, 3] = torch.tensor([-args.extent / 10, -args.extent / 10, 20.0])
+
+    collection = []
+    with tempfile.TemporaryDirectory() as tmpdir:
+        for N in args.num_splats:
+            splats = synthetic_scene(N, 15, args.extent)
+            path = os.path.join(tmpdir, f"{N}.gsc")
+
+            start = time.time()
+            export_splats(**splats, format="chunked", save_to=path)
+            t_write = time.time() - start
+            size = os.path.getsize(path) / 1024**2
+            del splats
+
+            # all at once
+            start = time.time()
+            chunked = ChunkedSplats(path)
+            chunked.fetch(torch.arange(chunked.num_chunks))
+            t_load = time.time() - start
+            del chunked
+
+            # progressively
+            start = time.time()
+            chunked = ChunkedSplats(path)
+            t_open = time.time() - start
+            chunk_ids = chunked.cull(viewmat, K, width, height)
+            ids = chunked.fetch(chunk_ids, sh_degree=0)
+            if torch.cuda.is_available():
+                render(chunked.splats, ids, viewmat, K, width, height)
+            t_first = time.time() - start
+            chunked.fetch(chunk_ids)
+            t_refined = time.time() - start
+
+            collection.append(
+                [
+                    N,
+                    f"{size:.1f}",
+                    f"{t_write * 1000:.0f}",
+                    f"{t_load * 1000:.0f}",
+                    f"{N / t_load / 1e6:.1f}",
+                    f"{t_open * 1000:.2f}",
+                    f"{len(chunk_ids)} / {chunked.num_chunks}",
+                    f"{t_first * 1000:.1f}",
+                    f"{t_refined * 1000:.1f}",
+                ]
+            )
+    headers = [
+        "Splats",
+        "Size (MB)",
+        "Write (ms)",
+        "Load all (ms)",
+        "Load (M splats/s)",
+        "Open (ms)",
+        "Visible chunks",
+        "First frame (ms)",
+        "Full SH (ms)",
+    ]
+    print(tabulate(collection, headers, tablefmt="rst"))
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--num_splats",
+        nargs="+",
+        type=int,
+        default=[1_000_000, 5_000_000],
+        help="Number of splats of the synthetic scenes",
+    )
+    parser.add_argument(
+        "--extent",
+        type=float,
+        default=200.0,
+        help="Size of the synthetic scenes",
+    )
+    args = parser.parse_args()
+    main(args)
@@ -0,0 +1,151 @@
+"""Benchmark the sorting step of the PNG compression and the rANS coder.
+
+Random splats are sorted with the native CPU implementation of PLAS and, if the
+`plas` package is installed, with it (on the largest square number of splats, as
+it requires), then compressed with `PngCompression` and `RansCompression`. The
+sort time, the size of the PNG and rANS files and the rANS decoding time are
+reported.
+
+Usage:
+```bash
+python profiling/compression.py --num_splats 100000 1000000
+```
+"""
+
+import math
+import os
+import tempfile
+import time
+
+import torch
+
+from gsplat.compression.png_compression import _compress_png, _compress_png_16bit
+from gsplat.compression.rans_compression import _compress_rans, _decompress_rans
+from gsplat.compression.sort import sort_splats
+
+
+def synthetic_splats(N: int):
+    torch.manual_seed(42)
+    return {
+        "means": torch.randn(N, 3),
+        "scales": torch.rand(N, 3) * 2 - 4,
+        "quats": torch.nn.functional.normalize(torch.randn(N, 4), dim=-1),
+        "opacities": torch.randn(N),
+        "sh0": torch.randn(N, 1, 3),
+    }
+
+
+def png_size(splats, tmpdir: str) -> float:
+    """Size in MB of the PNG files of the sorted splats."""
+    width = math.ceil(math.sqrt(len(splats["means"])))
+    for name, params in splats.items():
+        compress_fn = _compress_png_16bit if name == "means" else _compress_png
+        compress_fn(tmpdir, name, params, width=width)
+    return (
+        sum(
+            os.path.getsize(os.path.join(tmpdir, f))
+            for f in os.listdir(tmpdir)
+            if f.endswith(".png")
+        )
+        / 1024**2
+    )
+
+
+def rans_size(splats, tmpdir: str):
+    """Size in MB of the rANS files of the sorted splats, and their decoding time
+    in seconds."""
+    width = math.ceil(math.sqrt(len(splats["means"])))
+    metas = {}
+    for name, params in splats.items():
+        bits = 16 if name == "means" else 8
+        metas[name] = _compress_rans(
+            tmpdir, name, params.cpu(), width=width, bits=bits, verbose=False
+        )
+    start = time.time()
+    for name, meta in metas.items():
+        _decompress_rans(tmpdir, name, meta)
+    t_decode = time.time() - start
+    size = (
+        sum(
+            os.path.getsize(os.path.join(tmpdir, f))
+            for f in os.listdir(tmpdir)
+            if f.endswith(".rans")
+        )
+        / 1024**2
+    )
+    return size, t_decode
+
+
+def main(args):
+    from tabulate import tabulate
+
+    try:
+        import plas
+
+        backends = {"native": True, "plas": False}
+    except ImportError:
+        backends = {"native": True}
+
+    collection = []
+    for N in args.num_splats:
+        for backend, native in backends.items():
+            splats = synthetic_splats(N)
+            if not native:
+                # PLAS requires a square number of splats
+                n = int(N**0.5) ** 2
+                splats = {k: v[:n].to(args.device) for k, v in splats.items()}
+
+            start = time.time()
+            splats = sort_splats(splats, verbose=False, native=native)
+            t_sort = time.time() - start
+
+            with tempfile.TemporaryDirectory() as tmpdir:
+                size = png_size(splats, tmpdir)
+            with tempfile.TemporaryDirectory() as tmpdir:
+                size_rans, t_decode = rans_size(splats, tmpdir)
+            with tempfile.TemporaryDirectory() as tmpdir:
+                size_unsorted = png_size(synthetic_splats(N), tmpdir)
+            collection.append(
+                [
+                    N,
+                    backend,
+                    len(splats["means"]),
+                    f"{t_sort:.2f}",
+                    f"{size_unsorted:.2f}",
+                    f"{size:.2f}",
+                    f"{size_rans:.2f}",
+                    f"{t_decode * 1000:.0f}",
+                ]
+            )
+    headers = [
+        "Splats",
+        "Backend",
+        "Sorted splats",
+        "Sort (s)",
+        "Unsorted PNG (MB)",
+        "Sorted PNG (MB)",
+        "Sorted rANS (MB)",
+        "rANS decode (ms)",
+    ]
+    print(tabulate(collection, headers, tablefmt="rst"))
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--num_splats",
+        nargs="+",
+        type=int,
+        default=[100_000, 1_000_000],
+        help="Number of splats",
+    )
+    parser.add_argument(
+        "--device",
+        type=str,
+        default="cuda" if torch.cuda.is_available() else "cpu",
+        help="Device of the PLAS package",
+    )
+    args = parser.parse_args()
+    main(args)
@@ -0,0 +1,305 @@
+"""Benchmark the CPU implementations of the operators.
+
+Each benchmark compares a native CPU operator with the pure PyTorch fallback
+from `gsplat/cuda/_torch_impl.py`, both running on CPU tensors.
+
+Usage:
+```bash
+python profiling/cpu.py --ops rasterize --threads 1 8 32
+```
+"""
+
+import math
+import time
+
+import torch
+from typing_extensions import Callable
+
+from gsplat._helper import load_test_data
+
+device = torch.device("cpu")
+
+
+def timeit(repeats: int, f: Callable, *args, **kwargs) -> float:
+    for _ in range(min(repeats, 2)):  # warmup
+        f(*args, **kwargs)
+    start = time.time()
+    for _ in range(repeats):
+        results = f(*args, **kwargs)
+    end = time.time()
+    return (end - start) / repeats, results
+
+
+def bench_rasterize(
+    scene_grid: int = 1, width: int = 640, height: int = 360, repeats: int = 3
+):
+    from gsplat.cuda._torch_impl import (
+        _fully_fused_projection,
+        _isect_offset_encode,
+        _isect_tiles,
+        _quat_scale_to_covar_preci,
+        _rasterize_to_pixels,
+    )
+    from gsplat.cuda._wrapper import rasterize_to_pixels
+
+    means, quats, scales, opacities, colors, viewmats, Ks, W, H = load_test_data(
+        device=device, scene_grid=scene_grid
+    )
+    viewmats, Ks = viewmats[:1], Ks[:1]
+    Ks[..., 0, :] *= width / W
+    Ks[..., 1, :] *= height / H
+
+    covars, _ = _quat_scale_to_covar_preci(quats, scales, compute_preci=False)
+    radii, means2d, depths, conics, _ = _fully_fused_projection(
+        means, covars, viewmats, Ks, width, height
+    )
+    opacities = opacities[None].expand(len(viewmats), -1).contiguous()
+    colors = colors[None].expand(len(viewmats), -1, -1).contiguous()
+
+    tile_size = 16
+    tile_width = math.ceil(width / tile_size)
+    tile_height = math.ceil(height / tile_size)
+    _, isect_ids, flatten_ids = _isect_tiles(
+        means2d, radii, depths, tile_size, tile_width, tile_height
+    )
+    isect_offsets = _isect_offset_encode(
+        isect_ids, len(viewmats), tile_width, tile_height
+    )
+    args = (
+        means2d,
+        conics,
+        colors,
+        opacities,
+        width,
+        height,
+        tile_size,
+        isect_offsets,
+        flatten_ids,
+    )
+
+    t_native, _ = timeit(repeats, rasterize_to_pixels, *args)
+    try:
+        t_torch, _ = timeit(repeats, _rasterize_to_pixels, *args)
+    except Exception as e:  # the fallback relies on optional packages
+        print(f"torch fallback unavailable: {e}")
+        t_torch = float("nan")
+    return {
+        "name": "rasterize_to_pixels",
+        "size": f"{len(means)} GS @ {width}x{height}",
+        "native": t_native,
+        "torch": t_torch,
+    }
+
+
+def bench_projection(scene_grid: int = 5, repeats: int = 3):
+    from gsplat.cuda._torch_impl import (
+        _fully_fused_projection,
+        _quat_scale_to_covar_preci,
+    )
+    from gsplat.cuda._wrapper import fully_fused_projection
+
+    means, quats, scales, opacities, colors, viewmats, Ks, W, H = load_test_data(
+        device=device, scene_grid=scene_grid
+    )
+
+    t_native, _ = timeit(
+        repeats,
+        fully_fused_projection,
+        means,
+        None,
+        quats,
+        scales,
+        viewmats,
+        Ks,
+        W,
+        H,
+    )
+
+    def torch_projection():
+        covars, _ = _quat_scale_to_covar_preci(quats, scales, compute_preci=False)
+        return _fully_fused_projection(means, covars, viewmats, Ks, W, H)
+
+    t_torch, _ = timeit(repeats, torch_projection)
+    return {
+        "name": "fully_fused_projection",
+        "size": f"{len(means)} GS x {len(viewmats)} cams",
+        "native": t_native,
+        "torch": t_torch,
+    }
+
+
+def bench_isect(
+    scene_grid: int = 5, width: int = 1280, height: int = 720, repeats: int = 3
+):
+    from gsplat.cuda._torch_impl import (
+        _isect_offset_encode,
+        _isect_tiles,
+    )
+    from gsplat.cuda._wrapper import (
+        fully_fused_projection,
+        isect_offset_encode,
+        isect_tiles,
+    )
+
+    means, quats, scales, opacities, colors, viewmats, Ks, W, H = load_test_data(
+        device=device, scene_grid=scene_grid
+    )
+    Ks[..., 0, :] *= width / W
+    Ks[..., 1, :] *= height / H
+    radii, means2d, depths, _, _ = fully_fused_projection(
+        means, None, quats, scales, viewmats, Ks, width, height
+    )
+
+    tile_size = 16
+    tile_width = math.ceil(width / tile_size)
+    tile_height = math.ceil(height / tile_size)
+
+    def native_isect():
+        _, isect_ids, flatten_ids = isect_tiles(
+            means2d, radii, depths, tile_size, tile_width, tile_height
+        )
+        offsets = isect_offset_encode(
+            isect_ids, len(viewmats), tile_width, tile_height
+        )
+        return isect_ids, flatten_ids, offsets
+
+    def torch_isect():
+        _, isect_ids, flatten_ids = _isect_tiles(
+            means2d, radii, depths, tile_size, tile_width, tile_height
+        )
+        offsets = _isect_offset_encode(
+            isect_ids, len(viewmats), tile_width, tile_height
+        )
+        return isect_ids, flatten_ids, offsets
+
+    t_native, (isect_ids, _, _) = timeit(repeats, native_isect)
+    t_torch, _ = timeit(repeats, torch_isect)
+    return {
+        "name": "isect_tiles",
+        "size": f"{len(isect_ids)} isects @ {width}x{height}",
+        "native": t_native,
+        "torch": t_torch,
+    }
+
+
+def bench_sh(n_gaussians: int = 1_000_000, sh_degree: int = 3, repeats: int = 3):
+    from gsplat.cuda._torch_impl import _spherical_harmonics
+    from gsplat.cuda._wrapper import spherical_harmonics
+
+    dirs = torch.randn(n_gaussians, 3, device=device)
+    coeffs = torch.randn(n_gaussians, (sh_degree + 1) ** 2, 3, device=device)
+    dirs.requires_grad = True
+    coeffs.requires_grad = True
+
+    # forward + backward, including the gradient w.r.t. the directions
+    def native_sh():
+        colors = spherical_harmonics(sh_degree, dirs, coeffs)
+        colors.sum().backward()
+
+    def torch_sh():
+        colors = _spherical_harmonics(sh_degree, dirs, coeffs)
+        colors.sum().backward()
+
+    t_native, _ = timeit(repeats, native_sh)
+    t_torch, _ = timeit(repeats, torch_sh)
+    return {
+        "name": "spherical_harmonics",
+        "size": f"{n_gaussians} GS, degree {sh_degree}",
+        "native": t_native,
+        "torch": t_torch,
+    }
+
+
+def bench_densification_stats(
+    n_gaussians: int = 1_000_000, n_cameras: int = 4, repeats: int = 3
+):
+    from gsplat.strategy import DefaultStrategy
+
+    width, height = 1280, 720
+    # about half of the Gaussians are visible in each camera
+    radii = torch.randint(-8, 8, (n_cameras, n_gaussians, 2), dtype=torch.int32)
+    means2d = torch.zeros(n_cameras, n_gaussians, 2, requires_grad=True)
+    means2d.grad = torch.randn(n_cameras, n_gaussians, 2)
+    info = {
+        "width": width,
+        "height": height,
+        "n_cameras": n_cameras,
+        "radii": radii,
+        "gaussian_ids": None,
+        "means2d": means2d,
+    }
+    params = {"means": torch.zeros(n_gaussians, 3, device=device)}
+
+    # the running state update of one training step
+    def update_state(fused_stats: bool):
+        strategy = DefaultStrategy(refine_scale2d_stop_iter=1, fused_stats=fused_stats)
+        state = strategy.initialize_state()
+        return lambda: strategy._update_state(params, state, info)
+
+    t_native, _ = timeit(repeats, update_state(True))
+    t_torch, _ = timeit(repeats, update_state(False))
+    return {
+        "name": "densification_stats",
+        "size": f"{n_gaussians} GS x {n_cameras} cams",
+        "native": t_native,
+        "torch": t_torch,
+    }
+
+
+BENCHMARKS = {
+    "rasterize": bench_rasterize,
+    "projection": bench_projection,
+    "isect": bench_isect,
+    "sh": bench_sh,
+    "densification_stats": bench_densification_stats,
+}
+
+
+def main(args):
+    from tabulate import tabulate
+
+    collection = []
+    for n_threads in args.threads:
+        torch.set_num_threads(n_threads)
+        for op in args.ops:
+            stats = BENCHMARKS[op](repeats=args.repeats)
+            collection.append(
+                [
+                    stats["name"],
+                    stats["size"],
+                    n_threads,
+                    f"{stats['native'] * 1000:.1f}",
+                    f"{stats['torch'] * 1000:.1f}",
+                    f"{stats['torch'] / stats['native']:.1f}x",
+                ]
+            )
+    headers = ["Op", "Size", "Threads", "Native (ms)", "Torch (ms)", "Speedup"]
+    print(tabulate(collection, headers, tablefmt="rst"))
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--ops",
+        nargs="+",
+        type=str,
+        default=list(BENCHMARKS.keys()),
+        help=", ".join(BENCHMARKS.keys()),
+    )
+    parser.add_argument(
+        "--threads",
+        nargs="+",
+        type=int,
+        default=[torch.get_num_threads()],
+        help="Number of intra-op threads for profiling",
+    )
+    parser.add_argument(
+        "--repeats",
+        type=int,
+        default=3,
+        help="Number of repeats for profiling",
+    )
+    args = parser.parse_args()
+    main(args)
@@ -0,0 +1,78 @@
+"""Benchmark the compressed PLY export.
+
+The native CPU encoder of `splat2ply_bytes_compressed` is compared with its
+PyTorch implementation on random splats, and the two files are checked to be
+identical.
+
+Usage:
+```bash
+python profiling/export.py --num_splats 100000 1000000 --sh_degree 3
+```
+"""
+
+import time
+
+import torch
+
+from gsplat.exporter import splat2ply_bytes_compressed
+
+
+def main(args):
+    from tabulate import tabulate
+
+    collection = []
+    for N in args.num_splats:
+        torch.manual_seed(42)
+        K = (args.sh_degree + 1) ** 2 - 1
+        splats = {
+            "means": torch.randn(N, 3, device=args.device),
+            "scales": torch.randn(N, 3, device=args.device),
+            "quats": torch.randn(N, 4, device=args.device),
+            "opacities": torch.randn(N, device=args.device),
+            "sh0": torch.randn(N, 3, device=args.device),
+            "shN": torch.randn(N, K * 3, device=args.device),
+        }
+
+        timings = {}
+        for native in [True, False]:
+            start = time.time()
+            data = splat2ply_bytes_compressed(**splats, native=native)
+            timings[native] = (time.time() - start, data)
+        collection.append(
+            [
+                N,
+                f"{timings[False][0] * 1000:.1f}",
+                f"{timings[True][0] * 1000:.1f}",
+                f"{timings[False][0] / timings[True][0]:.1f}x",
+                timings[True][1] == timings[False][1],
+            ]
+        )
+    headers = ["Splats", "PyTorch (ms)", "Native (ms)", "Speedup", "Identical"]
+    print(tabulate(collection, headers, tablefmt="rst"))
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--device",
+        type=str,
+        default="cpu",
+        help="Device of the splats",
+    )
+    parser.add_argument(
+        "--num_splats",
+        nargs="+",
+        type=int,
+        default=[10_000, 100_000, 1_000_000],
+        help="Number of splats to export",
+    )
+    parser.add_argument(
+        "--sh_degree",
+        type=int,
+        default=3,
+        help="Degree of the spherical harmonics",
+    )
+    args = parser.parse_args()
+    main(args)
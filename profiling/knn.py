@@ -0,0 +1,85 @@
+"""Benchmark the k-nearest-neighbor distances used to initialize the Gaussians.
+
+The native k-d tree of gsplat is compared with `sklearn.neighbors.NearestNeighbors`,
+which `examples/utils.py::knn` used before, on random point clouds sampled on the
+surfaces of spheres like a SfM reconstruction.
+
+Usage:
+```bash
+python profiling/knn.py --num_points 1000000 5000000
+```
+"""
+
+import time
+
+import torch
+
+from gsplat.neighbors import knn
+
+
+def make_points(N: int, n_objects: int = 100) -> torch.Tensor:
+    torch.manual_seed(42)
+    centers = torch.rand(n_objects, 3) * 100
+    radii = torch.rand(n_objects, 1) * 5 + 1
+    ids = torch.randint(0, n_objects, (N,))
+    dirs = torch.nn.functional.normalize(torch.randn(N, 3), dim=-1)
+    return centers[ids] + dirs * radii[ids] + torch.randn(N, 3) * 0.01
+
+
+def knn_sklearn(x: torch.Tensor, K: int) -> torch.Tensor:
+    from sklearn.neighbors import NearestNeighbors
+
+    x_np = x.cpu().numpy()
+    model = NearestNeighbors(n_neighbors=K, metric="euclidean").fit(x_np)
+    distances, _ = model.kneighbors(x_np)
+    return torch.from_numpy(distances).to(x)
+
+
+def timeit(f, *args) -> float:
+    start = time.time()
+    results = f(*args)
+    return time.time() - start, results
+
+
+def main(args):
+    from tabulate import tabulate
+
+    collection = []
+    for N in args.num_points:
+        points = make_points(N)
+        t_gsplat, d_gsplat = timeit(knn, points, args.k)
+        if args.skip_sklearn:
+            collection.append([N, "-", f"{t_gsplat:.2f}", "-", "-"])
+            continue
+        t_sklearn, d_sklearn = timeit(knn_sklearn, points, args.k)
+        err = (d_gsplat - d_sklearn).abs().max().item()
+        collection.append(
+            [
+                N,
+                f"{t_sklearn:.2f}",
+                f"{t_gsplat:.2f}",
+                f"{t_sklearn / t_gsplat:.1f}x",
+                f"{err:.1e}",
+            ]
+        )
+    headers = ["Points", "sklearn (s)", "gsplat (s)", "Speedup", "Max error"]
+    print(tabulate(collection, headers, tablefmt="rst"))
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--num_points",
+        nargs="+",
+        type=int,
+        default=[1_000_000, 5_000_000],
+        help="Number of points",
+    )
+    parser.add_argument("--k", type=int, default=4, help="Number of neighbors")
+    parser.add_argument(
+        "--skip_sklearn", action="store_true", help="Only time the k-d tree"
+    )
+    args = parser.parse_args()
+    main(args)
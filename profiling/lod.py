@@ -0,0 +1,140 @@
+"""Benchmark rendering with a level-of-detail tree.
+
+The cameras of the test scene are pulled back by increasing distances, and the
+full rendering is compared with the rendering of the per-camera LOD cut: number
+of Gaussians passed to the projection, number of projected (visible) Gaussians
+and render time.
+
+Usage:
+```bash
+python profiling/lod.py --scene_grid 5 --distances 0 5 20 50
+```
+"""
+
+import time
+
+import torch
+from typing_extensions import Callable
+
+from gsplat._helper import load_test_data
+from gsplat.lod import build_lod_tree
+from gsplat.rendering import rasterization
+
+
+def timeit(repeats: int, f: Callable, *args, **kwargs) -> float:
+    for _ in range(min(repeats, 2)):  # warmup
+        f(*args, **kwargs)
+    if torch.cuda.is_available():
+        torch.cuda.synchronize()
+    start = time.time()
+    for _ in range(repeats):
+        results = f(*args, **kwargs)
+    if torch.cuda.is_available():
+        torch.cuda.synchronize()
+    end = time.time()
+    return (end - start) / repeats, results
+
+
+def main(args):
+    from tabulate import tabulate
+
+    device = torch.device(args.device)
+    means, quats, scales, opacities, colors, viewmats, Ks, width, height = (
+        load_test_data(device=device, scene_grid=args.scene_grid)
+    )
+    viewmats, Ks = viewmats[:1], Ks[:1]
+    N = len(means)
+
+    start = time.time()
+    tree = build_lod_tree(means, quats, scales, opacities, colors)
+    t_build = time.time() - start
+    print(
+        f"Built the LOD tree over {N} Gaussians in {t_build * 1000:.1f} ms "
+        f"({tree.n_nodes - N} merged nodes)."
+    )
+
+    collection = []
+    for distance in args.distances:
+        # pull the camera back along its viewing direction
+        _viewmats = viewmats.clone()
+        _viewmats[:, 2, 3] += distance
+
+        def render(**kwargs):
+            return rasterization(
+                means,
+                quats,
+                scales,
+                opacities,
+                colors,
+                _viewmats,
+                Ks,
+                width,
+                height,
+                packed=False,
+                **kwargs,
+            )
+
+        t_full, (_, _, meta_full) = timeit(args.repeats, render)
+        t_lod, (_, _, meta_lod) = timeit(
+            args.repeats, render, lod_tree=tree, lod_pixel_size=args.pixel_size
+        )
+        collection.append(
+            [
+                distance,
+                N,
+                len(meta_lod["lod_ids"]),
+                (meta_full["radii"] > 0).all(-1).sum().item(),
+                (meta_lod["radii"] > 0).all(-1).sum().item(),
+                f"{t_full * 1000:.2f}",
+                f"{t_lod * 1000:.2f}",
+            ]
+        )
+    headers = [
+        "Distance",
+        "GS (full)",
+        "GS (LOD)",
+        "Visible (full)",
+        "Visible (LOD)",
+        "Full (ms)",
+        "LOD (ms)",
+    ]
+    print(tabulate(collection, headers, tablefmt="rst"))
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--device",
+        type=str,
+        default="cuda" if torch.cuda.is_available() else "cpu",
+        help="Device to render on",
+    )
+    parser.add_argument(
+        "--scene_grid",
+        type=int,
+        default=5,
+        help="Repeat the test scene into a grid to mimic a large-scale setting",
+    )
+    parser.add_argument(
+        "--distances",
+        nargs="+",
+        type=float,
+        default=[0.0, 5.0, 20.0, 50.0],
+        help="Distances to pull the camera back by",
+    )
+    parser.add_argument(
+        "--pixel_size",
+        type=float,
+        default=1.0,
+        help="Largest on-screen size in pixels of a merged node",
+    )
+    parser.add_argument(
+        "--repeats",
+        type=int,
+        default=5,
+        help="Number of repeats for profiling",
+    )
+    args = parser.parse_args()
+    main(args)
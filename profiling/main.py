@@ -7,6 +7,7 @@ pytest <THIS_PY_FILE>
 """
 
 import time
+from typing import Optional
 
 import torch
 from typing_extensions import Callable, Literal
@@ -14,6 +15,7 @@ from typing_extensions import Callable, Literal
 from gsplat._helper import load_test_data
 from gsplat.distributed import cli
 from gsplat.rendering import rasterization
+from gsplat.storage import quantize_gaussians
 
 RESOLUTIONS = {
     "360p": (640, 360),
@@ -49,7 +51,10 @@ def main(
     memory_history: bool = False,
     world_rank: int = 0,
     world_size: int = 1,
+    storage: Optional[Literal["float32", "float16", "uint8"]] = None,
 ):
+    """Profile the rasterization. If `storage` is set, only the forward pass is
+    profiled, for inference with the Gaussians stored in that dtype."""
     (
         means,
         quats,
@@ -76,11 +81,27 @@ def main(
     opacities = opacities[world_rank::world_size].contiguous()
     colors = colors[world_rank::world_size].contiguous()
 
-    means.requires_grad = True
-    quats.requires_grad = True
-    scales.requires_grad = True
-    opacities.requires_grad = True
-    colors.requires_grad = True
+    kwargs = {}
+    if storage is None:
+        means.requires_grad = True
+        quats.requires_grad = True
+        scales.requires_grad = True
+        opacities.requires_grad = True
+        colors.requires_grad = True
+    elif storage != "float32":
+        (
+            means,
+            quats,
+            scales,
+            opacities,
+            colors,
+            kwargs["dequantization"],
+        ) = quantize_gaussians(
+            means, quats, scales, opacities, colors, dtype=getattr(torch, storage)
+        )
+    mem_splats = sum(
+        x.numel() * x.element_size() for x in [means, quats, scales, opacities, colors]
+    )
 
     render_width, render_height = RESOLUTIONS[reso]  # desired resolution
     Ks[..., 0, :] *= render_width / width
@@ -119,9 +140,23 @@ def main(
         radius_clip=3.0,
         sparse_grad=sparse_grad,
         distributed=world_size > 1,
+        **kwargs,
     )
     mem_toc_fwd = torch.cuda.max_memory_allocated() / 1024**3 - mem_tic
 
+    if storage is not None:
+        print(
+            f"Rasterization Storage: {storage}, Splats: {mem_splats / 1024**2:.1f} MB, "
+            f"Mem Allocation: [FWD]{mem_toc_fwd:.2f} GB "
+            f"Time: [FWD]{ellipse_time_fwd:.3f}s "
+            f"N Gaussians: {means.shape[0]}"
+        )
+        return {
+            "mem_splats": mem_splats,
+            "mem_fwd": mem_toc_fwd,
+            "time_fwd": ellipse_time_fwd,
+        }
+
     render_colors = outputs[0]
     loss = render_colors.sum()
 
@@ -157,6 +192,7 @@ def worker(local_rank: int, world_rank: int, world_size: int, args):
     # Tested on a NVIDIA TITAN RTX with (24 GB).
 
     collection = []
+    storage_collection = []
     for batch_size in args.batch_size:
         for channels in args.channels:
             print("========================================")
@@ -258,6 +294,34 @@ def worker(local_rank: int, world_rank: int, world_size: int, args):
                     )
                     torch.cuda.empty_cache()
 
+                # inference with the Gaussians stored in a compact dtype
+                for storage in args.storage if world_size == 1 else []:
+                    print(f"gsplat packed[True] storage[{storage}]")
+                    for scene_grid in args.scene_grid:
+                        stats = main(
+                            batch_size=batch_size,
+                            channels=channels,
+                            reso="1080p",
+                            scene_grid=scene_grid,
+                            packed=True,
+                            repeats=args.repeats,
+                            storage=storage,
+                        )
+                        storage_collection.append(
+                            [
+                                storage,
+                                # configs
+                                batch_size,
+                                channels,
+                                scene_grid,
+                                # stats
+                                f"{stats['mem_splats'] / 1024**2:0.1f}",
+                                f"{stats['mem_fwd']:0.2f}",
+                                f"{1.0 / stats['time_fwd']:0.1f} x {(batch_size)}",
+                            ]
+                        )
+                        torch.cuda.empty_cache()
+
             if "inria" in args.backends:
                 print("inria")
                 for scene_grid in args.scene_grid:
@@ -319,6 +383,20 @@ def worker(local_rank: int, world_rank: int, world_size: int, args):
 
         print(tabulate(collection, headers, tablefmt="rst"))
 
+        if storage_collection:
+            headers = [
+                "Storage",
+                # configs
+                "Batch Size",
+                "Channels",
+                "Scene Size",
+                # stats
+                "Splats (MB)",
+                "Mem[fwd] (GB)",
+                "FPS[fwd]",
+            ]
+            print(tabulate(storage_collection, headers, tablefmt="rst"))
+
 
 if __name__ == "__main__":
     import argparse
@@ -358,6 +436,14 @@ if __name__ == "__main__":
         default=[3],
         help="Number of color channels for profiling",
     )
+    parser.add_argument(
+        "--storage",
+        nargs="+",
+        type=str,
+        default=[],
+        help="Also profile inference with the Gaussians stored in these dtypes: "
+        "float32, float16, uint8",
+    )
     parser.add_argument(
         "--memory_history",
         action="store_true",
@@ -0,0 +1,151 @@
+"""Benchmark the refine steps of the strategy ops with and without a GaussianPool.
+
+A refine step duplicates, splits and prunes a fraction of the Gaussians, like the
+DefaultStrategy does, on CPU tensors with Adam states. The peak memory is the
+resident memory of the process sampled during the refine steps, above the one
+before them.
+
+Usage:
+```bash
+python profiling/pool.py --num_splats 1000000 5000000 10000000
+```
+"""
+
+import os
+import threading
+import time
+
+import torch
+
+from gsplat.strategy.ops import duplicate, remove, split
+from gsplat.strategy.pool import GaussianPool
+
+device = torch.device("cpu")
+
+
+class PeakRSS:
+    """Sample the resident memory of the process in a background thread."""
+
+    def __init__(self, interval: float = 1e-3):
+        self.interval = interval
+        self.page_size = os.sysconf("SC_PAGE_SIZE")
+
+    def _rss(self) -> int:
+        with open("/proc/self/statm") as f:
+            return int(f.read().split()[1]) * self.page_size
+
+    def _run(self):
+        while not self._done.is_set():
+            self.peak = max(self.peak, self._rss())
+            time.sleep(self.interval)
+
+    def __enter__(self):
+        self.base = self.peak = self._rss()
+        self._done = threading.Event()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+        return self
+
+    def __exit__(self, *args):
+        self._done.set()
+        self._thread.join()
+        self.peak = max(self.peak, self._rss())
+
+
+def make_splats(N: int, sh_degree: int = 3):
+    torch.manual_seed(42)
+    params = torch.nn.ParameterDict(
+        {
+            "means": torch.randn(N, 3),
+            "scales": torch.rand(N, 3) - 5,
+            "quats": torch.randn(N, 4),
+            "opacities": torch.rand(N),
+            "sh0": torch.rand(N, 1, 3),
+            "shN": torch.rand(N, (sh_degree + 1) ** 2 - 1, 3),
+        }
+    ).to(device)
+    optimizers = {k: torch.optim.Adam([v], lr=1e-3) for k, v in params.items()}
+    # populate the moments of Adam
+    for v in params.values():
+        v.grad = torch.zeros_like(v)
+    for optimizer in optimizers.values():
+        optimizer.step()
+        optimizer.zero_grad(set_to_none=True)
+    return params, optimizers
+
+
+def refine(params, optimizers, state, pool, frac: float):
+    N = len(params["means"])
+    duplicate(params, optimizers, state, torch.rand(N) < frac, pool=pool)
+    N = len(params["means"])
+    split(params, optimizers, state, torch.rand(N) < frac, pool=pool)
+    N = len(params["means"])
+    remove(params, optimizers, state, torch.rand(N) < 2 * frac, pool=pool)
+
+
+def bench(N: int, pooled: bool, steps: int, frac: float):
+    params, optimizers = make_splats(N)
+    state = {"grad2d": torch.zeros(N), "count": torch.zeros(N)}
+    pool = None
+    if pooled:
+        pool = GaussianPool(params, optimizers, capacity=int(N * 1.2))
+    refine(params, optimizers, state, pool, frac)  # warmup
+
+    with PeakRSS() as rss:
+        start = time.time()
+        for _ in range(steps):
+            refine(params, optimizers, state, pool, frac)
+        elapsed = (time.time() - start) / steps
+    return elapsed, rss.peak - rss.base
+
+
+def main(args):
+    from tabulate import tabulate
+
+    collection = []
+    for N in args.num_splats:
+        t_ops, mem_ops = bench(N, False, args.steps, args.frac)
+        t_pool, mem_pool = bench(N, True, args.steps, args.frac)
+        collection.append(
+            [
+                N,
+                f"{t_ops * 1000:.0f}",
+                f"{t_pool * 1000:.0f}",
+                f"{t_ops / t_pool:.1f}x",
+                f"{mem_ops / 1024**2:.0f}",
+                f"{mem_pool / 1024**2:.0f}",
+            ]
+        )
+    headers = [
+        "Splats",
+        "Ops (ms)",
+        "Pool (ms)",
+        "Speedup",
+        "Ops peak (MB)",
+        "Pool peak (MB)",
+    ]
+    print(tabulate(collection, headers, tablefmt="rst"))
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--num_splats",
+        nargs="+",
+        type=int,
+        default=[1_000_000, 5_000_000, 10_000_000],
+        help="Number of splats",
+    )
+    parser.add_argument(
+        "--steps", type=int, default=5, help="Number of refine steps to time"
+    )
+    parser.add_argument(
+        "--frac",
+        type=float,
+        default=0.01,
+        help="Fraction of the splats duplicated and split per refine step",
+    )
+    args = parser.parse_args()
+    main(args)
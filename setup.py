@@ -46,6 +46,9 @@ def get_extensions():
     extra_compile_args = {"cxx": ["-O3"]}
     if not os.name == "nt":  # Not on Windows:
         extra_compile_args["cxx"] += ["-Wno-sign-compare"]
+        # math functions that set errno (e.g. sqrt) keep the CPU kernels'
+        # simd loops from vectorizing
+        extra_compile_args["cxx"] += ["-fno-math-errno"]
     extra_link_args = [] if WITH_SYMBOLS else ["-s"]
 
     info = parallel_info()
@@ -0,0 +1,100 @@
+"""Tests for the delta checkpoints of gsplat.checkpoint.
+
+Usage:
+```bash
+pytest <THIS_PY_FILE> -s
+```
+"""
+
+import pytest
+import torch
+
+from gsplat.cuda._backend import _C
+
+device = torch.device("cuda:0" if torch.cuda.is_available() else "cpu")
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_delta_checkpoint(tmp_path):
+    from gsplat.checkpoint import (
+        PROVENANCE_KEY,
+        DeltaCheckpointWriter,
+        compact_checkpoint,
+        load_checkpoint,
+        track_provenance,
+    )
+    from gsplat.strategy.ops import duplicate, relocate, remove, sample_add, split
+
+    torch.manual_seed(42)
+
+    N = 1000
+    params = torch.nn.ParameterDict(
+        {
+            "means": torch.randn(N, 3),
+            "scales": torch.rand(N, 3),
+            "quats": torch.randn(N, 4),
+            "opacities": torch.rand(N),
+            "colors": torch.rand(N, 3),
+        }
+    ).to(device)
+    optimizers = {k: torch.optim.Adam([v], lr=1e-3) for k, v in params.items()}
+    track_provenance(params)
+    binoms = torch.ones((51, 51), device=device)
+
+    def mask():
+        return torch.rand(len(params["means"]), device=device) < 0.1
+
+    writer = DeltaCheckpointWriter(str(tmp_path), keyframe_every=4)
+    paths = []
+    for step in range(6):
+        duplicate(params, optimizers, {}, mask())
+        split(params, optimizers, {}, mask())
+        remove(params, optimizers, {}, mask())
+        relocate(params, optimizers, {}, mask(), binoms)
+        sample_add(params, optimizers, {}, 10, binoms)
+        with torch.no_grad():
+            for k, v in params.items():
+                if k != PROVENANCE_KEY:
+                    v.add_(torch.randn_like(v) * 1e-2)
+        expected = {k: v.detach().clone() for k, v in params.items()}
+        paths.append((writer.save(step, params), expected))
+
+    assert paths[0][0].endswith("ckpt_0_rank0.pt")
+    assert paths[1][0].endswith("ckpt_1_rank0.delta.pt")
+    assert paths[4][0].endswith("ckpt_4_rank0.pt")
+    for path, expected in paths:
+        splats = load_checkpoint(path, map_location=device)["splats"]
+        assert PROVENANCE_KEY not in splats
+        for k, v in splats.items():
+            torch.testing.assert_close(v, expected[k], atol=1e-3, rtol=0)
+
+    # fold the last delta of the first chain, the next ones keep loading
+    path, expected = paths[3]
+    full = compact_checkpoint(path, prune=True)
+    assert full.endswith("ckpt_3_rank0.pt")
+    assert not (tmp_path / "ckpt_1_rank0.delta.pt").exists()
+    splats = torch.load(full, map_location=device, weights_only=True)["splats"]
+    for k, v in splats.items():
+        torch.testing.assert_close(v, expected[k], atol=1e-3, rtol=0)
+
+
+@pytest.mark.parametrize("bits", [8, 16])
+def test_quantize_diff_outlier(bits: int):
+    from gsplat.checkpoint import DIFF_BLOCK_SIZE, _apply_delta, _quantize_diff
+
+    torch.manual_seed(42)
+
+    N = 4 * DIFF_BLOCK_SIZE + 10
+    diff = torch.randn(N, 3) * 1e-3
+    diff[0] = 100.0  # an outlier row in the first block
+    delta = {
+        "src": torch.arange(N, dtype=torch.int32),
+        "diffs": {"means": _quantize_diff(diff, bits)},
+    }
+    error = (_apply_delta({"means": torch.zeros(N, 3)}, delta)["means"] - diff).abs()
+
+    # the other blocks, including the last partial one, keep the precision of their
+    # own differences
+    qmax = 2 ** (bits - 1) - 1
+    tol = diff[DIFF_BLOCK_SIZE:].abs().amax(dim=0) / qmax
+    assert (error[DIFF_BLOCK_SIZE:] <= tol).all()
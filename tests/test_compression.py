@@ -6,13 +6,17 @@ pytest <THIS_PY_FILE> -s
 ```
 """
 
+import os
+
 import pytest
 import torch
 
-device = torch.device("cuda:0")
+from gsplat.cuda._backend import _C
+
+device = torch.device("cuda:0" if torch.cuda.is_available() else "cpu")
 
 
-@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
 def test_png_compression():
     from gsplat.compression import PngCompression
 
@@ -38,7 +42,133 @@ def test_png_compression():
     compression_method.compress(compress_dir, splats)
     # decompress the compressed files
     splats_c = compression_method.decompress(compress_dir)
+    # N is not a square number, no splat is dropped
+    for k, v in splats.items():
+        assert splats_c[k].shape == v.shape
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_kmeans_l1():
+    from gsplat.compression.png_compression import (
+        _compress_kmeans,
+        _decompress_kmeans,
+    )
+    from gsplat.cuda._wrapper import _make_lazy_cuda_func
+
+    torch.manual_seed(42)
+
+    # well separated blobs are recovered
+    n_blobs, D = 16, 45
+    centers = torch.randn(n_blobs, D) * 10
+    blob_ids = torch.arange(10000) % n_blobs
+    x = centers[blob_ids] + torch.randn(10000, D) * 0.1
+    centroids, labels = _make_lazy_cuda_func("kmeans_l1")(x, n_blobs, 20, 4096, 8, 0)
+    assert centroids.shape == (n_blobs, D)
+    assert labels.dtype == torch.int32
+    # one cluster per blob
+    mapping = torch.full((n_blobs,), -1, dtype=torch.long)
+    mapping[blob_ids] = labels.long()
+    torch.testing.assert_close(mapping[blob_ids], labels.long())
+    assert len(torch.unique(mapping)) == n_blobs
+    torch.testing.assert_close(centroids[mapping], centers, atol=0.02, rtol=0)
+
+    # the centroids are the means of their points
+    x = torch.randn(5000, 8)
+    centroids, labels = _make_lazy_cuda_func("kmeans_l1")(x, 64, 10, 1024, 4, 0)
+    means = torch.zeros(64, 8).index_add_(0, labels.long(), x)
+    counts = torch.bincount(labels.long(), minlength=64)[:, None]
+    torch.testing.assert_close(
+        centroids[counts[:, 0] > 0], (means / counts)[counts[:, 0] > 0]
+    )
+
+    # round trip through the npz file
+    compress_dir = "/tmp/gsplat/compression_kmeans"
+    os.makedirs(compress_dir, exist_ok=True)
+    shN = torch.randn(20000, 15, 3)
+    meta = _compress_kmeans(compress_dir, "shN", shN, n_clusters=1024, verbose=False)
+    shN_c = _decompress_kmeans(compress_dir, "shN", meta)
+    assert shN_c.shape == shN.shape
+    assert (shN_c - shN).abs().mean() < (shN - shN.mean()).abs().mean()
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_plas_sort():
+    from gsplat.cuda._wrapper import _make_lazy_cuda_func
+
+    torch.manual_seed(42)
+
+    def neighbor_distance(grid):
+        dx = (grid[:, 1:] - grid[:, :-1]).norm(dim=-1).mean()
+        dy = (grid[1:] - grid[:-1]).norm(dim=-1).mean()
+        return (dx + dy) / 2
+
+    # not a square number, the last row is partial
+    N, width = 10007, 101
+    params = torch.rand(N, 3)
+    order = _make_lazy_cuda_func("plas_sort")(params, width, 0.9, 1e-3, 0)
+    assert order.dtype == torch.int64
+    torch.testing.assert_close(order.sort().values, torch.arange(N))
+
+    # neighbors are much closer than in a random arrangement
+    n_full = N // width * width
+    random_grid = params[:n_full].reshape(-1, width, 3)
+    sorted_grid = params[order][:n_full].reshape(-1, width, 3)
+    assert neighbor_distance(sorted_grid) < 0.3 * neighbor_distance(random_grid)
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_rans():
+    from gsplat.compression import RansCompression
+    from gsplat.cuda._wrapper import _make_lazy_cuda_func
+
+    torch.manual_seed(42)
+
+    # lossless on smooth and noisy channels of mixed bit depths
+    N, width, tile_rows = 10007, 101, 8
+    bits = torch.tensor([16, 1, 8, 12], dtype=torch.int32)
+    maxs = 2 ** bits.long() - 1
+    smooth = torch.linspace(0, 1, N)[:, None] * maxs
+    noise = torch.randint(0, 2**16, (N, 4)) % (maxs + 1)
+    q = torch.where(torch.arange(N)[:, None] % 3 == 0, noise, smooth.round().long())
+    q = q.int().contiguous()
+    freqs, tile_sizes, data = _make_lazy_cuda_func("rans_encode")(
+        q, bits, width, tile_rows
+    )
+    assert freqs.shape == (6, 256)
+    assert (freqs.sum(dim=-1) == 4096).all()
+    assert tile_sizes.shape == (13,)
+    q_dec = _make_lazy_cuda_func("rans_decode")(
+        freqs, tile_sizes, data, bits, N, width, tile_rows
+    )
+    torch.testing.assert_close(q_dec, q)
+
+    # round trip of the splats
+    splats = torch.nn.ParameterDict(
+        {
+            "means": torch.randn(N, 3),
+            "scales": torch.randn(N, 3),
+            "quats": torch.randn(N, 4),
+            "opacities": torch.randn(N),
+            "sh0": torch.randn(N, 1, 3),
+            "shN": torch.randn(N, 24, 3),
+            "features": torch.randn(N, 128),
+        }
+    ).to(device)
+    scales = splats["scales"].detach().cpu().clone()
+    compress_dir = "/tmp/gsplat/compression_rans"
+    os.makedirs(compress_dir, exist_ok=True)
+
+    compression_method = RansCompression(use_sort=False)
+    compression_method.compress(compress_dir, splats)
+    splats_c = compression_method.decompress(compress_dir)
+    for k, v in splats.items():
+        assert splats_c[k].shape == v.shape
+    step = (scales.amax(dim=0) - scales.amin(dim=0)) / 255
+    assert ((splats_c["scales"] - scales).abs() <= step / 2 + 1e-5).all()
 
 
 if __name__ == "__main__":
     test_png_compression()
+    test_kmeans_l1()
+    test_plas_sort()
+    test_rans()
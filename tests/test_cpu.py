@@ -0,0 +1,702 @@
+"""Tests for the CPU implementations of the operators in the extension.
+
+Each CPU operator is checked against its CUDA counterpart on the same inputs.
+
+Usage:
+```bash
+pytest <THIS_PY_FILE> -s
+```
+"""
+
+import math
+import os
+
+import pytest
+import torch
+from typing_extensions import Literal, Tuple
+
+from gsplat._helper import load_test_data
+from gsplat.cuda._backend import _C
+
+device = torch.device("cuda:0" if torch.cuda.is_available() else "cpu")
+
+
+def expand(data: dict, batch_dims: Tuple[int, ...]):
+    # append multiple batch dimensions to the front of the tensor
+    ret = {}
+    for k, v in data.items():
+        if isinstance(v, torch.Tensor) and len(batch_dims) > 0:
+            new_shape = batch_dims + v.shape
+            ret[k] = v.expand(new_shape)
+        else:
+            ret[k] = v
+    return ret
+
+
+@pytest.fixture
+def test_data():
+    (
+        means,
+        quats,
+        scales,
+        opacities,
+        colors,
+        viewmats,
+        Ks,
+        width,
+        height,
+    ) = load_test_data(
+        device=device,
+        data_path=os.path.join(os.path.dirname(__file__), "../assets/test_garden.npz"),
+    )
+    return {
+        "means": means,  # [N, 3]
+        "quats": quats,  # [N, 4]
+        "scales": scales,  # [N, 3]
+        "opacities": opacities,  # [N]
+        "viewmats": viewmats,  # [C, 4, 4]
+        "Ks": Ks,  # [C, 3, 3]
+        "width": width,
+        "height": height,
+    }
+
+
+def _rasterize_inputs(test_data, channels: int, batch_dims: Tuple[int, ...]):
+    """Project the test scene on CUDA and return the rasterization inputs."""
+    from gsplat.cuda._wrapper import (
+        fully_fused_projection,
+        isect_offset_encode,
+        isect_tiles,
+    )
+
+    N = test_data["means"].shape[-2]
+    C = test_data["viewmats"].shape[-3]
+    I = math.prod(batch_dims) * C
+    test_data.update(
+        {
+            "colors": torch.rand(C, N, channels, device=device),
+            "backgrounds": torch.rand((C, channels), device=device),
+        }
+    )
+    test_data = expand(test_data, batch_dims)
+    width = test_data["width"]
+    height = test_data["height"]
+
+    radii, means2d, depths, conics, _ = fully_fused_projection(
+        test_data["means"],
+        None,
+        test_data["quats"],
+        test_data["scales"] * 0.1,
+        test_data["viewmats"],
+        test_data["Ks"],
+        width,
+        height,
+    )
+    opacities = torch.broadcast_to(
+        test_data["opacities"][..., None, :], batch_dims + (C, N)
+    )
+
+    tile_size = 16 if channels <= 32 else 4
+    tile_width = math.ceil(width / float(tile_size))
+    tile_height = math.ceil(height / float(tile_size))
+    _, isect_ids, flatten_ids = isect_tiles(
+        means2d, radii, depths, tile_size, tile_width, tile_height
+    )
+    isect_offsets = isect_offset_encode(isect_ids, I, tile_width, tile_height)
+    isect_offsets = isect_offsets.reshape(batch_dims + (C, tile_height, tile_width))
+
+    return {
+        "means2d": means2d,
+        "conics": conics,
+        "colors": test_data["colors"],
+        "opacities": opacities,
+        "image_width": width,
+        "image_height": height,
+        "tile_size": tile_size,
+        "isect_offsets": isect_offsets,
+        "flatten_ids": flatten_ids,
+        "backgrounds": test_data["backgrounds"],
+    }
+
+
+@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+@pytest.mark.parametrize("channels", [3, 32, 128])
+@pytest.mark.parametrize("batch_dims", [(), (2,)])
+def test_rasterize_to_pixels_fwd(
+    test_data, channels: int, batch_dims: Tuple[int, ...]
+):
+    from gsplat.cuda._wrapper import rasterize_to_pixels
+
+    torch.manual_seed(42)
+
+    inputs = _rasterize_inputs(test_data, channels, batch_dims)
+    render_colors, render_alphas = rasterize_to_pixels(**inputs)
+
+    inputs_cpu = {
+        k: v.contiguous().cpu() if isinstance(v, torch.Tensor) else v
+        for k, v in inputs.items()
+    }
+    _render_colors, _render_alphas = rasterize_to_pixels(**inputs_cpu)
+
+    torch.testing.assert_close(_render_colors, render_colors.cpu())
+    torch.testing.assert_close(_render_alphas, render_alphas.cpu())
+
+
+@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+@pytest.mark.parametrize("channels", [3, 32, 128])
+@pytest.mark.parametrize("batch_dims", [(), (2,)])
+def test_rasterize_to_pixels_bwd(
+    test_data, channels: int, batch_dims: Tuple[int, ...]
+):
+    from gsplat.cuda._wrapper import rasterize_to_pixels
+
+    torch.manual_seed(42)
+
+    inputs = _rasterize_inputs(test_data, channels, batch_dims)
+    inputs_cpu = {
+        k: v.detach().contiguous().cpu() if isinstance(v, torch.Tensor) else v
+        for k, v in inputs.items()
+    }
+    keys = ["means2d", "conics", "colors", "opacities", "backgrounds"]
+    for data in (inputs, inputs_cpu):
+        for k in keys:
+            data[k] = data[k].detach().clone().requires_grad_(True)
+
+    render_colors, render_alphas = rasterize_to_pixels(**inputs, absgrad=True)
+    _render_colors, _render_alphas = rasterize_to_pixels(**inputs_cpu, absgrad=True)
+
+    v_render_colors = torch.randn_like(render_colors)
+    v_render_alphas = torch.randn_like(render_alphas)
+    v_means2d, v_conics, v_colors, v_opacities, v_backgrounds = torch.autograd.grad(
+        (render_colors * v_render_colors).sum()
+        + (render_alphas * v_render_alphas).sum(),
+        [inputs[k] for k in keys],
+    )
+    (
+        _v_means2d,
+        _v_conics,
+        _v_colors,
+        _v_opacities,
+        _v_backgrounds,
+    ) = torch.autograd.grad(
+        (_render_colors * v_render_colors.cpu()).sum()
+        + (_render_alphas * v_render_alphas.cpu()).sum(),
+        [inputs_cpu[k] for k in keys],
+    )
+    torch.testing.assert_close(_v_means2d, v_means2d.cpu(), rtol=5e-3, atol=5e-3)
+    torch.testing.assert_close(
+        inputs_cpu["means2d"].absgrad,
+        inputs["means2d"].absgrad.cpu(),
+        rtol=5e-3,
+        atol=5e-3,
+    )
+    torch.testing.assert_close(_v_conics, v_conics.cpu(), rtol=1e-3, atol=1e-3)
+    torch.testing.assert_close(_v_colors, v_colors.cpu(), rtol=1e-3, atol=1e-3)
+    torch.testing.assert_close(_v_opacities, v_opacities.cpu(), rtol=8e-3, atol=6e-3)
+    torch.testing.assert_close(
+        _v_backgrounds, v_backgrounds.cpu(), rtol=1e-3, atol=1e-3
+    )
+
+
+@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+@pytest.mark.parametrize("fused", [False, True])
+@pytest.mark.parametrize("calc_compensations", [False, True])
+@pytest.mark.parametrize("camera_model", ["pinhole", "ortho", "fisheye"])
+@pytest.mark.parametrize("batch_dims", [(), (2,)])
+def test_fully_fused_projection(
+    test_data,
+    fused: bool,
+    calc_compensations: bool,
+    camera_model: Literal["pinhole", "ortho", "fisheye"],
+    batch_dims: Tuple[int, ...],
+):
+    from gsplat.cuda._torch_impl import _quat_scale_to_covar_preci
+    from gsplat.cuda._wrapper import fully_fused_projection
+
+    torch.manual_seed(42)
+
+    test_data = expand(test_data, batch_dims)
+    keys = ["means", "quats", "scales", "viewmats", "Ks"]
+    inputs = {k: test_data[k].contiguous() for k in keys}
+    inputs_cpu = {k: v.cpu() for k, v in inputs.items()}
+    for data in (inputs, inputs_cpu):
+        for k in ["means", "quats", "scales", "viewmats"]:
+            data[k].requires_grad = True
+
+    def project(data):
+        if fused:
+            covars, quats, scales = None, data["quats"], data["scales"]
+        else:
+            covars, _ = _quat_scale_to_covar_preci(
+                data["quats"], data["scales"], compute_preci=False, triu=True
+            )
+            quats, scales = None, None
+        return fully_fused_projection(
+            data["means"],
+            covars,
+            quats,
+            scales,
+            data["viewmats"],
+            data["Ks"],
+            test_data["width"],
+            test_data["height"],
+            calc_compensations=calc_compensations,
+            camera_model=camera_model,
+        )
+
+    radii, means2d, depths, conics, compensations = project(inputs)
+    _radii, _means2d, _depths, _conics, _compensations = project(inputs_cpu)
+
+    # radii is integer so we allow for 1 unit difference
+    valid = ((radii > 0).all(dim=-1) & (_radii.cuda() > 0).all(dim=-1)).cpu()
+    torch.testing.assert_close(_radii, radii.cpu(), rtol=0, atol=1)
+    torch.testing.assert_close(
+        _means2d[valid], means2d.cpu()[valid], rtol=1e-4, atol=1e-4
+    )
+    torch.testing.assert_close(_depths[valid], depths.cpu()[valid], rtol=1e-4, atol=1e-4)
+    torch.testing.assert_close(_conics[valid], conics.cpu()[valid], rtol=1e-4, atol=1e-4)
+    if calc_compensations:
+        torch.testing.assert_close(
+            _compensations[valid], compensations.cpu()[valid], rtol=1e-4, atol=1e-3
+        )
+
+    # backward
+    v_means2d = torch.randn_like(_means2d) * valid[..., None]
+    v_depths = torch.randn_like(_depths) * valid
+    v_conics = torch.randn_like(_conics) * valid[..., None]
+    v_compensations = torch.randn_like(_depths) * valid
+
+    def grads(outputs, data, device):
+        means2d, depths, conics, compensations = outputs
+        loss = (
+            (means2d * v_means2d.to(device)).sum()
+            + (depths * v_depths.to(device)).sum()
+            + (conics * v_conics.to(device)).sum()
+        )
+        if calc_compensations:
+            loss = loss + (compensations * v_compensations.to(device)).sum()
+        return torch.autograd.grad(
+            loss, [data[k] for k in ["viewmats", "quats", "scales", "means"]]
+        )
+
+    v_viewmats, v_quats, v_scales, v_means = grads(
+        (means2d, depths, conics, compensations), inputs, device
+    )
+    _v_viewmats, _v_quats, _v_scales, _v_means = grads(
+        (_means2d, _depths, _conics, _compensations), inputs_cpu, "cpu"
+    )
+    torch.testing.assert_close(_v_viewmats, v_viewmats.cpu(), rtol=2e-3, atol=2e-3)
+    torch.testing.assert_close(_v_quats, v_quats.cpu(), rtol=2e-1, atol=2e-2)
+    torch.testing.assert_close(_v_scales, v_scales.cpu(), rtol=5e-1, atol=2e-1)
+    torch.testing.assert_close(_v_means, v_means.cpu(), rtol=1e-2, atol=6e-2)
+
+
+@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+@pytest.mark.parametrize("fused", [False, True])
+@pytest.mark.parametrize("sparse_grad", [False, True])
+@pytest.mark.parametrize("calc_compensations", [False, True])
+@pytest.mark.parametrize("batch_dims", [(), (2,)])
+def test_fully_fused_projection_packed(
+    test_data,
+    fused: bool,
+    sparse_grad: bool,
+    calc_compensations: bool,
+    batch_dims: Tuple[int, ...],
+):
+    from gsplat.cuda._torch_impl import _quat_scale_to_covar_preci
+    from gsplat.cuda._wrapper import fully_fused_projection
+
+    if sparse_grad and batch_dims != ():
+        pytest.skip("sparse_grad does not support batch dimensions")
+
+    torch.manual_seed(42)
+
+    test_data = expand(test_data, batch_dims)
+    keys = ["means", "quats", "scales", "viewmats", "Ks"]
+    inputs = {k: test_data[k].contiguous() for k in keys}
+    inputs_cpu = {k: v.cpu() for k, v in inputs.items()}
+    for data in (inputs, inputs_cpu):
+        for k in ["means", "quats", "scales", "viewmats"]:
+            data[k].requires_grad = True
+
+    B = math.prod(batch_dims)
+    C = inputs["viewmats"].shape[-3]
+    N = inputs["means"].shape[-2]
+
+    def project(data):
+        if fused:
+            covars, quats, scales = None, data["quats"], data["scales"]
+        else:
+            covars, _ = _quat_scale_to_covar_preci(
+                data["quats"], data["scales"], compute_preci=False, triu=True
+            )
+            quats, scales = None, None
+        return fully_fused_projection(
+            data["means"],
+            covars,
+            quats,
+            scales,
+            data["viewmats"],
+            data["Ks"],
+            test_data["width"],
+            test_data["height"],
+            packed=True,
+            sparse_grad=sparse_grad,
+            calc_compensations=calc_compensations,
+        )
+
+    def to_dense(batch_ids, camera_ids, gaussian_ids, values):
+        # scatter the packed values to [B, C, N, ...]
+        dense = values.new_zeros((B, C, N) + values.shape[1:])
+        dense[batch_ids, camera_ids, gaussian_ids] = values
+        return dense
+
+    outputs = project(inputs)
+    _outputs = project(inputs_cpu)
+    batch_ids, camera_ids, gaussian_ids, radii = outputs[:4]
+    _batch_ids, _camera_ids, _gaussian_ids, _radii = _outputs[:4]
+
+    # the packed outputs are sorted by (batch, camera, gaussian)
+    _ids = (_batch_ids * C + _camera_ids) * N + _gaussian_ids
+    assert (_ids[1:] > _ids[:-1]).all()
+
+    radii = to_dense(batch_ids, camera_ids, gaussian_ids, radii).cpu()
+    _radii = to_dense(_batch_ids, _camera_ids, _gaussian_ids, _radii)
+    # radii is integer so we allow for 1 unit difference
+    valid = (radii > 0).all(dim=-1) & (_radii > 0).all(dim=-1)
+    torch.testing.assert_close(_radii, radii, rtol=0, atol=1)
+    for i in range(4, 7 + calc_compensations):
+        value = to_dense(batch_ids, camera_ids, gaussian_ids, outputs[i]).cpu()
+        _value = to_dense(_batch_ids, _camera_ids, _gaussian_ids, _outputs[i])
+        torch.testing.assert_close(
+            _value[valid], value[valid], rtol=1e-4, atol=1e-3
+        )
+
+    # backward, with the same random gradients on the shared (camera, gaussian)
+    v_means2d = torch.randn(B, C, N, 2) * valid[..., None]
+    v_depths = torch.randn(B, C, N) * valid
+    v_conics = torch.randn(B, C, N, 3) * valid[..., None]
+    v_compensations = torch.randn(B, C, N) * valid
+
+    def grads(outputs, data, device):
+        ids = tuple(x.cpu() for x in outputs[:3])
+        means2d, depths, conics, compensations = outputs[4:]
+        loss = (
+            (means2d * v_means2d[ids].to(device)).sum()
+            + (depths * v_depths[ids].to(device)).sum()
+            + (conics * v_conics[ids].to(device)).sum()
+        )
+        if calc_compensations:
+            loss = loss + (compensations * v_compensations[ids].to(device)).sum()
+        v_inputs = torch.autograd.grad(
+            loss, [data[k] for k in ["viewmats", "quats", "scales", "means"]]
+        )
+        return [v.to_dense() if v.is_sparse else v for v in v_inputs]
+
+    v_viewmats, v_quats, v_scales, v_means = grads(outputs, inputs, device)
+    _v_viewmats, _v_quats, _v_scales, _v_means = grads(_outputs, inputs_cpu, "cpu")
+    torch.testing.assert_close(_v_viewmats, v_viewmats.cpu(), rtol=2e-3, atol=2e-3)
+    torch.testing.assert_close(_v_quats, v_quats.cpu(), rtol=2e-1, atol=2e-2)
+    torch.testing.assert_close(_v_scales, v_scales.cpu(), rtol=5e-1, atol=2e-1)
+    torch.testing.assert_close(_v_means, v_means.cpu(), rtol=1e-2, atol=6e-2)
+
+
+@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+@pytest.mark.parametrize("segmented", [False, True])
+@pytest.mark.parametrize("batch_dims", [(), (2,)])
+def test_isect(test_data, segmented: bool, batch_dims: Tuple[int, ...]):
+    from gsplat.cuda._wrapper import (
+        fully_fused_projection,
+        isect_offset_encode,
+        isect_tiles,
+    )
+
+    test_data = expand(test_data, batch_dims)
+    width, height = test_data["width"], test_data["height"]
+    radii, means2d, depths, _, _ = fully_fused_projection(
+        test_data["means"],
+        None,
+        test_data["quats"],
+        test_data["scales"],
+        test_data["viewmats"],
+        test_data["Ks"],
+        width,
+        height,
+    )
+    I = math.prod(batch_dims) * test_data["viewmats"].shape[-3]
+
+    tile_size = 16
+    tile_width = math.ceil(width / float(tile_size))
+    tile_height = math.ceil(height / float(tile_size))
+
+    tiles_per_gauss, isect_ids, flatten_ids = isect_tiles(
+        means2d, radii, depths, tile_size, tile_width, tile_height, segmented=segmented
+    )
+    isect_offsets = isect_offset_encode(isect_ids, I, tile_width, tile_height)
+
+    _tiles_per_gauss, _isect_ids, _flatten_ids = isect_tiles(
+        means2d.cpu(),
+        radii.cpu(),
+        depths.cpu(),
+        tile_size,
+        tile_width,
+        tile_height,
+        segmented=segmented,
+    )
+    _isect_offsets = isect_offset_encode(_isect_ids, I, tile_width, tile_height)
+
+    # both sorts are stable so the results are identical
+    torch.testing.assert_close(_tiles_per_gauss, tiles_per_gauss.cpu(), rtol=0, atol=0)
+    torch.testing.assert_close(_isect_ids, isect_ids.cpu(), rtol=0, atol=0)
+    torch.testing.assert_close(_flatten_ids, flatten_ids.cpu(), rtol=0, atol=0)
+    torch.testing.assert_close(_isect_offsets, isect_offsets.cpu(), rtol=0, atol=0)
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("sh_degree", [0, 1, 2, 3, 4])
+@pytest.mark.parametrize("use_masks", [False, True])
+@pytest.mark.parametrize("batch_dims", [(), (2,)])
+def test_sh(sh_degree: int, use_masks: bool, batch_dims: Tuple[int, ...]):
+    from gsplat.cuda._torch_impl import _spherical_harmonics
+    from gsplat.cuda._wrapper import spherical_harmonics
+
+    torch.manual_seed(42)
+
+    N = 1000
+    test_data = {
+        "coeffs": torch.randn(N, (4 + 1) ** 2, 3),
+        "dirs": torch.randn(N, 3),
+        "masks": torch.rand(N) > 0.3,
+    }
+    test_data = expand(test_data, batch_dims)
+    coeffs = test_data["coeffs"].contiguous().requires_grad_(True)
+    dirs = test_data["dirs"].contiguous().requires_grad_(True)
+    masks = test_data["masks"].contiguous() if use_masks else None
+
+    colors = spherical_harmonics(sh_degree, dirs, coeffs, masks=masks)
+    _colors = _spherical_harmonics(sh_degree, dirs, coeffs)
+    if masks is not None:
+        # masked Gaussians are skipped and get zero colors
+        _colors = _colors * masks[..., None]
+    torch.testing.assert_close(colors, _colors, rtol=1e-4, atol=1e-4)
+
+    v_colors = torch.randn_like(colors)
+    v_coeffs, v_dirs = torch.autograd.grad(
+        (colors * v_colors).sum(), (coeffs, dirs), allow_unused=True
+    )
+    _v_coeffs, _v_dirs = torch.autograd.grad(
+        (_colors * v_colors).sum(), (coeffs, dirs), allow_unused=True
+    )
+    torch.testing.assert_close(v_coeffs, _v_coeffs, rtol=1e-4, atol=1e-4)
+    if sh_degree > 0:
+        torch.testing.assert_close(v_dirs, _v_dirs, rtol=1e-4, atol=1e-4)
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("dtype", [torch.float16, torch.uint8])
+def test_storage(test_data, dtype: torch.dtype):
+    from gsplat.cuda._torch_impl import _spherical_harmonics
+    from gsplat.cuda._wrapper import (
+        fully_fused_projection,
+        fully_fused_projection_storage,
+        spherical_harmonics_storage,
+    )
+    from gsplat.storage import (
+        MEANS_OFFSET,
+        OPACITIES_OFFSET,
+        QUATS_OFFSET,
+        SCALES_OFFSET,
+        dequantize,
+        quantize_gaussians,
+    )
+
+    torch.manual_seed(42)
+
+    test_data = {
+        k: v.cpu() if isinstance(v, torch.Tensor) else v for k, v in test_data.items()
+    }
+    N = test_data["means"].shape[0]
+    coeffs = torch.randn(N, 16, 3)
+    means, quats, scales, opacities, coeffs, dequantization = quantize_gaussians(
+        test_data["means"],
+        test_data["quats"],
+        test_data["scales"],
+        test_data["opacities"],
+        coeffs,
+        dtype=dtype,
+    )
+
+    # the float32 Gaussians the storage stands for
+    ids = torch.arange(N)
+    if dequantization is None:
+        d_geometry, d_colors, chunk_size = None, None, 0
+    else:
+        d_geometry = dequantization.geometry
+        d_colors = dequantization.colors
+        chunk_size = dequantization.chunk_size
+    _means = dequantize(means, ids, d_geometry, chunk_size, MEANS_OFFSET)
+    _quats = dequantize(quats, ids, d_geometry, chunk_size, QUATS_OFFSET)
+    _scales = dequantize(scales, ids, d_geometry, chunk_size, SCALES_OFFSET)
+    if dequantization is not None:
+        _scales = torch.exp(_scales)
+    _opacities = dequantize(opacities, ids, d_geometry, chunk_size, OPACITIES_OFFSET)
+    _coeffs = dequantize(coeffs, ids, d_colors, chunk_size)
+    # converting all the Gaussians needs no ids
+    torch.testing.assert_close(dequantize(coeffs, None, d_colors, chunk_size), _coeffs)
+
+    radii, means2d, depths, conics, _, opacities2d = fully_fused_projection_storage(
+        means,
+        quats,
+        scales,
+        opacities,
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+        dequant=d_geometry,
+        chunk_size=chunk_size,
+    )
+    _radii, _means2d, _depths, _conics, _ = fully_fused_projection(
+        _means,
+        None,
+        _quats,
+        _scales,
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+        opacities=_opacities,
+    )
+    visible, _visible = (radii > 0).all(dim=-1), (_radii > 0).all(dim=-1)
+    assert (visible != _visible).float().mean() < 1e-3
+    valid = visible & _visible
+    torch.testing.assert_close(radii[valid], _radii[valid], rtol=0, atol=1)
+    torch.testing.assert_close(means2d[valid], _means2d[valid], rtol=1e-4, atol=1e-4)
+    torch.testing.assert_close(depths[valid], _depths[valid], rtol=1e-4, atol=1e-4)
+    torch.testing.assert_close(conics[valid], _conics[valid], rtol=1e-4, atol=1e-4)
+    # the kernel returns the opacities it read
+    _opacities2d = _opacities.expand_as(opacities2d)
+    torch.testing.assert_close(opacities2d[visible], _opacities2d[visible])
+
+    # the packed projection gives the visible entries of the unpacked one
+    (
+        _,
+        camera_ids,
+        gaussian_ids,
+        p_radii,
+        p_means2d,
+        p_depths,
+        p_conics,
+        _,
+        p_opacities,
+    ) = fully_fused_projection_storage(
+        means,
+        quats,
+        scales,
+        opacities,
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+        dequant=d_geometry,
+        chunk_size=chunk_size,
+        packed=True,
+    )
+    assert len(camera_ids) == visible.sum()
+    assert visible[camera_ids, gaussian_ids].all()
+    torch.testing.assert_close(p_radii, radii[camera_ids, gaussian_ids])
+    torch.testing.assert_close(p_means2d, means2d[camera_ids, gaussian_ids])
+    torch.testing.assert_close(p_depths, depths[camera_ids, gaussian_ids])
+    torch.testing.assert_close(p_conics, conics[camera_ids, gaussian_ids])
+    torch.testing.assert_close(p_opacities, _opacities[gaussian_ids])
+
+    # the directions are computed in the kernel from the stored means
+    C = len(test_data["viewmats"])
+    campos = torch.randn(C, 3)
+    sh_camera_ids = torch.randint(0, C, (1000,))
+    sh_gaussian_ids = torch.randint(0, N, (1000,))
+    colors = spherical_harmonics_storage(
+        3,
+        means,
+        coeffs,
+        campos,
+        sh_camera_ids,
+        sh_gaussian_ids,
+        d_geometry,
+        d_colors,
+        chunk_size,
+    )  # [1000, 3]
+    _colors = _spherical_harmonics(
+        3,
+        _means[sh_gaussian_ids] - campos[sh_camera_ids],
+        _coeffs[sh_gaussian_ids],
+    )
+    torch.testing.assert_close(colors, _colors, rtol=1e-4, atol=1e-4)
+    colors = spherical_harmonics_storage(
+        3, means, coeffs, campos, None, None, d_geometry, d_colors, chunk_size
+    )  # [C, N, 3]
+    _colors = _spherical_harmonics(
+        3, _means[None] - campos[:, None], _coeffs.expand(C, -1, -1, -1)
+    )
+    torch.testing.assert_close(colors, _colors, rtol=1e-4, atol=1e-4)
+
+
+@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+@pytest.mark.parametrize("feature_dims", [(), (3,), (16, 3)])
+def test_selective_adam(feature_dims: Tuple[int, ...]):
+    from gsplat.optimizers import SelectiveAdam
+
+    torch.manual_seed(42)
+
+    N = 10000
+    param = torch.randn((N,) + feature_dims, device=device)
+    visibility = torch.rand(N, device=device) > 0.7
+
+    params, optimizers = [], []
+    for d in (device, "cpu"):
+        p = torch.nn.Parameter(param.clone().to(d))
+        params.append(p)
+        optimizers.append(SelectiveAdam([p], eps=1e-15, betas=(0.9, 0.999)))
+
+    for _ in range(3):
+        grad = torch.randn_like(param)
+        for p, optimizer in zip(params, optimizers):
+            p.grad = grad.to(p.device)
+            optimizer.step(visibility.to(p.device))
+
+    cuda_param, cpu_param = params
+    torch.testing.assert_close(cpu_param.data, cuda_param.data.cpu())
+    # invisible rows are left untouched
+    torch.testing.assert_close(
+        cpu_param.data[~visibility.cpu()], param[~visibility].cpu()
+    )
+    for key in ["exp_avg", "exp_avg_sq"]:
+        torch.testing.assert_close(
+            optimizers[1].state[cpu_param][key],
+            optimizers[0].state[cuda_param][key].cpu(),
+        )
+
+
+@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+def test_relocation():
+    from gsplat.relocation import compute_relocation
+
+    torch.manual_seed(42)
+
+    N, n_max = 100000, 51
+    binoms = torch.zeros((n_max, n_max))
+    for n in range(n_max):
+        for k in range(n + 1):
+            binoms[n, k] = math.comb(n, k)
+    opacities = torch.rand(N) * 0.99 + 0.005
+    scales = torch.rand(N, 3)
+    ratios = torch.randint(1, 11, (N,))
+
+    new_opacities, new_scales = compute_relocation(
+        opacities.to(device), scales.to(device), ratios.to(device), binoms.to(device)
+    )
+    _new_opacities, _new_scales = compute_relocation(
+        opacities, scales, ratios, binoms
+    )
+    torch.testing.assert_close(_new_opacities, new_opacities.cpu())
+    torch.testing.assert_close(_new_scales, new_scales.cpu(), rtol=1e-4, atol=1e-5)
@@ -0,0 +1,153 @@
+"""Tests for the frustum culling index.
+
+Usage:
+```bash
+pytest <THIS_PY_FILE> -s
+```
+"""
+
+import os
+
+import pytest
+import torch
+
+from gsplat._helper import load_test_data
+from gsplat.cuda._backend import _C
+
+device = torch.device("cuda:0" if torch.cuda.is_available() else "cpu")
+
+
+@pytest.fixture
+def test_data():
+    (
+        means,
+        quats,
+        scales,
+        opacities,
+        colors,
+        viewmats,
+        Ks,
+        width,
+        height,
+    ) = load_test_data(
+        device=device,
+        data_path=os.path.join(os.path.dirname(__file__), "../assets/test_garden.npz"),
+    )
+    return {
+        "means": means,  # [N, 3]
+        "quats": quats,  # [N, 4]
+        "scales": scales,  # [N, 3]
+        "opacities": opacities,  # [N]
+        "colors": colors,  # [N, 3]
+        "viewmats": viewmats,  # [C, 4, 4]
+        "Ks": Ks,  # [C, 3, 3]
+        "width": width,
+        "height": height,
+    }
+
+
+def _check_candidates(index, test_data, camera_model: str):
+    from gsplat.cuda._wrapper import fully_fused_projection
+
+    N = test_data["means"].shape[0]
+    C = test_data["viewmats"].shape[0]
+    camera_ids, gaussian_ids = index.query(
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+        camera_model=camera_model,
+    )
+    assert (camera_ids[1:] >= camera_ids[:-1]).all()
+    is_candidate = torch.zeros(C, N, dtype=torch.bool, device=device)
+    is_candidate[camera_ids, gaussian_ids] = True
+    assert is_candidate.sum() == len(gaussian_ids)
+
+    # every projected Gaussian is a candidate
+    radii, _, _, _, _ = fully_fused_projection(
+        test_data["means"],
+        None,
+        test_data["quats"],
+        test_data["scales"],
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+        camera_model=camera_model,
+    )
+    is_visible = (radii > 0).all(dim=-1)
+    assert is_candidate[is_visible].all()
+    return is_candidate
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("camera_model", ["pinhole", "ortho", "fisheye"])
+def test_frustum_index(test_data, camera_model: str):
+    from gsplat.culling import build_frustum_index
+
+    index = build_frustum_index(test_data["means"], test_data["scales"])
+    assert sorted(index.order.tolist()) == list(range(len(test_data["means"])))
+    is_candidate = _check_candidates(index, test_data, camera_model)
+    if camera_model == "pinhole":
+        assert not is_candidate.all()
+
+    # the query stays conservative after the Gaussians moved
+    test_data["means"] = test_data["means"] + 0.1 * torch.randn_like(
+        test_data["means"]
+    )
+    test_data["scales"] = test_data["scales"] * 1.5
+    index.refit(test_data["means"], test_data["scales"])
+    _check_candidates(index, test_data, camera_model)
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_frustum_index_extent():
+    from gsplat.cuda._wrapper import fully_fused_projection
+    from gsplat.culling import build_frustum_index
+
+    # an orthographic camera that sees 0 <= x, y <= 10, and two Gaussians left of
+    # it: the center of the first one is outside but its 3.33-sigma extent is not
+    means = torch.tensor([[-3.2, 5.0, 5.0], [-4.5, 5.0, 5.0]], device=device)
+    quats = torch.tensor([[1.0, 0.0, 0.0, 0.0]], device=device).repeat(2, 1)
+    scales = torch.ones(2, 3, device=device)
+    viewmats = torch.eye(4, device=device)[None]
+    Ks = torch.eye(3, device=device)[None]
+
+    radii, _, _, _, _ = fully_fused_projection(
+        means, None, quats, scales, viewmats, Ks, 10, 10, camera_model="ortho"
+    )
+    assert (radii[0] > 0).all(dim=-1).tolist() == [True, False]
+
+    index = build_frustum_index(means, scales)
+    _, gaussian_ids = index.query(
+        viewmats, Ks, 10, 10, padding=0.0, camera_model="ortho"
+    )
+    assert gaussian_ids.tolist() == [0]
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_rasterization_frustum_culling(test_data):
+    from gsplat.culling import build_frustum_index
+    from gsplat.rendering import rasterization
+
+    index = build_frustum_index(test_data["means"], test_data["scales"])
+    args = (
+        test_data["means"],
+        test_data["quats"],
+        test_data["scales"],
+        test_data["opacities"],
+        test_data["colors"],
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+    )
+    render_colors, render_alphas, meta = rasterization(*args, packed=True)
+    _render_colors, _render_alphas, _meta = rasterization(
+        *args, packed=True, frustum_index=index
+    )
+    torch.testing.assert_close(render_colors, _render_colors, rtol=1e-4, atol=1e-4)
+    torch.testing.assert_close(render_alphas, _render_alphas, rtol=1e-4, atol=1e-4)
+    torch.testing.assert_close(meta["camera_ids"], _meta["camera_ids"])
+    torch.testing.assert_close(meta["gaussian_ids"], _meta["gaussian_ids"])
+    torch.testing.assert_close(meta["radii"], _meta["radii"])
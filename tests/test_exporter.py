@@ -0,0 +1,110 @@
+"""Tests for the exporters.
+
+Usage:
+```bash
+pytest <THIS_PY_FILE> -s
+```
+"""
+
+import pytest
+import torch
+
+from gsplat.cuda._backend import _C
+
+
+def _random_splats(N: int, K: int):
+    torch.manual_seed(42)
+    splats = {
+        "means": torch.randn(N, 3),
+        "scales": torch.randn(N, 3),
+        "quats": torch.randn(N, 4),
+        "opacities": torch.randn(N),
+        "sh0": torch.randn(N, 1, 3),
+        "shN": torch.randn(N, K, 3),
+    }
+    # a few invalid splats
+    splats["means"][3, 1] = float("nan")
+    splats["opacities"][10] = float("inf")
+    splats["shN"][-1, -1, -1] = float("-inf")
+    return splats
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("K", [0, 15])
+def test_export_ply_streaming(tmp_path, K: int):
+    from gsplat.exporter import export_splats
+
+    # more splats than one chunk of the native writer
+    splats = _random_splats(100_000, K)
+    data = export_splats(**splats, format="ply")
+
+    path = tmp_path / "splats.ply"
+    assert export_splats(**splats, format="ply", save_to=path, streaming=True) is None
+    assert path.read_bytes() == data
+
+    # CUDA tensors are moved to the CPU chunk by chunk
+    if torch.cuda.is_available():
+        splats = {k: v.cuda() for k, v in splats.items()}
+        export_splats(**splats, format="ply", save_to=path, streaming=True)
+        assert path.read_bytes() == data
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("K", [0, 15])
+def test_export_ply_compressed_native(K: int):
+    from gsplat.exporter import splat2ply_bytes_compressed
+
+    splats = _random_splats(10_000, K)
+    splats = {k: torch.nan_to_num(v, posinf=0.0, neginf=0.0) for k, v in splats.items()}
+    # many equal Morton codes
+    splats["means"][::7] = splats["means"][0]
+    splats["sh0"] = splats["sh0"].squeeze(1)
+    splats["shN"] = splats["shN"].permute(0, 2, 1).reshape(10_000, -1)
+
+    data = splat2ply_bytes_compressed(**splats, native=False)
+    assert splat2ply_bytes_compressed(**splats, native=True) == data
+    # the native encoder is picked when the extension is available
+    assert splat2ply_bytes_compressed(**splats) == data
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_export_splats_multi():
+    from gsplat.exporter import export_splats, export_splats_multi
+
+    splats = _random_splats(10_000, 15)
+    formats = ["ply", "splat", "ply_compressed", "chunked"]
+    timings = {}
+    results = export_splats_multi(**splats, formats=formats, timings=timings)
+    for format in formats:
+        assert results[format] == export_splats(**splats, format=format)
+    assert {"filter", "sort", "encode"} <= timings.keys()
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_export_checkpoints(tmp_path):
+    from gsplat.exporter import export_checkpoints, export_splats
+
+    ckpts = []
+    for i in range(3):
+        splats = _random_splats(1000 * (i + 1), 3)
+        ckpts.append(str(tmp_path / f"ckpt_{i}.pt"))
+        torch.save({"step": i, "splats": splats}, ckpts[-1])
+    ckpts.append(str(tmp_path / "broken.pt"))
+    torch.save({"step": 0, "splats": {}}, ckpts[-1])
+
+    # a budget of a single checkpoint runs them one by one
+    reports = export_checkpoints(
+        ckpts,
+        ["ply", "splat"],
+        output_dir=str(tmp_path / "out"),
+        num_workers=2,
+        memory_budget=1,
+    )
+    assert [r.ckpt for r in reports] == ckpts
+    assert reports[-1].error is not None
+    for i, report in enumerate(reports[:-1]):
+        assert report.error is None
+        splats = _random_splats(1000 * (i + 1), 3)
+        with open(report.files["splat"], "rb") as f:
+            assert f.read() == export_splats(**splats, format="splat")
+        assert report.files["ply"].endswith(f"ckpt_{i}.ply")
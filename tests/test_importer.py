@@ -0,0 +1,179 @@
+"""Tests for the importers.
+
+Usage:
+```bash
+pytest <THIS_PY_FILE> -s
+```
+"""
+
+import pytest
+import torch
+import torch.nn.functional as F
+
+from gsplat.cuda._backend import _C
+
+
+def _random_splats(N: int, K: int):
+    torch.manual_seed(42)
+    return {
+        "means": torch.randn(N, 3),
+        "scales": torch.randn(N, 3),
+        "quats": torch.randn(N, 4),
+        "opacities": torch.randn(N),
+        "sh0": torch.randn(N, 1, 3),
+        "shN": torch.randn(N, K, 3),
+    }
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("K", [0, 15])
+def test_import_ply(tmp_path, K: int):
+    from gsplat.exporter import export_splats
+    from gsplat.importer import import_splats
+
+    splats = _random_splats(10_000, K)
+    path = tmp_path / "splats.ply"
+    export_splats(**splats, format="ply", save_to=path)
+
+    loaded = import_splats(path)
+    for k, v in splats.items():
+        assert loaded[k].shape == v.shape
+        torch.testing.assert_close(loaded[k], v, rtol=0, atol=0)
+    # all the tensors view the same mapping of the file
+    storage = loaded["means"].untyped_storage().data_ptr()
+    for v in loaded.values():
+        assert v.untyped_storage().data_ptr() == storage
+
+    # round trip
+    assert export_splats(**loaded, format="ply") == path.read_bytes()
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("K", [0, 15])
+def test_import_ply_compressed(tmp_path, K: int):
+    from gsplat.exporter import export_splats, sort_centers
+    from gsplat.importer import import_splats
+
+    splats = _random_splats(10_000, K)
+    path = tmp_path / "splats.ply"
+    export_splats(**splats, format="ply_compressed", save_to=path)
+    loaded = import_splats(path)
+
+    # the exporter drops the transparent splats and sorts the others
+    mask = torch.sigmoid(splats["opacities"]) > 1 / 255
+    splats = {k: v[mask] for k, v in splats.items()}
+    order = sort_centers(splats["means"], torch.arange(len(splats["means"])))
+    splats = {k: v[order] for k, v in splats.items()}
+
+    for k, v in splats.items():
+        assert loaded[k].shape == v.shape
+    # 10 or 11 bits within the bounds of each chunk of 256 splats
+    torch.testing.assert_close(loaded["means"], splats["means"], rtol=0, atol=1e-2)
+    torch.testing.assert_close(loaded["scales"], splats["scales"], rtol=0, atol=1e-2)
+    dots = (loaded["quats"] * F.normalize(splats["quats"], dim=-1)).sum(-1).abs()
+    assert (dots > 0.999).all()
+    # 8 bits for the colors, the opacities and the SH coefficients
+    torch.testing.assert_close(
+        torch.sigmoid(loaded["opacities"]),
+        torch.sigmoid(splats["opacities"]),
+        rtol=0,
+        atol=1 / 255,
+    )
+    torch.testing.assert_close(loaded["sh0"], splats["sh0"], rtol=0, atol=5e-2)
+    torch.testing.assert_close(
+        loaded["shN"], splats["shN"].clamp(-4, 4 - 1 / 32), rtol=0, atol=2e-2
+    )
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_import_splat(tmp_path):
+    from gsplat.exporter import export_splats, sort_centers
+    from gsplat.importer import import_splats
+
+    splats = _random_splats(1_000, 0)
+    path = tmp_path / "splats.splat"
+    export_splats(**splats, format="splat", save_to=path)
+    loaded = import_splats(path)
+
+    order = sort_centers(splats["means"], torch.arange(len(splats["means"])))
+    splats = {k: v[order] for k, v in splats.items()}
+    torch.testing.assert_close(loaded["means"], splats["means"], rtol=0, atol=0)
+    torch.testing.assert_close(loaded["scales"], splats["scales"])
+    assert loaded["shN"].shape == (1_000, 0, 3)
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_import_chunked(tmp_path):
+    from gsplat.exporter import export_splats
+    from gsplat.importer import ChunkedSplats, import_splats
+
+    splats = _random_splats(10_000, 15)
+    # small splats, which barely widen the boxes of the chunks for the culling
+    splats["scales"] -= 8.0
+    # the SH band of degree 3 is zero, the one of degree 2 is zero for x < 0
+    splats["shN"][:, 8:] = 0.0
+    splats["shN"][splats["means"][:, 0] < 0, 3:8] = 0.0
+    export_splats(**splats, format="chunked", save_to=tmp_path / "splats.gsc")
+    export_splats(**splats, format="ply_compressed", save_to=tmp_path / "splats.ply")
+
+    # same chunks and decoder as the compressed PLY file
+    loaded = import_splats(tmp_path / "splats.gsc")
+    expected = import_splats(tmp_path / "splats.ply")
+    for k, v in expected.items():
+        torch.testing.assert_close(loaded[k], v, rtol=0, atol=0)
+
+    chunked = ChunkedSplats(tmp_path / "splats.gsc")
+    assert chunked.num_splats == len(expected["means"])
+    assert (chunked.sh_masks & 0b100 == 0).all()
+    assert (chunked.sh_masks & 0b010 == 0).any()
+    assert (chunked.sh_masks & 0b010 != 0).any()
+
+    # a camera at z = -10 looking at the splats
+    viewmat = torch.eye(4)
+    viewmat[2, 3] = 10.0
+    K = torch.tensor([[100.0, 0.0, 50.0], [0.0, 100.0, 50.0], [0.0, 0.0, 1.0]])
+    chunk_ids = chunked.cull(viewmat, K, 100, 100)
+    assert 0 < len(chunk_ids) < chunked.num_chunks
+    splat_ids = chunked.fetch(chunk_ids, sh_degree=1)
+    assert (chunked.loaded_sh_degree[chunk_ids] == 1).all()
+
+    # all the splats in the image are fetched
+    means = expected["means"] + viewmat[:3, 3]
+    uv = means @ K.T
+    uv = uv[:, :2] / uv[:, 2:]
+    inside = (means[:, 2] > 0.01) & ((uv >= 0) & (uv < 100)).all(dim=-1)
+    assert torch.isin(torch.where(inside)[0], splat_ids).all()
+    for k, v in expected.items():
+        if k == "shN":
+            v = v.clone()
+            # the bands of degree 2 and 3 are left at zero (quantized to 128)
+            v[:, 3:] = ((128 + 0.5) / 256 - 0.5) * 8
+        torch.testing.assert_close(chunked.splats[k][splat_ids], v[splat_ids])
+
+    # refine to the full SH degree
+    chunked.fetch(chunk_ids)
+    torch.testing.assert_close(
+        chunked.splats["shN"][splat_ids], expected["shN"][splat_ids]
+    )
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_chunked_cull_extent(tmp_path):
+    from gsplat.exporter import export_splats
+    from gsplat.importer import ChunkedSplats
+
+    # a chunk left of the view of a camera at z = -10, which only its large
+    # splats reach into
+    splats = _random_splats(256, 3)
+    splats["means"] = splats["means"] * 0.1 + torch.tensor([-6.0, 0.0, 0.0])
+    splats["opacities"][:] = 5.0
+    viewmat = torch.eye(4)
+    viewmat[2, 3] = 10.0
+    K = torch.tensor([[100.0, 0.0, 50.0], [0.0, 100.0, 50.0], [0.0, 0.0, 1.0]])
+    for scale, n_visible in [(0.05, 0), (1.0, 1)]:
+        splats["scales"] = torch.full((256, 3), scale).log()
+        path = tmp_path / f"splats_{scale}.gsc"
+        export_splats(**splats, format="chunked", save_to=path)
+        chunked = ChunkedSplats(path)
+        assert chunked.num_chunks == 1
+        assert len(chunked.cull(viewmat, K, 100, 100)) == n_visible
@@ -0,0 +1,55 @@
+"""Tests for the k-d tree.
+
+Usage:
+```bash
+pytest <THIS_PY_FILE> -s
+```
+"""
+
+import pytest
+import torch
+
+from gsplat.cuda._backend import _C
+
+device = torch.device("cuda:0" if torch.cuda.is_available() else "cpu")
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("N", [1, 3, 1000])
+@pytest.mark.parametrize("leaf_size", [1, 16])
+def test_kdtree(N: int, leaf_size: int):
+    from gsplat.neighbors import build_kdtree, knn
+
+    torch.manual_seed(42)
+
+    # a plane with duplicated points, the worst case of the median splits
+    points = torch.randn(N, 3)
+    points[:, 2] = 0.0
+    points[: N // 4] = points[N // 4 : N // 2]
+    queries = torch.randn(100, 3, device=device)
+
+    tree = build_kdtree(points, leaf_size=leaf_size)
+    assert (tree.order.sort().values == torch.arange(N)).all()
+
+    K = 4
+    distances, indices = tree.query(queries, K)
+    assert distances.device == queries.device
+    mode = "donot_use_mm_for_euclid_dist"
+    dists = torch.cdist(queries.cpu(), points, compute_mode=mode)  # [M, N]
+    k = min(K, N)
+    expected = dists.topk(k, dim=-1, largest=False).values
+    torch.testing.assert_close(distances[:, :k].cpu(), expected)
+    torch.testing.assert_close(
+        dists.gather(1, indices[:, :k].cpu()), distances[:, :k].cpu()
+    )
+    # padding when there are fewer than K points
+    assert distances[:, k:].isinf().all()
+    assert (indices[:, k:] == -1).all()
+
+    # the points themselves, in their input order
+    distances, indices = tree.query_self(K)
+    torch.testing.assert_close(distances[:, 0], torch.zeros(N))
+    dists = torch.cdist(points, points, compute_mode=mode)
+    expected = dists.topk(k, dim=-1, largest=False).values
+    torch.testing.assert_close(distances[:, :k], expected)
+    torch.testing.assert_close(knn(points.to(device), K)[:, :k].cpu(), expected)
@@ -0,0 +1,167 @@
+"""Tests for the level-of-detail tree.
+
+Usage:
+```bash
+pytest <THIS_PY_FILE> -s
+```
+"""
+
+import os
+
+import pytest
+import torch
+
+from gsplat._helper import load_test_data
+from gsplat.cuda._backend import _C
+
+device = torch.device("cuda:0" if torch.cuda.is_available() else "cpu")
+
+
+@pytest.fixture
+def test_data():
+    (
+        means,
+        quats,
+        scales,
+        opacities,
+        colors,
+        viewmats,
+        Ks,
+        width,
+        height,
+    ) = load_test_data(
+        device=device,
+        data_path=os.path.join(os.path.dirname(__file__), "../assets/test_garden.npz"),
+    )
+    return {
+        "means": means,  # [N, 3]
+        "quats": quats,  # [N, 4]
+        "scales": scales,  # [N, 3]
+        "opacities": opacities,  # [N]
+        "colors": colors,  # [N, 3]
+        "viewmats": viewmats,  # [C, 4, 4]
+        "Ks": Ks,  # [C, 3, 3]
+        "width": width,
+        "height": height,
+    }
+
+
+def _leaves_of(tree, node_ids: torch.Tensor) -> torch.Tensor:
+    """Count how many times each leaf is covered by the nodes."""
+    N = tree.n_leaves
+    counts = torch.zeros(N, dtype=torch.int64)
+    stack = node_ids.cpu().tolist()
+    while stack:
+        i = stack.pop()
+        if i < N:
+            counts[i] += 1
+        else:
+            start, end = tree.child_offsets[i - N : i - N + 2].tolist()
+            stack.extend(tree.children[start:end].tolist())
+    return counts
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_lod_tree(test_data):
+    from gsplat.lod import build_lod_tree
+
+    N = test_data["means"].shape[0]
+    tree = build_lod_tree(
+        test_data["means"],
+        test_data["quats"],
+        test_data["scales"],
+        test_data["opacities"],
+        test_data["colors"],
+    )
+    M = tree.node_means.shape[0]
+    assert tree.n_nodes == N + M
+    assert tree.children.shape == (N + M - 1,)
+    assert tree.child_offsets[-1].item() == N + M - 1
+    # every node but the root has exactly one parent
+    counts = torch.bincount(tree.children, minlength=N + M)
+    assert (counts[:-1] == 1).all() and counts[-1] == 0
+    assert (tree.node_opacities >= 0).all() and (tree.node_opacities <= 1).all()
+    torch.testing.assert_close(
+        tree.node_quats.norm(dim=-1), torch.ones(M), rtol=1e-4, atol=1e-4
+    )
+
+    # a camera far away only sees the root
+    viewmats = test_data["viewmats"].clone()
+    viewmats[:, 2, 3] += 1e4
+    node_ids = tree.cut(viewmats, test_data["Ks"], pixel_size=float("inf"))
+    assert node_ids.tolist() == [N + M - 1]
+
+    # zero-sized pixels keep all the leaves
+    node_ids = tree.cut(test_data["viewmats"], test_data["Ks"], pixel_size=0.0)
+    assert sorted(node_ids.tolist()) == list(range(N))
+
+    # any cut covers every leaf exactly once
+    for pixel_size in [1.0, 10.0, 100.0]:
+        node_ids = tree.cut(test_data["viewmats"], test_data["Ks"], pixel_size)
+        assert (_leaves_of(tree, node_ids) == 1).all()
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_rasterization_lod(test_data):
+    from gsplat.lod import build_lod_tree
+    from gsplat.rendering import rasterization
+
+    N = test_data["means"].shape[0]
+    tree = build_lod_tree(
+        test_data["means"],
+        test_data["quats"],
+        test_data["scales"],
+        test_data["opacities"],
+        test_data["colors"],
+    )
+    means = test_data["means"].clone().requires_grad_(True)
+    render_colors, render_alphas, _ = rasterization(
+        test_data["means"],
+        test_data["quats"],
+        test_data["scales"],
+        test_data["opacities"],
+        test_data["colors"],
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+    )
+
+    # without merged nodes the LOD rendering is the full rendering
+    _render_colors, _render_alphas, meta = rasterization(
+        means,
+        test_data["quats"],
+        test_data["scales"],
+        test_data["opacities"],
+        test_data["colors"],
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+        lod_tree=tree,
+        lod_pixel_size=0.0,
+    )
+    assert sorted(meta["lod_ids"].tolist()) == list(range(N))
+    torch.testing.assert_close(render_colors, _render_colors, rtol=1e-4, atol=1e-4)
+    torch.testing.assert_close(render_alphas, _render_alphas, rtol=1e-4, atol=1e-4)
+
+    # coarser cuts render fewer Gaussians and propagate gradients to the leaves
+    _render_colors, _, meta = rasterization(
+        means,
+        test_data["quats"],
+        test_data["scales"],
+        test_data["opacities"],
+        test_data["colors"],
+        test_data["viewmats"],
+        test_data["Ks"],
+        test_data["width"],
+        test_data["height"],
+        lod_tree=tree,
+        lod_pixel_size=16.0,
+    )
+    lod_ids = meta["lod_ids"]
+    assert len(lod_ids) < N
+    _render_colors.sum().backward()
+    is_leaf = torch.zeros(N, dtype=torch.bool, device=device)
+    is_leaf[lod_ids[lod_ids < N]] = True
+    assert (means.grad[~is_leaf] == 0).all()
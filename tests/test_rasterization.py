@@ -96,3 +96,61 @@ def test_rasterization(
     )
     torch.testing.assert_close(renders, _renders, rtol=1e-4, atol=1e-4)
     torch.testing.assert_close(alphas, _alphas, rtol=1e-4, atol=1e-4)
+
+
+@pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
+@pytest.mark.parametrize("dtype", [torch.float16, torch.uint8])
+@pytest.mark.parametrize("sh_degree", [None, 3])
+@pytest.mark.parametrize("packed", [True, False])
+def test_rasterization_storage(
+    dtype: torch.dtype, sh_degree: Optional[int], packed: bool
+):
+    from gsplat.rendering import rasterization
+    from gsplat.storage import quantize_gaussians
+
+    torch.manual_seed(42)
+
+    C, N = 3, 10_000
+    means = torch.rand(N, 3, device=device)
+    quats = torch.randn(N, 4, device=device)
+    scales = torch.rand(N, 3, device=device) * 0.1
+    opacities = torch.rand(N, device=device)
+    if sh_degree is None:
+        colors = torch.rand(N, 3, device=device)
+    else:
+        colors = torch.rand(N, (sh_degree + 1) ** 2, 3, device=device)
+
+    width, height = 300, 200
+    focal = 300.0
+    Ks = torch.tensor(
+        [[focal, 0.0, width / 2.0], [0.0, focal, height / 2.0], [0.0, 0.0, 1.0]],
+        device=device,
+    ).expand(C, -1, -1)
+    viewmats = torch.eye(4, device=device).expand(C, -1, -1).clone()
+    viewmats[:, 2, 3] = torch.tensor([1.0, 2.0, 3.0], device=device)
+
+    kwargs = dict(
+        viewmats=viewmats,
+        Ks=Ks,
+        width=width,
+        height=height,
+        sh_degree=sh_degree,
+        packed=packed,
+    )
+    _renders, _alphas, _ = rasterization(
+        means, quats, scales, opacities, colors, **kwargs
+    )
+
+    *gaussians, dequantization = quantize_gaussians(
+        means, quats, scales, opacities, colors, dtype=dtype
+    )
+    renders, alphas, meta = rasterization(
+        *gaussians, dequantization=dequantization, **kwargs
+    )
+    assert renders.dtype == torch.float32
+    assert renders.shape == _renders.shape
+
+    # the storage is lossy, so the renders only match on average
+    atol = 1e-3 if dtype == torch.float16 else 2e-2
+    assert (renders - _renders).abs().mean() < atol
+    assert (alphas - _alphas).abs().mean() < atol
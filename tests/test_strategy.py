@@ -9,7 +9,9 @@ pytest <THIS_PY_FILE> -s
 import pytest
 import torch
 
-device = torch.device("cuda:0")
+from gsplat.cuda._backend import _C
+
+device = torch.device("cuda:0" if torch.cuda.is_available() else "cpu")
 
 
 @pytest.mark.skipif(not torch.cuda.is_available(), reason="No CUDA device")
@@ -128,6 +130,206 @@ def test_strategy_requires_grad():
     assert_consistent_sizes(params)
 
 
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+def test_gaussian_pool():
+    from gsplat.strategy.ops import duplicate, remove, sample_add, split
+    from gsplat.strategy.pool import GaussianPool
+
+    def make_splats():
+        torch.manual_seed(42)
+        N = 1000
+        params = torch.nn.ParameterDict(
+            {
+                "means": torch.randn(N, 3),
+                "scales": torch.rand(N, 3),
+                "quats": torch.randn(N, 4),
+                "opacities": torch.rand(N),
+                "colors": torch.rand(N, 3),
+                "ids": torch.arange(N).float(),
+            }
+        ).to(device)
+        params["ids"].requires_grad = False
+        optimizers = {
+            k: torch.optim.Adam([v], lr=1e-3)
+            for k, v in params.items()
+            if v.requires_grad
+        }
+        state = {"ids": params["ids"].clone()}
+        return params, optimizers, state
+
+    def refine(params, optimizers, state, pool):
+        duplicate(params, optimizers, state, params["ids"] % 7 == 0, pool=pool)
+        remove(params, optimizers, state, params["ids"] % 3 == 0, pool=pool)
+        # gradients that do not depend on the order of the Gaussians
+        for k, optimizer in optimizers.items():
+            params[k].grad = params[k].detach() * 0.1
+            optimizer.step()
+            optimizer.zero_grad(set_to_none=True)
+
+    def sort(params):
+        order = torch.argsort(params["means"][:, 0], stable=True)
+        return order[torch.argsort(params["ids"][order], stable=True)]
+
+    params, optimizers, state = make_splats()
+    pooled, pooled_optimizers, pooled_state = make_splats()
+    pool = GaussianPool(pooled, pooled_optimizers, capacity=1200)
+    for _ in range(3):
+        refine(params, optimizers, state, None)
+        refine(pooled, pooled_optimizers, pooled_state, pool)
+
+    # same Gaussians and optimizer states, in another order
+    assert len(pool) == len(pooled["means"]) == len(params["means"])
+    order, pooled_order = sort(params), sort(pooled)
+    for k in params.keys():
+        torch.testing.assert_close(params[k][order], pooled[k][pooled_order])
+        if k in optimizers:
+            for key in ["exp_avg", "exp_avg_sq"]:
+                v = optimizers[k].state[params[k]][key]
+                pooled_v = pooled_optimizers[k].state[pooled[k]][key]
+                torch.testing.assert_close(v[order], pooled_v[pooled_order])
+    torch.testing.assert_close(pooled_state["ids"], pooled["ids"])
+
+    # grow beyond the capacity with split and sample_add
+    N = len(pool)
+    n_split = int((pooled["ids"] % 2 == 0).sum())
+    split(pooled, pooled_optimizers, pooled_state, pooled["ids"] % 2 == 0, pool=pool)
+    binoms = torch.ones((51, 51), device=device)
+    sample_add(pooled, pooled_optimizers, {}, N, binoms, pool=pool)
+    assert len(pool) == len(pooled["means"]) == N + n_split + N
+    assert pool.capacity >= len(pool) > 1200
+    torch.testing.assert_close(pooled_state["ids"], pooled["ids"][: N + n_split])
+
+    # the parameters and the optimizer states are views on the pool
+    for k, v in pooled.items():
+        assert v.data_ptr() == pool._storages[k].data_ptr()
+        if k in pooled_optimizers:
+            exp_avg = pooled_optimizers[k].state[v]["exp_avg"]
+            assert exp_avg.data_ptr() == pool._states[k]["exp_avg"].data_ptr()
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("packed", [False, True])
+@pytest.mark.parametrize("stats_device", ["cpu", "cuda"])
+def test_densification_stats(packed: bool, stats_device: str):
+    from gsplat.strategy import DefaultStrategy
+
+    if stats_device == "cuda" and not torch.cuda.is_available():
+        pytest.skip("No CUDA device")
+
+    torch.manual_seed(42)
+
+    C, N, width, height = 3, 1000, 64, 48
+    radii = torch.randint(-2, 10, (C, N, 2), dtype=torch.int32, device=stats_device)
+    grads = torch.randn(C, N, 2, device=stats_device)
+    info = {"width": width, "height": height, "n_cameras": C}
+    if packed:
+        camera_ids, gaussian_ids = torch.where((radii > 0).all(dim=-1))
+        info["radii"] = radii[camera_ids, gaussian_ids]
+        info["gaussian_ids"] = gaussian_ids
+        grads = grads[camera_ids, gaussian_ids]
+    else:
+        info["radii"] = radii
+        info["gaussian_ids"] = None
+    means2d = torch.zeros_like(grads, requires_grad=True)
+    means2d.grad = grads
+    info["means2d"] = means2d
+    params = {"means": torch.zeros(N, 3, device=stats_device)}
+
+    states = []
+    for fused_stats in [False, True]:
+        strategy = DefaultStrategy(
+            refine_scale2d_stop_iter=1000, fused_stats=fused_stats
+        )
+        state = strategy.initialize_state()
+        for _ in range(2):
+            strategy._update_state(params, state, info, packed=packed)
+        states.append(state)
+    for k in ["grad2d", "count", "radii"]:
+        torch.testing.assert_close(states[0][k], states[1][k])
+
+
+@pytest.mark.skipif(_C is None, reason="No gsplat extension")
+@pytest.mark.parametrize("device", ["cpu", "cuda"])
+@pytest.mark.parametrize("native", [True, False])
+def test_compact_rows(monkeypatch, device: str, native: bool):
+    from gsplat.cuda._wrapper import compact_rows
+    from gsplat.strategy import ops
+    from gsplat.strategy.ops import duplicate, remove, split
+
+    if device == "cuda" and not torch.cuda.is_available():
+        pytest.skip("No CUDA device")
+
+    torch.manual_seed(42)
+
+    N = 10000
+    tensors = [
+        torch.randn(N, 3, device=device),
+        torch.randint(0, 255, (N, 5), dtype=torch.uint8, device=device),
+        torch.arange(N, device=device),
+        torch.randn(N, 15, 3, device=device).half(),
+    ]
+    keep = torch.rand(N, device=device) > 0.3
+    append = torch.randint(0, N, (777,), device=device)
+    zero_append = [False, False, True, False]
+    outputs = compact_rows(tensors, keep, append, zero_append)
+    for x, out, zero in zip(tensors, outputs, zero_append):
+        x_append = torch.zeros_like(x[append]) if zero else x[append]
+        torch.testing.assert_close(out, torch.cat([x[keep], x_append]))
+
+    # the ops match their gathers, including the optimizer states, with and
+    # without the native compaction
+    monkeypatch.setattr(ops, "_has_compact_rows", lambda: native)
+    params = torch.nn.ParameterDict(
+        {
+            "means": torch.randn(N, 3),
+            "scales": torch.rand(N, 3),
+            "quats": torch.randn(N, 4),
+            "opacities": torch.rand(N),
+        }
+    ).to(device)
+    optimizers = {k: torch.optim.Adam([v], lr=1e-3) for k, v in params.items()}
+    for v in params.values():
+        v.grad = torch.randn_like(v)
+    for optimizer in optimizers.values():
+        optimizer.step()
+    state = {"grad2d": torch.rand(N, device=device), "scene_scale": 1.0}
+
+    def snapshot():
+        return {
+            "quats": params["quats"].detach().clone(),
+            "exp_avg": optimizers["quats"].state[params["quats"]]["exp_avg"].clone(),
+            "grad2d": state["grad2d"].clone(),
+        }
+
+    mask = torch.rand(N, device=device) > 0.9
+    before = snapshot()
+    duplicate(params, optimizers, state, mask)
+    after = snapshot()
+    for k, v in before.items():
+        v_new = torch.zeros_like(v[mask]) if k == "exp_avg" else v[mask]
+        torch.testing.assert_close(after[k], torch.cat([v, v_new]))
+
+    mask = torch.rand(len(params["means"]), device=device) > 0.9
+    before = snapshot()
+    split(params, optimizers, state, mask)
+    after = snapshot()
+    for k, v in before.items():
+        v_new = torch.zeros_like(v[mask]) if k == "exp_avg" else v[mask]
+        torch.testing.assert_close(after[k], torch.cat([v[~mask], v_new, v_new]))
+
+    mask = torch.rand(len(params["means"]), device=device) > 0.5
+    before = snapshot()
+    remove(params, optimizers, state, mask)
+    after = snapshot()
+    for k, v in before.items():
+        torch.testing.assert_close(after[k], v[~mask])
+    assert state["scene_scale"] == 1.0
+    for name, p in params.items():
+        assert len(p) == len(state["grad2d"])
+        assert optimizers[name].param_groups[0]["params"][0] is p
+        assert optimizers[name].state[p]["exp_avg_sq"].shape == p.shape
+
+
 if __name__ == "__main__":
     test_strategy()
     test_strategy_requires_grad()